@@ -10,6 +10,9 @@ from AthenaConfiguration.ComponentFactory import CompFactory
 from AthenaConfiguration.MainServicesConfig import MainServicesCfg
 from AthenaConfiguration.TestDefaults import defaultTestFiles
 
+# Project import(s).
+from CUDAExamples.MemoryResourcesConfig import MemoryResourceSvcCfg
+
 # I/O import(s).
 from AthenaPoolCnvSvc.PoolReadConfig import PoolReadCfg
 
@@ -20,6 +23,9 @@ import sys
 def ElectronCalibCUDAAlgCfg(flags, **kwargs):
     # Create an accumulator to hold the configuration.
     result = ComponentAccumulator()
+    # Set up the memory resource service used by the algorithm.
+    kwargs.setdefault("MemoryResourceSvc",
+                      result.getPrimaryAndMerge(MemoryResourceSvcCfg(flags)))
     # Create the example algorithm.
     alg = CompFactory.GPUTutorial.ElectronCalibCUDAAlg(**kwargs)
     result.addEventAlgo(alg)
@@ -32,6 +38,10 @@ if __name__ == '__main__':
     # Set up the job's flags.
     flags = initConfigFlags()
     flags.Exec.MaxEvents = 1000
+    #########################################
+    flags.Exec.FPE = -2
+    flags.Concurrency.NumOffloadThreads = 2
+    #########################################
     flags.Input.Files = defaultTestFiles.AOD_RUN3_DATA
     flags.fillFromArgs()
     flags.lock()
@@ -42,7 +52,13 @@ if __name__ == '__main__':
     # Set up the input file reading.
     acc.merge(PoolReadCfg(flags))
 
-    # Set up the tutorial algorithm.
+    # Set up the tutorial algorithm. To use the binned calibration, pass
+    # CalibrationFile="CUDAExamples/ElectronCalibration.txt" to it. To only
+    # store the calibrated pt values in the output, pass
+    # ShallowCopyOutput=True to it. To decide in every event whether to
+    # calibrate on the host or on the device, pass Backend="Dispatch" to it,
+    # together with MockDevice=True on a machine without a GPU. (With a real
+    # device, that needs the calibration of the exercise's kernel first.)
     acc.merge(ElectronCalibCUDAAlgCfg(flags))
 
     # Run the configuration.
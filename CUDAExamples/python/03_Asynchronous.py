@@ -14,6 +14,9 @@ from AthenaConfiguration.TestDefaults import defaultTestFiles, defaultConditions
 from JetRecConfig.StandardSmallRJets import AntiKt4EMPFlow
 from JetRecConfig.JetRecConfig import JetRecCfg
 
+# Project import(s).
+from CUDAExamples.MemoryResourcesConfig import MemoryResourceSvcCfg
+
 # I/O import(s).
 from AthenaPoolCnvSvc.PoolReadConfig import PoolReadCfg
 
@@ -37,6 +40,9 @@ def JetBuildCfg(flags, **kwargs):
 def JetPullCUDAAlgCfg(flags, **kwargs):
     # Create an accumulator to hold the configuration.
     result = ComponentAccumulator()
+    # Set up the memory resource service used by the algorithm.
+    kwargs.setdefault("MemoryResourceSvc",
+                      result.getPrimaryAndMerge(MemoryResourceSvcCfg(flags)))
     # Create the example algorithm.
     alg = CompFactory.GPUTutorial.JetPullCUDAAlg(InputContainer="AntiKt4EMPFlowJets", **kwargs)
     result.addEventAlgo(alg)
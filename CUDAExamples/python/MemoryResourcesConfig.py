@@ -0,0 +1,23 @@
+#
+# Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#
+
+# Core import(s).
+from AthenaConfiguration.ComponentAccumulator import ComponentAccumulator
+from AthenaConfiguration.ComponentFactory import CompFactory
+
+
+def MemoryResourceSvcCfg(flags, **kwargs):
+    # Create an accumulator to hold the configuration.
+    result = ComponentAccumulator()
+    # Create the memory resource service, shared by all the CUDA algorithms.
+    # The amount of host and device memory that it may use can be limited
+    # with MaxHostMemory and MaxDeviceMemory (in MB). Without a CUDA device
+    # it only uses host memory, for the host backends of the algorithms. With
+    # an AllocationProfile file, the memory used by this job is allocated up
+    # front by the next one.
+    svc = CompFactory.GPUTutorial.CUDAMemoryResourceSvc("MemoryResourceSvc",
+                                                        **kwargs)
+    result.addService(svc, primary=True)
+    # Return the result to the caller.
+    return result
@@ -0,0 +1,66 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef CUDAEXAMPLES_AUXSTORECOLUMNS_H
+#define CUDAEXAMPLES_AUXSTORECOLUMNS_H
+
+// Project include(s).
+#include "GPUTutorialCore/DeviceColumns.h"
+
+// Framework include(s).
+#include "AthContainers/AuxElement.h"
+#include "AthContainers/AuxVectorData.h"
+#include "AthContainersInterfaces/IAuxStore.h"
+
+// System include(s).
+#include <cstddef>
+
+namespace GPUTutorial
+{
+   /// The accessor of the auxiliary variable of a column
+   template <typename COLUMN>
+   const SG::AuxElement::ConstAccessor<typename COLUMN::value_type> &
+   auxAccessor()
+   {
+      static const SG::AuxElement::ConstAccessor<typename COLUMN::value_type>
+          acc(COLUMN::auxName);
+      return acc;
+   }
+
+   /// Create a view of the columns that the kernels read
+   ///
+   /// The view points directly at the (contiguous) arrays of the container's
+   /// auxiliary store, no data is copied. Columns that are only written by
+   /// the kernels are left empty.
+   ///
+   template <typename SET, typename CONTAINER>
+   typename CONTAINER::const_view
+   makeReadView(const SG::AuxVectorData &container)
+   {
+      return SET::template bind<ColumnAccess::Read,
+                                typename CONTAINER::const_view>(
+          container.size_v(), [&](auto column)
+          { return auxAccessor<decltype(column)>().getDataArray(container); });
+   }
+
+   /// Create a (writable) view of the columns that the kernels write
+   ///
+   /// The variables are created in the store if they did not exist yet.
+   /// Columns that are only read by the kernels are left empty, so that
+   /// they are not copied back from the device.
+   ///
+   template <typename SET, typename CONTAINER>
+   typename CONTAINER::view makeWriteView(SG::IAuxStore &store,
+                                          std::size_t size)
+   {
+      return SET::template bind<ColumnAccess::Write,
+                                typename CONTAINER::view>(
+          size, [&](auto column)
+          {
+             using value_type = typename decltype(column)::value_type;
+             return static_cast<value_type *>(store.getData(
+                 auxAccessor<decltype(column)>().auxid(), size, size));
+          });
+   }
+
+} // namespace GPUTutorial
+
+#endif // CUDAEXAMPLES_AUXSTORECOLUMNS_H
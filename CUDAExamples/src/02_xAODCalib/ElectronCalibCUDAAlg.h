@@ -2,19 +2,47 @@
 #ifndef CUDAEXAMPLES_ELECTRONCALIBCUDAALG_H
 #define CUDAEXAMPLES_ELECTRONCALIBCUDAALG_H
 
+// Local include(s).
+#include "../MemoryResources/IMemoryResourceSvc.h"
+#include "../Timing/CUDAStageTimer.h"
+
+// Project include(s).
+#include "GPUTutorialCore/AsyncExecutor.h"
+#include "GPUTutorialCore/ElectronCalibrationTable.h"
+#include "GPUTutorialCore/ElectronDeviceContainer.h"
+#include "GPUTutorialCore/EventCapture.h"
+#include "GPUTutorialCore/LaunchTuning.h"
+#include "GPUTutorialCore/OffloadDispatcher.h"
+#include "GPUTutorialCore/StageTimeline.h"
+#include "GPUTutorialCore/TransferEncoding.h"
+
 // Framework include(s).
-#include "AthenaBaseComps/AthReentrantAlgorithm.h"
+#include "AthenaBaseComps/AthAsynchronousAlgorithm.h"
+#include "GaudiKernel/ServiceHandle.h"
 #include "StoreGate/ReadHandleKey.h"
 #include "StoreGate/WriteHandleKey.h"
 #include "xAODEgamma/ElectronContainer.h"
 
+// VecMem include(s).
+#include <vecmem/utils/copy.hpp>
+
+// CUDA include(s).
+#include <cuda_runtime_api.h>
+
 // System include(s).
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace GPUTutorial
 {
    /// Example algorithm performing a calibration on xAOD::Electron objects
-   class ElectronCalibCUDAAlg final : public AthReentrantAlgorithm
+   ///
+   /// The device work of every event is scheduled on a CUDA stream of its
+   /// own, and is only waited for once, without blocking the thread that the
+   /// algorithm runs on.
+   ///
+   class ElectronCalibCUDAAlg final : public AthAsynchronousAlgorithm
    {
    public:
       /// Constructor
@@ -22,17 +50,38 @@ namespace GPUTutorial
       /// Destructor
       ~ElectronCalibCUDAAlg() override;
 
-      /// @name Functions inherited from @c AthReentrantAlgorithm
+      /// @name Functions inherited from @c AthAsynchronousAlgorithm
       /// @{
 
       /// Function initializing the algorithm
       StatusCode initialize() override;
       /// Function executing the algorithm
       StatusCode execute(const EventContext &ctx) const override;
+      /// Function finalizing the algorithm
+      StatusCode finalize() override;
 
       /// @}
 
    private:
+      /// The context to record the stage timings of an event for
+      StageContext stageContext(const EventContext &ctx) const;
+      /// Set up the host/device dispatch, and the mock device if requested
+      StatusCode setupDispatcher();
+      /// PIMPL structure holding the buffers of an encoded transfer
+      struct EncodedTransfer;
+      /// Copy the input columns to the device with the transfer encoding
+      ///
+      /// The encoded columns are decoded into @c deviceInput on the device.
+      /// The copies and the decoding are only scheduled on @c stream, with
+      /// @c transfer holding the buffers that they use until they finished.
+      ///
+      StatusCode copyEncoded(const ElectronDeviceContainer::const_view &input,
+                             const ElectronDeviceContainer::view &deviceInput,
+                             EncodedTransfer &transfer,
+                             const vecmem::copy &copy, cudaStream_t stream,
+                             CUDAStageTimer &timer, const EventContext &ctx,
+                             const StageContext &timing) const;
+
       /// @name Algorithm properties
       /// @{
 
@@ -44,17 +93,135 @@ namespace GPUTutorial
       SG::WriteHandleKey<xAOD::ElectronContainer> m_outputKey{
           this, "OutputContainer", "CalibratedElectrons",
           "The output electron container"};
+      /// The (optional) binned calibration file
+      Gaudi::Property<std::string> m_calibrationFile{
+          this, "CalibrationFile", "",
+          "Text file with the binned calibration tables (none: use a formula)"};
+      /// How the electron variables should be handed to the device
+      Gaudi::Property<std::string> m_inputMode{
+          this, "InputMode", "Auto",
+          "How to move data between the aux stores and the device "
+          "(Auto, ZeroCopy, Direct, Pinned)"};
+      /// Encoding of the input columns on the host-to-device transfers
+      Gaudi::Property<std::string> m_transferEncoding{
+          this, "TransferEncoding", "none",
+          "Encoding of the eta, phi and pt columns on the host-to-device "
+          "transfers, like \"eta=fixed:16,phi=fixed:16,pt=half\" (none: "
+          "transfer the float32 columns as they are)"};
+      /// Where to calibrate the electrons
+      Gaudi::Property<std::string> m_backend{
+          this, "Backend", "Device",
+          "Where to calibrate the electrons: \"Device\", \"Host\", or "
+          "\"Dispatch\" to decide in every event, based on the number of "
+          "electrons"};
+      /// Threshold of the host/device dispatch
+      Gaudi::Property<long> m_dispatchThreshold{
+          this, "DispatchThreshold", -1,
+          "Smallest number of electrons calibrated on the device with "
+          "Backend=\"Dispatch\" (negative: derive it from timing runs in "
+          "initialize())"};
+      /// Launch parameters of the calibration kernel
+      Gaudi::Property<std::string> m_launchParameters{
+          this, "LaunchParameters", "auto",
+          "Launch parameters of the calibration kernel: \"auto\" to tune "
+          "them in initialize(), or a fixed block size, like \"256\""};
+      /// File caching the tuned launch parameters
+      Gaudi::Property<std::string> m_launchCacheFile{
+          this, "LaunchCacheFile", "gpuTutorialLaunch.cache",
+          "File caching the tuned launch parameters of the kernels, per "
+          "device (none if empty)"};
+      /// Use a mock device instead of the CUDA device
+      Gaudi::Property<bool> m_mockDevice{
+          this, "MockDevice", false,
+          "Run the device side of the calibration on the host, delayed like "
+          "on a slow device (for testing without an accelerator)"};
+      /// Latency of the mock device
+      Gaudi::Property<float> m_mockDeviceLatency{
+          this, "MockDeviceLatency", 20.f,
+          "Latency of every calculation on the mock device, in microseconds"};
+      /// Bandwidth of the mock device
+      Gaudi::Property<float> m_mockDeviceBandwidth{
+          this, "MockDeviceBandwidth", 10.f,
+          "Bandwidth of the transfers of the mock device, in GB/s"};
+      /// Number of threads of the mock device
+      Gaudi::Property<unsigned int> m_mockDeviceThreads{
+          this, "MockDeviceThreads", 4,
+          "Number of calculations that the mock device can run at the same "
+          "time, on a pool of host threads"};
+      /// The memory resource service
+      ServiceHandle<IMemoryResourceSvc> m_memorySvc{
+          this, "MemoryResourceSvc",
+          "GPUTutorial::CUDAMemoryResourceSvc/MemoryResourceSvc",
+          "Service providing the host and device memory resources"};
+      /// Write the output as a shallow copy, with only pt stored
+      Gaudi::Property<bool> m_shallowCopyOutput{
+          this, "ShallowCopyOutput", false,
+          "Write the output as a shallow copy of the input, only storing the "
+          "calibrated pt values in it"};
+      /// Measure the time spent in the stages of the calibration
+      Gaudi::Property<bool> m_stageTiming{
+          this, "StageTiming", false,
+          "Measure the time spent in the stages of every event"};
+      /// File to write the stage timings into, as a Chrome trace
+      Gaudi::Property<std::string> m_chromeTraceFile{
+          this, "ChromeTraceFile", "",
+          "File to write the stage timings of all algorithms into, as a "
+          "Chrome trace (none if empty)"};
+      /// File to capture the offload inputs of every event into
+      Gaudi::Property<std::string> m_captureFile{
+          this, "CaptureFile", "",
+          "File to write the electron variables handed to the calibration "
+          "into, for replaying them with gpuTutorialReplay (none if empty)"};
 
       /// @}
 
       /// @name Algorithm data members
       /// @{
 
-      /// PIMPL structure of memory resources
+      /// Identifier of the algorithm in the memory resource service
+      IMemoryResourceSvc::ClientID m_memoryClient = 0;
+      /// PIMPL structure of the algorithm's own memory resources
       struct MemoryResources;
-      /// Memory resources used by the algorithm
+      /// Device memory caches of the algorithm, on top of the shared resource
       std::unique_ptr<MemoryResources> m_memoryResources;
 
+      /// The possible ways of moving data between the aux stores and the device
+      enum class InputMode
+      {
+         ZeroCopy, ///< The device accesses the aux store arrays directly
+         Direct,   ///< Copy directly between the aux stores and the device
+         Pinned    ///< Stage the copies through pinned host memory
+      };
+      /// The resolved input mode
+      InputMode m_resolvedInputMode = InputMode::Direct;
+      /// The parsed transfer encoding
+      TransferEncoding m_encoding;
+      /// Launch parameters of the calibration kernel
+      LaunchConfig m_launch;
+
+      /// Helper deciding where to calibrate the electrons of an event
+      std::unique_ptr<OffloadDispatcher> m_dispatcher;
+      /// The mock device, if one is used
+      std::unique_ptr<MockDevice> m_mock;
+      /// The threads running the calculations of the mock device
+      std::unique_ptr<HostThreadPool> m_mockThreads;
+
+      /// The calibration tables read from the calibration file
+      std::vector<ElectronCalibrationIOV> m_calibrations;
+      /// PIMPL structure holding the calibration table on the device
+      struct DeviceCalibration;
+      /// The calibration table currently on the device
+      std::unique_ptr<DeviceCalibration> m_deviceCalibration;
+
+      /// Writer of the captured offload inputs, if requested (shared with
+      /// the other algorithms writing into the same file)
+      std::shared_ptr<EventCaptureWriter> m_capture;
+
+      /// Timeline to record the stage timings into
+      std::shared_ptr<StageTimeline> m_timeline;
+      /// Identifier of the algorithm on the timeline
+      std::size_t m_timingSource = 0;
+
       /// @}
 
    }; // class ElectronCalibCUDAAlg
@@ -1,43 +0,0 @@
-// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
-#ifndef CUDAEXAMPLES_ELECTRONDEVICECONTAINER_H
-#define CUDAEXAMPLES_ELECTRONDEVICECONTAINER_H
-
-// VecMem include(s).
-#include <vecmem/edm/container.hpp>
-
-namespace GPUTutorial
-{
-   /// Interface for the VecMem based GPU friendly ElectronDeviceContainer.
-   template <typename BASE>
-   struct ElectronDeviceInterface : public BASE
-   {
-      /// Inherit the base class's constructor(s)
-      using BASE::BASE;
-
-      /// Inherit the base class's assignment operator(s)
-      using BASE::operator=;
-
-      /// Get the pseudorapidity of the electrons (const)
-      VECMEM_HOST_AND_DEVICE
-      const auto &eta() const { return BASE::template get<0>(); }
-      /// Get the pseudorapidity of the electrons (non-const)
-      VECMEM_HOST_AND_DEVICE
-      auto &eta() { return BASE::template get<0>(); }
-
-      /// Get the azimuthal angles of the electrons (const)
-      VECMEM_HOST_AND_DEVICE
-      const auto &phi() const { return BASE::template get<1>(); }
-      /// Get the azimuthal angles of the electrons (non-const)
-      VECMEM_HOST_AND_DEVICE
-      auto &phi() { return BASE::template get<1>(); }
-
-   }; // struct ElectronDeviceInterface
-
-   /// SoA, GPU friendly electron container.
-   using ElectronDeviceContainer = vecmem::edm::container<
-       ElectronDeviceInterface, vecmem::edm::type::vector<float>,
-       vecmem::edm::type::vector<float>>;
-
-} // namespace GPUTutorial
-
-#endif // CUDAEXAMPLES_ELECTRONDEVICECONTAINER_H
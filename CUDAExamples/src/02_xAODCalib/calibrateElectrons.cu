@@ -29,7 +29,8 @@ namespace GPUTutorial
       /// Simple kernel "calibrating" electrons
       __global__ void
       calibrateElectrons(ElectronDeviceContainer::const_view inputView,
-                         ElectronDeviceContainer::view outputView)
+                         ElectronDeviceContainer::view outputView,
+                         ElectronCalibrationTableView table)
       {
          // Get the index of the current thread.
          const int idx = blockIdx.x * blockDim.x + threadIdx.x;
@@ -44,9 +45,17 @@ namespace GPUTutorial
             return;
          }
 
-         // Copy the input electron to the output container.
-         output[idx].eta() = input[idx].eta();
-         output[idx].phi() = input[idx].phi();
+         // Set the (only) variable written by the calibration. The other
+         // columns of the output are not bound to any memory.
+         output.pt()[idx] = input[idx].pt();
+
+         // Apply the binned calibration, if one was provided.
+         if (!table.empty())
+         {
+            output.pt()[idx] *= table.factor(input[idx].eta(), input[idx].phi(),
+                                             input[idx].pt(),
+                                             input[idx].author());
+         }
 
          // Perform some calibration on the output electron.
       }
@@ -54,19 +63,22 @@ namespace GPUTutorial
    } // namespace Kernels
 
    StatusCode calibrateElectrons(ElectronDeviceContainer::const_view input,
-                                 ElectronDeviceContainer::view output)
+                                 ElectronDeviceContainer::view output,
+                                 cudaStream_t stream,
+                                 const ElectronCalibrationTableView &table,
+                                 const LaunchConfig &launch)
    {
       // Launch the kernel.
-      const int blockSize = 256;
-      const int numBlocks = (input.capacity() + blockSize - 1) / blockSize;
-      Kernels::calibrateElectrons<<<numBlocks, blockSize>>>(input, output);
+      const unsigned int blockSize =
+          static_cast<unsigned int>(launch.workGroupSize);
+      const unsigned int numBlocks =
+          (input.capacity() + blockSize - 1) / blockSize;
+      Kernels::calibrateElectrons<<<numBlocks, blockSize, 0, stream>>>(
+          input, output, table);
 
       // Check for errors in kernel launch.
       ATH_CUDA_CHECK(cudaGetLastError());
 
-      // Wait for the device to finish with the kernel.
-      ATH_CUDA_CHECK(cudaDeviceSynchronize());
-
       // Return gracefully.
       return StatusCode::SUCCESS;
    }
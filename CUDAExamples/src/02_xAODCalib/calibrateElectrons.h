@@ -5,15 +5,35 @@
 // Framework include(s).
 #include "GaudiKernel/StatusCode.h"
 
-// Local include(s).
-#include "ElectronDeviceContainer.h"
+// Project include(s).
+#include "GPUTutorialCore/ElectronCalibrationTable.h"
+#include "GPUTutorialCore/ElectronDeviceContainer.h"
+#include "GPUTutorialCore/LaunchTuning.h"
+
+// CUDA include(s).
+#include <cuda_runtime_api.h>
 
 namespace GPUTutorial
 {
 
    /// Standalone function to calibrate the electrons
+   ///
+   /// If a (device resident) calibration table is provided, the electrons'
+   /// transverse momenta are corrected using that table. Only the columns
+   /// of @c output that @c GPUTutorial::ElectronColumns declares as written
+   /// are set, the others may be left unbound.
+   ///
+   /// The kernel is only launched on @c stream. The caller needs to
+   /// synchronise with the stream before using the output.
+   ///
+   /// Only the block size of @c launch is used, every thread calibrates a
+   /// single electron.
+   ///
    StatusCode calibrateElectrons(ElectronDeviceContainer::const_view input,
-                                 ElectronDeviceContainer::view output);
+                                 ElectronDeviceContainer::view output,
+                                 cudaStream_t stream,
+                                 const ElectronCalibrationTableView &table = {},
+                                 const LaunchConfig &launch = {});
 
 } // namespace GPUTutorial
 
@@ -0,0 +1,46 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "decodeColumns.h"
+
+// Project include(s).
+#include "GPUTutorialCore/TransferEncodingCUDA.h"
+
+// Framework include(s).
+#include "AthenaKernel/errorcheck.h"
+
+/// Helper macro for checking CUDA calls
+#define ATH_CUDA_CHECK(EXP)                                      \
+   do                                                            \
+   {                                                             \
+      const cudaError_t ce = EXP;                                \
+      if (ce != cudaSuccess)                                     \
+      {                                                          \
+         REPORT_ERROR_WITH_CONTEXT(StatusCode::FAILURE,          \
+                                   "GPUTutorial::decodeColumns") \
+             << "Failed to execute \""                           \
+             << #EXP << "\" because:"                            \
+             << cudaGetErrorString(ce);                          \
+         return StatusCode::FAILURE;                             \
+      }                                                          \
+   } while (false)
+
+namespace GPUTutorial
+{
+
+   StatusCode decodeColumns(std::span<const DeviceColumnDecoding> columns,
+                            cudaStream_t stream)
+   {
+      // Launch the kernels.
+      for (const DeviceColumnDecoding &column : columns)
+      {
+         ATH_CUDA_CHECK(CUDA::decodeColumn(column.codes.size(),
+                                           column.codes.ptr(), column.decoder,
+                                           column.values.ptr(), stream));
+      }
+
+      // Return gracefully.
+      return StatusCode::SUCCESS;
+   }
+
+} // namespace GPUTutorial
@@ -0,0 +1,45 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef CUDAEXAMPLES_DECODECOLUMNS_H
+#define CUDAEXAMPLES_DECODECOLUMNS_H
+
+// Framework include(s).
+#include "GaudiKernel/StatusCode.h"
+
+// Project include(s).
+#include "GPUTutorialCore/TransferEncoding.h"
+
+// VecMem include(s).
+#include <vecmem/containers/data/vector_view.hpp>
+
+// CUDA include(s).
+#include <cuda_runtime_api.h>
+
+// System include(s).
+#include <cstdint>
+#include <span>
+
+namespace GPUTutorial
+{
+
+   /// An encoded column on the device, and the column to decode it into
+   struct DeviceColumnDecoding
+   {
+      /// The encoded values, on the device
+      vecmem::data::vector_view<const std::uint16_t> codes;
+      /// The decoder of the values
+      FloatDecoder decoder;
+      /// The decoded values, on the device
+      vecmem::data::vector_view<float> values;
+   };
+
+   /// Standalone function decoding columns on the device
+   ///
+   /// The kernels of all columns are only launched on @c stream. The caller
+   /// needs to synchronise with the stream before using the decoded values.
+   ///
+   StatusCode decodeColumns(std::span<const DeviceColumnDecoding> columns,
+                            cudaStream_t stream);
+
+} // namespace GPUTutorial
+
+#endif // CUDAEXAMPLES_DECODECOLUMNS_H
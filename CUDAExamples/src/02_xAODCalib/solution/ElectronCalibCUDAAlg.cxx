@@ -2,52 +2,513 @@
 
 // Local include(s).
 #include "ElectronCalibCUDAAlg.h"
-#include "ElectronDeviceContainer.h"
+#include "AuxStoreColumns.h"
 #include "calibrateElectrons.h"
+#include "decodeColumns.h"
+#include "../Async/FiberAwait.h"
+
+// Project include(s).
+#include "GPUTutorialCore/ElectronCalibration.h"
+#include "GPUTutorialCore/ElectronDeviceContainer.h"
+#include "GPUTutorialCore/LaunchTuning.h"
 
 // Framework include(s).
 #include "AthContainers/tools/copyAuxStoreThinned.h"
+#include "Gaudi/CUDA/CUDAStream.h"
+#include "PathResolver/PathResolver.h"
 #include "StoreGate/ReadHandle.h"
 #include "StoreGate/WriteHandle.h"
 #include "xAODCore/AuxContainerBase.h"
+#include "xAODCore/ShallowCopy.h"
 
 // VecMem include(s).
-#include <vecmem/memory/cuda/host_memory_resource.hpp>
-#include <vecmem/memory/cuda/device_memory_resource.hpp>
+#include <vecmem/containers/data/vector_buffer.hpp>
 #include <vecmem/memory/pool_memory_resource.hpp>
 #include <vecmem/memory/synchronized_memory_resource.hpp>
+#include <vecmem/utils/copy.hpp>
+#include <vecmem/utils/cuda/async_copy.hpp>
 #include <vecmem/utils/cuda/copy.hpp>
+#include <vecmem/utils/cuda/stream_wrapper.hpp>
+
+// CUDA include(s).
+#include <cuda_runtime_api.h>
+
+// System include(s).
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+   /// The (host) array of a column of a view
+   template <typename COLUMN>
+   std::span<const typename COLUMN::value_type>
+   hostColumn(const GPUTutorial::ElectronDeviceContainer::const_view &view)
+   {
+      const vecmem::data::vector_view<const typename COLUMN::value_type>
+          column = view.template get<
+              GPUTutorial::ElectronColumns::Set::index<COLUMN>()>();
+      return {column.ptr(), column.size()};
+   }
+   /// A floating point column of a (device) view
+   template <typename COLUMN>
+   vecmem::data::vector_view<float>
+   deviceColumn(const GPUTutorial::ElectronDeviceContainer::view &view)
+   {
+      return view.template get<
+          GPUTutorial::ElectronColumns::Set::index<COLUMN>()>();
+   }
+
+   /// Synthetic electrons, used to time the calibration in initialize()
+   struct SyntheticElectrons
+   {
+      /// Constructor with the (maximal) number of electrons
+      explicit SyntheticElectrons(std::size_t n)
+          : eta(n), phi(n), pt(n), author(n), calibratedPt(n)
+      {
+         for (std::size_t i = 0; i < n; ++i)
+         {
+            eta[i] = -2.4f + 4.8f * static_cast<float>(i % 97) / 97.f;
+            phi[i] = -3.1f + 6.2f * static_cast<float>(i % 89) / 89.f;
+            pt[i] = 5000.f + 100.f * static_cast<float>(i % 1013);
+            author[i] = static_cast<std::uint16_t>(1 + i % 16);
+         }
+      }
+
+      /// View of the input columns of the first @c n electrons
+      GPUTutorial::ElectronDeviceContainer::const_view input(std::size_t n) const
+      {
+         using namespace GPUTutorial;
+         return ElectronColumns::Set::bind<ColumnAccess::Read,
+                                           ElectronDeviceContainer::const_view>(
+             n, [this](auto column)
+             {
+                using COLUMN = decltype(column);
+                if constexpr (std::is_same_v<COLUMN, ElectronColumns::Eta>)
+                {
+                   return eta.data();
+                }
+                else if constexpr (std::is_same_v<COLUMN, ElectronColumns::Phi>)
+                {
+                   return phi.data();
+                }
+                else if constexpr (std::is_same_v<COLUMN, ElectronColumns::Pt>)
+                {
+                   return pt.data();
+                }
+                else
+                {
+                   return author.data();
+                }
+             });
+      }
+      /// View of the output column of the first @c n electrons
+      GPUTutorial::ElectronDeviceContainer::view output(std::size_t n)
+      {
+         using namespace GPUTutorial;
+         return ElectronColumns::Set::bind<ColumnAccess::Write,
+                                           ElectronDeviceContainer::view>(
+             n, [this](auto) { return calibratedPt.data(); });
+      }
+
+      /// Calibrate the first @c n electrons on the host
+      void calibrateHost(std::size_t n,
+                         const GPUTutorial::ElectronCalibrationTableView &table)
+      {
+         GPUTutorial::Host::calibrateElectrons(
+             {eta.data(), n}, {phi.data(), n}, {pt.data(), n},
+             {author.data(), n}, table, {calibratedPt.data(), n});
+      }
+
+      /// @name The electron variables
+      /// @{
+      std::vector<float> eta, phi, pt;
+      std::vector<std::uint16_t> author;
+      std::vector<float> calibratedPt;
+      /// @}
+   };
+
+   /// Number of bytes moved to and from a device per electron
+   constexpr std::size_t BYTES_PER_ELECTRON =
+       GPUTutorial::ElectronColumns::Set::bytesPerElement<
+           GPUTutorial::ColumnAccess::Read>() +
+       GPUTutorial::ElectronColumns::Set::bytesPerElement<
+           GPUTutorial::ColumnAccess::Write>();
+
+   /// The electron variables copied from the aux stores towards the device
+   using CopiedColumns = GPUTutorial::ElectronColumns::Set; // FIX
+
+} // namespace
 
 namespace GPUTutorial
 {
 
    struct ElectronCalibCUDAAlg::MemoryResources
    {
-      /// Uncached host memory resource
-      vecmem::cuda::host_memory_resource m_hostMR;
-      /// Cached host memory resource
-      vecmem::pool_memory_resource m_cachedHostMR{m_hostMR};
-      /// Synchronized and cached host memory resource
-      vecmem::synchronized_memory_resource m_syncHostMR{m_cachedHostMR};
-
-      /// Uncached device memory resource
-      vecmem::cuda::device_memory_resource m_deviceMR;
+      /// Constructor with the (shared) upstream device memory resource
+      explicit MemoryResources(vecmem::memory_resource &upstream)
+          : m_cachedDeviceMR{upstream} {}
+
       /// Cached device memory resource
-      vecmem::pool_memory_resource m_cachedDeviceMR{m_deviceMR};
+      vecmem::pool_memory_resource m_cachedDeviceMR;
       /// Synchronized and cached device memory resource
       vecmem::synchronized_memory_resource m_syncDeviceMR{m_cachedDeviceMR};
    };
 
+   struct ElectronCalibCUDAAlg::DeviceCalibration
+   {
+      /// A calibration table copied to the device
+      struct Table
+      {
+         /// Constructor, allocating the table on the device
+         Table(std::size_t size, vecmem::memory_resource &mr)
+             : m_buffer(static_cast<unsigned int>(size), mr)
+         {
+            if (cudaEventCreateWithFlags(&m_uploaded,
+                                         cudaEventDisableTiming) !=
+                cudaSuccess)
+            {
+               cudaGetLastError();
+               throw std::runtime_error("Failed to create a CUDA event");
+            }
+         }
+         /// Destructor, releasing the event
+         ~Table() { cudaEventDestroy(m_uploaded); }
+         /// Tables are not copyable
+         Table(const Table &) = delete;
+         /// Tables are not copy-assignable
+         Table &operator=(const Table &) = delete;
+
+         /// Make (the future work of) a stream wait for the upload
+         bool await(cudaStream_t stream) const
+         {
+            return (cudaStreamWaitEvent(stream, m_uploaded, 0) == cudaSuccess);
+         }
+
+         /// The flat table data on the device
+         vecmem::data::vector_buffer<float> m_buffer;
+         /// View of the table on the device
+         ElectronCalibrationTableView m_view;
+         /// Event marking the end of the copy of the table to the device
+         cudaEvent_t m_uploaded = nullptr;
+      };
+
+      /// Get the table for a given IOV, copying it to the device if needed
+      ///
+      /// The table is only copied when the IOV changes. The copy is issued
+      /// on @c stream, and is not waited for. Every user of the table needs
+      /// to make its own stream wait for it with @c Table::await. Events
+      /// still using the previous table keep it alive through their shared
+      /// pointer.
+      ///
+      std::shared_ptr<const Table> get(std::size_t iov,
+                                       const ElectronCalibrationTable &table,
+                                       vecmem::memory_resource &mr,
+                                       cudaStream_t stream)
+      {
+         std::lock_guard lock(m_mutex);
+         if ((m_table != nullptr) && (m_iov == iov))
+         {
+            return m_table;
+         }
+         const std::span<const float> data = table.data();
+         auto result = std::make_shared<Table>(data.size(), mr);
+         if ((cudaMemcpyAsync(result->m_buffer.ptr(), data.data(),
+                              data.size_bytes(), cudaMemcpyHostToDevice,
+                              stream) != cudaSuccess) ||
+             (cudaEventRecord(result->m_uploaded, stream) != cudaSuccess))
+         {
+            cudaGetLastError();
+            throw std::runtime_error(
+                "Failed to copy the calibration table to the device");
+         }
+         result->m_view = table.view(result->m_buffer.ptr());
+         m_table = result;
+         m_iov = iov;
+         ++m_nUploads;
+         return result;
+      }
+
+      /// Mutex protecting the cached table
+      std::mutex m_mutex;
+      /// Index of the IOV of the table currently on the device
+      std::size_t m_iov = std::numeric_limits<std::size_t>::max();
+      /// The table currently on the device
+      std::shared_ptr<const Table> m_table;
+      /// Number of times a table was copied to the device
+      std::size_t m_nUploads = 0;
+   };
+
+   struct ElectronCalibCUDAAlg::EncodedTransfer
+   {
+      /// Constructor with the (pinned) host memory resource to use
+      explicit EncodedTransfer(std::pmr::memory_resource &hostMR)
+          : etaCodes(&hostMR), phiCodes(&hostMR), ptCodes(&hostMR) {}
+
+      /// @name The encoded columns on the host
+      /// @{
+      std::pmr::vector<std::uint16_t> etaCodes, phiCodes, ptCodes;
+      /// @}
+      /// The encoded columns on the device
+      std::vector<vecmem::data::vector_buffer<std::uint16_t>> codeBuffers;
+      /// The decodings to perform on the device
+      std::vector<DeviceColumnDecoding> decodings;
+   };
+
    ElectronCalibCUDAAlg::ElectronCalibCUDAAlg(const std::string &name,
                                               ISvcLocator *svcloc)
-       : AthReentrantAlgorithm(name, svcloc) {}
+       : AthAsynchronousAlgorithm(name, svcloc) {}
 
    ElectronCalibCUDAAlg::~ElectronCalibCUDAAlg() = default;
 
    StatusCode ElectronCalibCUDAAlg::initialize()
    {
       // Set up the memory resources.
-      m_memoryResources = std::make_unique<MemoryResources>();
+      ATH_CHECK(m_memorySvc.retrieve());
+      m_memoryClient = m_memorySvc->registerClient(name());
+      m_memoryResources =
+          std::make_unique<MemoryResources>(m_memorySvc->sharedDeviceMR());
+
+      // Set up the stage timing, if requested.
+      if (m_stageTiming || !m_chromeTraceFile.value().empty())
+      {
+         m_timeline = StageTimeline::shared();
+         m_timingSource = m_timeline->registerSource(name());
+      }
+
+      // Set up the capture of the offload inputs, if requested.
+      if (!m_captureFile.value().empty())
+      {
+         try
+         {
+            m_capture = EventCaptureWriter::shared(m_captureFile.value());
+         }
+         catch (const std::exception &ex)
+         {
+            ATH_MSG_ERROR(ex.what());
+            return StatusCode::FAILURE;
+         }
+         ATH_MSG_INFO("Capturing the electron variables into: "
+                      << m_captureFile.value());
+      }
+
+      // Read the calibration tables, if a file was specified.
+      if (!m_calibrationFile.value().empty())
+      {
+         const std::string fileName =
+             PathResolver::find_file(m_calibrationFile.value(), "DATAPATH");
+         if (fileName.empty())
+         {
+            ATH_MSG_ERROR("Could not find calibration file \""
+                          << m_calibrationFile.value() << "\"");
+            return StatusCode::FAILURE;
+         }
+         try
+         {
+            m_calibrations = readElectronCalibration(fileName);
+         }
+         catch (const std::exception &ex)
+         {
+            ATH_MSG_ERROR(ex.what());
+            return StatusCode::FAILURE;
+         }
+         ATH_MSG_INFO("Read " << m_calibrations.size()
+                              << " calibration table(s) from: " << fileName);
+      }
+      m_deviceCalibration = std::make_unique<DeviceCalibration>();
+
+      // Set up the encoding of the host-to-device transfers.
+      try
+      {
+         m_encoding = TransferEncoding::parse(m_transferEncoding.value());
+      }
+      catch (const std::exception &ex)
+      {
+         ATH_MSG_ERROR("Invalid transfer encoding: " << ex.what());
+         return StatusCode::FAILURE;
+      }
+
+      // Decide how to move data between the aux stores and the device.
+      int device = 0, pageableAccess = 0;
+      if ((cudaGetDevice(&device) != cudaSuccess) ||
+          (cudaDeviceGetAttribute(&pageableAccess,
+                                  cudaDevAttrPageableMemoryAccess,
+                                  device) != cudaSuccess))
+      {
+         cudaGetLastError();
+         pageableAccess = 0;
+      }
+      if (m_inputMode.value() == "Auto")
+      {
+         // An encoding only makes sense with explicit transfers.
+         m_resolvedInputMode =
+             ((pageableAccess && !m_encoding.encoded()) ? InputMode::ZeroCopy
+                                                        : InputMode::Direct);
+      }
+      else if (m_inputMode.value() == "ZeroCopy")
+      {
+         if (!pageableAccess)
+         {
+            ATH_MSG_ERROR("The device can not access pageable host memory, "
+                          "ZeroCopy input is not possible");
+            return StatusCode::FAILURE;
+         }
+         if (m_encoding.encoded())
+         {
+            ATH_MSG_ERROR("ZeroCopy input does not transfer the data, it can "
+                          "not be combined with a transfer encoding");
+            return StatusCode::FAILURE;
+         }
+         m_resolvedInputMode = InputMode::ZeroCopy;
+      }
+      else if (m_inputMode.value() == "Direct")
+      {
+         m_resolvedInputMode = InputMode::Direct;
+      }
+      else if (m_inputMode.value() == "Pinned")
+      {
+         m_resolvedInputMode = InputMode::Pinned;
+      }
+      else
+      {
+         ATH_MSG_ERROR("Unknown input mode: \"" << m_inputMode.value()
+                                                 << "\"");
+         return StatusCode::FAILURE;
+      }
+      ATH_MSG_INFO("Moving electron data using "
+                   << ((m_resolvedInputMode == InputMode::ZeroCopy)
+                           ? "direct device access to the aux stores"
+                       : (m_resolvedInputMode == InputMode::Direct)
+                           ? "direct copies from/to the aux stores"
+                           : "copies staged through pinned host memory"));
+      if (m_encoding.encoded())
+      {
+         ATH_MSG_INFO("Encoding the transfers to the device as: "
+                      << m_encoding.toString());
+      }
+
+      // Choose the launch parameters of the calibration kernel, by timing it
+      // on synthetic electrons if they are not fixed. Nothing is launched on
+      // a CUDA device with a mock device, or with Backend="Host".
+      if (!m_mockDevice.value() && (m_backend.value() != "Host"))
+      {
+         cudaDeviceProp properties;
+         if ((cudaGetDevice(&device) != cudaSuccess) ||
+             (cudaGetDeviceProperties(&properties, device) != cudaSuccess))
+         {
+            cudaGetLastError();
+            ATH_MSG_ERROR("No CUDA device is available, use MockDevice=True "
+                          "or Backend=\"Host\" without one");
+            return StatusCode::FAILURE;
+         }
+         try
+         {
+            LaunchTuner::Config config;
+            config.itemsPerThread = {1};
+            config.maxWorkGroupSize =
+                static_cast<std::size_t>(properties.maxThreadsPerBlock);
+            // The synthetic electrons of the timing runs, and their own copy
+            // of the calibration table, are only set up if the parameters
+            // are neither fixed, nor found in the cache. With as many
+            // electrons as the largest timing run of the host/device
+            // dispatch.
+            struct TuningInput
+            {
+               ElectronDeviceContainer::buffer input, output;
+               vecmem::data::vector_buffer<float> table;
+               ElectronCalibrationTableView view;
+            };
+            std::optional<TuningInput> tuning;
+            auto setupTuning = [&]()
+            {
+               const OffloadDispatcher::CalibrationConfig sizes;
+               const std::size_t n =
+                   *std::max_element(sizes.sizes.begin(), sizes.sizes.end());
+               SyntheticElectrons electrons(n);
+               using Columns = ElectronColumns::Set;
+               const auto size =
+                   static_cast<ElectronDeviceContainer::buffer::size_type>(n);
+               const std::span<const float> tableData =
+                   (m_calibrations.empty()
+                        ? std::span<const float>{}
+                        : m_calibrations.front().table.data());
+               TuningInput &result = tuning.emplace(
+                   ElectronDeviceContainer::buffer{
+                       size, m_memorySvc->sharedDeviceMR()},
+                   ElectronDeviceContainer::buffer{
+                       size, m_memorySvc->sharedDeviceMR()},
+                   vecmem::data::vector_buffer<float>{
+                       static_cast<unsigned int>(tableData.size()),
+                       m_memorySvc->sharedDeviceMR()},
+                   ElectronCalibrationTableView{});
+               vecmem::cuda::copy copy;
+               copy.setup(result.input)->wait();
+               copy.setup(result.output)->wait();
+               Columns::copy<ColumnAccess::Read>(
+                   copy, electrons.input(n), result.input,
+                   vecmem::copy::type::host_to_device);
+               if (!m_calibrations.empty())
+               {
+                  copy(vecmem::data::vector_view<const float>(
+                           static_cast<unsigned int>(tableData.size()),
+                           tableData.data()),
+                       result.table)
+                      ->wait();
+                  result.view =
+                      m_calibrations.front().table.view(result.table.ptr());
+               }
+            };
+            const LaunchTuner::Result result = selectLaunchConfig(
+                m_launchParameters.value(), m_launchCacheFile.value(),
+                properties.name, "calibrateElectrons", config,
+                [&](const LaunchConfig &launch)
+                {
+                   if (!tuning)
+                   {
+                      setupTuning();
+                   }
+                   if (calibrateElectrons(tuning->input, tuning->output,
+                                          nullptr, tuning->view, launch)
+                           .isFailure() ||
+                       (cudaDeviceSynchronize() != cudaSuccess))
+                   {
+                      throw std::runtime_error(
+                          "Failed to calibrate electrons on the device");
+                   }
+                });
+            if (result.config.itemsPerThread != 1)
+            {
+               ATH_MSG_ERROR("Every thread calibrates a single electron, "
+                             "invalid launch parameters: "
+                             << result.config.toString());
+               return StatusCode::FAILURE;
+            }
+            m_launch = result.config;
+            ATH_MSG_INFO("Launching the calibration with: "
+                         << result.toString());
+         }
+         catch (const std::exception &ex)
+         {
+            ATH_MSG_ERROR("Could not choose the launch parameters: "
+                          << ex.what());
+            return StatusCode::FAILURE;
+         }
+      }
+
+      // Decide where the electrons should be calibrated.
+      ATH_CHECK(setupDispatcher());
 
       // Set up the input and output keys.
       ATH_CHECK(m_inputKey.initialize());
@@ -57,11 +518,96 @@ namespace GPUTutorial
       return StatusCode::SUCCESS;
    }
 
+   StatusCode ElectronCalibCUDAAlg::finalize()
+   {
+      // Tell the user where the electrons were calibrated.
+      if (m_dispatcher)
+      {
+         std::ostringstream summary;
+         m_dispatcher->printSummary(summary);
+         ATH_MSG_INFO("Host/device dispatch of the calibration:\n"
+                      << summary.str());
+      }
+
+      // Tell the user how often the calibration had to be copied.
+      if (!m_calibrations.empty())
+      {
+         ATH_MSG_INFO("Copied calibration tables to the device "
+                      << m_deviceCalibration->m_nUploads << " time(s)");
+      }
+
+      // Write the index of the capture file, if no other algorithm writing
+      // into it did that yet.
+      if (m_capture)
+      {
+         try
+         {
+            m_capture->close();
+         }
+         catch (const std::exception &ex)
+         {
+            ATH_MSG_ERROR(ex.what());
+            return StatusCode::FAILURE;
+         }
+         ATH_MSG_INFO("Captured the electron variables into: "
+                      << m_captureFile.value() << " (holding "
+                      << m_capture->size() << " event(s))");
+         m_capture.reset();
+      }
+
+      // Report the stage timings.
+      if (m_timeline)
+      {
+         std::ostringstream summary;
+         m_timeline->printSummary(summary, m_timingSource);
+         ATH_MSG_INFO("Time spent in the stages of the calibration:\n"
+                      << summary.str());
+         if (!m_chromeTraceFile.value().empty())
+         {
+            // Every algorithm writes the whole timeline, the last one to
+            // finalize leaves the complete trace.
+            try
+            {
+               m_timeline->writeChromeTrace(m_chromeTraceFile.value());
+            }
+            catch (const std::exception &ex)
+            {
+               ATH_MSG_ERROR(ex.what());
+               return StatusCode::FAILURE;
+            }
+         }
+         m_timeline.reset();
+      }
+
+      // Return gracefully.
+      return StatusCode::SUCCESS;
+   }
+
    StatusCode ElectronCalibCUDAAlg::execute(const EventContext &ctx) const
    {
       // Get the input container.
       SG::ReadHandle input(m_inputKey, ctx);
 
+      // Set up the timing of the stages.
+      const StageContext timing = stageContext(ctx);
+
+      // Find the calibration table valid for this event, if one was set up.
+      std::vector<ElectronCalibrationIOV>::const_iterator iov =
+          m_calibrations.end();
+      if (!m_calibrations.empty())
+      {
+         ScopedStageTimer timer(timing, "table");
+         const std::uint32_t run = ctx.eventID().run_number();
+         iov = std::find_if(m_calibrations.begin(), m_calibrations.end(),
+                            [run](const ElectronCalibrationIOV &c)
+                            { return c.contains(run); });
+         if (iov == m_calibrations.end())
+         {
+            ATH_MSG_ERROR("No calibration table is available for run " << run);
+            return StatusCode::FAILURE;
+         }
+      }
+
       // FIX If the input container is empty, record an empty output right away.
       if (input->empty())
       {
@@ -75,72 +621,488 @@ namespace GPUTutorial
       }
       // FIX
 
-      // Set up a host buffer for the electron container.
+      // View of the electron variables that the calibration reads, in the
+      // input aux store.
+      using Columns = ElectronColumns::Set;
       auto nElectrons = static_cast<ElectronDeviceContainer::buffer::size_type>(
           input->size());
-      ElectronDeviceContainer::buffer
-          hostBuffer{nElectrons, m_memoryResources->m_syncHostMR};
-
-      // Copy data from the xAOD container into the host buffer.
-      static const SG::AuxElement::ConstAccessor<float> etaAcc("eta");
-      static const SG::AuxElement::ConstAccessor<float> phiAcc("phi");
-      static const SG::AuxElement::ConstAccessor<float> ptAcc("pt"); // FIX
-      static const SG::AuxElement::ConstAccessor<std::uint16_t>      // FIX
-          authorAcc("author");                                       // FIX
-      std::memcpy(hostBuffer.get<0>().ptr(), etaAcc.getDataArray(*input),
-                  nElectrons * sizeof(float));
-      std::memcpy(hostBuffer.get<1>().ptr(), phiAcc.getDataArray(*input),
-                  nElectrons * sizeof(float));
-      std::memcpy(hostBuffer.get<2>().ptr(), ptAcc.getDataArray(*input),     // FIX
-                  nElectrons * sizeof(float));                               // FIX
-      std::memcpy(hostBuffer.get<3>().ptr(), authorAcc.getDataArray(*input), // FIX
-                  nElectrons * sizeof(std::uint16_t));                       // FIX
-
-      // Helper object used to copy data between the host and the device.
-      vecmem::cuda::copy copy;
-
-      // Create two device buffers.
-      ElectronDeviceContainer::buffer deviceInputBuffer{
-          nElectrons, m_memoryResources->m_syncDeviceMR}; // FIX
-      copy.setup(deviceInputBuffer)->wait();
-      ElectronDeviceContainer::buffer deviceOutputBuffer{
-          nElectrons, m_memoryResources->m_syncDeviceMR}; // FIX
-      copy.setup(deviceOutputBuffer)->wait();
-
-      // Copy data into the input buffer.
-      copy(hostBuffer, deviceInputBuffer)->wait();
-
-      // Run the GPU calibration in a separate function.
-      ATH_CHECK(calibrateElectrons(deviceInputBuffer, deviceOutputBuffer));
-
-      // Copy the output buffer back to the host.
-      copy(deviceOutputBuffer, hostBuffer)->wait();
-
-      // Construct the output container.
-      auto outputAux = std::make_unique<xAOD::AuxContainerBase>();
-      SG::copyAuxStoreThinned(*(input->getConstStore()), *outputAux, nullptr);
-      std::memcpy(outputAux->getData(etaAcc.auxid(), nElectrons, nElectrons),
-                  hostBuffer.get<0>().ptr(), nElectrons * sizeof(float));
-      std::memcpy(outputAux->getData(phiAcc.auxid(), nElectrons, nElectrons),
-                  hostBuffer.get<1>().ptr(), nElectrons * sizeof(float));
-      std::memcpy(outputAux->getData(ptAcc.auxid(), nElectrons, nElectrons),      // FIX
-                  hostBuffer.get<2>().ptr(), nElectrons * sizeof(float));         // FIX
-      std::memcpy(outputAux->getData(authorAcc.auxid(), nElectrons, nElectrons),  // FIX
-                  hostBuffer.get<3>().ptr(), nElectrons * sizeof(std::uint16_t)); // FIX
-      auto outputInterface = std::make_unique<xAOD::ElectronContainer>();
-      for (std::size_t i = 0; i < nElectrons; ++i)
-      {
-         outputInterface->push_back(new xAOD::Electron());
-      }
-      outputInterface->setStore(outputAux.get());
+      const ElectronDeviceContainer::const_view inputView =
+          makeReadView<Columns, ElectronDeviceContainer>(*input);
+
+      // Capture the variables, exactly as the calibration will receive them.
+      if (m_capture)
+      {
+         ScopedStageTimer timer(timing, "capture");
+         try
+         {
+            m_capture->write(
+                ctx.eventID().run_number(), ctx.eventID().event_number(),
+                {{CaptureColumn::ElectronEta,
+                  hostColumn<ElectronColumns::Eta>(inputView)},
+                 {CaptureColumn::ElectronPhi,
+                  hostColumn<ElectronColumns::Phi>(inputView)},
+                 {CaptureColumn::ElectronPt,
+                  hostColumn<ElectronColumns::Pt>(inputView)},
+                 {CaptureColumn::ElectronAuthor,
+                  hostColumn<ElectronColumns::Author>(inputView)}});
+         }
+         catch (const std::exception &ex)
+         {
+            ATH_MSG_ERROR(ex.what());
+            return StatusCode::FAILURE;
+         }
+      }
+
+      // Set up the output. Either as a full copy of the input's aux store,
+      // or as a shallow copy that only stores the calibrated pt values. In
+      // both cases only the variables written by the calibration are bound
+      // to the output view.
+      std::unique_ptr<xAOD::ElectronContainer> outputInterface;
+      std::unique_ptr<xAOD::AuxContainerBase> outputAux;
+      std::unique_ptr<xAOD::ShallowAuxContainer> outputShallowAux;
+      ElectronDeviceContainer::view outputView;
+      ScopedStageTimer setupTimer(timing, "output setup");
+      if (m_shallowCopyOutput)
+      {
+         std::tie(outputInterface, outputShallowAux) =
+             xAOD::shallowCopyContainer(*input, ctx);
+         outputView = makeWriteView<Columns, ElectronDeviceContainer>(
+             *outputShallowAux, nElectrons);
+      }
+      else
+      {
+         outputAux = std::make_unique<xAOD::AuxContainerBase>();
+         SG::copyAuxStoreThinned(*(input->getConstStore()), *outputAux,
+                                 nullptr);
+         outputView = makeWriteView<Columns, ElectronDeviceContainer>(
+             *outputAux, nElectrons);
+      }
+      setupTimer.stop();
+
+      // Decide where to calibrate the electrons of this event.
+      const OffloadTarget target = m_dispatcher->decide(nElectrons);
+
+      // Calibrate the electrons on the host (or the mock device), directly
+      // from the input aux store into the output one.
+      auto calibrateOnHost = [&]()
+      {
+         const vecmem::data::vector_view<float> calibratedPt =
+             deviceColumn<ElectronColumns::Pt>(outputView);
+         Host::calibrateElectrons(
+             hostColumn<ElectronColumns::Eta>(inputView),
+             hostColumn<ElectronColumns::Phi>(inputView),
+             hostColumn<ElectronColumns::Pt>(inputView),
+             hostColumn<ElectronColumns::Author>(inputView),
+             ((iov != m_calibrations.end()) ? iov->table.view()
+                                            : ElectronCalibrationTableView{}),
+             {calibratedPt.ptr(), calibratedPt.size()});
+      };
+
+      if (target == OffloadTarget::Host)
+      {
+         ScopedStageTimer timer(timing, "host");
+         calibrateOnHost();
+      }
+      else if (m_mock)
+      {
+         // Run the calibration on one of the mock device's threads, letting
+         // this thread run other algorithms until it finished.
+         ScopedStageTimer timer(timing, "mock device");
+         std::unique_ptr<AsyncExecutor::Stream> stream =
+             m_mockThreads->makeStream();
+         stream->enqueue(
+             [&]()
+             { m_mock->run(nElectrons * BYTES_PER_ELECTRON, calibrateOnHost); });
+         try
+         {
+            awaitStream(*stream);
+         }
+         catch (const std::exception &ex)
+         {
+            ATH_MSG_ERROR("Failed to calibrate the electrons on the mock "
+                          "device: "
+                          << ex.what());
+            return StatusCode::FAILURE;
+         }
+      }
+      else
+      {
+         // All of the device work of the event is scheduled on a stream of
+         // its own, and is only waited for once, when the results are needed
+         // on the host.
+         Gaudi::CUDA::Stream stream(this);
+         CUDAStageTimer timer(timing, stream);
+         vecmem::cuda::stream_wrapper vecmemStream(
+             static_cast<cudaStream_t>(stream));
+         vecmem::cuda::async_copy copy(vecmemStream);
+
+         // Copy the calibration table to the device, if it changed. Neither
+         // the copy, nor the copy of a previous event (on the stream of that
+         // event) is waited for on the host. Only the stream of this event
+         // waits for the upload of the table.
+         std::shared_ptr<const DeviceCalibration::Table> table;
+         if (iov != m_calibrations.end())
+         {
+            timer.start("table upload");
+            try
+            {
+               table = m_deviceCalibration->get(
+                   iov - m_calibrations.begin(), iov->table,
+                   m_memorySvc->sharedDeviceMR(), stream);
+            }
+            catch (const std::exception &ex)
+            {
+               ATH_MSG_ERROR(ex.what());
+               return StatusCode::FAILURE;
+            }
+            timer.stop();
+            if (!table->await(stream))
+            {
+               ATH_MSG_ERROR("Failed to wait for the calibration table");
+               return StatusCode::FAILURE;
+            }
+         }
+         const ElectronCalibrationTableView tableView =
+             (table ? table->m_view : ElectronCalibrationTableView{});
+
+         // Memory resource for the device buffers of the event.
+         vecmem::memory_resource &deviceMR =
+             m_memoryResources->m_syncDeviceMR; // FIX
+
+         if (m_resolvedInputMode == InputMode::ZeroCopy)
+         {
+            // The device can read and write the aux store arrays directly.
+            timer.start("kernel");
+            ATH_CHECK(calibrateElectrons(inputView, outputView, stream,
+                                         tableView, m_launch));
+            timer.stop();
+            ATH_CHECK(stream.await());
+         }
+         else if (m_encoding.encoded())
+         {
+            // Copy the inputs encoded, and decode them on the device.
+            ElectronDeviceContainer::buffer deviceInputBuffer{
+                nElectrons, deviceMR};
+            ElectronDeviceContainer::buffer deviceOutputBuffer{
+                nElectrons, deviceMR};
+            copy.setup(deviceInputBuffer);
+            copy.setup(deviceOutputBuffer);
+            EncodedTransfer transfer(m_memorySvc->hostMR(m_memoryClient, ctx));
+            ATH_CHECK(copyEncoded(inputView, deviceInputBuffer, transfer, copy,
+                                  stream, timer, ctx, timing));
+            timer.start("kernel");
+            ATH_CHECK(calibrateElectrons(deviceInputBuffer, deviceOutputBuffer,
+                                         stream, tableView, m_launch));
+            timer.stop();
+            timer.start("d2h");
+            Columns::copyAsync<ColumnAccess::Write>(
+                copy, deviceOutputBuffer, outputView,
+                vecmem::copy::type::device_to_host);
+            timer.stop();
+            ATH_CHECK(stream.await());
+         }
+         else if (m_resolvedInputMode == InputMode::Pinned)
+         {
+            // Stage the data through a pinned host buffer.
+            vecmem::copy hostCopy;
+            ElectronDeviceContainer::buffer hostBuffer{
+                nElectrons, m_memorySvc->hostMR(m_memoryClient, ctx)};
+            ElectronDeviceContainer::buffer deviceInputBuffer{
+                nElectrons, deviceMR};
+            ElectronDeviceContainer::buffer deviceOutputBuffer{
+                nElectrons, deviceMR};
+            copy.setup(deviceInputBuffer);
+            copy.setup(deviceOutputBuffer);
+            ScopedStageTimer stagingTimer(timing, "staging");
+            CopiedColumns::copy<ColumnAccess::Read>(hostCopy, inputView,
+                                                    hostBuffer);
+            stagingTimer.stop();
+            timer.start("h2d");
+            Columns::copyAsync<ColumnAccess::Read>(
+                copy, hostBuffer, deviceInputBuffer,
+                vecmem::copy::type::host_to_device);
+            timer.stop();
+            timer.start("kernel");
+            ATH_CHECK(calibrateElectrons(deviceInputBuffer, deviceOutputBuffer,
+                                         stream, tableView, m_launch));
+            timer.stop();
+            timer.start("d2h");
+            Columns::copyAsync<ColumnAccess::Write>(
+                copy, deviceOutputBuffer, hostBuffer,
+                vecmem::copy::type::device_to_host);
+            timer.stop();
+            ATH_CHECK(stream.await());
+            ScopedStageTimer writeTimer(timing, "write");
+            Columns::copy<ColumnAccess::Write>(
+                hostCopy, hostBuffer, outputView,
+                vecmem::copy::type::host_to_host);
+         }
+         else
+         {
+            // Copy directly between the aux stores and the device.
+            ElectronDeviceContainer::buffer deviceInputBuffer{
+                nElectrons, deviceMR};
+            ElectronDeviceContainer::buffer deviceOutputBuffer{
+                nElectrons, deviceMR};
+            copy.setup(deviceInputBuffer);
+            copy.setup(deviceOutputBuffer);
+            timer.start("h2d");
+            CopiedColumns::copyAsync<ColumnAccess::Read>(
+                copy, inputView, deviceInputBuffer,
+                vecmem::copy::type::host_to_device);
+            timer.stop();
+            timer.start("kernel");
+            ATH_CHECK(calibrateElectrons(deviceInputBuffer, deviceOutputBuffer,
+                                         stream, tableView, m_launch));
+            timer.stop();
+            timer.start("d2h");
+            Columns::copyAsync<ColumnAccess::Write>(
+                copy, deviceOutputBuffer, outputView,
+                vecmem::copy::type::device_to_host);
+            timer.stop();
+            ATH_CHECK(stream.await());
+         }
+         timer.flush();
+      }
 
       // Record the output container(s).
+      ScopedStageTimer recordTimer(timing, "record");
       SG::WriteHandle output(m_outputKey, ctx);
-      ATH_CHECK(output.record(std::move(outputInterface),
-                              std::move(outputAux)));
+      if (m_shallowCopyOutput)
+      {
+         ATH_CHECK(output.record(std::move(outputInterface),
+                                 std::move(outputShallowAux)));
+      }
+      else
+      {
+         outputInterface = std::make_unique<xAOD::ElectronContainer>();
+         for (std::size_t i = 0; i < nElectrons; ++i)
+         {
+            outputInterface->push_back(new xAOD::Electron());
+         }
+         outputInterface->setStore(outputAux.get());
+         ATH_CHECK(output.record(std::move(outputInterface),
+                                 std::move(outputAux)));
+      }
 
       // Return gracefuilly.
       return StatusCode::SUCCESS;
    }
 
+   StatusCode ElectronCalibCUDAAlg::copyEncoded(
+       const ElectronDeviceContainer::const_view &input,
+       const ElectronDeviceContainer::view &deviceInput,
+       EncodedTransfer &transfer, const vecmem::copy &copy,
+       cudaStream_t stream, CUDAStageTimer &timer, const EventContext &ctx,
+       const StageContext &timing) const
+   {
+      // Encode the floating point columns into (pinned) host memory.
+      ScopedStageTimer encodeTimer(timing, "encode");
+      const EncodedFloatColumn eta =
+          encodeColumn(m_encoding.eta, hostColumn<ElectronColumns::Eta>(input),
+                       transfer.etaCodes);
+      const EncodedFloatColumn phi =
+          encodeColumn(m_encoding.phi, hostColumn<ElectronColumns::Phi>(input),
+                       transfer.phiCodes);
+      const EncodedFloatColumn pt =
+          encodeColumn(m_encoding.pt, hostColumn<ElectronColumns::Pt>(input),
+                       transfer.ptCodes);
+      encodeTimer.stop();
+
+      // Copy the columns to the device as they are. Float32 columns go
+      // straight into the input buffer, encoded ones into buffers of their
+      // own. The buffers must not be reallocated while the copies run.
+      transfer.codeBuffers.reserve(3);
+      timer.start("h2d");
+      auto upload = [&](const EncodedFloatColumn &column,
+                        vecmem::data::vector_view<float> target)
+      {
+         const auto size = static_cast<unsigned int>(column.size());
+         if (!column.encoded())
+         {
+            copy(vecmem::data::vector_view<const float>(size,
+                                                        column.values.data()),
+                 target, vecmem::copy::type::host_to_device);
+            return;
+         }
+         transfer.codeBuffers.emplace_back(
+             size, m_memorySvc->deviceMR(m_memoryClient, ctx));
+         copy(vecmem::data::vector_view<const std::uint16_t>(
+                  size, column.codes.data()),
+              transfer.codeBuffers.back(), vecmem::copy::type::host_to_device);
+         transfer.decodings.push_back(
+             {transfer.codeBuffers.back(), column.decoder, target});
+      };
+      upload(eta, deviceColumn<ElectronColumns::Eta>(deviceInput));
+      upload(phi, deviceColumn<ElectronColumns::Phi>(deviceInput));
+      upload(pt, deviceColumn<ElectronColumns::Pt>(deviceInput));
+      constexpr std::size_t author =
+          ElectronColumns::Set::index<ElectronColumns::Author>();
+      copy(input.get<author>(), deviceInput.get<author>(),
+           vecmem::copy::type::host_to_device);
+      timer.stop();
+
+      // Decode the encoded columns.
+      timer.start("decode");
+      ATH_CHECK(decodeColumns(transfer.decodings, stream));
+      timer.stop();
+
+      // Return gracefully.
+      return StatusCode::SUCCESS;
+   }
+
+   StatusCode ElectronCalibCUDAAlg::setupDispatcher()
+   {
+      // Set up the mock device, if requested.
+      if (m_mockDevice)
+      {
+         try
+         {
+            m_mock = std::make_unique<MockDevice>(
+                std::chrono::duration<double, std::micro>(
+                    m_mockDeviceLatency.value()),
+                m_mockDeviceBandwidth.value() * 1e9);
+         }
+         catch (const std::exception &ex)
+         {
+            ATH_MSG_ERROR(ex.what());
+            return StatusCode::FAILURE;
+         }
+         if (m_mockDeviceThreads.value() == 0)
+         {
+            ATH_MSG_ERROR("The mock device needs at least one thread");
+            return StatusCode::FAILURE;
+         }
+         m_mockThreads =
+             std::make_unique<HostThreadPool>(m_mockDeviceThreads.value());
+         ATH_MSG_INFO("Using a mock device with "
+                      << m_mockDeviceLatency.value() << " us latency, "
+                      << m_mockDeviceBandwidth.value() << " GB/s bandwidth and "
+                      << m_mockDeviceThreads.value() << " thread(s)");
+      }
+
+      // Set up the threshold of the dispatcher. The fixed backends are just
+      // (counted) dispatches with trivial thresholds.
+      m_dispatcher = std::make_unique<OffloadDispatcher>();
+      if (m_backend.value() == "Host")
+      {
+         m_dispatcher->setThreshold(std::numeric_limits<std::size_t>::max());
+      }
+      else if (m_backend.value() == "Device")
+      {
+         m_dispatcher->setThreshold(0);
+      }
+      else if (m_backend.value() != "Dispatch")
+      {
+         ATH_MSG_ERROR("Unknown backend: \"" << m_backend.value() << "\"");
+         return StatusCode::FAILURE;
+      }
+      else if (m_dispatchThreshold.value() >= 0)
+      {
+         m_dispatcher->setThreshold(
+             static_cast<std::size_t>(m_dispatchThreshold.value()));
+      }
+      else
+      {
+         // Time the calibration on both sides with synthetic electrons, using
+         // the first calibration table (if any).
+         const OffloadDispatcher::CalibrationConfig config;
+         SyntheticElectrons electrons(
+             *std::max_element(config.sizes.begin(), config.sizes.end()));
+         const ElectronCalibrationTableView hostTable =
+             (m_calibrations.empty() ? ElectronCalibrationTableView{}
+                                     : m_calibrations.front().table.view());
+         auto host = [&](std::size_t n)
+         { electrons.calibrateHost(n, hostTable); };
+         OffloadDispatcher::Function device;
+         std::shared_ptr<const DeviceCalibration::Table> deviceTable;
+         if (m_mock)
+         {
+            device = [&](std::size_t n)
+            { m_mock->run(n * BYTES_PER_ELECTRON, [&]() { host(n); }); };
+         }
+         else
+         {
+            if (!m_calibrations.empty())
+            {
+               // Uploaded on the default stream, which the kernels of the
+               // timing runs use as well.
+               try
+               {
+                  deviceTable = m_deviceCalibration->get(
+                      0, m_calibrations.front().table,
+                      m_memorySvc->sharedDeviceMR(), nullptr);
+               }
+               catch (const std::exception &ex)
+               {
+                  ATH_MSG_ERROR(ex.what());
+                  return StatusCode::FAILURE;
+               }
+            }
+            device = [&](std::size_t n)
+            {
+               // Copy the electrons directly from/to (pageable) host memory,
+               // like the "Direct" input mode does.
+               using Columns = ElectronColumns::Set;
+               const auto size =
+                   static_cast<ElectronDeviceContainer::buffer::size_type>(n);
+               vecmem::cuda::copy copy;
+               ElectronDeviceContainer::buffer input{
+                   size, m_memorySvc->sharedDeviceMR()};
+               ElectronDeviceContainer::buffer output{
+                   size, m_memorySvc->sharedDeviceMR()};
+               copy.setup(input)->wait();
+               copy.setup(output)->wait();
+               Columns::copy<ColumnAccess::Read>(
+                   copy, electrons.input(n), input,
+                   vecmem::copy::type::host_to_device);
+               // The kernel runs on the default stream, which the
+               // (synchronous) copy of the output waits for.
+               if (calibrateElectrons(input, output, nullptr,
+                                      (deviceTable ? deviceTable->m_view
+                                                   : ElectronCalibrationTableView{}),
+                                      m_launch)
+                       .isFailure())
+               {
+                  throw std::runtime_error(
+                      "Failed to calibrate electrons on the device");
+               }
+               Columns::copy<ColumnAccess::Write>(
+                   copy, output, electrons.output(n),
+                   vecmem::copy::type::device_to_host);
+            };
+         }
+         try
+         {
+            m_dispatcher->calibrate(host, device, config);
+         }
+         catch (const std::exception &ex)
+         {
+            ATH_MSG_ERROR("Could not calibrate the host/device dispatch: "
+                          << ex.what());
+            return StatusCode::FAILURE;
+         }
+      }
+      if (m_backend.value() == "Dispatch")
+      {
+         std::ostringstream summary;
+         m_dispatcher->printSummary(summary);
+         ATH_MSG_INFO("Deciding for every event where to calibrate its "
+                      "electrons:\n"
+                      << summary.str());
+      }
+
+      // Return gracefully.
+      return StatusCode::SUCCESS;
+   }
+
+   StageContext ElectronCalibCUDAAlg::stageContext(const EventContext &ctx) const
+   {
+      if (!m_timeline)
+      {
+         return {};
+      }
+      return {m_timeline.get(), m_timingSource, ctx.slot(), ctx.evt()};
+   }
+
 } // namespace GPUTutorial
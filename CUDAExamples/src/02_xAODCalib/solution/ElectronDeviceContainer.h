@@ -1,66 +1,113 @@
 // Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
-#ifndef CUDAEXAMPLES_ELECTRONDEVICECONTAINER_H
-#define CUDAEXAMPLES_ELECTRONDEVICECONTAINER_H
+#ifndef GPUTUTORIALCORE_ELECTRONDEVICECONTAINER_H
+#define GPUTUTORIALCORE_ELECTRONDEVICECONTAINER_H
 
-// VecMem include(s).
-#include <vecmem/edm/container.hpp>
+// Local include(s).
+#include "GPUTutorialCore/DeviceColumns.h"
+
+// System include(s).
+#include <cstdint>
 
 namespace GPUTutorial
 {
+   /// Descriptors of the electron variables used on the device
+   namespace ElectronColumns
+   {
+      /// Pseudorapidity of the electrons
+      struct Eta : Column<float, ColumnAccess::Read>
+      {
+         static constexpr const char *auxName = "eta";
+      };
+      /// Azimuthal angle of the electrons
+      struct Phi : Column<float, ColumnAccess::Read>
+      {
+         static constexpr const char *auxName = "phi";
+      };
+      // FIX
+
+      /// Transverse momentum of the electrons, calibrated on the device
+      struct Pt : Column<float, ColumnAccess::ReadWrite>
+      {
+         static constexpr const char *auxName = "pt";
+      };
+      /// Author of the electrons
+      struct Author : Column<std::uint16_t, ColumnAccess::Read>
+      {
+         static constexpr const char *auxName = "author";
+      };
+
+      // FIX
+
+      /// All columns of the electron container
+      using Set = ColumnSet<Eta, Phi, Pt, Author>;
+
+   } // namespace ElectronColumns
+
    /// Interface for the VecMem based GPU friendly ElectronDeviceContainer.
    template <typename BASE>
-   struct ElectronDeviceInterface : public BASE
+   struct ElectronDeviceInterface
+       : public ElectronColumns::Set::Interface<BASE>
    {
+      /// The base interface
+      using Base = ElectronColumns::Set::Interface<BASE>;
       /// Inherit the base class's constructor(s)
-      using BASE::BASE;
-
+      using Base::Base;
       /// Inherit the base class's assignment operator(s)
-      using BASE::operator=;
+      using Base::operator=;
 
       /// Get the pseudorapidity of the electrons (const)
       VECMEM_HOST_AND_DEVICE
-      const auto &eta() const { return BASE::template get<0>(); }
+      const auto &eta() const
+      {
+         return Base::template column<ElectronColumns::Eta>();
+      }
       /// Get the pseudorapidity of the electrons (non-const)
       VECMEM_HOST_AND_DEVICE
-      auto &eta() { return BASE::template get<0>(); }
+      auto &eta() { return Base::template column<ElectronColumns::Eta>(); }
 
       /// Get the azimuthal angles of the electrons (const)
       VECMEM_HOST_AND_DEVICE
-      const auto &phi() const { return BASE::template get<1>(); }
+      const auto &phi() const
+      {
+         return Base::template column<ElectronColumns::Phi>();
+      }
       /// Get the azimuthal angles of the electrons (non-const)
       VECMEM_HOST_AND_DEVICE
-      auto &phi() { return BASE::template get<1>(); }
+      auto &phi() { return Base::template column<ElectronColumns::Phi>(); }
 
       // FIX
 
       /// Get the transverse momentum of the electrons (const)
       VECMEM_HOST_AND_DEVICE
-      const auto &pt() const { return BASE::template get<2>(); }
+      const auto &pt() const
+      {
+         return Base::template column<ElectronColumns::Pt>();
+      }
       /// Get the transverse momentum of the electrons (non-const)
       VECMEM_HOST_AND_DEVICE
-      auto &pt() { return BASE::template get<2>(); }
+      auto &pt() { return Base::template column<ElectronColumns::Pt>(); }
 
       /// Get the author of the electrons (const)
       VECMEM_HOST_AND_DEVICE
-      const auto &author() const { return BASE::template get<3>(); }
+      const auto &author() const
+      {
+         return Base::template column<ElectronColumns::Author>();
+      }
       /// Get the author of the electrons (non-const)
       VECMEM_HOST_AND_DEVICE
-      auto &author() { return BASE::template get<3>(); }
+      auto &author()
+      {
+         return Base::template column<ElectronColumns::Author>();
+      }
 
       // FIX
 
    }; // struct ElectronDeviceInterface
 
    /// SoA, GPU friendly electron container.
-   using ElectronDeviceContainer = vecmem::edm::container<
-       ElectronDeviceInterface, vecmem::edm::type::vector<float>,
-       vecmem::edm::type::vector<float>,
-       // FIX
-       vecmem::edm::type::vector<float>,
-       vecmem::edm::type::vector<std::uint16_t>
-       // FIX
-       >;
+   using ElectronDeviceContainer =
+       ElectronColumns::Set::container<ElectronDeviceInterface>;
 
 } // namespace GPUTutorial
 
-#endif // CUDAEXAMPLES_ELECTRONDEVICECONTAINER_H
+#endif // GPUTUTORIALCORE_ELECTRONDEVICECONTAINER_H
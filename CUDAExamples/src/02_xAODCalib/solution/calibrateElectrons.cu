@@ -3,12 +3,12 @@
 // Local include(s).
 #include "calibrateElectrons.h"
 
+// Project include(s).
+#include "GPUTutorialCore/ElectronCalibration.h" // FIX
+
 // Framework include(s).
 #include "AthenaKernel/errorcheck.h"
 
-// System include(s).
-#include <numbers> // FIX
-
 /// Helper macro for checking CUDA calls
 #define ATH_CUDA_CHECK(EXP)                                           \
    do                                                                 \
@@ -32,7 +32,8 @@ namespace GPUTutorial
       /// Simple kernel "calibrating" electrons
       __global__ void
       calibrateElectrons(ElectronDeviceContainer::const_view inputView,
-                         ElectronDeviceContainer::view outputView)
+                         ElectronDeviceContainer::view outputView,
+                         ElectronCalibrationTableView table)
       {
          // Get the index of the current thread.
          const int idx = blockIdx.x * blockDim.x + threadIdx.x;
@@ -47,35 +48,33 @@ namespace GPUTutorial
             return;
          }
 
-         // Copy the input electron to the output container.
-         output[idx].eta() = input[idx].eta();
-         output[idx].phi() = input[idx].phi();
-         output[idx].author() = input[idx].author(); // FIX
-
-         // FIX Perform some calibration on the output electron.
-         output[idx].pt() =
-             input[idx].pt() * (0.9f + 0.4f * std::numbers::inv_pi_v<float> *
-                                           (input[idx].phi() +
-                                            std::numbers::pi_v<float>));
+         // FIX Perform some calibration on the output electron, the same way
+         // as the host does. Only its pt column is bound to memory.
+         output.pt()[idx] = calibratedElectronPt(
+             input[idx].pt(), input[idx].eta(), input[idx].phi(),
+             input[idx].author(), table);
          // FIX
       }
 
    } // namespace Kernels
 
    StatusCode calibrateElectrons(ElectronDeviceContainer::const_view input,
-                                 ElectronDeviceContainer::view output)
+                                 ElectronDeviceContainer::view output,
+                                 cudaStream_t stream,
+                                 const ElectronCalibrationTableView &table,
+                                 const LaunchConfig &launch)
    {
       // Launch the kernel.
-      const int blockSize = 256;
-      const int numBlocks = (input.capacity() + blockSize - 1) / blockSize;
-      Kernels::calibrateElectrons<<<numBlocks, blockSize>>>(input, output);
+      const unsigned int blockSize =
+          static_cast<unsigned int>(launch.workGroupSize);
+      const unsigned int numBlocks =
+          (input.capacity() + blockSize - 1) / blockSize;
+      Kernels::calibrateElectrons<<<numBlocks, blockSize, 0, stream>>>(
+          input, output, table);
 
       // Check for errors in kernel launch.
       ATH_CUDA_CHECK(cudaGetLastError());
 
-      // Wait for the device to finish with the kernel.
-      ATH_CUDA_CHECK(cudaDeviceSynchronize());
-
       // Return gracefully.
       return StatusCode::SUCCESS;
    }
@@ -0,0 +1,77 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef CUDAEXAMPLES_DEVICEALLOCATOR_H
+#define CUDAEXAMPLES_DEVICEALLOCATOR_H
+
+// CUDA include(s).
+#include <cuda_runtime_api.h>
+
+// System include(s).
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace GPUTutorial
+{
+   /// Device allocator with the interface of @c cub::CachingDeviceAllocator,
+   /// taking its memory from a (device) memory resource
+   ///
+   /// Kernels may still be using a buffer when @c DeviceFree is called on
+   /// it, so the memory is only given back to the resource when the
+   /// allocator is destroyed. Before that, the allocator synchronises with
+   /// all streams that it allocated buffers for. So the memory is not
+   /// handed out again while the device may still use it, not even when
+   /// the algorithm returns early, without awaiting its stream. The streams
+   /// need to outlive the allocator.
+   ///
+   class DeviceAllocator
+   {
+   public:
+      /// Constructor with the device memory resource to use
+      explicit DeviceAllocator(std::pmr::memory_resource& mr) : m_mr(mr) {}
+      /// Destructor, giving all memory back to the memory resource
+      ~DeviceAllocator() {
+         for (cudaStream_t stream : m_streams) {
+            // Nothing to wait for if the stream was awaited already. The
+            // error of a failed stream was reported by its user already.
+            if (cudaStreamSynchronize(stream) != cudaSuccess) {
+               cudaGetLastError();
+            }
+         }
+         for (const auto& [ptr, bytes] : m_allocations) {
+            m_mr.deallocate(ptr, bytes);
+         }
+      }
+
+      /// Allocate a device buffer
+      cudaError_t DeviceAllocate(void** ptr, std::size_t bytes, cudaStream_t stream) {
+         try {
+            *ptr = m_mr.allocate(bytes);
+         } catch (const std::bad_alloc&) {
+            *ptr = nullptr;
+            return cudaErrorMemoryAllocation;
+         }
+         m_allocations.emplace_back(*ptr, bytes);
+         if (std::find(m_streams.begin(), m_streams.end(), stream) == m_streams.end()) {
+            m_streams.push_back(stream);
+         }
+         return cudaSuccess;
+      }
+      /// Mark a device buffer as no longer needed
+      cudaError_t DeviceFree(void* /*ptr*/) { return cudaSuccess; }
+
+   private:
+      /// The memory resource to allocate from
+      std::pmr::memory_resource& m_mr;
+      /// The allocations made so far
+      std::vector<std::pair<void*, std::size_t>> m_allocations;
+      /// The streams that the buffers were allocated for
+      std::vector<cudaStream_t> m_streams;
+
+   }; // class DeviceAllocator
+
+} // namespace GPUTutorial
+
+#endif // CUDAEXAMPLES_DEVICEALLOCATOR_H
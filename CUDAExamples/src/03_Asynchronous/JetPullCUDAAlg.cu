@@ -2,6 +2,8 @@
 
 // Local include(s).
 #include "JetPullCUDAAlg.h"
+#include "DeviceAllocator.h"
+#include "../Timing/CUDAStageTimer.h"
 
 // Framework include(s).
 #include "AthenaKernel/errorcheck.h"
@@ -60,15 +62,20 @@ namespace GPUTutorial
                                             const std::pmr::vector<float>& constEta, ///< [in] flat array of constituent etas (grouped by jet)
                                             const std::pmr::vector<float>& constPhi, ///< [in] flat array of constituent phis (grouped by jet)
                                             std::pmr::vector<float>& jetPullEta, ///< [out] eta component of each jet pull vector
-                                            std::pmr::vector<float>& jetPullPhi ///< [out] phi component of each jet pull vector
+                                            std::pmr::vector<float>& jetPullPhi, ///< [out] phi component of each jet pull vector
+                                            std::pmr::memory_resource& deviceMR, ///< [in] memory resource for the device buffers
+                                            const StageContext& timing ///< [in] context to record the stage timings for
                                           ) const
    {
-      // Setup the device allocator
-      static cub::CachingDeviceAllocator devAlloc{};
-
       // Create our CUDA stream
       Gaudi::CUDA::Stream stream(this);
 
+      // Setup the device allocator. Created after the stream, so that it
+      // can synchronise with the stream when it is destroyed.
+      DeviceAllocator devAlloc{deviceMR};
+      // Time the work scheduled on the stream, if requested
+      CUDAStageTimer timer(timing, stream);
+
       // Setup device copies of inputs
       const std::size_t nJets = jetPt.size();
       const std::size_t totalConstituents = constPt.size();
@@ -109,6 +116,7 @@ namespace GPUTutorial
 
       // Finally, await completion of anything left scheduled on the stream
       ATH_CHECK(stream.await());
+      timer.flush();
       return StatusCode::SUCCESS;
    }
 
@@ -2,6 +2,12 @@
 
 // Local include(s).
 #include "JetPullCUDAAlg.h"
+#include "../Async/FiberAwait.h"
+
+// Project include(s).
+#include "GPUTutorialCore/ConstituentGather.h"
+#include "GPUTutorialCore/JetPullBatcher.h"
+#include "GPUTutorialCore/JetPullHost.h"
 
 // Framework include(s).
 #include "StoreGate/ReadHandle.h"
@@ -11,36 +17,146 @@
 #include "xAODJet/JetContainer.h"
 #include "xAODJet/Jet.h"
 
-// VecMem include(s).
-#include <vecmem/memory/cuda/host_memory_resource.hpp>
-// #include <vecmem/memory/cuda/device_memory_resource.hpp>
-#include <vecmem/memory/pool_memory_resource.hpp>
-#include <vecmem/memory/synchronized_memory_resource.hpp>
-#include <vecmem/utils/cuda/copy.hpp>
+// Boost include(s).
+#include <boost/fiber/condition_variable.hpp>
+#include <boost/fiber/mutex.hpp>
+
+// TBB include(s).
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+// CUDA include(s).
+#include <cuda_runtime_api.h>
 
 // STL includes(s)
+#include <algorithm>
+#include <chrono>
 #include <format>
+#include <exception>
+#include <limits>
+#include <map>
+#include <numeric>
 #include <span>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
+namespace
+{
+   /// Gather the constituent kinematics of a range of jets, through their
+   /// constituent vectors
+   ///
+   /// The output spans hold the constituents of the selected jets only.
+   void gatherConstituentsLoop(const xAOD::JetContainer& jets,
+                               std::size_t begin, std::size_t end,
+                               std::span<float> constPt,
+                               std::span<float> constEta,
+                               std::span<float> constPhi) {
+      std::size_t pos = 0;
+      for (std::size_t i = begin; i < end; ++i) {
+         for (const auto* c : jets[i]->getConstituents()) {
+            constPt[pos] = c->pt();
+            constEta[pos] = c->eta();
+            constPhi[pos] = c->phi();
+            ++pos;
+         }
+      }
+   }
+
+   /// Gather the constituent kinematics of a range of jets with indexed loads
+   ///
+   /// The constituent links are resolved to (container, index) pairs, and
+   /// the kinematics are loaded directly from the aux store arrays of the
+   /// constituent containers. Jets with constituents from containers that
+   /// do not store "pt", "eta" and "phi" (like calorimeter clusters) are
+   /// gathered through their constituent vectors, just like in the simple
+   /// loop.
+   ///
+   /// The output spans hold the constituents of the selected jets only.
+   void gatherConstituentsIndexed(const xAOD::JetContainer& jets,
+                                  std::size_t begin, std::size_t end,
+                                  std::span<float> constPt,
+                                  std::span<float> constEta,
+                                  std::span<float> constPhi,
+                                  std::pmr::memory_resource* mr) {
+      // Helper function finding the kinematic columns of a container.
+      static const SG::AuxElement::ConstAccessor<float> ptAcc("pt");
+      static const SG::AuxElement::ConstAccessor<float> etaAcc("eta");
+      static const SG::AuxElement::ConstAccessor<float> phiAcc("phi");
+      auto findColumns = [](const xAOD::IParticleContainer* container) {
+         if ((container == nullptr) || container->empty() || !ptAcc.isAvailable(*container) ||
+             !etaAcc.isAvailable(*container) || !phiAcc.isAvailable(*container)) {
+            return GPUTutorial::ConstituentColumns{};
+         }
+         const std::size_t n = container->size();
+         return GPUTutorial::ConstituentColumns{{ptAcc.getDataArray(*container), n},
+                                                {etaAcc.getDataArray(*container), n},
+                                                {phiAcc.getDataArray(*container), n}};
+      };
+
+      // Gather the constituents.
+      GPUTutorial::ConstituentGatherer<const xAOD::IParticleContainer*> gatherer(
+          findColumns, constPt, constEta, constPhi, mr);
+      for (std::size_t i = begin; i < end; ++i) {
+         const xAOD::Jet* jet = jets[i];
+         const std::size_t pos = gatherer.position();
+         bool gathered = true;
+         for (const auto& link : jet->constituentLinks()) {
+            gathered &= gatherer.gather(link.getStorableObjectPointer(), link.index());
+         }
+         if (!gathered) {
+            // Fall back to the constituent vector for this jet.
+            gatherConstituentsLoop(jets, i, i + 1, constPt.subspan(pos), constEta.subspan(pos),
+                                   constPhi.subspan(pos));
+         }
+      }
+   }
+
+   /// Number of bytes moved to and from a device per jet
+   constexpr std::size_t BYTES_PER_JET = 5 * sizeof(float) + sizeof(std::size_t);
+   /// Number of bytes moved to a device per constituent
+   constexpr std::size_t BYTES_PER_CONSTITUENT = 3 * sizeof(float);
+
+   /// Synthetic jets, used to time the pull calculation in initialize()
+   struct SyntheticJets {
+      /// Constructor with the total number of constituents
+      explicit SyntheticJets(std::size_t nConst) {
+         const std::size_t nJets = std::max<std::size_t>(nConst / 20, 1);
+         for (std::size_t i = 0; i < nJets; ++i) {
+            jetPt.push_back(20000.f + 1000.f * static_cast<float>(i % 50));
+            jetEta.push_back(-2.f + 4.f * static_cast<float>(i % 41) / 41.f);
+            jetPhi.push_back(-3.f + 6.f * static_cast<float>(i % 37) / 37.f);
+            nConstituents.push_back(nConst / nJets + ((i < nConst % nJets) ? 1 : 0));
+         }
+         for (std::size_t c = 0; c < nConst; ++c) {
+            constPt.push_back(500.f + 10.f * static_cast<float>(c % 101));
+            constEta.push_back(-2.f + 4.f * static_cast<float>(c % 43) / 43.f);
+            constPhi.push_back(-3.f + 6.f * static_cast<float>(c % 47) / 47.f);
+         }
+         pullEta.resize(nJets);
+         pullPhi.resize(nJets);
+      }
+      /// @name The jet and constituent variables
+      /// @{
+      std::vector<float> jetPt, jetEta, jetPhi;
+      std::pmr::vector<std::size_t> nConstituents;
+      std::pmr::vector<float> constPt, constEta, constPhi;
+      std::pmr::vector<float> pullEta, pullPhi;
+      /// @}
+   };
+} // namespace
+
 namespace GPUTutorial
 {
-   struct JetPullCUDAAlg::MemoryResources
+   /// Batcher using fiber aware synchronization, as execute() runs in a fiber
+   using FiberJetPullBatcher = JetPullBatcher<boost::fibers::mutex,
+                                              boost::fibers::condition_variable>;
+   struct JetPullCUDAAlg::Batcher : public FiberJetPullBatcher
    {
-      /// Uncached host memory resource
-      vecmem::cuda::host_memory_resource m_plainHostMR;
-      /// Cached host memory resource
-      vecmem::pool_memory_resource m_cachedHostMR{m_plainHostMR};
-      /// Synchronized and cached host memory resource
-      vecmem::synchronized_memory_resource m_hostMR{m_cachedHostMR};
-
-      std::pmr::memory_resource* hostMR();
+      using FiberJetPullBatcher::FiberJetPullBatcher;
    };
 
-   std::pmr::memory_resource* JetPullCUDAAlg::MemoryResources::hostMR() {
-      return &m_hostMR;
-   }
-
    JetPullCUDAAlg::JetPullCUDAAlg(const std::string &name,
                                               ISvcLocator *svcloc)
        : AthAsynchronousAlgorithm(name, svcloc) {}
@@ -49,8 +165,118 @@ namespace GPUTutorial
 
    StatusCode JetPullCUDAAlg::initialize()
    {
+      // Decide which backend to use.
+      if (m_backend.value() == "Host") {
+         m_useHost = true;
+      } else if ((m_backend.value() == "Device") || (m_backend.value() == "Dispatch")) {
+         m_useHost = false;
+      } else if (m_backend.value() == "Auto") {
+         int nDevices = 0;
+         m_useHost = ((cudaGetDeviceCount(&nDevices) != cudaSuccess) ||
+                      (nDevices == 0));
+         // Clear the error state, if there was an error.
+         cudaGetLastError();
+      } else {
+         ATH_MSG_ERROR("Unknown backend: \"" << m_backend.value() << "\"");
+         return StatusCode::FAILURE;
+      }
+      const char* device = (m_mockDevice ? "mock device" : "CUDA device");
+      if (m_backend.value() == "Dispatch") {
+         ATH_MSG_INFO("Calculating jet pulls on the host or the " << device);
+      } else {
+         ATH_MSG_INFO("Calculating jet pulls on the " << (m_useHost ? "host" : device));
+      }
+      if (m_useHost && m_crossCheck) {
+         ATH_MSG_WARNING("Host/device cross-check requested with the host "
+                         "backend. It will not be performed.");
+      }
+
+      // Set up the encoding of the host-to-device transfers.
+      try {
+         m_encoding = TransferEncoding::parse(m_transferEncoding.value());
+      } catch (const std::exception& ex) {
+         ATH_MSG_ERROR("Invalid transfer encoding: " << ex.what());
+         return StatusCode::FAILURE;
+      }
+      if (m_encoding.encoded()) {
+         if (m_useHost) {
+            ATH_MSG_WARNING("Transfer encoding requested with the host "
+                            "backend. It will not be used.");
+         } else {
+            ATH_MSG_INFO("Encoding the transfers to the device as: " << m_encoding.toString());
+         }
+      }
+
+      // Set up the observables to calculate. Only the pull has a device
+      // implementation, anything else is calculated together with it, in a
+      // single segmented pass on the host.
+      try {
+         m_observableSet = parseJetObservables(m_observables.value());
+      } catch (const std::exception& ex) {
+         ATH_MSG_ERROR("Invalid observables: " << ex.what());
+         return StatusCode::FAILURE;
+      }
+      if (m_observableSet == 0) {
+         ATH_MSG_ERROR("No jet observables requested");
+         return StatusCode::FAILURE;
+      }
+      m_fusedSubstructure = (m_observableSet != static_cast<JetObservableSet>(JetObservable::Pull));
+      if (m_fusedSubstructure) {
+         ATH_MSG_INFO("Calculating jet observables " << toString(m_observableSet)
+                      << " in a fused pass on the host");
+         if (!m_useHost) {
+            ATH_MSG_WARNING("The fused substructure pass has no CUDA implementation. "
+                            "It will be run on the host.");
+         }
+         if (m_batchSize.value() > 1) {
+            ATH_MSG_ERROR("Batching is only supported when calculating just the jet pulls");
+            return StatusCode::FAILURE;
+         }
+      }
+
       // Set up the memory resources.
-      m_memoryResources = std::make_unique<MemoryResources>();
+      ATH_CHECK(m_memorySvc.retrieve());
+      m_memoryClient = m_memorySvc->registerClient(name());
+
+      // Set up the host/device dispatch.
+      ATH_CHECK(setupDispatcher());
+
+      // Set up the stage timing, if requested.
+      if (m_stageTiming || !m_chromeTraceFile.value().empty()) {
+         m_timeline = StageTimeline::shared();
+         m_timingSource = m_timeline->registerSource(name());
+      }
+
+      // Set up the capture of the offload inputs, if requested.
+      if (!m_captureFile.value().empty()) {
+         try {
+            m_capture = EventCaptureWriter::shared(m_captureFile.value());
+         } catch (const std::exception& ex) {
+            ATH_MSG_ERROR(ex.what());
+            return StatusCode::FAILURE;
+         }
+         ATH_MSG_INFO("Capturing the jet and constituent arrays into: " << m_captureFile.value());
+      }
+
+      // Set up the batching of multiple events, if requested.
+      if (m_batchSize.value() > 1) {
+         ATH_MSG_INFO("Processing up to " << m_batchSize.value() << " events in one batch, waiting at most "
+                      << m_batchMaxWait.value() << " us for a batch to fill up");
+         m_batcher = std::make_unique<Batcher>(
+             [this](JetPullBatch& batch) {
+                // The batch outlives the events that it is made of, so it
+                // can not use their arenas.
+                return runBackend(batch.jetPt, batch.jetEta, batch.jetPhi, batch.nConstituents,
+                                  batch.constPt, batch.constEta, batch.constPhi,
+                                  batch.pullEta, batch.pullPhi,
+                                  m_memorySvc->sharedHostMR(),
+                                  m_memorySvc->sharedDeviceMR(),
+                                  m_timeline ? StageContext{m_timeline.get(), m_timingSource}
+                                             : StageContext{}).isSuccess();
+             },
+             m_batchSize.value(), std::chrono::microseconds(m_batchMaxWait.value()),
+             &(m_memorySvc->sharedHostMR()));
+      }
 
       // Set up the input and output keys.
       ATH_CHECK(m_inputKey.initialize());
@@ -74,14 +300,17 @@ namespace GPUTutorial
       if (nJets == 0) {
          return StatusCode::SUCCESS;
       }
-      std::pmr::vector<std::size_t> nConstituents(m_memoryResources->hostMR());
+      const StageContext timing = stageContext(ctx);
+      ScopedStageTimer gatherTimer(timing, "gather");
+      std::pmr::memory_resource* hostMR = &(m_memorySvc->hostMR(m_memoryClient, ctx));
+      std::pmr::vector<std::size_t> nConstituents(hostMR);
       // // Is this worth it?
-      // std::pmr::vector<float> jetPt(nJets, m_memoryResources->hostMR());
-      // std::pmr::vector<float> jetEta(nJets, m_memoryResources->hostMR());
-      // std::pmr::vector<float> jetPhi(nJets, m_memoryResources->hostMR());
-      std::pmr::vector<float> constPt(m_memoryResources->hostMR());
-      std::pmr::vector<float> constEta(m_memoryResources->hostMR());
-      std::pmr::vector<float> constPhi(m_memoryResources->hostMR());
+      // std::pmr::vector<float> jetPt(nJets, hostMR);
+      // std::pmr::vector<float> jetEta(nJets, hostMR);
+      // std::pmr::vector<float> jetPhi(nJets, hostMR);
+      std::pmr::vector<float> constPt(hostMR);
+      std::pmr::vector<float> constEta(hostMR);
+      std::pmr::vector<float> constPhi(hostMR);
 
       // Get jet data
       static const SG::AuxElement::ConstAccessor<float> ptAcc("pt");
@@ -94,55 +323,375 @@ namespace GPUTutorial
       // std::memcpy(jetEta.data(), etaAcc.getDataArray(*inputJets), nJets * sizeof(float));
       // std::memcpy(jetPhi.data(), phiAcc.getDataArray(*inputJets), nJets * sizeof(float));
 
-      // Get constituent data. We loop twice so we can allocate the constituent arrays in one go.
-      std::size_t totalConstituents = 0;
-      nConstituents.reserve(nJets);
-      for (const auto& jet : *inputJets) {
-         std::size_t nConst = jet->numConstituents();
-         totalConstituents += nConst;
-         nConstituents.push_back(nConst);
-      }
-      
-      constPt.reserve(totalConstituents);
-      constEta.reserve(totalConstituents);
-      constPhi.reserve(totalConstituents);
-      for (const auto& jet : *inputJets) {
-         for (const auto* c : jet->getConstituents()) {
-            constPt.push_back(c->pt());
-            constEta.push_back(c->eta());
-            constPhi.push_back(c->phi());
-         }
-      }
-   
+      // Count the constituents of the jets in parallel, and lay out the flat
+      // constituent arrays with a prefix sum over the counts.
+      const tbb::blocked_range<std::size_t> jetRange(
+          0, nJets, std::max<std::size_t>(m_prepGrainSize.value(), 1));
+      nConstituents.resize(nJets);
+      tbb::parallel_for(jetRange, [&](const tbb::blocked_range<std::size_t>& r) {
+         for (std::size_t i = r.begin(); i < r.end(); ++i) {
+            nConstituents[i] = (*inputJets)[i]->numConstituents();
+         }
+      });
+      std::pmr::vector<std::size_t> offsets(nJets + 1, 0, hostMR);
+      std::inclusive_scan(nConstituents.begin(), nConstituents.end(), offsets.begin() + 1);
+      const std::size_t totalConstituents = offsets.back();
+      constPt.resize(totalConstituents);
+      constEta.resize(totalConstituents);
+      constPhi.resize(totalConstituents);
+
+      // Get constituent data in parallel. Every task writes into the slice of
+      // its own jets, so the output does not depend on the task scheduling.
+      tbb::parallel_for(jetRange, [&](const tbb::blocked_range<std::size_t>& r) {
+         const std::size_t offset = offsets[r.begin()];
+         const std::size_t count = offsets[r.end()] - offset;
+         const std::span<float> pt = std::span<float>(constPt).subspan(offset, count);
+         const std::span<float> eta = std::span<float>(constEta).subspan(offset, count);
+         const std::span<float> phi = std::span<float>(constPhi).subspan(offset, count);
+         if (m_indexedGather) {
+            gatherConstituentsIndexed(*inputJets, r.begin(), r.end(), pt, eta, phi, hostMR);
+         } else {
+            gatherConstituentsLoop(*inputJets, r.begin(), r.end(), pt, eta, phi);
+         }
+      });
+
       // Create host buffers to store results
-      std::pmr::vector<float> jetPullEta(nJets, m_memoryResources->hostMR());
-      std::pmr::vector<float> jetPullPhi(nJets, m_memoryResources->hostMR());
+      std::pmr::vector<float> jetPullEta(nJets, hostMR);
+      std::pmr::vector<float> jetPullPhi(nJets, hostMR);
+
+      gatherTimer.stop();
+
+      // Capture the arrays, exactly as the calculation will receive them
+      if (m_capture) {
+         ScopedStageTimer captureTimer(timing, "capture");
+         try {
+            m_capture->write(ctx.eventID().run_number(), ctx.eventID().event_number(),
+                             {{CaptureColumn::JetPt, jetPt},
+                              {CaptureColumn::JetEta, jetEta},
+                              {CaptureColumn::JetPhi, jetPhi},
+                              {CaptureColumn::JetNConstituents, std::span<const std::size_t>(nConstituents)},
+                              {CaptureColumn::ConstituentPt, std::span<const float>(constPt)},
+                              {CaptureColumn::ConstituentEta, std::span<const float>(constEta)},
+                              {CaptureColumn::ConstituentPhi, std::span<const float>(constPhi)}});
+         } catch (const std::exception& ex) {
+            ATH_MSG_ERROR(ex.what());
+            return StatusCode::FAILURE;
+         }
+      }
+
+      // Run the calculation, possibly as part of a multi-event batch, or as a
+      // fused pass over all requested observables
+      SubstructureArrays outputs{jetPullEta.data(), jetPullPhi.data()};
+      std::pmr::vector<float> substructure(hostMR);
+      ScopedStageTimer calculateTimer(timing, m_fusedSubstructure ? "substructure"
+                                              : m_batcher ? "batch" : "calculate");
+      if (m_fusedSubstructure) {
+         substructure.resize(SUBSTRUCTURE_OUTPUTS.size() * nJets);
+         outputs = makeSubstructureArrays(m_observableSet, substructure.data(), nJets);
+         try {
+            Host::calculateSubstructure({jetPt, jetEta, jetPhi, nConstituents, constPt, constEta,
+                                         constPhi},
+                                        m_observableSet, outputs);
+         } catch (const std::exception& ex) {
+            ATH_MSG_ERROR("Failed to calculate the jet substructure: " << ex.what());
+            return StatusCode::FAILURE;
+         }
+      } else if (m_batcher) {
+         if (!m_batcher->process({jetPt, jetEta, jetPhi, nConstituents, constPt, constEta, constPhi},
+                                 jetPullEta, jetPullPhi)) {
+            ATH_MSG_ERROR("Failed to calculate the jet pulls of a batch of events");
+            return StatusCode::FAILURE;
+         }
+      } else {
+         ATH_CHECK(runBackend(jetPt, jetEta, jetPhi, nConstituents, constPt, constEta, constPhi,
+                              jetPullEta, jetPullPhi, *hostMR,
+                              m_memorySvc->deviceMR(m_memoryClient, ctx), timing));
+      }
+      calculateTimer.stop();
 
-      // Run GPU code
-      ATH_CHECK(deviceExecute(jetPt, jetEta, jetPhi, nConstituents, constPt, constEta, constPhi,
-                               jetPullEta, jetPullPhi));
-      
       // Save output
+      ScopedStageTimer decorateTimer(timing, "decorate");
       // Get an std::pair of unique_ptrs back
       auto outputJetsSC = xAOD::shallowCopyContainer(*inputJets, ctx);
       auto&& [outputJets, outputAux] = outputJetsSC;
       {
-         SG::Accessor<float> pullEtaAcc("pullEta");
-         SG::Accessor<float> pullPhiAcc("pullPhi");
-         std::size_t i = 0;
-         for(auto jet : *outputJets) {
-            pullEtaAcc(*jet) = jetPullEta[i];
-            pullPhiAcc(*jet) = jetPullPhi[i];
-            ++i;
+         // Create the decorations up front, as that is not thread-safe, and
+         // then fill them in parallel.
+         std::vector<std::pair<const float*, float*>> decorations;
+         for (const auto& [decoration, array] : SUBSTRUCTURE_OUTPUTS) {
+            if (outputs.*array != nullptr) {
+               SG::Accessor<float> acc(decoration);
+               decorations.emplace_back(outputs.*array, acc.getDataArray(*outputJets));
+            }
          }
+         tbb::parallel_for(jetRange, [&](const tbb::blocked_range<std::size_t>& r) {
+            for (const auto& [source, destination] : decorations) {
+               std::copy(source + r.begin(), source + r.end(), destination + r.begin());
+            }
+         });
       }
-      if (nJets > 0) {
-         ATH_MSG_INFO(std::format("Jet 0 with {} components has pull vector [{}, {}]", nConstituents[0], jetPullEta[0], jetPullPhi[0]));
+      if (contains(m_observableSet, JetObservable::Pull)) {
+         ATH_MSG_INFO(std::format("Jet 0 with {} components has pull vector [{}, {}]", nConstituents[0], outputs.pullEta[0], outputs.pullPhi[0]));
       }
 
+      decorateTimer.stop();
+
       // Record
+      ScopedStageTimer recordTimer(timing, "record");
       SG::WriteHandle output(m_outputKey, ctx);
       ATH_CHECK(output.record(std::move(outputJets), std::move(outputAux)));
+      recordTimer.stop();
+
+      // Return gracefully.
+      return StatusCode::SUCCESS;
+   }
+
+   StatusCode JetPullCUDAAlg::finalize()
+   {
+      // Report where the pulls were calculated.
+      if (m_dispatcher) {
+         std::ostringstream summary;
+         m_dispatcher->printSummary(summary);
+         ATH_MSG_INFO("Host/device dispatch of the calculation:\n" << summary.str());
+      }
+
+      // Report the results of the host/device cross-check.
+      if (m_crossCheck && !m_useHost) {
+         ATH_MSG_INFO(std::format("{} / {} jet pull(s) differed between the host and the device "
+                                  "(relative tolerance: {}, absolute tolerance: {})",
+                                  m_nCrossCheckFailures.load(), m_nCrossCheckedJets.load(),
+                                  m_crossCheckRelTolerance.value(),
+                                  m_crossCheckAbsTolerance.value()));
+      }
+
+      // Write the index of the capture file, if no other algorithm writing
+      // into it did that yet.
+      if (m_capture) {
+         try {
+            m_capture->close();
+         } catch (const std::exception& ex) {
+            ATH_MSG_ERROR(ex.what());
+            return StatusCode::FAILURE;
+         }
+         ATH_MSG_INFO("Captured the jet and constituent arrays into: " << m_captureFile.value()
+                      << " (holding " << m_capture->size() << " event(s))");
+         m_capture.reset();
+      }
+
+      // Report the stage timings.
+      if (m_timeline) {
+         std::ostringstream summary;
+         m_timeline->printSummary(summary, m_timingSource);
+         ATH_MSG_INFO("Time spent in the stages of the calculation:\n" << summary.str());
+         if (!m_chromeTraceFile.value().empty()) {
+            // Every algorithm writes the whole timeline, the last one to
+            // finalize leaves the complete trace.
+            try {
+               m_timeline->writeChromeTrace(m_chromeTraceFile.value());
+            } catch (const std::exception& ex) {
+               ATH_MSG_ERROR(ex.what());
+               return StatusCode::FAILURE;
+            }
+         }
+         m_timeline.reset();
+      }
+
+      // Return gracefully.
+      return StatusCode::SUCCESS;
+   }
+
+   StatusCode JetPullCUDAAlg::setupDispatcher()
+   {
+      // Set up the mock device, if requested.
+      if (m_mockDevice) {
+         try {
+            m_mock = std::make_unique<MockDevice>(
+                std::chrono::duration<double, std::micro>(m_mockDeviceLatency.value()),
+                m_mockDeviceBandwidth.value() * 1e9);
+         } catch (const std::exception& ex) {
+            ATH_MSG_ERROR(ex.what());
+            return StatusCode::FAILURE;
+         }
+         if (m_mockDeviceThreads.value() == 0) {
+            ATH_MSG_ERROR("The mock device needs at least one thread");
+            return StatusCode::FAILURE;
+         }
+         m_mockThreads = std::make_unique<HostThreadPool>(m_mockDeviceThreads.value());
+         ATH_MSG_INFO("Using a mock device with " << m_mockDeviceLatency.value() << " us latency, "
+                      << m_mockDeviceBandwidth.value() << " GB/s bandwidth and "
+                      << m_mockDeviceThreads.value() << " thread(s)");
+      }
+
+      // Set up the threshold of the dispatcher. The fixed backends are just
+      // (counted) dispatches with trivial thresholds.
+      m_dispatcher = std::make_unique<OffloadDispatcher>();
+      if (m_backend.value() != "Dispatch") {
+         m_dispatcher->setThreshold(m_useHost ? std::numeric_limits<std::size_t>::max() : 0);
+         return StatusCode::SUCCESS;
+      }
+      if (m_dispatchThreshold.value() >= 0) {
+         m_dispatcher->setThreshold(static_cast<std::size_t>(m_dispatchThreshold.value()));
+      } else {
+         // Time the calculation on both sides with synthetic jets, made of
+         // the calibration's numbers of constituents. The device is timed
+         // without a transfer encoding.
+         const OffloadDispatcher::CalibrationConfig config;
+         std::map<std::size_t, SyntheticJets> jets;
+         for (std::size_t n : config.sizes) {
+            jets.try_emplace(n, n);
+         }
+         auto host = [&](std::size_t n) {
+            SyntheticJets& j = jets.at(n);
+            if (hostExecute(j.jetPt, j.jetEta, j.jetPhi, j.nConstituents, j.constPt, j.constEta,
+                            j.constPhi, j.pullEta, j.pullPhi).isFailure()) {
+               throw std::runtime_error("Failed to calculate jet pulls on the host");
+            }
+         };
+         OffloadDispatcher::Function device;
+         if (m_mock) {
+            device = [&](std::size_t n) {
+               const SyntheticJets& j = jets.at(n);
+               m_mock->run(j.jetPt.size() * BYTES_PER_JET + n * BYTES_PER_CONSTITUENT,
+                           [&]() { host(n); });
+            };
+         } else {
+            device = [&](std::size_t n) {
+               SyntheticJets& j = jets.at(n);
+               if (deviceExecute(j.jetPt, j.jetEta, j.jetPhi, j.nConstituents, j.constPt,
+                                 j.constEta, j.constPhi, j.pullEta, j.pullPhi,
+                                 m_memorySvc->sharedDeviceMR(), StageContext{}).isFailure()) {
+                  throw std::runtime_error("Failed to calculate jet pulls on the device");
+               }
+            };
+         }
+         try {
+            m_dispatcher->calibrate(host, device, config);
+         } catch (const std::exception& ex) {
+            ATH_MSG_ERROR("Could not calibrate the host/device dispatch: " << ex.what());
+            return StatusCode::FAILURE;
+         }
+      }
+      std::ostringstream summary;
+      m_dispatcher->printSummary(summary);
+      ATH_MSG_INFO("Deciding for every calculation where to run it:\n" << summary.str());
+
+      // Return gracefully.
+      return StatusCode::SUCCESS;
+   }
+
+   StageContext JetPullCUDAAlg::stageContext(const EventContext& ctx) const
+   {
+      if (!m_timeline) {
+         return {};
+      }
+      return {m_timeline.get(), m_timingSource, ctx.slot(), ctx.evt()};
+   }
+
+   StatusCode JetPullCUDAAlg::runBackend(const std::span<const float>& jetPt,
+                                         const std::span<const float>& jetEta,
+                                         const std::span<const float>& jetPhi,
+                                         const std::pmr::vector<std::size_t>& nConstituents,
+                                         const std::pmr::vector<float>& constPt,
+                                         const std::pmr::vector<float>& constEta,
+                                         const std::pmr::vector<float>& constPhi,
+                                         std::pmr::vector<float>& jetPullEta,
+                                         std::pmr::vector<float>& jetPullPhi,
+                                         std::pmr::memory_resource& hostMR,
+                                         std::pmr::memory_resource& deviceMR,
+                                         const StageContext& timing
+                                        ) const
+   {
+      // Make sure that the outputs have the right size.
+      const std::size_t nJets = jetPt.size();
+      jetPullEta.resize(nJets);
+      jetPullPhi.resize(nJets);
+
+      // Run the calculation on the selected backend
+      const bool useHost = (m_dispatcher->decide(constPt.size()) == OffloadTarget::Host);
+      if (useHost) {
+         ScopedStageTimer timer(timing, "host");
+         ATH_CHECK(hostExecute(jetPt, jetEta, jetPhi, nConstituents, constPt, constEta, constPhi,
+                               jetPullEta, jetPullPhi));
+      } else if (m_mock) {
+         // Run the calculation on one of the mock device's threads, letting
+         // this thread run other algorithms until it finished.
+         ScopedStageTimer timer(timing, "mock device");
+         StatusCode sc = StatusCode::SUCCESS;
+         std::unique_ptr<AsyncExecutor::Stream> stream = m_mockThreads->makeStream();
+         stream->enqueue([&]() {
+            m_mock->run(nJets * BYTES_PER_JET + constPt.size() * BYTES_PER_CONSTITUENT, [&]() {
+               sc = hostExecute(jetPt, jetEta, jetPhi, nConstituents, constPt, constEta, constPhi,
+                                jetPullEta, jetPullPhi);
+            });
+         });
+         try {
+            awaitStream(*stream);
+         } catch (const std::exception& ex) {
+            ATH_MSG_ERROR("Failed to calculate the jet pulls on the mock device: " << ex.what());
+            return StatusCode::FAILURE;
+         }
+         ATH_CHECK(sc);
+      } else if (m_encoding.encoded()) {
+         ScopedStageTimer encodeTimer(timing, "encode");
+         JetArraysEncoder encoder(m_encoding, &hostMR);
+         EncodedJetArrays encoded;
+         try {
+            encoded = encoder.encode({jetPt, jetEta, jetPhi, nConstituents, constPt, constEta,
+                                      constPhi});
+         } catch (const std::exception& ex) {
+            ATH_MSG_ERROR("Failed to encode the jets: " << ex.what());
+            return StatusCode::FAILURE;
+         }
+         encodeTimer.stop();
+         ScopedStageTimer timer(timing, "device");
+         ATH_CHECK(deviceExecuteEncoded(encoded, jetPullEta, jetPullPhi, deviceMR, timing));
+      } else {
+         ScopedStageTimer timer(timing, "device");
+         ATH_CHECK(deviceExecute(jetPt, jetEta, jetPhi, nConstituents, constPt, constEta, constPhi,
+                                 jetPullEta, jetPullPhi, deviceMR, timing));
+      }
+
+      // Cross-check the device results with the host, if requested
+      if (m_crossCheck && !useHost) {
+         ScopedStageTimer timer(timing, "cross-check");
+         std::pmr::vector<float> hostPullEta(nJets, &hostMR);
+         std::pmr::vector<float> hostPullPhi(nJets, &hostMR);
+         ATH_CHECK(hostExecute(jetPt, jetEta, jetPhi, nConstituents, constPt, constEta, constPhi,
+                               hostPullEta, hostPullPhi));
+         const std::size_t nFailures = Host::comparePulls(
+             hostPullEta, hostPullPhi, jetPullEta, jetPullPhi,
+             m_crossCheckRelTolerance.value(), m_crossCheckAbsTolerance.value());
+         m_nCrossCheckedJets += nJets;
+         m_nCrossCheckFailures += nFailures;
+         if (nFailures > 0) {
+            ATH_MSG_WARNING(std::format("{} / {} jet pull(s) differ between the host and the device",
+                                        nFailures, nJets));
+         }
+      }
+
+      // Return gracefully.
+      return StatusCode::SUCCESS;
+   }
+
+   StatusCode JetPullCUDAAlg::hostExecute(const std::span<const float>& jetPt,
+                                          const std::span<const float>& jetEta,
+                                          const std::span<const float>& jetPhi,
+                                          const std::pmr::vector<std::size_t>& nConstituents,
+                                          const std::pmr::vector<float>& constPt,
+                                          const std::pmr::vector<float>& constEta,
+                                          const std::pmr::vector<float>& constPhi,
+                                          std::pmr::vector<float>& jetPullEta,
+                                          std::pmr::vector<float>& jetPullPhi
+                                         ) const
+   {
+      // Make sure that the outputs have the right size.
+      const std::size_t nJets = jetPt.size();
+      jetPullEta.resize(nJets);
+      jetPullPhi.resize(nJets);
+
+      // Run the calculation.
+      Host::calculatePulls(jetPt, jetEta, jetPhi, nConstituents, constPt, constEta, constPhi,
+                           jetPullEta, jetPullPhi, m_hostGrainSize.value());
 
       // Return gracefully.
       return StatusCode::SUCCESS;
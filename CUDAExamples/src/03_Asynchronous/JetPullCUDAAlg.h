@@ -2,15 +2,30 @@
 #ifndef CUDAEXAMPLES_JETPULLCUDAALG_H
 #define CUDAEXAMPLES_JETPULLCUDAALG_H
 
+// Local include(s).
+#include "../MemoryResources/IMemoryResourceSvc.h"
+
+// Project include(s).
+#include "GPUTutorialCore/AsyncExecutor.h"
+#include "GPUTutorialCore/EventCapture.h"
+#include "GPUTutorialCore/JetSubstructure.h"
+#include "GPUTutorialCore/OffloadDispatcher.h"
+#include "GPUTutorialCore/StageTimeline.h"
+#include "GPUTutorialCore/TransferEncoding.h"
+
 // Framework include(s).
 #include "AthenaBaseComps/AthAsynchronousAlgorithm.h"
+#include "GaudiKernel/ServiceHandle.h"
 #include "StoreGate/ReadHandleKey.h"
 #include "StoreGate/WriteHandleKey.h"
 #include "xAODJet/JetContainer.h"
 
 // System include(s).
+#include <atomic>
 #include <memory>
+#include <memory_resource>
 #include <span>
+#include <string>
 #include <vector>
 
 namespace GPUTutorial
@@ -34,9 +49,58 @@ namespace GPUTutorial
                                const std::pmr::vector<float>& constEta, ///< [in] flat array of constituent etas (grouped by jet)
                                const std::pmr::vector<float>& constPhi, ///< [in] flat array of constituent phis (grouped by jet)
                                std::pmr::vector<float>& jetPullEta, ///< [out] eta component of each jet pull vector
-                               std::pmr::vector<float>& jetPullPhi ///< [out] phi component of each jet pull vector
+                               std::pmr::vector<float>& jetPullPhi, ///< [out] phi component of each jet pull vector
+                               std::pmr::memory_resource& deviceMR, ///< [in] memory resource for the device buffers
+                               const StageContext& timing ///< [in] context to record the stage timings for
                               ) const;
 
+      /// Entry point to the CUDA portion, receiving the inputs encoded
+      ///
+      /// The encoded columns are copied to the device as they are, and are
+      /// decoded there before calculating the pulls.
+      ///
+      StatusCode deviceExecuteEncoded(const EncodedJetArrays& input, ///< [in] The encoded jet and constituent arrays
+                                      std::pmr::vector<float>& jetPullEta, ///< [out] eta component of each jet pull vector
+                                      std::pmr::vector<float>& jetPullPhi, ///< [out] phi component of each jet pull vector
+                                      std::pmr::memory_resource& deviceMR, ///< [in] memory resource for the device buffers
+                                      const StageContext& timing ///< [in] context to record the stage timings for
+                                     ) const;
+
+      /// Entry point to the host portion, with the same interface as
+      /// @c deviceExecute
+      StatusCode hostExecute(const std::span<const float>& jetPt, ///< [in] Jet pT array
+                             const std::span<const float>& jetEta, ///< [in] Jet eta array
+                             const std::span<const float>& jetPhi, ///< [in] jet phi array
+                             const std::pmr::vector<std::size_t>& nConstituents, ///< [in] number of constituents for each jet
+                             const std::pmr::vector<float>& constPt, ///< [in] flat array of constituent pTs (grouped by jet)
+                             const std::pmr::vector<float>& constEta, ///< [in] flat array of constituent etas (grouped by jet)
+                             const std::pmr::vector<float>& constPhi, ///< [in] flat array of constituent phis (grouped by jet)
+                             std::pmr::vector<float>& jetPullEta, ///< [out] eta component of each jet pull vector
+                             std::pmr::vector<float>& jetPullPhi ///< [out] phi component of each jet pull vector
+                            ) const;
+
+      /// Run the calculation on the configured backend(s), with the same
+      /// interface as @c deviceExecute
+      StatusCode runBackend(const std::span<const float>& jetPt, ///< [in] Jet pT array
+                            const std::span<const float>& jetEta, ///< [in] Jet eta array
+                            const std::span<const float>& jetPhi, ///< [in] jet phi array
+                            const std::pmr::vector<std::size_t>& nConstituents, ///< [in] number of constituents for each jet
+                            const std::pmr::vector<float>& constPt, ///< [in] flat array of constituent pTs (grouped by jet)
+                            const std::pmr::vector<float>& constEta, ///< [in] flat array of constituent etas (grouped by jet)
+                            const std::pmr::vector<float>& constPhi, ///< [in] flat array of constituent phis (grouped by jet)
+                            std::pmr::vector<float>& jetPullEta, ///< [out] eta component of each jet pull vector
+                            std::pmr::vector<float>& jetPullPhi, ///< [out] phi component of each jet pull vector
+                            std::pmr::memory_resource& hostMR, ///< [in] memory resource for temporary host arrays
+                            std::pmr::memory_resource& deviceMR, ///< [in] memory resource for the device buffers
+                            const StageContext& timing ///< [in] context to record the stage timings for
+                           ) const;
+
+      /// The context to record the stage timings of an event for
+      StageContext stageContext(const EventContext& ctx) const;
+
+      /// Set up the host/device dispatch, and the mock device if requested
+      StatusCode setupDispatcher();
+
       /// @name Functions inherited from @c AthAsynchronousAlgorithm
       /// @{
 
@@ -44,6 +108,8 @@ namespace GPUTutorial
       StatusCode initialize() override;
       /// Function executing the algorithm
       StatusCode execute(const EventContext &ctx) const override;
+      /// Function finalizing the algorithm
+      StatusCode finalize() override;
 
       /// @}
 
@@ -63,15 +129,146 @@ namespace GPUTutorial
       // SG::WriteHandleKey<double*> m_outputKey{
       //     this, "OutputContainer", "JetPullMatrix",
       //     "The output jet container with pull vectors"};
+
+      /// The backend to calculate the pulls with ("Device", "Host", "Auto" or
+      /// "Dispatch")
+      Gaudi::Property<std::string> m_backend{
+          this, "Backend", "Auto",
+          "Backend to use: \"Device\", \"Host\", \"Auto\" to use the "
+          "host when no CUDA device is available, or \"Dispatch\" to decide "
+          "in every calculation, based on the number of constituents"};
+      /// Threshold of the host/device dispatch
+      Gaudi::Property<long> m_dispatchThreshold{
+          this, "DispatchThreshold", -1,
+          "Smallest number of constituents processed on the device with "
+          "Backend=\"Dispatch\" (negative: derive it from timing runs in "
+          "initialize())"};
+      /// Use a mock device instead of the CUDA device
+      Gaudi::Property<bool> m_mockDevice{
+          this, "MockDevice", false,
+          "Run the device side of the calculation on the host, delayed like "
+          "on a slow device (for testing without an accelerator)"};
+      /// Latency of the mock device
+      Gaudi::Property<float> m_mockDeviceLatency{
+          this, "MockDeviceLatency", 20.f,
+          "Latency of every calculation on the mock device, in microseconds"};
+      /// Bandwidth of the mock device
+      Gaudi::Property<float> m_mockDeviceBandwidth{
+          this, "MockDeviceBandwidth", 10.f,
+          "Bandwidth of the transfers of the mock device, in GB/s"};
+      /// Number of threads of the mock device
+      Gaudi::Property<unsigned int> m_mockDeviceThreads{
+          this, "MockDeviceThreads", 4,
+          "Number of calculations that the mock device can run at the same "
+          "time, on a pool of host threads"};
+      /// Number of jets processed by one TBB task on the host
+      Gaudi::Property<std::size_t> m_hostGrainSize{
+          this, "HostGrainSize", 16,
+          "Number of jets processed by one TBB task in the host backend"};
+      /// Number of jets handled by one TBB task while preparing the inputs
+      Gaudi::Property<std::size_t> m_prepGrainSize{
+          this, "HostPrepGrainSize", 8,
+          "Number of jets handled by one TBB task while gathering the "
+          "constituents and writing the pull decorations"};
+      /// Cross-check the device results against the host backend
+      Gaudi::Property<bool> m_crossCheck{
+          this, "CrossCheckHost", false,
+          "Compare the results of the device backend with the host one"};
+      /// Relative tolerance of the host/device cross-check
+      Gaudi::Property<float> m_crossCheckRelTolerance{
+          this, "CrossCheckRelTolerance", 1e-4f,
+          "Relative tolerance of the host/device cross-check"};
+      /// Absolute tolerance of the host/device cross-check
+      Gaudi::Property<float> m_crossCheckAbsTolerance{
+          this, "CrossCheckAbsTolerance", 1e-5f,
+          "Absolute tolerance of the host/device cross-check"};
+      /// Gather the constituents with indexed loads from their aux stores
+      Gaudi::Property<bool> m_indexedGather{
+          this, "IndexedConstituentGather", true,
+          "Gather the constituent kinematics with indexed loads from the aux "
+          "stores of the constituent containers, instead of through the "
+          "constituents' virtual functions"};
+      /// Encoding of the inputs on the host-to-device transfers
+      Gaudi::Property<std::string> m_transferEncoding{
+          this, "TransferEncoding", "none",
+          "Encoding of the jet and constituent columns on the host-to-device "
+          "transfers, like \"eta=fixed:16,phi=fixed:16,counts=count16\" "
+          "(none: transfer the float32 / size_t arrays as they are)"};
+      /// The memory resource service
+      ServiceHandle<IMemoryResourceSvc> m_memorySvc{
+          this, "MemoryResourceSvc",
+          "GPUTutorial::CUDAMemoryResourceSvc/MemoryResourceSvc",
+          "Service providing the host and device memory resources"};
+      /// Number of events to process in a single batch
+      Gaudi::Property<std::size_t> m_batchSize{
+          this, "BatchSize", 1,
+          "Number of events to combine into a single calculation (1: no batching)"};
+      /// Maximal time an event would wait for its batch to fill up
+      Gaudi::Property<unsigned int> m_batchMaxWait{
+          this, "BatchMaxWait", 2000,
+          "Maximal time (in microseconds) an event would wait for its batch to fill up"};
+      /// Measure the time spent in the stages of the calculation
+      Gaudi::Property<bool> m_stageTiming{
+          this, "StageTiming", false,
+          "Measure the time spent in the stages of every event"};
+      /// File to write the stage timings into, as a Chrome trace
+      Gaudi::Property<std::string> m_chromeTraceFile{
+          this, "ChromeTraceFile", "",
+          "File to write the stage timings of all algorithms into, as a Chrome "
+          "trace (none if empty)"};
+      /// The jet observables to calculate
+      Gaudi::Property<std::vector<std::string>> m_observables{
+          this, "Observables", {"Pull"},
+          "Jet observables to calculate and decorate the jets with: \"Pull\", "
+          "\"Girth\", \"Width\", \"PtD\", \"C2\" and/or \"D2\". Anything "
+          "other than just \"Pull\" is calculated by a fused pass on the host"};
+      /// File to capture the offload inputs of every event into
+      Gaudi::Property<std::string> m_captureFile{
+          this, "CaptureFile", "",
+          "File to write the gathered jet and constituent arrays into, for "
+          "replaying them with gpuTutorialReplay (none if empty)"};
+
       /// @}
 
       /// @name Algorithm data members
       /// @{
 
-      /// PIMPL structure of memory resources
-      struct MemoryResources;
-      /// Memory resources used by the algorithm
-      std::unique_ptr<MemoryResources> m_memoryResources;
+      /// Identifier of the algorithm in the memory resource service
+      IMemoryResourceSvc::ClientID m_memoryClient = 0;
+
+      /// PIMPL structure for the multi-event batching
+      struct Batcher;
+      /// Helper object combining the calculations of multiple events
+      std::unique_ptr<Batcher> m_batcher;
+
+      /// Flag set when the host backend is (to be) used
+      bool m_useHost = false;
+      /// Helper deciding where to run a calculation
+      std::unique_ptr<OffloadDispatcher> m_dispatcher;
+      /// The mock device, if one is used
+      std::unique_ptr<MockDevice> m_mock;
+      /// The threads running the calculations of the mock device
+      std::unique_ptr<HostThreadPool> m_mockThreads;
+      /// The parsed transfer encoding
+      TransferEncoding m_encoding;
+      /// The parsed set of jet observables
+      JetObservableSet m_observableSet = 0;
+      /// Flag set when the observables need the fused substructure pass
+      bool m_fusedSubstructure = false;
+
+      /// Writer of the captured offload inputs, if requested (shared with
+      /// the other algorithms writing into the same file)
+      std::shared_ptr<EventCaptureWriter> m_capture;
+
+      /// Timeline to record the stage timings into
+      std::shared_ptr<StageTimeline> m_timeline;
+      /// Identifier of the algorithm on the timeline
+      std::size_t m_timingSource = 0;
+
+      /// Number of jets checked by the host/device cross-check
+      mutable std::atomic<std::size_t> m_nCrossCheckedJets{0};
+      /// Number of jets failing the host/device cross-check
+      mutable std::atomic<std::size_t> m_nCrossCheckFailures{0};
 
       /// @}
    }; // class JetPullCUDAAlg
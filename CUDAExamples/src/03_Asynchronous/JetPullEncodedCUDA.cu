@@ -0,0 +1,224 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "JetPullCUDAAlg.h"
+#include "DeviceAllocator.h"
+#include "../Timing/CUDAStageTimer.h"
+
+// Project include(s).
+#include "GPUTutorialCore/JetPull.h"
+#include "GPUTutorialCore/TransferEncodingCUDA.h"
+
+// Framework include(s).
+#include "AthenaKernel/errorcheck.h"
+
+// Gaudi include(s)
+#include "Gaudi/CUDA/CUDAStream.h"
+
+// CUDA include(s)
+#include "cub/cub.cuh"
+
+// Standard Library includes(s)
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/// Helper macro for checking CUDA calls
+#define ATH_CUDA_CHECK(EXP)                                             \
+   do                                                                   \
+   {                                                                    \
+      const cudaError_t ce = EXP;                                       \
+      if (ce != cudaSuccess)                                            \
+      {                                                                 \
+         REPORT_ERROR_WITH_CONTEXT(StatusCode::FAILURE,                 \
+                                   "GPUTutorial::JetPullCUDAAlg")       \
+             << "Failed to execute \""                                  \
+             << #EXP << "\" :"                                          \
+             << cudaGetErrorName(ce) << ": " << cudaGetErrorString(ce); \
+         return StatusCode::FAILURE;                                    \
+      }                                                                 \
+   } while (false)
+
+namespace
+{
+   /// Number of threads per block (jet) of the pull kernel
+   constexpr int BLOCKSIZE = 128;
+
+   /// The decoded jet and constituent arrays on the device
+   struct DeviceJets
+   {
+      float* jetPt = nullptr;
+      float* jetEta = nullptr;
+      float* jetPhi = nullptr;
+      std::size_t* offsets = nullptr;
+      float* constPt = nullptr;
+      float* constEta = nullptr;
+      float* constPhi = nullptr;
+   };
+
+   /// Kernel calculating the jet pulls, with one block per jet
+   __global__ void calculatePulls(DeviceJets jets, std::size_t nJets,
+                                  float* pullEta, float* pullPhi)
+   {
+      const std::size_t jetIdx = blockIdx.x;
+      if (jetIdx >= nJets) {
+         return;
+      }
+      const std::size_t begin = jets.offsets[jetIdx];
+      const std::size_t end = jets.offsets[jetIdx + 1];
+
+      const float invPt = 1.f / jets.jetPt[jetIdx];
+      float sumEta = 0.f;
+      float sumPhi = 0.f;
+      for (std::size_t c = begin + threadIdx.x; c < end; c += blockDim.x) {
+         GPUTutorial::addPullContribution(invPt, jets.jetEta[jetIdx], jets.jetPhi[jetIdx],
+                                          jets.constPt[c], jets.constEta[c], jets.constPhi[c],
+                                          sumEta, sumPhi);
+      }
+
+      using BlockReduce = cub::BlockReduce<float, BLOCKSIZE>;
+      __shared__ typename BlockReduce::TempStorage tempStorage;
+      const float resultEta = BlockReduce(tempStorage).Sum(sumEta);
+      __syncthreads(); // block sync to reuse tempStorage
+      const float resultPhi = BlockReduce(tempStorage).Sum(sumPhi);
+
+      if (threadIdx.x == 0) {
+         pullEta[jetIdx] = resultEta;
+         pullPhi[jetIdx] = GPUTutorial::wrapPhi(resultPhi);
+      }
+   }
+
+} // namespace
+
+namespace GPUTutorial
+{
+   StatusCode JetPullCUDAAlg::deviceExecuteEncoded(const EncodedJetArrays& input,
+                                                   std::pmr::vector<float>& jetPullEta,
+                                                   std::pmr::vector<float>& jetPullPhi,
+                                                   std::pmr::memory_resource& deviceMR,
+                                                   const StageContext& timing
+                                                  ) const
+   {
+      // Create our CUDA stream
+      Gaudi::CUDA::Stream stream(this);
+
+      // Setup the device allocator. Created after the stream, so that it
+      // can synchronise with the stream when it is destroyed.
+      DeviceAllocator devAlloc{deviceMR};
+      // Time the work scheduled on the stream, if requested
+      CUDAStageTimer timer(timing, stream);
+
+      const EncodedCountColumn& counts = input.nConstituents;
+      const std::size_t nJets = counts.size();
+      const std::size_t totalConstituents = input.constPt.size();
+
+      // Allocate the decoded arrays, and the pull outputs
+      DeviceJets d_jets{};
+      ATH_CUDA_CHECK(devAlloc.DeviceAllocate((void**)&d_jets.jetPt, nJets * sizeof(float), stream));
+      ATH_CUDA_CHECK(devAlloc.DeviceAllocate((void**)&d_jets.jetEta, nJets * sizeof(float), stream));
+      ATH_CUDA_CHECK(devAlloc.DeviceAllocate((void**)&d_jets.jetPhi, nJets * sizeof(float), stream));
+      ATH_CUDA_CHECK(devAlloc.DeviceAllocate((void**)&d_jets.offsets, (nJets + 1) * sizeof(std::size_t), stream));
+      ATH_CUDA_CHECK(devAlloc.DeviceAllocate((void**)&d_jets.constPt, totalConstituents * sizeof(float), stream));
+      ATH_CUDA_CHECK(devAlloc.DeviceAllocate((void**)&d_jets.constEta, totalConstituents * sizeof(float), stream));
+      ATH_CUDA_CHECK(devAlloc.DeviceAllocate((void**)&d_jets.constPhi, totalConstituents * sizeof(float), stream));
+      float* d_jetPullEta = nullptr;
+      float* d_jetPullPhi = nullptr;
+      ATH_CUDA_CHECK(devAlloc.DeviceAllocate((void**)&d_jetPullEta, nJets * sizeof(float), stream));
+      ATH_CUDA_CHECK(devAlloc.DeviceAllocate((void**)&d_jetPullPhi, nJets * sizeof(float), stream));
+
+      // Copy the columns to the device as they are. Float32 columns go
+      // straight into their final arrays, encoded ones into buffers of
+      // their own, which are decoded in the next step.
+      std::vector<std::pair<const EncodedFloatColumn*, float*>> columns{
+          {&input.jetPt, d_jets.jetPt},       {&input.jetEta, d_jets.jetEta},
+          {&input.jetPhi, d_jets.jetPhi},     {&input.constPt, d_jets.constPt},
+          {&input.constEta, d_jets.constEta}, {&input.constPhi, d_jets.constPhi}};
+      std::vector<std::uint16_t*> d_codes(columns.size(), nullptr);
+      void* d_counts = nullptr;
+      timer.start("h2d");
+      for (std::size_t i = 0; i < columns.size(); ++i) {
+         const EncodedFloatColumn& column = *(columns[i].first);
+         if (column.encoded()) {
+            ATH_CUDA_CHECK(devAlloc.DeviceAllocate((void**)&d_codes[i], column.size_bytes(), stream));
+            ATH_CUDA_CHECK(cudaMemcpyAsync(d_codes[i], column.codes.data(), column.size_bytes(),
+                                           cudaMemcpyHostToDevice, stream));
+         } else {
+            ATH_CUDA_CHECK(cudaMemcpyAsync(columns[i].second, column.values.data(),
+                                           column.size_bytes(), cudaMemcpyHostToDevice, stream));
+         }
+      }
+      switch (counts.type) {
+      case CountEncoding::Size:
+         ATH_CUDA_CHECK(cudaMemcpyAsync(d_jets.offsets, counts.sizes.data(), counts.size_bytes(),
+                                        cudaMemcpyHostToDevice, stream));
+         break;
+      case CountEncoding::Count16:
+         ATH_CUDA_CHECK(devAlloc.DeviceAllocate(&d_counts, counts.size_bytes(), stream));
+         ATH_CUDA_CHECK(cudaMemcpyAsync(d_counts, counts.counts.data(), counts.size_bytes(),
+                                        cudaMemcpyHostToDevice, stream));
+         break;
+      case CountEncoding::Offset32:
+         ATH_CUDA_CHECK(devAlloc.DeviceAllocate(&d_counts, counts.size_bytes(), stream));
+         ATH_CUDA_CHECK(cudaMemcpyAsync(d_counts, counts.offsets.data(), counts.size_bytes(),
+                                        cudaMemcpyHostToDevice, stream));
+         break;
+      }
+      timer.stop();
+
+      // Decode the columns, and widen the counts / offsets
+      timer.start("decode");
+      for (std::size_t i = 0; i < columns.size(); ++i) {
+         const EncodedFloatColumn& column = *(columns[i].first);
+         if (column.encoded()) {
+            ATH_CUDA_CHECK(CUDA::decodeColumn(column.size(), d_codes[i], column.decoder,
+                                              columns[i].second, stream));
+         }
+      }
+      if (counts.type == CountEncoding::Count16) {
+         ATH_CUDA_CHECK(CUDA::widen(nJets, static_cast<const std::uint16_t*>(d_counts),
+                                    d_jets.offsets, stream));
+      } else if (counts.type == CountEncoding::Offset32) {
+         ATH_CUDA_CHECK(CUDA::widen(nJets + 1, static_cast<const std::uint32_t*>(d_counts),
+                                    d_jets.offsets, stream));
+      }
+      timer.stop();
+
+      // Turn the counts into offsets. The 32-bit offsets arrive as offsets
+      // already, so they do not need a scan.
+      if (counts.type != CountEncoding::Offset32) {
+         timer.start("scan");
+         ATH_CUDA_CHECK(cudaMemsetAsync(d_jets.offsets + nJets, 0, sizeof(std::size_t), stream));
+         void* d_tempStorage = nullptr;
+         std::size_t tempStorageSize = 0;
+         ATH_CUDA_CHECK(cub::DeviceScan::ExclusiveSum(d_tempStorage, tempStorageSize, d_jets.offsets,
+                                                      d_jets.offsets, nJets + 1, stream));
+         ATH_CUDA_CHECK(devAlloc.DeviceAllocate(&d_tempStorage, tempStorageSize, stream));
+         ATH_CUDA_CHECK(cub::DeviceScan::ExclusiveSum(d_tempStorage, tempStorageSize, d_jets.offsets,
+                                                      d_jets.offsets, nJets + 1, stream));
+         timer.stop();
+      }
+
+      // Calculate the pulls, with one block per jet
+      timer.start("kernel");
+      calculatePulls<<<nJets, BLOCKSIZE, 0, stream>>>(d_jets, nJets, d_jetPullEta, d_jetPullPhi);
+      ATH_CUDA_CHECK(cudaGetLastError());
+      timer.stop();
+
+      // Copy back the results
+      jetPullEta.resize(nJets);
+      jetPullPhi.resize(nJets);
+      timer.start("d2h");
+      ATH_CUDA_CHECK(cudaMemcpyAsync(jetPullEta.data(), d_jetPullEta, nJets * sizeof(float),
+                                     cudaMemcpyDeviceToHost, stream));
+      ATH_CUDA_CHECK(cudaMemcpyAsync(jetPullPhi.data(), d_jetPullPhi, nJets * sizeof(float),
+                                     cudaMemcpyDeviceToHost, stream));
+      timer.stop();
+
+      // Wait for everything to finish, before the allocator releases the
+      // device buffers.
+      ATH_CHECK(stream.await());
+      timer.flush();
+      return StatusCode::SUCCESS;
+   }
+
+} // namespace GPUTutorial
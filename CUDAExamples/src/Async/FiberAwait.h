@@ -0,0 +1,43 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef CUDAEXAMPLES_FIBERAWAIT_H
+#define CUDAEXAMPLES_FIBERAWAIT_H
+
+// Project include(s).
+#include "GPUTutorialCore/AsyncExecutor.h"
+
+// Boost include(s).
+#include <boost/fiber/future.hpp>
+
+// System include(s).
+#include <exception>
+#include <memory>
+
+namespace GPUTutorial
+{
+   /// Wait for the work enqueued on an executor stream, from a fiber
+   ///
+   /// Unlike @c GPUTutorial::AsyncExecutor::Stream::wait, this only
+   /// suspends the calling fiber, leaving its thread free to run other
+   /// algorithms in the meantime. The same way as
+   /// @c Gaudi::CUDA::Stream::await does it for CUDA streams.
+   ///
+   /// @throws The first exception thrown by the work
+   ///
+   inline void awaitStream(AsyncExecutor::Stream &stream)
+   {
+      // The promise is shared with the callback, which is called from one
+      // of the executor's threads.
+      auto promise =
+          std::make_shared<boost::fibers::promise<std::exception_ptr>>();
+      boost::fibers::future<std::exception_ptr> future = promise->get_future();
+      stream.notify([promise](std::exception_ptr error)
+                    { promise->set_value(error); });
+      if (std::exception_ptr error = future.get())
+      {
+         std::rethrow_exception(error);
+      }
+   }
+
+} // namespace GPUTutorial
+
+#endif // CUDAEXAMPLES_FIBERAWAIT_H
@@ -0,0 +1,57 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "CUDAMemoryResourceSvc.h"
+
+// VecMem include(s).
+#include <vecmem/memory/cuda/device_memory_resource.hpp>
+#include <vecmem/memory/cuda/host_memory_resource.hpp>
+
+// CUDA include(s).
+#include <cuda_runtime_api.h>
+
+namespace GPUTutorial
+{
+   StatusCode CUDAMemoryResourceSvc::initialize()
+   {
+      // Check whether there's a device to use.
+      int nDevices = 0;
+      m_haveDevice = ((cudaGetDeviceCount(&nDevices) == cudaSuccess) &&
+                      (nDevices > 0));
+      // Clear the error state, if there was an error.
+      cudaGetLastError();
+      if (!m_haveDevice)
+      {
+         ATH_MSG_INFO("No CUDA device is available, using host memory only");
+      }
+
+      // Set up the resources.
+      return HostMemoryResourceSvc::initialize();
+   }
+
+   std::unique_ptr<std::pmr::memory_resource>
+   CUDAMemoryResourceSvc::makeHostMR() const
+   {
+      if (!m_haveDevice)
+      {
+         return HostMemoryResourceSvc::makeHostMR();
+      }
+      return std::make_unique<vecmem::cuda::host_memory_resource>();
+   }
+
+   std::unique_ptr<std::pmr::memory_resource>
+   CUDAMemoryResourceSvc::makeDeviceMR() const
+   {
+      if (!m_haveDevice)
+      {
+         return HostMemoryResourceSvc::makeDeviceMR();
+      }
+      return std::make_unique<vecmem::cuda::device_memory_resource>();
+   }
+
+   bool CUDAMemoryResourceSvc::deviceInHostMemory() const
+   {
+      return !m_haveDevice;
+   }
+
+} // namespace GPUTutorial
@@ -0,0 +1,43 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef CUDAEXAMPLES_CUDAMEMORYRESOURCESVC_H
+#define CUDAEXAMPLES_CUDAMEMORYRESOURCESVC_H
+
+// Local include(s).
+#include "HostMemoryResourceSvc.h"
+
+namespace GPUTutorial
+{
+   /// Memory resource service using pinned host and CUDA device memory
+   ///
+   /// On nodes without a CUDA device it falls back to plain host memory for
+   /// both resources, like @c GPUTutorial::HostMemoryResourceSvc. So that
+   /// the algorithms can still run their host code there.
+   ///
+   class CUDAMemoryResourceSvc : public HostMemoryResourceSvc
+   {
+   public:
+      /// Inherit the base class's constructor(s)
+      using HostMemoryResourceSvc::HostMemoryResourceSvc;
+
+      /// Function initializing the service
+      StatusCode initialize() override;
+
+   protected:
+      /// @name Functions overriding @c GPUTutorial::HostMemoryResourceSvc
+      /// @{
+
+      std::unique_ptr<std::pmr::memory_resource> makeHostMR() const override;
+      std::unique_ptr<std::pmr::memory_resource> makeDeviceMR() const override;
+      bool deviceInHostMemory() const override;
+
+      /// @}
+
+   private:
+      /// Whether a CUDA device is available
+      bool m_haveDevice = false;
+
+   }; // class CUDAMemoryResourceSvc
+
+} // namespace GPUTutorial
+
+#endif // CUDAEXAMPLES_CUDAMEMORYRESOURCESVC_H
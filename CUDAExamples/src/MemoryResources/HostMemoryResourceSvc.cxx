@@ -0,0 +1,345 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "HostMemoryResourceSvc.h"
+
+// Framework include(s).
+#include "GaudiKernel/ConcurrencyFlags.h"
+#include "GaudiKernel/IIncidentSvc.h"
+
+// VecMem include(s).
+#include <vecmem/memory/host_memory_resource.hpp>
+
+// System include(s).
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <string>
+
+namespace
+{
+   /// Name of a resource in the allocation profile
+   std::string profileName(const std::string &name, const std::string &type)
+   {
+      return name + "/" + type;
+   }
+
+   /// Whether a resource of the allocation profile is a device resource
+   bool isDeviceProfile(const std::string &name)
+   {
+      return name.ends_with("/device");
+   }
+
+} // namespace
+
+namespace GPUTutorial
+{
+   HostMemoryResourceSvc::Resources::Resources(
+       std::unique_ptr<std::pmr::memory_resource> upstream, std::size_t limit)
+       : m_upstream(std::move(upstream)), m_bounded(*m_upstream, limit) {}
+
+   HostMemoryResourceSvc::Arena::Arena(std::pmr::memory_resource &upstream,
+                                       std::size_t size)
+       : m_upstream(upstream), m_arena(m_upstream, size), m_requests(m_arena)
+   {
+   }
+
+   StatusCode HostMemoryResourceSvc::initialize()
+   {
+      // Set up the resources.
+      m_hostResources = std::make_unique<Resources>(
+          makeHostMR(), m_maxHostMemory.value() * 1024 * 1024);
+      m_deviceResources = std::make_unique<Resources>(
+          makeDeviceMR(), m_maxDeviceMemory.value() * 1024 * 1024);
+      m_nSlots = std::max<std::size_t>(
+          Gaudi::Concurrency::ConcurrencyFlags::numConcurrentEvents(), 1);
+      ATH_MSG_INFO("Setting up memory arenas for " << m_nSlots
+                                                   << " event slot(s)");
+
+      // Pre-warm the shared pools with the memory use of the previous job.
+      if (!m_profileFile.value().empty())
+      {
+         try
+         {
+            m_profile = AllocationProfile::read(m_profileFile.value());
+            const std::size_t hostBytes = GPUTutorial::prewarm(
+                m_hostResources->m_pool,
+                m_profile.blocks(profileName("Shared", "host")));
+            // The device memory needed on a node with a device says nothing
+            // about the memory needed on one without.
+            const std::size_t deviceBytes =
+                (deviceInHostMemory()
+                     ? 0
+                     : GPUTutorial::prewarm(
+                           m_deviceResources->m_pool,
+                           m_profile.blocks(profileName("Shared", "device"))));
+            ATH_MSG_INFO("Pre-warmed the shared pools with "
+                         << hostBytes << " bytes of host, " << deviceBytes
+                         << " bytes of device memory from "
+                         << m_profileFile.value());
+         }
+         catch (const std::exception &ex)
+         {
+            ATH_MSG_ERROR("Could not pre-warm the memory resources: "
+                          << ex.what());
+            return StatusCode::FAILURE;
+         }
+         // Only count the misses of the events in the statistics.
+         m_hostResources->m_poolUpstream.reset();
+         m_deviceResources->m_poolUpstream.reset();
+      }
+
+      // Reset the arenas at the end of every event.
+      ServiceHandle<IIncidentSvc> incidentSvc("IncidentSvc", name());
+      ATH_CHECK(incidentSvc.retrieve());
+      incidentSvc->addListener(this, IncidentType::EndEvent);
+
+      // Return gracefully.
+      return StatusCode::SUCCESS;
+   }
+
+   StatusCode HostMemoryResourceSvc::finalize()
+   {
+      // Record the memory use of the job, for the next one.
+      if (!m_profileFile.value().empty())
+      {
+         try
+         {
+            writeProfile();
+         }
+         catch (const std::exception &ex)
+         {
+            ATH_MSG_ERROR("Could not write the allocation profile: "
+                          << ex.what());
+            return StatusCode::FAILURE;
+         }
+      }
+
+      // Tell the user how much memory was needed.
+      for (const std::unique_ptr<Client> &client : m_clients)
+      {
+         Statistics host, device;
+         for (std::size_t slot = 0; slot < m_nSlots; ++slot)
+         {
+            host.m_requests += client->m_hostStats[slot].m_requests;
+            host.m_misses += client->m_hostStats[slot].m_misses;
+            host.m_events += client->m_hostStats[slot].m_events;
+            device.m_requests += client->m_deviceStats[slot].m_requests;
+            device.m_misses += client->m_deviceStats[slot].m_misses;
+            device.m_events += client->m_deviceStats[slot].m_events;
+         }
+         print(client->m_name, "host", host);
+         print(client->m_name, "device", device);
+      }
+      Statistics sharedHost, sharedDevice;
+      sharedHost.m_requests = m_hostResources->m_shared.statistics();
+      sharedHost.m_misses = m_hostResources->m_poolUpstream.statistics();
+      sharedDevice.m_requests = m_deviceResources->m_shared.statistics();
+      sharedDevice.m_misses = m_deviceResources->m_poolUpstream.statistics();
+      print("Shared", "host", sharedHost);
+      print("Shared", "device", sharedDevice);
+      ATH_MSG_INFO("Largest total use: "
+                   << m_hostResources->m_bounded.peak() << " bytes of host, "
+                   << m_deviceResources->m_bounded.peak()
+                   << " bytes of device memory");
+
+      // Release all memory.
+      m_clients.clear();
+      m_deviceResources.reset();
+      m_hostResources.reset();
+
+      // Return gracefully.
+      return StatusCode::SUCCESS;
+   }
+
+   HostMemoryResourceSvc::ClientID
+   HostMemoryResourceSvc::registerClient(const std::string &name)
+   {
+      std::lock_guard lock(m_clientMutex);
+      auto client = std::make_unique<Client>();
+      client->m_name = name;
+      for (std::size_t slot = 0; slot < m_nSlots; ++slot)
+      {
+         client->m_host.push_back(std::make_unique<Arena>(
+             m_hostResources->m_bounded, m_arenaSize.value()));
+         client->m_device.push_back(std::make_unique<Arena>(
+             m_deviceResources->m_bounded, m_arenaSize.value()));
+      }
+      client->m_hostStats.resize(m_nSlots);
+      client->m_deviceStats.resize(m_nSlots);
+      prewarm(*client);
+      m_clients.push_back(std::move(client));
+      return m_clients.size() - 1;
+   }
+
+   std::pmr::memory_resource &
+   HostMemoryResourceSvc::hostMR(ClientID client, const EventContext &ctx)
+   {
+      return m_clients[client]->m_host[ctx.slot()]->m_requests;
+   }
+
+   std::pmr::memory_resource &
+   HostMemoryResourceSvc::deviceMR(ClientID client, const EventContext &ctx)
+   {
+      return m_clients[client]->m_device[ctx.slot()]->m_requests;
+   }
+
+   std::pmr::memory_resource &HostMemoryResourceSvc::sharedHostMR()
+   {
+      return m_hostResources->m_shared;
+   }
+
+   std::pmr::memory_resource &HostMemoryResourceSvc::sharedDeviceMR()
+   {
+      return m_deviceResources->m_shared;
+   }
+
+   void HostMemoryResourceSvc::handle(const Incident &incident)
+   {
+      // All clients are done with the event in this slot.
+      const std::size_t slot = incident.context().slot();
+      for (const std::unique_ptr<Client> &client : m_clients)
+      {
+         endEvent(client->m_name, "host", *(client->m_host[slot]),
+                  client->m_hostStats[slot]);
+         endEvent(client->m_name, "device", *(client->m_device[slot]),
+                  client->m_deviceStats[slot]);
+      }
+   }
+
+   void HostMemoryResourceSvc::endEvent(const std::string &name,
+                                        const std::string &type, Arena &arena,
+                                        Statistics &total)
+   {
+      // Reset the arena, and collect the statistics of the event. Including
+      // the re-allocation done by the arena's reset.
+      arena.m_arena.reset();
+      Statistics event;
+      event.m_requests = arena.m_requests.reset();
+      event.m_misses = arena.m_upstream.reset();
+      event.m_events = 1;
+
+      // Print them if requested.
+      if (m_dumpPerEvent.value())
+      {
+         print(name, type, event);
+      }
+
+      // Add them to the total.
+      total.m_requests += event.m_requests;
+      total.m_misses += event.m_misses;
+      total.m_events += event.m_events;
+   }
+
+   void HostMemoryResourceSvc::prewarm(Client &client)
+   {
+      auto reserve = [&](const std::string &type,
+                         std::vector<std::unique_ptr<Arena>> &arenas)
+      {
+         const std::size_t bytes = AllocationProfile::bytes(
+             m_profile.blocks(profileName(client.m_name, type)));
+         if (bytes == 0)
+         {
+            return;
+         }
+         for (const std::unique_ptr<Arena> &arena : arenas)
+         {
+            arena->m_arena.reserve(bytes);
+            // Only count the misses of the events in the statistics.
+            arena->m_upstream.reset();
+         }
+         ATH_MSG_DEBUG("Pre-warmed the " << type << " arenas of "
+                       << client.m_name << " with " << bytes << " bytes");
+      };
+      reserve("host", client.m_host);
+      if (!deviceInHostMemory())
+      {
+         reserve("device", client.m_device);
+      }
+   }
+
+   void HostMemoryResourceSvc::writeProfile() const
+   {
+      // Every arena needs (a single chunk of) the most memory that any of
+      // the client's arenas used in an event. Without a device, the device
+      // entries of the previous job are kept as they were.
+      AllocationProfile profile;
+      if (deviceInHostMemory())
+      {
+         for (const auto &[resource, blocks] : m_profile.resources())
+         {
+            if (isDeviceProfile(resource))
+            {
+               profile.set(resource, blocks);
+            }
+         }
+      }
+      auto arenaPeak = [](const std::vector<std::unique_ptr<Arena>> &arenas)
+      {
+         std::size_t result = 0;
+         for (const std::unique_ptr<Arena> &arena : arenas)
+         {
+            result = std::max(result, arena->m_arena.peak());
+         }
+         return AllocationProfile::Histogram{{result, 1}};
+      };
+      for (const std::unique_ptr<Client> &client : m_clients)
+      {
+         profile.set(profileName(client->m_name, "host"),
+                     arenaPeak(client->m_host));
+         if (!deviceInHostMemory())
+         {
+            profile.set(profileName(client->m_name, "device"),
+                        arenaPeak(client->m_device));
+         }
+      }
+      // The pools need the blocks that were used at the same time.
+      profile.set(profileName("Shared", "host"),
+                  m_hostResources->m_recorder.histogram());
+      if (!deviceInHostMemory())
+      {
+         profile.set(profileName("Shared", "device"),
+                     m_deviceResources->m_recorder.histogram());
+      }
+      profile.write(m_profileFile.value());
+      ATH_MSG_INFO("Wrote the allocation profile of the job to "
+                   << m_profileFile.value());
+   }
+
+   void HostMemoryResourceSvc::print(const std::string &name,
+                                     const std::string &type,
+                                     const Statistics &stats) const
+   {
+      using fmilliseconds = std::chrono::duration<double, std::milli>;
+      const std::size_t hits =
+          std::max(stats.m_requests.allocations, stats.m_misses.allocations) -
+          stats.m_misses.allocations;
+      ATH_MSG_INFO(name << " (" << type << "): "
+                   << stats.m_requests.allocations << " allocations of "
+                   << stats.m_requests.bytes << " bytes in " << stats.m_events
+                   << " event(s), peak " << stats.m_requests.peak
+                   << " bytes, " << hits << " hits / "
+                   << stats.m_misses.allocations << " misses ("
+                   << stats.m_misses.bytes << " bytes), "
+                   << fmilliseconds(stats.m_requests.time).count()
+                   << " ms allocating");
+   }
+
+   std::unique_ptr<std::pmr::memory_resource>
+   HostMemoryResourceSvc::makeHostMR() const
+   {
+      return std::make_unique<vecmem::host_memory_resource>();
+   }
+
+   std::unique_ptr<std::pmr::memory_resource>
+   HostMemoryResourceSvc::makeDeviceMR() const
+   {
+      return std::make_unique<vecmem::host_memory_resource>();
+   }
+
+   bool HostMemoryResourceSvc::deviceInHostMemory() const
+   {
+      return true;
+   }
+
+} // namespace GPUTutorial
@@ -0,0 +1,219 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef CUDAEXAMPLES_HOSTMEMORYRESOURCESVC_H
+#define CUDAEXAMPLES_HOSTMEMORYRESOURCESVC_H
+
+// Local include(s).
+#include "IMemoryResourceSvc.h"
+
+// Project include(s).
+#include "GPUTutorialCore/AllocationProfile.h"
+#include "GPUTutorialCore/ArenaMemoryResource.h"
+#include "GPUTutorialCore/BoundedMemoryResource.h"
+#include "GPUTutorialCore/InstrumentedMemoryResource.h"
+
+// Framework include(s).
+#include "AthenaBaseComps/AthService.h"
+#include "GaudiKernel/IIncidentListener.h"
+
+// VecMem include(s).
+#include <vecmem/memory/pool_memory_resource.hpp>
+#include <vecmem/memory/synchronized_memory_resource.hpp>
+
+// System include(s).
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace GPUTutorial
+{
+   /// Memory resource service using only host memory
+   ///
+   /// Both the "host" and the "device" resources of this implementation are
+   /// in plain host memory. It can be used by jobs that run all of their
+   /// calculations on the host. Implementations for devices override the
+   /// functions creating the upstream memory resources.
+   ///
+   /// Every resource handed out by the service is instrumented, as is the
+   /// upstream of every arena and pool. So the service knows how much
+   /// memory every client requested in every event, and how many of those
+   /// requests could not be served from memory already held by the arenas
+   /// and pools (misses). A summary is printed in @c finalize(), and with
+   /// @c DumpPerEvent also at the end of every event.
+   ///
+   /// With an @c AllocationProfile file the service also records the
+   /// largest amount of memory used by every arena in one event, and the
+   /// blocks used at the same time from the shared pools, and writes them
+   /// into the file in @c finalize(). The next job reads the file in
+   /// @c initialize(), and allocates all of that memory up front. So its
+   /// first events do not pay for the (slow) upstream allocations. The
+   /// "device" entries of the file are only used (and updated) if the device
+   /// resource is not in host memory. So a profile written on a node with a
+   /// device does not make a job on a host-only node allocate the device
+   /// memory of that job, and is not overwritten by it either.
+   ///
+   class HostMemoryResourceSvc
+       : public extends<AthService, IMemoryResourceSvc, IIncidentListener>
+   {
+   public:
+      /// Inherit the base class's constructor(s)
+      using extends::extends;
+
+      /// @name Functions inherited from @c AthService
+      /// @{
+
+      /// Function initializing the service
+      StatusCode initialize() override;
+      /// Function finalizing the service
+      StatusCode finalize() override;
+
+      /// @}
+
+      /// @name Functions implementing @c GPUTutorial::IMemoryResourceSvc
+      /// @{
+
+      ClientID registerClient(const std::string &name) override;
+      std::pmr::memory_resource &hostMR(ClientID client,
+                                        const EventContext &ctx) override;
+      std::pmr::memory_resource &deviceMR(ClientID client,
+                                          const EventContext &ctx) override;
+      std::pmr::memory_resource &sharedHostMR() override;
+      std::pmr::memory_resource &sharedDeviceMR() override;
+
+      /// @}
+
+      /// Function resetting the arenas of a slot at the end of every event
+      void handle(const Incident &incident) override;
+
+   protected:
+      /// Create the upstream host memory resource
+      virtual std::unique_ptr<std::pmr::memory_resource> makeHostMR() const;
+      /// Create the upstream device memory resource
+      virtual std::unique_ptr<std::pmr::memory_resource> makeDeviceMR() const;
+      /// Whether the device memory resource is in host memory
+      virtual bool deviceInHostMemory() const;
+
+   private:
+      /// @name Service properties
+      /// @{
+
+      /// Maximal amount of host memory to use
+      Gaudi::Property<std::size_t> m_maxHostMemory{
+          this, "MaxHostMemory", 0,
+          "Maximal amount of host memory (in MB) to use in the job (0: no "
+          "limit)"};
+      /// Maximal amount of device memory to use
+      Gaudi::Property<std::size_t> m_maxDeviceMemory{
+          this, "MaxDeviceMemory", 0,
+          "Maximal amount of device memory (in MB) to use in the job (0: no "
+          "limit)"};
+      /// Initial size of the arenas
+      Gaudi::Property<std::size_t> m_arenaSize{
+          this, "ArenaSize", 1024 * 1024,
+          "Initial size (in bytes) of the host and device arenas"};
+      /// Print the memory statistics of every event
+      Gaudi::Property<bool> m_dumpPerEvent{
+          this, "DumpPerEvent", false,
+          "Print the memory statistics of every client in every event"};
+      /// File with the memory use of the previous job
+      Gaudi::Property<std::string> m_profileFile{
+          this, "AllocationProfile", "",
+          "File with the memory use of an earlier job, to pre-warm the arenas "
+          "and pools with in initialize(). The memory use of this job is "
+          "written into it in finalize(). (Not used if empty.)"};
+
+      /// @}
+
+      /// Memory resources of one type of memory
+      struct Resources
+      {
+         /// Constructor with the upstream resource and the limit
+         Resources(std::unique_ptr<std::pmr::memory_resource> upstream,
+                   std::size_t limit);
+         /// The upstream memory resource
+         std::unique_ptr<std::pmr::memory_resource> m_upstream;
+         /// Resource enforcing the memory limit
+         BoundedMemoryResource m_bounded;
+         /// Instrumentation of the pool's upstream
+         InstrumentedMemoryResource m_poolUpstream{m_bounded};
+         /// Cached resource, for the shared allocations
+         vecmem::pool_memory_resource m_pool{m_poolUpstream};
+         /// Recording of the blocks taken from the pool
+         AllocationRecorder m_recorder{m_pool};
+         /// Shared, thread-safe resource
+         vecmem::synchronized_memory_resource m_synchronized{m_recorder};
+         /// Instrumentation of the shared resource
+         InstrumentedMemoryResource m_shared{m_synchronized};
+      };
+      /// The (instrumented) arena of one client, in one slot
+      struct Arena
+      {
+         /// Constructor with the upstream resource and the initial size
+         Arena(std::pmr::memory_resource &upstream, std::size_t size);
+         /// Instrumentation of the arena's upstream
+         InstrumentedMemoryResource m_upstream;
+         /// The arena itself
+         ArenaMemoryResource m_arena;
+         /// Instrumentation of the arena
+         InstrumentedMemoryResource m_requests;
+      };
+      /// Memory statistics of one client, for one type of memory
+      struct Statistics
+      {
+         /// Statistics of the requests
+         InstrumentedMemoryResource::Statistics m_requests;
+         /// Statistics of the requests that the arenas could not serve
+         InstrumentedMemoryResource::Statistics m_misses;
+         /// Number of events the statistics were collected in
+         std::size_t m_events = 0;
+      };
+      /// The arenas of one client
+      struct Client
+      {
+         /// Name of the client
+         std::string m_name;
+         /// Host memory arenas, one per slot
+         std::vector<std::unique_ptr<Arena>> m_host;
+         /// Device memory arenas, one per slot
+         std::vector<std::unique_ptr<Arena>> m_device;
+         /// Host memory statistics, one per slot
+         std::vector<Statistics> m_hostStats;
+         /// Device memory statistics, one per slot
+         std::vector<Statistics> m_deviceStats;
+      };
+
+      /// Reset an arena at the end of an event, collecting its statistics
+      void endEvent(const std::string &name, const std::string &type,
+                    Arena &arena, Statistics &total);
+      /// Pre-warm the arenas of a new client, from the allocation profile
+      void prewarm(Client &client);
+      /// Write the memory use of the job into the allocation profile file
+      void writeProfile() const;
+      /// Print a summary of some statistics
+      void print(const std::string &name, const std::string &type,
+                 const Statistics &stats) const;
+
+      /// @name Service data members
+      /// @{
+
+      /// Host memory resources
+      std::unique_ptr<Resources> m_hostResources;
+      /// Device memory resources
+      std::unique_ptr<Resources> m_deviceResources;
+      /// Memory use of the previous job
+      AllocationProfile m_profile;
+      /// Number of event slots in the job
+      std::size_t m_nSlots = 1;
+      /// Mutex protecting the client registration
+      std::mutex m_clientMutex;
+      /// The clients of the service
+      std::vector<std::unique_ptr<Client>> m_clients;
+
+      /// @}
+
+   }; // class HostMemoryResourceSvc
+
+} // namespace GPUTutorial
+
+#endif // CUDAEXAMPLES_HOSTMEMORYRESOURCESVC_H
@@ -0,0 +1,57 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef CUDAEXAMPLES_IMEMORYRESOURCESVC_H
+#define CUDAEXAMPLES_IMEMORYRESOURCESVC_H
+
+// Framework include(s).
+#include "GaudiKernel/EventContext.h"
+#include "GaudiKernel/IService.h"
+
+// System include(s).
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+
+namespace GPUTutorial
+{
+   /// Interface for the service providing memory resources to algorithms
+   ///
+   /// Every algorithm (client) receives its own memory arena for every
+   /// event slot, in host and in device memory. The arenas are not shared
+   /// between clients or slots, so no locking is needed to allocate from
+   /// them, and all of their memory is released at the end of every event.
+   /// Memory that has to outlive an event (like conditions data, or data
+   /// shared between the events of a batch) should be allocated from the
+   /// shared, thread-safe resources.
+   ///
+   class IMemoryResourceSvc : virtual public IService
+   {
+   public:
+      /// Declare the interface ID
+      DeclareInterfaceID(GPUTutorial::IMemoryResourceSvc, 1, 0);
+
+      /// Type identifying the clients of the service
+      using ClientID = std::size_t;
+
+      /// Register a client, setting up its arenas
+      ///
+      /// Should be called in the @c initialize() function of the client.
+      ///
+      virtual ClientID registerClient(const std::string &name) = 0;
+
+      /// Host memory arena of a client, for the current event
+      virtual std::pmr::memory_resource &hostMR(ClientID client,
+                                                const EventContext &ctx) = 0;
+      /// Device memory arena of a client, for the current event
+      virtual std::pmr::memory_resource &deviceMR(ClientID client,
+                                                  const EventContext &ctx) = 0;
+
+      /// Shared (thread-safe) host memory resource
+      virtual std::pmr::memory_resource &sharedHostMR() = 0;
+      /// Shared (thread-safe) device memory resource
+      virtual std::pmr::memory_resource &sharedDeviceMR() = 0;
+
+   }; // class IMemoryResourceSvc
+
+} // namespace GPUTutorial
+
+#endif // CUDAEXAMPLES_IMEMORYRESOURCESVC_H
@@ -0,0 +1,77 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "CUDAStageTimer.h"
+
+// System include(s).
+#include <chrono>
+
+namespace GPUTutorial
+{
+   CUDAStageTimer::CUDAStageTimer(const StageContext &context,
+                                  cudaStream_t stream)
+       : m_context(context), m_stream(stream) {}
+
+   CUDAStageTimer::~CUDAStageTimer()
+   {
+      for (const Stage &stage : m_stages)
+      {
+         cudaEventDestroy(stage.start);
+         cudaEventDestroy(stage.stop);
+      }
+   }
+
+   void CUDAStageTimer::start(const char *name)
+   {
+      if (!m_context.enabled())
+      {
+         return;
+      }
+      Stage stage{name, StageTimeline::Clock::now()};
+      if ((cudaEventCreate(&stage.start) != cudaSuccess) ||
+          (cudaEventCreate(&stage.stop) != cudaSuccess) ||
+          (cudaEventRecord(stage.start, m_stream) != cudaSuccess))
+      {
+         cudaGetLastError();
+      }
+      m_stages.push_back(stage);
+   }
+
+   void CUDAStageTimer::stop()
+   {
+      if (m_stages.empty())
+      {
+         return;
+      }
+      if (cudaEventRecord(m_stages.back().stop, m_stream) != cudaSuccess)
+      {
+         cudaGetLastError();
+      }
+   }
+
+   void CUDAStageTimer::flush()
+   {
+      for (const Stage &stage : m_stages)
+      {
+         float milliseconds = 0.f;
+         if (cudaEventElapsedTime(&milliseconds, stage.start, stage.stop) !=
+             cudaSuccess)
+         {
+            cudaGetLastError();
+            continue;
+         }
+         m_context.record(
+             stage.name, stage.scheduled,
+             std::chrono::duration_cast<StageTimeline::Clock::duration>(
+                 std::chrono::duration<float, std::milli>(milliseconds)),
+             StageTimeline::Track::Device);
+      }
+      for (const Stage &stage : m_stages)
+      {
+         cudaEventDestroy(stage.start);
+         cudaEventDestroy(stage.stop);
+      }
+      m_stages.clear();
+   }
+
+} // namespace GPUTutorial
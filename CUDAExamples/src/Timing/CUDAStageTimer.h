@@ -0,0 +1,71 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef CUDAEXAMPLES_CUDASTAGETIMER_H
+#define CUDAEXAMPLES_CUDASTAGETIMER_H
+
+// Project include(s).
+#include "GPUTutorialCore/StageTimeline.h"
+
+// CUDA include(s).
+#include <cuda_runtime_api.h>
+
+// System include(s).
+#include <vector>
+
+namespace GPUTutorial
+{
+   /// Helper timing the stages of the work scheduled on a CUDA stream
+   ///
+   /// The start and end of every stage are marked with CUDA events on the
+   /// stream. The durations are only read out by @c flush(), which must be
+   /// called once the stream was synchronised. The stages are placed on the
+   /// timeline at the (host) time that they were scheduled at.
+   ///
+   /// Timing is best-effort, CUDA errors in it are ignored. With a disabled
+   /// context the helper does nothing.
+   ///
+   class CUDAStageTimer
+   {
+   public:
+      /// Constructor with the context to record for, and the stream to time
+      CUDAStageTimer(const StageContext &context, cudaStream_t stream);
+      /// Destructor, releasing the CUDA events
+      ~CUDAStageTimer();
+
+      /// The timer can not be copied
+      CUDAStageTimer(const CUDAStageTimer &) = delete;
+      /// The timer can not be assigned
+      CUDAStageTimer &operator=(const CUDAStageTimer &) = delete;
+
+      /// Mark the start of a stage on the stream
+      void start(const char *stage);
+      /// Mark the end of the current stage on the stream
+      void stop();
+      /// Record the durations of the (finished) stages on the timeline
+      void flush();
+
+   private:
+      /// One timed stage
+      struct Stage
+      {
+         /// The name of the stage
+         const char *name = nullptr;
+         /// The host time that the stage was scheduled at
+         StageTimeline::Clock::time_point scheduled;
+         /// The event marking the start of the stage
+         cudaEvent_t start = nullptr;
+         /// The event marking the end of the stage
+         cudaEvent_t stop = nullptr;
+      };
+
+      /// The context to record the stages for
+      const StageContext &m_context;
+      /// The stream being timed
+      cudaStream_t m_stream;
+      /// The stages timed so far
+      std::vector<Stage> m_stages;
+
+   }; // class CUDAStageTimer
+
+} // namespace GPUTutorial
+
+#endif // CUDAEXAMPLES_CUDASTAGETIMER_H
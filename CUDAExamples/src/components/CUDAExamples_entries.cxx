@@ -4,9 +4,13 @@
 #include "../01_LinearTransform/LinearTransformCUDAAlg.h"
 #include "../02_xAODCalib/ElectronCalibCUDAAlg.h"
 #include "../03_Asynchronous/JetPullCUDAAlg.h"
+#include "../MemoryResources/CUDAMemoryResourceSvc.h"
+#include "../MemoryResources/HostMemoryResourceSvc.h"
 
 // Declare the component(s).
 DECLARE_COMPONENT(GPUTutorial::LinearTransformCUDAAlg)
 DECLARE_COMPONENT(GPUTutorial::ElectronCalibCUDAAlg)
 DECLARE_COMPONENT(GPUTutorial::JetPullCUDAAlg)
+DECLARE_COMPONENT(GPUTutorial::HostMemoryResourceSvc)
+DECLARE_COMPONENT(GPUTutorial::CUDAMemoryResourceSvc)
 
@@ -0,0 +1,131 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_ALLOCATIONPROFILE_H
+#define GPUTUTORIALCORE_ALLOCATIONPROFILE_H
+
+// System include(s).
+#include <cstddef>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+
+namespace GPUTutorial
+{
+   /// The memory blocks needed by a set of memory resources in a job
+   ///
+   /// For every (named) memory resource it holds a histogram of the blocks
+   /// that were in use at the same time, per size class. A later job can
+   /// allocate these blocks up front, while it is initialized, instead of
+   /// in its first events (see @c GPUTutorial::prewarm).
+   ///
+   /// Profiles are stored in plain text files, with one
+   /// "resource<TAB>block size<TAB>blocks" line per size class.
+   ///
+   class AllocationProfile
+   {
+   public:
+      /// Number of blocks, per block size
+      using Histogram = std::map<std::size_t, std::size_t>;
+
+      /// The size class of an allocation: the next power of two, but at
+      /// least 256 bytes
+      static std::size_t sizeClass(std::size_t bytes);
+      /// Total size of the blocks of a histogram
+      static std::size_t bytes(const Histogram &blocks);
+
+      /// Set the blocks of a resource (an empty histogram removes it)
+      void set(const std::string &resource, Histogram blocks);
+      /// The blocks of a resource (empty for an unknown resource)
+      const Histogram &blocks(const std::string &resource) const;
+      /// The blocks of all resources
+      const std::map<std::string, Histogram> &resources() const
+      {
+         return m_resources;
+      }
+      /// Whether the profile holds no blocks at all
+      bool empty() const { return m_resources.empty(); }
+
+      /// Read a profile from a file
+      ///
+      /// A missing file is treated as an empty profile, as it is the normal
+      /// situation in the first job using it.
+      ///
+      /// @throws std::runtime_error if an existing file can not be parsed
+      ///
+      static AllocationProfile read(const std::string &fileName);
+      /// Write the profile into a file, replacing its current content
+      ///
+      /// @throws std::invalid_argument for resource names that can not be
+      ///         written
+      /// @throws std::runtime_error if the file can not be written
+      ///
+      void write(const std::string &fileName) const;
+
+   private:
+      /// The blocks of every resource
+      std::map<std::string, Histogram> m_resources;
+
+   }; // class AllocationProfile
+
+   /// Memory resource recording the blocks in use, per size class
+   ///
+   /// It keeps track of how many blocks of every size class
+   /// (@c GPUTutorial::AllocationProfile::sizeClass) are in use, and of
+   /// the largest number of them used at the same time. Placed on top of a
+   /// pool, the latter is the number of blocks that the pool needs to serve
+   /// the job without allocating from its upstream.
+   ///
+   /// The resource is thread-safe if its upstream resource is.
+   ///
+   class AllocationRecorder : public std::pmr::memory_resource
+   {
+   public:
+      /// Constructor with the upstream resource
+      explicit AllocationRecorder(std::pmr::memory_resource &upstream);
+
+      /// The largest number of blocks used at the same time, per size class
+      AllocationProfile::Histogram histogram() const;
+
+   private:
+      /// @name Functions implementing @c std::pmr::memory_resource
+      /// @{
+      void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+      void do_deallocate(void *p, std::size_t bytes,
+                         std::size_t alignment) override;
+      bool do_is_equal(
+          const std::pmr::memory_resource &other) const noexcept override;
+      /// @}
+
+      /// Use of one size class
+      struct Blocks
+      {
+         /// Number of blocks currently in use
+         std::size_t inUse = 0;
+         /// Largest number of blocks in use at the same time
+         std::size_t peak = 0;
+      };
+
+      /// The upstream memory resource
+      std::pmr::memory_resource &m_upstream;
+      /// Mutex protecting the histogram
+      mutable std::mutex m_mutex;
+      /// Use of every size class, indexed by the size of the class
+      std::map<std::size_t, Blocks> m_blocks;
+
+   }; // class AllocationRecorder
+
+   /// Allocate the blocks of a histogram from a caching memory resource
+   ///
+   /// All of the blocks are allocated at the same time, and are then given
+   /// back to the resource. So a pool keeps them for its later
+   /// allocations, and does not need to ask its upstream resource for
+   /// memory until more blocks are used than in the profiled job.
+   ///
+   /// @return The number of bytes allocated
+   ///
+   std::size_t prewarm(std::pmr::memory_resource &mr,
+                       const AllocationProfile::Histogram &blocks);
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_ALLOCATIONPROFILE_H
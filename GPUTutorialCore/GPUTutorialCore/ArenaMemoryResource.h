@@ -0,0 +1,106 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_ARENAMEMORYRESOURCE_H
+#define GPUTUTORIALCORE_ARENAMEMORYRESOURCE_H
+
+// System include(s).
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+namespace GPUTutorial
+{
+   /// Arena ("bump") memory resource, releasing all memory at once
+   ///
+   /// Memory is handed out from large chunks, taken from an upstream
+   /// resource, by atomically moving an offset in the current chunk. So
+   /// allocations are lock-free, unless a new chunk is needed. Individual
+   /// deallocations are no-ops, all memory is given back with @c reset().
+   ///
+   /// When more than one chunk was needed between two resets, @c reset()
+   /// replaces them with a single chunk that is large enough for all of
+   /// them. So after a few events the arena settles on one chunk, and
+   /// stops allocating from its upstream resource.
+   ///
+   /// The arena never accesses the memory that it hands out, so it can be
+   /// used with device memory as well.
+   ///
+   class ArenaMemoryResource : public std::pmr::memory_resource
+   {
+   public:
+      /// Constructor with the upstream resource and the initial chunk size
+      ///
+      /// The first chunk is only allocated with the first allocation.
+      ///
+      ArenaMemoryResource(std::pmr::memory_resource &upstream,
+                          std::size_t chunkSize = 1024 * 1024);
+      /// Destructor, giving all chunks back to the upstream resource
+      ~ArenaMemoryResource() override;
+
+      /// Release all allocations made since the previous reset
+      ///
+      /// Must not be called concurrently with any allocation.
+      ///
+      void reset();
+      /// Make sure that the arena holds a single chunk of at least some size
+      ///
+      /// Lets the arena allocate the memory that it will need up front,
+      /// instead of growing to that size in the first events. Must not be
+      /// called concurrently with any allocation, or while any memory
+      /// allocated from the arena is still in use.
+      ///
+      void reserve(std::size_t bytes);
+
+      /// Total size of the chunks held by the arena
+      std::size_t capacity() const;
+      /// Largest amount of memory allocated between two resets
+      std::size_t peak() const { return m_peak; }
+
+   private:
+      /// One chunk of memory
+      struct Chunk
+      {
+         /// The memory of the chunk
+         std::byte *data = nullptr;
+         /// The size of the chunk
+         std::size_t size = 0;
+         /// The number of bytes already handed out from the chunk
+         std::atomic<std::size_t> used{0};
+      };
+
+      /// @name Functions implementing @c std::pmr::memory_resource
+      /// @{
+      void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+      void do_deallocate(void *, std::size_t, std::size_t) override {}
+      bool do_is_equal(
+          const std::pmr::memory_resource &other) const noexcept override;
+      /// @}
+
+      /// Try to allocate memory from one chunk
+      static void *tryAllocate(Chunk &chunk, std::size_t bytes,
+                               std::size_t alignment);
+      /// Add a new chunk to the arena, large enough for some allocation
+      void addChunk(std::size_t bytes);
+      /// Give all chunks back to the upstream resource
+      void releaseChunks();
+
+      /// The upstream memory resource
+      std::pmr::memory_resource &m_upstream;
+      /// Size of the first chunk
+      std::size_t m_chunkSize;
+      /// All chunks of the arena
+      std::vector<std::unique_ptr<Chunk>> m_chunks;
+      /// The chunk currently being allocated from
+      std::atomic<Chunk *> m_current{nullptr};
+      /// Mutex protecting the addition of new chunks
+      std::mutex m_chunkMutex;
+      /// Largest amount of memory allocated between two resets
+      std::size_t m_peak = 0;
+
+   }; // class ArenaMemoryResource
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_ARENAMEMORYRESOURCE_H
@@ -0,0 +1,138 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_ASYNCEXECUTOR_H
+#define GPUTUTORIALCORE_ASYNCEXECUTOR_H
+
+// System include(s).
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace GPUTutorial
+{
+   /// Interface for running work asynchronously with respect to its caller
+   ///
+   /// Work is enqueued on streams. The work of one stream is run in the
+   /// order that it was enqueued in, while different streams may progress
+   /// concurrently. The same way as the work on CUDA streams, or on in-order
+   /// SYCL queues.
+   ///
+   /// The completion of the work is signalled through callbacks, so that
+   /// the caller can wait for it in whatever way suits its threading model.
+   /// Like blocking a thread with @c Stream::wait, or suspending a fiber.
+   ///
+   class AsyncExecutor
+   {
+   public:
+      /// A piece of work to run
+      using Work = std::function<void()>;
+      /// Function called once all the work of a stream finished
+      ///
+      /// It receives the first exception thrown by the work since the last
+      /// callback, or a null pointer if all of it succeeded. It must not
+      /// throw.
+      ///
+      using Callback = std::function<void(std::exception_ptr)>;
+
+      /// A sequence of work, run in order
+      class Stream
+      {
+      public:
+         /// Virtual destructor
+         virtual ~Stream() = default;
+
+         /// Enqueue some work, to run after all work enqueued before it
+         ///
+         /// Once some work failed, the rest of the work is skipped until
+         /// the failure was reported to a callback.
+         ///
+         virtual void enqueue(Work work) = 0;
+         /// Call a function once all work enqueued so far finished
+         ///
+         /// The callback may be called from any thread, including the
+         /// calling one before this function returns.
+         ///
+         virtual void notify(Callback callback) = 0;
+
+         /// Block the calling thread until all enqueued work finished
+         ///
+         /// @throws The first exception thrown by the work
+         ///
+         void wait();
+      };
+
+      /// Virtual destructor
+      virtual ~AsyncExecutor() = default;
+
+      /// Name of the executor, as used in reports
+      virtual std::string name() const = 0;
+      /// Create a new stream
+      virtual std::unique_ptr<Stream> makeStream() = 0;
+
+   }; // class AsyncExecutor
+
+   /// Executor running the work of its streams on a pool of host threads
+   ///
+   /// Every stream runs at most one of its pieces of work at a time, and
+   /// gives up its thread after every piece, so that many streams can share
+   /// a few threads fairly. Destroying a stream waits for its work to
+   /// finish, destroying the pool finishes all of the enqueued work.
+   ///
+   class HostThreadPool final : public AsyncExecutor
+   {
+   public:
+      /// Constructor with the number of threads to use
+      ///
+      /// @throws std::invalid_argument for zero threads
+      ///
+      explicit HostThreadPool(std::size_t nThreads);
+      /// Destructor, joining the threads
+      ~HostThreadPool() override;
+
+      /// The pool can not be copied
+      HostThreadPool(const HostThreadPool &) = delete;
+      /// The pool can not be assigned
+      HostThreadPool &operator=(const HostThreadPool &) = delete;
+
+      /// @name Functions implementing @c GPUTutorial::AsyncExecutor
+      /// @{
+
+      std::string name() const override;
+      std::unique_ptr<Stream> makeStream() override;
+
+      /// @}
+
+      /// The number of threads in the pool
+      std::size_t size() const { return m_threads.size(); }
+
+   private:
+      /// The stream implementation
+      class PoolStream;
+
+      /// Schedule a task on one of the threads
+      void post(std::function<void()> task);
+      /// Function run by the threads
+      void run();
+
+      /// Mutex protecting the task queue
+      std::mutex m_mutex;
+      /// Condition signalling new tasks, or the end of the pool
+      std::condition_variable m_condition;
+      /// The tasks waiting for a thread
+      std::deque<std::function<void()>> m_tasks;
+      /// Flag telling the threads to finish
+      bool m_stop = false;
+      /// The threads of the pool
+      std::vector<std::thread> m_threads;
+
+   }; // class HostThreadPool
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_ASYNCEXECUTOR_H
@@ -0,0 +1,455 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_BENCHMARK_H
+#define GPUTUTORIALCORE_BENCHMARK_H
+
+// Local include(s).
+#include "GPUTutorialCore/AllocationProfile.h"
+#include "GPUTutorialCore/ElectronCalibrationTable.h"
+#include "GPUTutorialCore/EventCapture.h"
+#include "GPUTutorialCore/JetArrays.h"
+#include "GPUTutorialCore/SegmentedReduction.h"
+#include "GPUTutorialCore/SyntheticEvents.h"
+#include "GPUTutorialCore/TransferEncoding.h"
+
+// System include(s).
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace GPUTutorial
+{
+   namespace Benchmark
+   {
+      /// Clock used for all host side time measurements
+      using Clock = std::chrono::steady_clock;
+      /// Type used to accumulate durations
+      using Duration = std::chrono::duration<double>;
+
+      /// Time spent in, and data moved by, one stage of a calculation
+      struct StageResult
+      {
+         /// Total time spent in the stage
+         Duration time{0.};
+         /// Total number of bytes moved/processed by the stage
+         std::size_t bytes = 0;
+
+         /// Accumulate results
+         StageResult &operator+=(const StageResult &rhs);
+      };
+
+      /// Results of all the stages of a calculation
+      struct StageResults
+      {
+         /// Host objects -> (pinned) host arrays
+         StageResult gather;
+         /// Host <-> device copies (in both directions)
+         StageResult transfer;
+         /// Kernel(s) on the device, or the equivalent host code
+         StageResult compute;
+         /// Host arrays -> host objects
+         StageResult scatter;
+
+         /// Accumulate results
+         StageResults &operator+=(const StageResults &rhs);
+      };
+
+      /// Helper function timing one piece of host code
+      template <typename FUNC>
+      void timeStage(StageResult &result, std::size_t bytes, FUNC &&func)
+      {
+         const Clock::time_point start = Clock::now();
+         func();
+         result.time += Clock::now() - start;
+         result.bytes += bytes;
+      }
+
+      /// Flat electron arrays, as received by the backends
+      struct ElectronArrays
+      {
+         std::span<const float> eta;
+         std::span<const float> phi;
+         std::span<const float> pt;
+         std::span<const std::uint16_t> author;
+      };
+
+      /// Flat electron arrays, encoded for the host-to-device transfer
+      struct EncodedElectronArrays
+      {
+         EncodedFloatColumn eta;
+         EncodedFloatColumn phi;
+         EncodedFloatColumn pt;
+         std::span<const std::uint16_t> author;
+
+         /// The number of bytes to transfer
+         std::size_t size_bytes() const;
+      };
+
+      /// Flat jet and constituent arrays, as received by the backends
+      using JetArrays = GPUTutorial::JetArrays;
+
+      /// Interface for the backends that the benchmark can exercise
+      ///
+      /// The backends receive flat host arrays, allocated from their own
+      /// host memory resource, and are responsible for filling the
+      /// "transfer" and "compute" stages of the results. The "gather" and
+      /// "scatter" stages are measured by the benchmark driver.
+      ///
+      class Backend
+      {
+      public:
+         /// Virtual destructor
+         virtual ~Backend() = default;
+
+         /// Name of the backend, as used in the report
+         virtual std::string name() const = 0;
+         /// Memory resource to gather the inputs / receive the outputs with
+         virtual std::pmr::memory_resource &hostMR() = 0;
+         /// Whether the backend can use (pageable) host memory in place
+         ///
+         /// Such backends may run their kernels directly on the host arrays
+         /// that they receive, without copying them first.
+         ///
+         virtual bool hostAccessible() const = 0;
+
+         /// Perform the linear transformation
+         virtual void linearTransform(std::span<const float> input,
+                                      std::span<float> output,
+                                      StageResults &results) = 0;
+         /// Set the calibration table to use in @c calibrateElectrons
+         ///
+         /// The table is only copied to the device (if any) by this call,
+         /// the same way as it would only be done once per IOV in a job.
+         /// An empty table selects the phi dependent formula.
+         ///
+         virtual void setCalibrationTable(const ElectronCalibrationTable &table,
+                                          StageResults &results) = 0;
+         /// Calibrate electrons
+         virtual void calibrateElectrons(const ElectronArrays &input,
+                                         std::span<float> calibratedPt,
+                                         StageResults &results) = 0;
+         /// Calculate jet pulls
+         virtual void calculatePulls(const JetArrays &input,
+                                     std::span<float> pullEta,
+                                     std::span<float> pullPhi,
+                                     StageResults &results) = 0;
+
+         /// Whether the backend implements @c calculatePullsSegmented
+         virtual bool hasSegmentedReduction() const { return false; }
+         /// Calculate jet pulls, with a load balanced segmented reduction
+         ///
+         /// @throws std::logic_error if the backend does not implement it
+         ///
+         virtual void
+         calculatePullsSegmented(const JetArrays &input,
+                                 std::span<float> pullEta,
+                                 std::span<float> pullPhi,
+                                 const SegmentedReductionConfig &config,
+                                 StageResults &results);
+
+         /// Whether the backend implements the encoded transfers
+         virtual bool hasTransferEncoding() const { return false; }
+         /// Calibrate electrons, receiving the inputs encoded
+         ///
+         /// The inputs are transferred to the device as they are, and are
+         /// decoded on it.
+         ///
+         /// @throws std::logic_error if the backend does not implement it
+         ///
+         virtual void
+         calibrateElectronsEncoded(const EncodedElectronArrays &input,
+                                   std::span<float> calibratedPt,
+                                   StageResults &results);
+         /// Calculate jet pulls, receiving the inputs encoded
+         ///
+         /// @throws std::logic_error if the backend does not implement it
+         ///
+         virtual void calculatePullsEncoded(const EncodedJetArrays &input,
+                                            std::span<float> pullEta,
+                                            std::span<float> pullPhi,
+                                            StageResults &results);
+
+         /// Whether the backend implements @c elementWiseChain
+         virtual bool hasElementWise() const { return false; }
+         /// Run the transformations of @c GPUTutorial::ElementWiseChain
+         ///
+         /// With @c fused all of the steps are done by a single loop /
+         /// kernel, otherwise every step is run separately, each of them
+         /// reading and writing the full array.
+         ///
+         /// @throws std::logic_error if the backend does not implement it
+         ///
+         virtual void elementWiseChain(std::span<const float> input,
+                                       std::span<float> output, bool fused,
+                                       StageResults &results);
+
+      }; // class Backend
+
+      /// Create the host backend
+      std::unique_ptr<Backend> makeHostBackend(std::size_t grainSize = 16);
+      /// Create the CUDA backend
+      ///
+      /// Only available if the package was built with CUDA support. Returns
+      /// a null pointer if no CUDA device is available at runtime.
+      ///
+      std::unique_ptr<Backend> makeCUDABackend();
+      /// Create a SYCL backend, using a device selected by name
+      ///
+      /// Only available if the package was built with SYCL support. The
+      /// selector can be "cpu", "gpu", "accelerator" or "default". Returns a
+      /// null pointer if no such device is available at runtime.
+      ///
+      /// On devices sharing the memory of the host (see
+      /// @c GPUTutorial::SYCL::hostAccess) the kernels use the host arrays in
+      /// place, without copying them. A ":copy" suffix on the selector (like
+      /// "cpu:copy") makes the backend copy them even on such devices.
+      ///
+      std::unique_ptr<Backend> makeSYCLBackend(const std::string &selector);
+
+      /// Deviation of some results from their reference values
+      struct Accuracy
+      {
+         /// Number of values compared
+         std::size_t n = 0;
+         /// Largest absolute difference
+         double maxAbsError = 0.;
+         /// Sum of the squared differences
+         double sumSquaredError = 0.;
+         /// Sum of the squared reference values
+         double sumSquaredReference = 0.;
+         /// Largest acceptable relative error (not checked if zero)
+         double tolerance = 0.;
+
+         /// Compare one value to its reference
+         void add(double reference, double value);
+         /// The RMS difference, relative to the RMS of the reference values
+         double relativeError() const;
+         /// Whether the relative error is within the tolerance
+         bool passed() const;
+      };
+
+      /// Result of benchmarking one kernel with one backend
+      struct KernelResult
+      {
+         /// Name of the kernel
+         std::string kernel;
+         /// Name of the backend
+         std::string backend;
+         /// Additional description of the benchmark configuration
+         std::string variant;
+         /// Number of events processed in one go
+         std::size_t batchSize = 1;
+         /// Number of events processed
+         std::size_t nEvents = 0;
+         /// Total number of objects processed
+         std::size_t nObjects = 0;
+         /// The per-stage results
+         StageResults stages;
+         /// Deviation of the results from a reference calculation, for the
+         /// benchmarks that have one
+         std::optional<Accuracy> accuracy;
+      };
+
+      /// Benchmark the linear transformation
+      KernelResult runLinearTransform(Backend &backend,
+                                      std::vector<SyntheticEvent> &events);
+      /// Benchmark the element-wise transformation chain
+      ///
+      /// Uses the same input values as @c runLinearTransform, and writes
+      /// its results into the same place. The steps of the chain are either
+      /// run separately, or fused into a single transformation.
+      ///
+      KernelResult runElementWiseChain(Backend &backend,
+                                       std::vector<SyntheticEvent> &events,
+                                       bool fused);
+      /// Benchmark the electron calibration
+      ///
+      /// The calibration table is set up once for the backend, and is then
+      /// used for all of the events.
+      ///
+      /// The electron variables are first put into flat arrays, the same
+      /// way as an xAOD auxiliary store would hold them. By default these
+      /// are staged through the backend's host memory resource. With
+      /// @c zeroCopyInput the backend receives the arrays as they are.
+      ///
+      /// The results are compared to the host calculation. Without an
+      /// @c encoding they have to agree with it up to rounding. With one
+      /// the arrays are encoded while they are staged, and the deviation
+      /// from the host is only reported.
+      ///
+      /// @throws std::invalid_argument for an encoding with zero-copy input
+      ///
+      KernelResult
+      runCalibrateElectrons(Backend &backend,
+                            std::vector<SyntheticEvent> &events,
+                            const ElectronCalibrationTable &table = {},
+                            bool zeroCopyInput = false,
+                            const TransferEncoding *encoding = nullptr);
+      /// Benchmark the jet pull calculation
+      ///
+      /// With a batch size larger than one, the jets of multiple events are
+      /// combined into a single calculation, the same way as
+      /// @c GPUTutorial::JetPullBatcher does it.
+      ///
+      /// The constituents of every jet are summed up the backend's default
+      /// way, or with its segmented reduction if @c segmented is given.
+      ///
+      /// The results are compared to the host calculation. Without an
+      /// @c encoding they have to agree with it up to the order of the
+      /// summation. With one the arrays are encoded after they are
+      /// gathered, and the deviation from the host is only reported.
+      ///
+      /// @throws std::invalid_argument for an encoding with a segmented
+      ///         reduction
+      ///
+      KernelResult
+      runCalculatePulls(Backend &backend, std::vector<SyntheticEvent> &events,
+                        std::size_t batchSize = 1,
+                        const SegmentedReductionConfig *segmented = nullptr,
+                        const TransferEncoding *encoding = nullptr);
+
+      /// Benchmark gathering the jet constituents into flat arrays
+      ///
+      /// The constituents of every event are distributed over @c nSources
+      /// "containers", each holding its variables in aux store like columns,
+      /// with the jets referring to their constituents through links. This
+      /// is not a kernel of any backend, it is always run on the host.
+      ///
+      /// With @c indexed the links are resolved, and the constituents are
+      /// gathered using @c GPUTutorial::gatherConstituents. Otherwise they
+      /// are gathered through virtual function calls on every constituent,
+      /// the same way as through the xAOD interface. The results of the
+      /// indexed gather are checked against the latter.
+      ///
+      /// @throws std::runtime_error if the two gathers' results differ
+      ///
+      KernelResult runGatherConstituents(std::vector<SyntheticEvent> &events,
+                                         std::size_t nSources, bool indexed);
+
+      /// The functions of @c GPUTutorial::Kinematics that can be benchmarked
+      enum class KinematicsFunction
+      {
+         DeltaPhi,        ///< @c Kinematics::deltaPhi
+         DeltaR,          ///< @c Kinematics::deltaR
+         PtWeightedSum,   ///< @c Kinematics::ptWeightedSum (of the etas)
+         PtWeightedDeltaR ///< @c Kinematics::ptWeightedDeltaR
+      };
+      /// Benchmark one of the kinematic helper functions
+      ///
+      /// The (host, span based) function is applied to the constituents of
+      /// every jet, with the jet as the axis. This is not a kernel of any
+      /// backend, it is always run on the host. The results have to agree
+      /// with a double precision calculation up to float rounding.
+      ///
+      KernelResult runKinematics(std::vector<SyntheticEvent> &events,
+                                 KinematicsFunction function);
+
+      /// Configuration of @c runConcurrentOffload
+      struct ConcurrentOffloadConfig
+      {
+         /// Number of events processed at the same time
+         std::size_t concurrentEvents = 1;
+         /// Wait for the work of all events, instead of just the own work
+         ///
+         /// The same way as @c cudaDeviceSynchronize() waits for all work
+         /// on the device, not just the work of the calling thread.
+         ///
+         bool deviceWideSync = false;
+         /// Latency of every offloaded calculation
+         Duration latency{20e-6};
+         /// Bandwidth of the (simulated) transfers, in bytes per second
+         double bytesPerSecond = 10e9;
+      };
+      /// Benchmark offloading the electron calibration of concurrent events
+      ///
+      /// Every event slot offloads the calibration of its electrons to a
+      /// @c GPUTutorial::MockDevice, run asynchronously on a stream of a
+      /// @c GPUTutorial::HostThreadPool with one thread per slot, and then
+      /// waits for it. This shows how the throughput scales with the number
+      /// of concurrent events on machines without an accelerator. This is
+      /// not a kernel of any backend, it is always run on the host.
+      ///
+      KernelResult runConcurrentOffload(std::vector<SyntheticEvent> &events,
+                                        const ConcurrentOffloadConfig &config);
+
+      /// Configuration of @c runFirstEvents
+      struct FirstEventsConfig
+      {
+         /// Number of events at the start of the job to process
+         std::size_t nEvents = 10;
+         /// Pre-warm the memory resources from the allocation profile
+         bool prewarm = false;
+         /// Name of the upstream memory resource, for the report
+         std::string upstream = "host";
+      };
+      /// Benchmark the memory allocations of the first events of a job
+      ///
+      /// Sets up a new arena and a new pool on @c upstream, the same way as
+      /// the memory resource service of the examples does it, and allocates
+      /// and fills the arrays of the first events with them. The per-event
+      /// arrays of the linear transformation, the electron calibration and
+      /// the jet pull come from the arena, which is reset at the end of
+      /// every event. The jet constituents come from the pool, like the
+      /// buffers of a jet pull batch would. This is not a kernel of any
+      /// backend, it is always run on the host.
+      ///
+      /// With @c prewarm the arena and the pool first allocate the memory
+      /// recorded in @c profile. (That time is not included in the results,
+      /// as a job spends it in @c initialize().) In both cases @c profile is
+      /// replaced by the memory use of this run at the end. So a second run
+      /// is pre-warmed with the memory use of the first one, like a job is
+      /// with the profile of the previous job.
+      ///
+      KernelResult runFirstEvents(std::vector<SyntheticEvent> &events,
+                                  std::pmr::memory_resource &upstream,
+                                  AllocationProfile &profile,
+                                  const FirstEventsConfig &config);
+      /// Create a pinned host memory resource, for @c runFirstEvents
+      ///
+      /// Only available if the package was built with CUDA support. Returns
+      /// a null pointer if no CUDA device is available at runtime.
+      ///
+      std::unique_ptr<std::pmr::memory_resource> makeCUDAPinnedMR();
+
+      /// @name Replaying captured events
+      /// @{
+
+      /// Benchmark the electron calibration on captured events
+      ///
+      /// The backend receives the electron columns in place in the (memory
+      /// mapped) capture file, the same way as it would receive the aux
+      /// store arrays of a job with zero-copy input. Events without
+      /// captured electrons are skipped.
+      ///
+      KernelResult replayCalibrateElectrons(
+          Backend &backend, const EventCaptureReader &input,
+          const ElectronCalibrationTable &table = {});
+      /// Benchmark the jet pull calculation on captured events
+      ///
+      /// The backend receives the jet and constituent columns in place in
+      /// the (memory mapped) capture file. Events without captured jets are
+      /// skipped.
+      ///
+      KernelResult replayCalculatePulls(Backend &backend,
+                                        const EventCaptureReader &input);
+
+      /// @}
+
+      /// Write the benchmark results as JSON
+      void writeJson(std::ostream &out, const SyntheticEventConfig &config,
+                     const std::vector<KernelResult> &results);
+      /// Write the results of replaying captured events as JSON
+      void writeJson(std::ostream &out, const EventCaptureReader &input,
+                     const std::vector<KernelResult> &results);
+
+   } // namespace Benchmark
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_BENCHMARK_H
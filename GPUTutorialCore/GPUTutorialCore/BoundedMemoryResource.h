@@ -0,0 +1,59 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_BOUNDEDMEMORYRESOURCE_H
+#define GPUTUTORIALCORE_BOUNDEDMEMORYRESOURCE_H
+
+// System include(s).
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+
+namespace GPUTutorial
+{
+   /// Memory resource putting an upper limit on the memory of its upstream
+   ///
+   /// Allocations that would take the total amount of memory allocated
+   /// through the resource above its limit fail with @c std::bad_alloc.
+   /// The bookkeeping is done with atomic counters, so the resource is
+   /// thread-safe if its upstream resource is.
+   ///
+   class BoundedMemoryResource : public std::pmr::memory_resource
+   {
+   public:
+      /// Constructor with the upstream resource, and the limit (in bytes)
+      ///
+      /// A limit of 0 means no limit.
+      ///
+      BoundedMemoryResource(std::pmr::memory_resource &upstream,
+                            std::size_t limit = 0);
+
+      /// The limit of the resource (0 for no limit)
+      std::size_t limit() const { return m_limit; }
+      /// The amount of memory currently allocated
+      std::size_t allocated() const { return m_allocated; }
+      /// The largest amount of memory allocated at any one time
+      std::size_t peak() const { return m_peak; }
+
+   private:
+      /// @name Functions implementing @c std::pmr::memory_resource
+      /// @{
+      void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+      void do_deallocate(void *p, std::size_t bytes,
+                         std::size_t alignment) override;
+      bool do_is_equal(
+          const std::pmr::memory_resource &other) const noexcept override;
+      /// @}
+
+      /// The upstream memory resource
+      std::pmr::memory_resource &m_upstream;
+      /// The limit of the resource
+      std::size_t m_limit;
+      /// The amount of memory currently allocated
+      std::atomic<std::size_t> m_allocated{0};
+      /// The largest amount of memory allocated at any one time
+      std::atomic<std::size_t> m_peak{0};
+
+   }; // class BoundedMemoryResource
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_BOUNDEDMEMORYRESOURCE_H
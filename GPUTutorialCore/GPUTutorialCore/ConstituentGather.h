@@ -0,0 +1,148 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_CONSTITUENTGATHER_H
+#define GPUTUTORIALCORE_CONSTITUENTGATHER_H
+
+// System include(s).
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace GPUTutorial
+{
+   /// (Non-owning) kinematic columns of one constituent source container
+   ///
+   /// In an xAOD job these are the "pt", "eta" and "phi" arrays of the aux
+   /// store of a container that the jet constituents point into. Sources
+   /// that do not store their kinematics in such arrays are represented by
+   /// empty columns.
+   ///
+   struct ConstituentColumns
+   {
+      /// The pT column
+      std::span<const float> pt;
+      /// The eta column
+      std::span<const float> eta;
+      /// The phi column
+      std::span<const float> phi;
+
+      /// Check whether the source provides its columns
+      bool empty() const { return pt.empty(); }
+   };
+
+   /// Helper gathering the kinematics of jet constituents into flat arrays
+   ///
+   /// The caller resolves every constituent link into a (source, index)
+   /// pair, with the source identifying the container that the constituent
+   /// is in. The columns of every source are looked up only once, when the
+   /// source is first encountered, and the constituents are then filled
+   /// with indexed loads from the columns of their source. Since jet finding
+   /// keeps the constituents from the same container next to each other,
+   /// consecutive constituents are usually served from the same columns.
+   ///
+   /// @tparam SOURCE Type identifying the source containers
+   ///
+   template <typename SOURCE>
+   class ConstituentGatherer
+   {
+   public:
+      /// Type of the function looking up the columns of a source
+      using ColumnFinder = std::function<ConstituentColumns(const SOURCE &)>;
+
+      /// Constructor with the column finder, and the output arrays
+      ///
+      /// @param finder Function looking up the columns of a source
+      /// @param pt The output pT array
+      /// @param eta The output eta array, with the same size as @c pt
+      /// @param phi The output phi array, with the same size as @c pt
+      /// @param mr Memory resource for the cache of the sources
+      ///
+      /// @throws std::invalid_argument if the output sizes differ
+      ///
+      ConstituentGatherer(
+          ColumnFinder finder, std::span<float> pt, std::span<float> eta,
+          std::span<float> phi,
+          std::pmr::memory_resource *mr = std::pmr::get_default_resource())
+          : m_finder(std::move(finder)), m_pt(pt), m_eta(eta), m_phi(phi),
+            m_sources(mr)
+      {
+         if ((eta.size() != pt.size()) || (phi.size() != pt.size()))
+         {
+            throw std::invalid_argument(
+                "The constituent output arrays have different sizes");
+         }
+      }
+
+      /// Gather the next constituent
+      ///
+      /// Constituents from sources without columns are skipped, leaving
+      /// their output elements untouched. It is up to the caller to fill
+      /// those in some other way.
+      ///
+      /// @param source The source (container) of the constituent
+      /// @param index The index of the constituent in its source
+      /// @return @c true if the constituent was gathered, @c false if its
+      ///         source does not provide columns
+      ///
+      bool gather(const SOURCE &source, std::size_t index)
+      {
+         if (!m_current || !(m_current->first == source))
+         {
+            select(source);
+         }
+         const ConstituentColumns &columns = m_current->second;
+         const std::size_t pos = m_position++;
+         if (columns.empty())
+         {
+            return false;
+         }
+         m_pt[pos] = columns.pt[index];
+         m_eta[pos] = columns.eta[index];
+         m_phi[pos] = columns.phi[index];
+         return true;
+      }
+
+      /// The position of the next constituent in the output arrays
+      std::size_t position() const { return m_position; }
+      /// Number of different sources encountered so far
+      std::size_t nSources() const { return m_sources.size(); }
+
+   private:
+      /// Select the (possibly new) source of the next constituent(s)
+      void select(const SOURCE &source)
+      {
+         for (const auto &s : m_sources)
+         {
+            if (s.first == source)
+            {
+               m_current = &s;
+               return;
+            }
+         }
+         m_sources.emplace_back(source, m_finder(source));
+         m_current = &(m_sources.back());
+      }
+
+      /// Function looking up the columns of a source
+      ColumnFinder m_finder;
+      /// @name The output arrays
+      /// @{
+      std::span<float> m_pt;
+      std::span<float> m_eta;
+      std::span<float> m_phi;
+      /// @}
+      /// The sources encountered so far, with their columns
+      std::pmr::vector<std::pair<SOURCE, ConstituentColumns>> m_sources;
+      /// The source of the previous constituent
+      const std::pair<SOURCE, ConstituentColumns> *m_current = nullptr;
+      /// The position of the next constituent in the output arrays
+      std::size_t m_position = 0;
+
+   }; // class ConstituentGatherer
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_CONSTITUENTGATHER_H
@@ -0,0 +1,232 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_DEVICECOLUMNS_H
+#define GPUTUTORIALCORE_DEVICECOLUMNS_H
+
+// VecMem include(s).
+#include <vecmem/containers/data/vector_view.hpp>
+#include <vecmem/edm/container.hpp>
+#include <vecmem/utils/copy.hpp>
+#include <vecmem/utils/types.hpp>
+
+// System include(s).
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace GPUTutorial
+{
+   /// How the kernels of a device container use one of its columns
+   enum class ColumnAccess : unsigned int
+   {
+      /// The column is only read, it is copied to the device
+      Read = 0x1,
+      /// The column is only written, it is copied back from the device
+      Write = 0x2,
+      /// The column is both read and written
+      ReadWrite = 0x3
+   };
+
+   /// Check whether a column access includes another one
+   constexpr bool hasAccess(ColumnAccess access, ColumnAccess requested)
+   {
+      return (static_cast<unsigned int>(access) &
+              static_cast<unsigned int>(requested)) != 0;
+   }
+
+   /// Base class of the compile-time column descriptors
+   ///
+   /// A descriptor derives from this type, and adds the name of the
+   /// auxiliary variable that the column is filled from / written into.
+   /// Like:
+   ///
+   /// @code
+   /// struct Eta : Column<float, ColumnAccess::Read>
+   /// {
+   ///    static constexpr const char *auxName = "eta";
+   /// };
+   /// @endcode
+   ///
+   template <typename T, ColumnAccess ACCESS>
+   struct Column
+   {
+      /// The type of the column's elements
+      using value_type = T;
+      /// How the kernels use the column
+      static constexpr ColumnAccess access = ACCESS;
+   };
+
+   /// A set of column descriptors, describing a SoA device container
+   ///
+   /// The set provides the VecMem container type, accessors to the columns
+   /// through their descriptors, and helpers that bind / copy only the
+   /// columns that are read or written by the kernels. So that a variable
+   /// can be added to a container by adding a descriptor to its set.
+   ///
+   template <typename... COLUMNS>
+   struct ColumnSet
+   {
+      /// The number of columns
+      static constexpr std::size_t size = sizeof...(COLUMNS);
+
+      /// The index of a column in the set
+      template <typename COLUMN>
+      static constexpr std::size_t index()
+      {
+         static_assert((std::is_same_v<COLUMN, COLUMNS> || ...),
+                       "Column is not part of the set");
+         std::size_t result = 0;
+         bool found = false;
+         ((found = (found || std::is_same_v<COLUMN, COLUMNS>),
+           result += (found ? 0 : 1)),
+          ...);
+         return result;
+      }
+
+      /// Interface accessing the columns of a container by descriptor
+      template <typename BASE>
+      struct Interface : public BASE
+      {
+         /// Inherit the base class's constructor(s)
+         using BASE::BASE;
+         /// Inherit the base class's assignment operator(s)
+         using BASE::operator=;
+
+         /// Get one column / element of a column (const)
+         template <typename COLUMN>
+         VECMEM_HOST_AND_DEVICE const auto &column() const
+         {
+            return BASE::template get<index<COLUMN>()>();
+         }
+         /// Get one column / element of a column (non-const)
+         template <typename COLUMN>
+         VECMEM_HOST_AND_DEVICE auto &column()
+         {
+            return BASE::template get<index<COLUMN>()>();
+         }
+      };
+
+      /// The VecMem container type, with a given interface
+      ///
+      /// The interface should derive from @c Interface, to provide named
+      /// accessors on top of the ones using the descriptors.
+      ///
+      template <template <typename> class INTERFACE = Interface>
+      using container =
+          vecmem::edm::container<INTERFACE,
+                                 vecmem::edm::type::vector<
+                                     typename COLUMNS::value_type>...>;
+
+      /// Call a functor for every column
+      ///
+      /// The functor receives the index of the column as an
+      /// @c std::integral_constant, and a (default constructed) descriptor.
+      ///
+      template <typename FUNC>
+      static void forEach(FUNC &&func)
+      {
+         forEach(func, std::index_sequence_for<COLUMNS...>{});
+      }
+
+      /// Bind the columns with a given access to (host) arrays
+      ///
+      /// @param size The number of elements in the arrays
+      /// @param getter Functor returning the array of a column, when called
+      ///               with its descriptor
+      /// @return A view with the selected columns set, and all other ones
+      ///         left empty
+      ///
+      template <ColumnAccess ACCESS, typename VIEW, typename GETTER>
+      static VIEW bind(std::size_t size, GETTER &&getter)
+      {
+         VIEW result{static_cast<unsigned int>(size)};
+         if (size == 0)
+         {
+            return result;
+         }
+         forEach(
+             [&](auto index, auto column)
+             {
+                if constexpr (hasAccess(decltype(column)::access, ACCESS))
+                {
+                   result.template get<decltype(index)::value>() = {
+                       static_cast<unsigned int>(size), getter(column)};
+                }
+             });
+         return result;
+      }
+
+      /// Start copying the columns with a given access between two views
+      ///
+      /// With an asynchronous @c copy object the copies may still be running
+      /// when this function returns. The caller then needs to synchronise
+      /// with them, either through the returned events, or through the
+      /// stream / queue of @c copy.
+      ///
+      /// @return The events of the individual copies
+      ///
+      template <ColumnAccess ACCESS, typename FROM, typename TO>
+      static std::vector<vecmem::copy::event_type>
+      copyAsync(const vecmem::copy &copy, const FROM &from, const TO &to,
+                vecmem::copy::type::copy_type type =
+                    vecmem::copy::type::unknown)
+      {
+         std::vector<vecmem::copy::event_type> events;
+         events.reserve(size);
+         forEach(
+             [&](auto index, auto column)
+             {
+                if constexpr (hasAccess(decltype(column)::access, ACCESS))
+                {
+                   constexpr std::size_t i = decltype(index)::value;
+                   using value_type =
+                       typename decltype(column)::value_type;
+                   const vecmem::data::vector_view<const value_type> source =
+                       from.template get<i>();
+                   events.push_back(copy(source, to.template get<i>(), type));
+                }
+             });
+         return events;
+      }
+
+      /// Copy the columns with a given access between two views
+      ///
+      /// All copies are started before waiting for any of them.
+      ///
+      template <ColumnAccess ACCESS, typename FROM, typename TO>
+      static void copy(const vecmem::copy &copy, const FROM &from,
+                       const TO &to,
+                       vecmem::copy::type::copy_type type =
+                           vecmem::copy::type::unknown)
+      {
+         for (vecmem::copy::event_type &event :
+              copyAsync<ACCESS>(copy, from, to, type))
+         {
+            event->wait();
+         }
+      }
+
+      /// The number of bytes held by the columns with a given access
+      template <ColumnAccess ACCESS>
+      static constexpr std::size_t bytesPerElement()
+      {
+         return ((hasAccess(COLUMNS::access, ACCESS)
+                      ? sizeof(typename COLUMNS::value_type)
+                      : 0) +
+                 ... + 0);
+      }
+
+   private:
+      /// Helper for @c forEach
+      template <typename FUNC, std::size_t... INDICES>
+      static void forEach(FUNC &func, std::index_sequence<INDICES...>)
+      {
+         (func(std::integral_constant<std::size_t, INDICES>{}, COLUMNS{}),
+          ...);
+      }
+
+   }; // struct ColumnSet
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_DEVICECOLUMNS_H
@@ -0,0 +1,69 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_ELECTRONCALIBRATION_H
+#define GPUTUTORIALCORE_ELECTRONCALIBRATION_H
+
+// Local include(s).
+#include "GPUTutorialCore/ElectronCalibrationTable.h"
+#include "GPUTutorialCore/Kinematics.h"
+
+// VecMem include(s).
+#include <vecmem/utils/types.hpp>
+
+// System include(s).
+#include <cstdint>
+#include <span>
+
+namespace GPUTutorial
+{
+   /// The phi dependent "calibration" of the electron transverse momentum
+   ///
+   /// It is pt * (0.9 + 0.4 * (phi + π) / π), with the constants folded,
+   /// so that the factor takes a single multiply-add.
+   ///
+   VECMEM_HOST_AND_DEVICE
+   constexpr float calibratedElectronPt(float pt, float phi)
+   {
+      return pt * (1.3f + (0.4f * Kinematics::INV_PI) * phi);
+   }
+
+   /// Calibration of the electron transverse momentum, using a binned table
+   ///
+   /// Falls back to the phi dependent formula if no table is provided.
+   ///
+   VECMEM_HOST_AND_DEVICE
+   inline float calibratedElectronPt(float pt, float eta, float phi,
+                                     std::uint16_t author,
+                                     const ElectronCalibrationTableView &table)
+   {
+      if (table.empty())
+      {
+         return calibratedElectronPt(pt, phi);
+      }
+      return pt * table.factor(eta, phi, pt, author);
+   }
+
+   namespace Host
+   {
+      /// "Calibrate" electrons on the host
+      void calibrateElectrons(
+          std::span<const float> eta,           ///< [in] Electron eta array
+          std::span<const float> phi,           ///< [in] Electron phi array
+          std::span<const float> pt,            ///< [in] Electron pT array
+          std::span<const std::uint16_t> author, ///< [in] Electron author array
+          std::span<float> calibratedPt         ///< [out] Calibrated pT array
+      );
+      /// Calibrate electrons on the host, using a binned table
+      void calibrateElectrons(
+          std::span<const float> eta,           ///< [in] Electron eta array
+          std::span<const float> phi,           ///< [in] Electron phi array
+          std::span<const float> pt,            ///< [in] Electron pT array
+          std::span<const std::uint16_t> author, ///< [in] Electron author array
+          const ElectronCalibrationTableView &table, ///< [in] Calibration table
+          std::span<float> calibratedPt         ///< [out] Calibrated pT array
+      );
+
+   } // namespace Host
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_ELECTRONCALIBRATION_H
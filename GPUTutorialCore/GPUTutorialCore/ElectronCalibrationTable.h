@@ -0,0 +1,215 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_ELECTRONCALIBRATIONTABLE_H
+#define GPUTUTORIALCORE_ELECTRONCALIBRATIONTABLE_H
+
+// VecMem include(s).
+#include <vecmem/utils/types.hpp>
+
+// System include(s).
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace GPUTutorial
+{
+   /// Find the bin of a value along one axis of a binned table
+   ///
+   /// Values outside of the axis are assigned to the first/last bin. Axes
+   /// with equidistant bins are indexed directly, all others are searched
+   /// with a binary search.
+   ///
+   VECMEM_HOST_AND_DEVICE
+   inline unsigned int findBin(const float *edges, unsigned int nBins,
+                               bool uniform, float x)
+   {
+      if (uniform)
+      {
+         const float pos = (x - edges[0]) / (edges[nBins] - edges[0]) *
+                           static_cast<float>(nBins);
+         // Written such that NaN values would end up in the first bin.
+         if (!(pos > 0.f))
+         {
+            return 0;
+         }
+         if (pos >= static_cast<float>(nBins))
+         {
+            return nBins - 1;
+         }
+         return static_cast<unsigned int>(pos);
+      }
+      // Find the last (inner) edge that is not larger than the value.
+      unsigned int low = 0, high = nBins - 1;
+      while (low < high)
+      {
+         const unsigned int mid = (low + high + 1) / 2;
+         if (edges[mid] <= x)
+         {
+            low = mid;
+         }
+         else
+         {
+            high = mid - 1;
+         }
+      }
+      return low;
+   }
+
+   /// Non-owning view of a flattened, binned electron calibration table
+   ///
+   /// All bin edges, author codes and correction factors are stored in a
+   /// single float array, so that the table can be moved to a device with
+   /// a single copy. The layout of the array is:
+   ///  - eta edges (nEta + 1)
+   ///  - phi edges (nPhi + 1)
+   ///  - pt edges (nPt + 1)
+   ///  - author codes (nAuthor)
+   ///  - correction factors (nAuthor * nEta * nPhi * nPt), with pt being
+   ///    the fastest changing index
+   ///
+   struct ElectronCalibrationTableView
+   {
+      /// The flat table data
+      const float *data = nullptr;
+
+      /// @name Layout of the table
+      /// @{
+
+      unsigned int nEta = 0;
+      unsigned int nPhi = 0;
+      unsigned int nPt = 0;
+      unsigned int nAuthor = 0;
+      bool uniformEta = false;
+      bool uniformPhi = false;
+      bool uniformPt = false;
+
+      /// @}
+
+      /// Check whether the view points to a table
+      VECMEM_HOST_AND_DEVICE
+      bool empty() const { return (data == nullptr); }
+
+      /// Get the correction factor for one electron
+      ///
+      /// Electrons with an author that is not in the table are left
+      /// uncorrected.
+      ///
+      VECMEM_HOST_AND_DEVICE
+      float factor(float eta, float phi, float pt, std::uint16_t author) const
+      {
+         const float *etaEdges = data;
+         const float *phiEdges = etaEdges + nEta + 1;
+         const float *ptEdges = phiEdges + nPhi + 1;
+         const float *authors = ptEdges + nPt + 1;
+         const float *factors = authors + nAuthor;
+
+         // There are only ever a handful of authors, so a linear search is
+         // the fastest option.
+         unsigned int iAuthor = 0;
+         while ((iAuthor < nAuthor) &&
+                (authors[iAuthor] != static_cast<float>(author)))
+         {
+            ++iAuthor;
+         }
+         if (iAuthor == nAuthor)
+         {
+            return 1.f;
+         }
+
+         const unsigned int iEta = findBin(etaEdges, nEta, uniformEta, eta);
+         const unsigned int iPhi = findBin(phiEdges, nPhi, uniformPhi, phi);
+         const unsigned int iPt = findBin(ptEdges, nPt, uniformPt, pt);
+         return factors[((iAuthor * nEta + iEta) * nPhi + iPhi) * nPt + iPt];
+      }
+
+   }; // struct ElectronCalibrationTableView
+
+   /// Owning, flattened, binned electron calibration table
+   class ElectronCalibrationTable
+   {
+   public:
+      /// Default constructor, creating an empty table
+      ElectronCalibrationTable() = default;
+      /// Constructor from the bin edges, authors and correction factors
+      ///
+      /// @throws std::invalid_argument if the arguments are not consistent
+      ///
+      ElectronCalibrationTable(std::span<const float> etaEdges,
+                               std::span<const float> phiEdges,
+                               std::span<const float> ptEdges,
+                               std::span<const std::uint16_t> authors,
+                               std::span<const float> factors);
+
+      /// Check whether the table is empty
+      bool empty() const { return m_data.empty(); }
+      /// Total number of bins in the table
+      std::size_t nBins() const;
+
+      /// The flat table data, for copying it to a device
+      std::span<const float> data() const { return m_data; }
+      /// A view of the table in host memory
+      ElectronCalibrationTableView view() const;
+      /// A view of (a copy of) the table, in some other memory
+      ElectronCalibrationTableView view(const float *data) const;
+
+   private:
+      /// The flat table data
+      std::vector<float> m_data;
+      /// The layout of the table
+      ElectronCalibrationTableView m_layout;
+
+   }; // class ElectronCalibrationTable
+
+   /// Calibration table with its interval of validity (in run numbers)
+   struct ElectronCalibrationIOV
+   {
+      /// First run (inclusive) that the table is valid for
+      std::uint32_t firstRun = 0;
+      /// Last run (inclusive) that the table is valid for
+      std::uint32_t lastRun = 0;
+      /// The calibration table
+      ElectronCalibrationTable table;
+
+      /// Check if the table is valid for a given run
+      bool contains(std::uint32_t run) const
+      {
+         return ((run >= firstRun) && (run <= lastRun));
+      }
+   };
+
+   /// Read electron calibration tables from a text stream
+   ///
+   /// The stream may hold any number of tables, each of them introduced by
+   /// an "iov" line. Empty lines and lines starting with '#' are ignored.
+   ///
+   /// @code
+   /// iov <first run> <last run>
+   /// eta <bin edges>
+   /// phi <bin edges>
+   /// pt <bin edges>
+   /// author <author codes>
+   /// factors <correction factors>
+   /// @endcode
+   ///
+   /// @throws std::runtime_error if the input could not be interpreted
+   ///
+   std::vector<ElectronCalibrationIOV>
+   readElectronCalibration(std::istream &in);
+   /// Read electron calibration tables from a text file
+   std::vector<ElectronCalibrationIOV>
+   readElectronCalibration(const std::string &fileName);
+
+   /// Create a table with random correction factors, for testing
+   ///
+   /// The eta and phi axes are equidistant, the pt axis is logarithmic, and
+   /// the authors are numbered from 1.
+   ///
+   ElectronCalibrationTable
+   makeSyntheticElectronCalibration(unsigned int nEta, unsigned int nPhi,
+                                    unsigned int nPt, unsigned int nAuthor,
+                                    unsigned int seed = 1234);
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_ELECTRONCALIBRATIONTABLE_H
@@ -0,0 +1,105 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_ELECTRONDEVICECONTAINER_H
+#define GPUTUTORIALCORE_ELECTRONDEVICECONTAINER_H
+
+// Local include(s).
+#include "GPUTutorialCore/DeviceColumns.h"
+
+// System include(s).
+#include <cstdint>
+
+namespace GPUTutorial
+{
+   /// Descriptors of the electron variables used on the device
+   namespace ElectronColumns
+   {
+      /// Pseudorapidity of the electrons
+      struct Eta : Column<float, ColumnAccess::Read>
+      {
+         static constexpr const char *auxName = "eta";
+      };
+      /// Azimuthal angle of the electrons
+      struct Phi : Column<float, ColumnAccess::Read>
+      {
+         static constexpr const char *auxName = "phi";
+      };
+      /// Transverse momentum of the electrons, calibrated on the device
+      struct Pt : Column<float, ColumnAccess::ReadWrite>
+      {
+         static constexpr const char *auxName = "pt";
+      };
+      /// Author of the electrons
+      struct Author : Column<std::uint16_t, ColumnAccess::Read>
+      {
+         static constexpr const char *auxName = "author";
+      };
+
+      /// All columns of the electron container
+      using Set = ColumnSet<Eta, Phi, Pt, Author>;
+
+   } // namespace ElectronColumns
+
+   /// Interface for the VecMem based GPU friendly ElectronDeviceContainer.
+   template <typename BASE>
+   struct ElectronDeviceInterface
+       : public ElectronColumns::Set::Interface<BASE>
+   {
+      /// The base interface
+      using Base = ElectronColumns::Set::Interface<BASE>;
+      /// Inherit the base class's constructor(s)
+      using Base::Base;
+      /// Inherit the base class's assignment operator(s)
+      using Base::operator=;
+
+      /// Get the pseudorapidity of the electrons (const)
+      VECMEM_HOST_AND_DEVICE
+      const auto &eta() const
+      {
+         return Base::template column<ElectronColumns::Eta>();
+      }
+      /// Get the pseudorapidity of the electrons (non-const)
+      VECMEM_HOST_AND_DEVICE
+      auto &eta() { return Base::template column<ElectronColumns::Eta>(); }
+
+      /// Get the azimuthal angles of the electrons (const)
+      VECMEM_HOST_AND_DEVICE
+      const auto &phi() const
+      {
+         return Base::template column<ElectronColumns::Phi>();
+      }
+      /// Get the azimuthal angles of the electrons (non-const)
+      VECMEM_HOST_AND_DEVICE
+      auto &phi() { return Base::template column<ElectronColumns::Phi>(); }
+
+      /// Get the transverse momentum of the electrons (const)
+      VECMEM_HOST_AND_DEVICE
+      const auto &pt() const
+      {
+         return Base::template column<ElectronColumns::Pt>();
+      }
+      /// Get the transverse momentum of the electrons (non-const)
+      VECMEM_HOST_AND_DEVICE
+      auto &pt() { return Base::template column<ElectronColumns::Pt>(); }
+
+      /// Get the author of the electrons (const)
+      VECMEM_HOST_AND_DEVICE
+      const auto &author() const
+      {
+         return Base::template column<ElectronColumns::Author>();
+      }
+      /// Get the author of the electrons (non-const)
+      VECMEM_HOST_AND_DEVICE
+      auto &author()
+      {
+         return Base::template column<ElectronColumns::Author>();
+      }
+
+   }; // struct ElectronDeviceInterface
+
+   /// SoA, GPU friendly electron container.
+   using ElectronDeviceContainer =
+       ElectronColumns::Set::container<ElectronDeviceInterface>;
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_ELECTRONDEVICECONTAINER_H
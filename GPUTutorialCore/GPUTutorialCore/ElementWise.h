@@ -0,0 +1,328 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_ELEMENTWISE_H
+#define GPUTUTORIALCORE_ELEMENTWISE_H
+
+// VecMem include(s).
+#include <vecmem/utils/types.hpp>
+
+// System include(s).
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+namespace GPUTutorial
+{
+   /// Element-wise transformations, composed at compile time
+   ///
+   /// Transformations are written as arithmetic expressions of their
+   /// arguments, like
+   ///
+   /// @code
+   /// using namespace GPUTutorial::ElementWise;
+   /// constexpr auto scale = (arg<0> - 10.f) * arg<1>;
+   /// constexpr auto squash = arg<0> / (arg<0> + 1.f);
+   /// constexpr auto chain = fuse(scale, squash);
+   /// @endcode
+   ///
+   /// Every expression is a (trivially copyable) functor, evaluating the
+   /// whole expression tree for one set of arguments. So a chain of
+   /// transformations becomes a single loop / kernel, without intermediate
+   /// arrays. The argument values may be scalars, or (SYCL) vector types
+   /// supporting the arithmetic operators, so that a device can load and
+   /// process multiple elements at once.
+   ///
+   namespace ElementWise
+   {
+      /// The argument values of an expression, for one evaluation
+      template <typename T, std::size_t N>
+      struct Values
+      {
+         /// The values
+         T values[N];
+
+         /// Access one of the values (const)
+         VECMEM_HOST_AND_DEVICE
+         const T &operator[](std::size_t i) const { return values[i]; }
+         /// Access one of the values (non-const)
+         VECMEM_HOST_AND_DEVICE
+         T &operator[](std::size_t i) { return values[i]; }
+      };
+
+      /// Types that can be used as element-wise expressions
+      ///
+      /// Every expression declares the number of arguments that it needs,
+      /// and can be evaluated on a @c Values object with (at least) that
+      /// many values.
+      ///
+      template <typename E>
+      concept Expression = requires {
+         { E::nArgs } -> std::convertible_to<std::size_t>;
+      };
+
+      /// @name Leaves of the expression trees
+      /// @{
+
+      /// The I-th argument of an expression
+      template <std::size_t I>
+      struct Arg
+      {
+         /// The number of arguments used
+         static constexpr std::size_t nArgs = I + 1;
+
+         /// Evaluate the expression
+         template <typename T, std::size_t N>
+         VECMEM_HOST_AND_DEVICE T operator()(const Values<T, N> &args) const
+         {
+            static_assert(I < N, "Not enough arguments provided");
+            return args[I];
+         }
+      };
+
+      /// A constant value
+      struct Constant
+      {
+         /// The number of arguments used
+         static constexpr std::size_t nArgs = 0;
+
+         /// The value of the constant
+         float value = 0.f;
+
+         /// Evaluate the expression
+         template <typename T, std::size_t N>
+         VECMEM_HOST_AND_DEVICE float operator()(const Values<T, N> &) const
+         {
+            return value;
+         }
+      };
+
+      /// @}
+
+      /// @name Operations of the expression trees
+      /// @{
+
+      /// Addition
+      struct Plus
+      {
+         template <typename A, typename B>
+         VECMEM_HOST_AND_DEVICE auto operator()(const A &a, const B &b) const
+         {
+            return a + b;
+         }
+      };
+      /// Subtraction
+      struct Minus
+      {
+         template <typename A, typename B>
+         VECMEM_HOST_AND_DEVICE auto operator()(const A &a, const B &b) const
+         {
+            return a - b;
+         }
+      };
+      /// Multiplication
+      struct Multiplies
+      {
+         template <typename A, typename B>
+         VECMEM_HOST_AND_DEVICE auto operator()(const A &a, const B &b) const
+         {
+            return a * b;
+         }
+      };
+      /// Division
+      struct Divides
+      {
+         template <typename A, typename B>
+         VECMEM_HOST_AND_DEVICE auto operator()(const A &a, const B &b) const
+         {
+            return a / b;
+         }
+      };
+
+      /// An operation on the results of two sub-expressions
+      template <typename OP, Expression L, Expression R>
+      struct Binary
+      {
+         /// The number of arguments used
+         static constexpr std::size_t nArgs = std::max(L::nArgs, R::nArgs);
+
+         /// The left hand side sub-expression
+         L lhs;
+         /// The right hand side sub-expression
+         R rhs;
+
+         /// Evaluate the expression
+         template <typename T, std::size_t N>
+         VECMEM_HOST_AND_DEVICE T operator()(const Values<T, N> &args) const
+         {
+            return T(OP{}(lhs(args), rhs(args)));
+         }
+      };
+
+      /// Negation of a sub-expression
+      template <Expression E>
+      struct Negate
+      {
+         /// The number of arguments used
+         static constexpr std::size_t nArgs = E::nArgs;
+
+         /// The sub-expression
+         E expr;
+
+         /// Evaluate the expression
+         template <typename T, std::size_t N>
+         VECMEM_HOST_AND_DEVICE T operator()(const Values<T, N> &args) const
+         {
+            return -T(expr(args));
+         }
+      };
+
+      /// Application of one transformation on the result of another one
+      ///
+      /// @c OUTER receives the result of @c INNER as its first argument,
+      /// while its other arguments are the same as the ones of @c INNER.
+      ///
+      template <Expression OUTER, Expression INNER>
+      struct Compose
+      {
+         /// The number of arguments used
+         static constexpr std::size_t nArgs =
+             std::max<std::size_t>({OUTER::nArgs, INNER::nArgs, 1});
+
+         /// The transformation applied first
+         INNER inner;
+         /// The transformation applied on the result of @c inner
+         OUTER outer;
+
+         /// Evaluate the expression
+         template <typename T, std::size_t N>
+         VECMEM_HOST_AND_DEVICE T operator()(const Values<T, N> &args) const
+         {
+            Values<T, N> outerArgs = args;
+            outerArgs[0] = T(inner(args));
+            return outer(outerArgs);
+         }
+      };
+
+      /// @}
+
+      /// @name Building the expressions
+      /// @{
+
+      /// The I-th argument of an expression
+      template <std::size_t I>
+      inline constexpr Arg<I> arg{};
+
+      /// Types that can be operands of the arithmetic operators
+      template <typename T>
+      concept Operand = Expression<T> || std::is_arithmetic_v<T>;
+
+      /// Turn an operand into an expression
+      template <Operand T>
+      constexpr auto toExpression(const T &operand)
+      {
+         if constexpr (Expression<T>)
+         {
+            return operand;
+         }
+         else
+         {
+            return Constant{static_cast<float>(operand)};
+         }
+      }
+
+      /// Create a binary operation, with at least one expression operand
+      template <typename OP, Operand L, Operand R>
+         requires(Expression<L> || Expression<R>)
+      constexpr auto makeBinary(const L &lhs, const R &rhs)
+      {
+         return Binary<OP, decltype(toExpression(lhs)),
+                       decltype(toExpression(rhs))>{toExpression(lhs),
+                                                    toExpression(rhs)};
+      }
+
+      template <Operand L, Operand R>
+         requires(Expression<L> || Expression<R>)
+      constexpr auto operator+(const L &lhs, const R &rhs)
+      {
+         return makeBinary<Plus>(lhs, rhs);
+      }
+      template <Operand L, Operand R>
+         requires(Expression<L> || Expression<R>)
+      constexpr auto operator-(const L &lhs, const R &rhs)
+      {
+         return makeBinary<Minus>(lhs, rhs);
+      }
+      template <Operand L, Operand R>
+         requires(Expression<L> || Expression<R>)
+      constexpr auto operator*(const L &lhs, const R &rhs)
+      {
+         return makeBinary<Multiplies>(lhs, rhs);
+      }
+      template <Operand L, Operand R>
+         requires(Expression<L> || Expression<R>)
+      constexpr auto operator/(const L &lhs, const R &rhs)
+      {
+         return makeBinary<Divides>(lhs, rhs);
+      }
+      template <Expression E>
+      constexpr auto operator-(const E &expr)
+      {
+         return Negate<E>{expr};
+      }
+
+      /// Fuse a chain of transformations into a single one (end of chain)
+      template <Expression LAST>
+      constexpr auto fuse(const LAST &last)
+      {
+         return last;
+      }
+
+      /// Fuse a chain of transformations into a single one
+      ///
+      /// Every transformation receives the result of the previous one as
+      /// its first argument. The other arguments are shared by all of them.
+      ///
+      template <Expression FIRST, Expression SECOND, Expression... REST>
+      constexpr auto fuse(const FIRST &first, const SECOND &second,
+                          const REST &...rest)
+      {
+         return fuse(Compose<SECOND, FIRST>{first, second}, rest...);
+      }
+
+      /// @}
+
+      /// Helper for @c evaluate
+      template <Expression EXPR, typename... INPUTS>
+      void evaluateLoop(const EXPR &expr, std::size_t n, float *output,
+                        const INPUTS *...inputs)
+      {
+         for (std::size_t i = 0; i < n; ++i)
+         {
+            output[i] = expr(Values<float, sizeof...(INPUTS)>{{inputs[i]...}});
+         }
+      }
+
+      /// Evaluate an expression element by element on the host
+      ///
+      /// The whole expression is evaluated in a single, simple loop, which
+      /// the compiler can vectorize. The output may be one of the inputs.
+      ///
+      template <Expression EXPR, typename... INPUTS>
+      void evaluate(const EXPR &expr, std::span<float> output,
+                    const INPUTS &...inputs)
+      {
+         static_assert(sizeof...(INPUTS) >= EXPR::nArgs,
+                       "Not enough inputs provided");
+         assert(((std::span<const float>(inputs).size() == output.size()) &&
+                 ...));
+         evaluateLoop(expr, output.size(), output.data(),
+                      std::span<const float>(inputs).data()...);
+      }
+
+   } // namespace ElementWise
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_ELEMENTWISE_H
@@ -0,0 +1,133 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_ELEMENTWISESYCL_H
+#define GPUTUTORIALCORE_ELEMENTWISESYCL_H
+
+// Local include(s).
+#include "GPUTutorialCore/ElementWise.h"
+#include "GPUTutorialCore/LaunchTuning.h"
+
+// SYCL include(s).
+#include <sycl/sycl.hpp>
+
+// System include(s).
+#include <cstddef>
+#include <vector>
+
+namespace GPUTutorial
+{
+   namespace Kernels
+   {
+      /// Kernel name of @c GPUTutorial::SYCL::evaluate
+      template <typename EXPR, std::size_t NINPUTS>
+      class ElementWiseEvaluate;
+
+   } // namespace Kernels
+
+   namespace SYCL
+   {
+      /// Evaluate an element-wise expression on a SYCL device
+      ///
+      /// The whole expression is evaluated by a single kernel. Every
+      /// work-item loads, transforms and stores a @c sycl::vec of
+      /// @c VECSIZE consecutive elements from every array, so that the
+      /// work-items of a sub-group access one contiguous block of memory.
+      /// The last, incomplete vector of the arrays is processed element by
+      /// element.
+      ///
+      /// Every work-item processes @c launch.itemsPerThread such vectors,
+      /// one work-group size apart, so that the accesses of the sub-groups
+      /// stay contiguous.
+      ///
+      /// All arrays need to be accessible on the device of the queue. The
+      /// output may be one of the inputs.
+      ///
+      /// @return The event of the kernel
+      ///
+      template <ElementWise::Expression EXPR, typename... INPUTS>
+      sycl::event evaluate(sycl::queue &queue, const LaunchConfig &launch,
+                           const EXPR &expr, std::size_t n, float *output,
+                           const std::vector<sycl::event> &dependencies,
+                           const INPUTS *...inputs)
+      {
+         static_assert(sizeof...(INPUTS) >= EXPR::nArgs,
+                       "Not enough inputs provided");
+         static constexpr std::size_t NINPUTS = sizeof...(INPUTS);
+         static constexpr int VECSIZE = 4;
+         using vec_t = sycl::vec<float, VECSIZE>;
+
+         // One work-item per (possibly incomplete) vector, or per a few of
+         // them.
+         const std::size_t nVectors = (n + VECSIZE - 1) / VECSIZE;
+         const std::size_t localSize = launch.workGroupSize;
+         const std::size_t itemsPerThread = launch.itemsPerThread;
+         const std::size_t globalSize = launch.globalSize(nVectors);
+         if (globalSize == 0)
+         {
+            // Return an event that still respects the dependencies.
+            return queue.submit([&](sycl::handler &h)
+                                { h.depends_on(dependencies); });
+         }
+
+         return queue.submit(
+             [&](sycl::handler &h)
+             {
+                h.depends_on(dependencies);
+                h.parallel_for<Kernels::ElementWiseEvaluate<EXPR, NINPUTS>>(
+                    sycl::nd_range<1>{globalSize, localSize},
+                    [=](sycl::nd_item<1> item)
+                    {
+                       const std::size_t first =
+                           item.get_group(0) * localSize * itemsPerThread +
+                           item.get_local_id(0);
+                       for (std::size_t v = 0; v < itemsPerThread; ++v)
+                       {
+                          const std::size_t begin =
+                              (first + v * localSize) * VECSIZE;
+                          if (begin + VECSIZE <= n)
+                          {
+                             // Load, transform and store a full vector.
+                             auto global = [](auto *ptr)
+                             {
+                                return sycl::address_space_cast<
+                                    sycl::access::address_space::global_space,
+                                    sycl::access::decorated::no>(ptr);
+                             };
+                             ElementWise::Values<vec_t, NINPUTS> args;
+                             std::size_t i = 0;
+                             ((args[i++].load(0, global(inputs + begin))),
+                              ...);
+                             const vec_t result = expr(args);
+                             result.store(0, global(output + begin));
+                          }
+                          else
+                          {
+                             // Process the end of the arrays one by one.
+                             for (std::size_t i = begin; i < n; ++i)
+                             {
+                                output[i] = expr(
+                                    ElementWise::Values<float, NINPUTS>{
+                                        {inputs[i]...}});
+                             }
+                          }
+                       }
+                    });
+             });
+      }
+
+      /// Evaluate an element-wise expression on a SYCL device, with the
+      /// default launch parameters
+      template <ElementWise::Expression EXPR, typename... INPUTS>
+      sycl::event evaluate(sycl::queue &queue, const EXPR &expr, std::size_t n,
+                           float *output,
+                           const std::vector<sycl::event> &dependencies,
+                           const INPUTS *...inputs)
+      {
+         return evaluate(queue, LaunchConfig{}, expr, n, output, dependencies,
+                         inputs...);
+      }
+
+   } // namespace SYCL
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_ELEMENTWISESYCL_H
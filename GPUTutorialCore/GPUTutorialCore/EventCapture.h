@@ -0,0 +1,268 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_EVENTCAPTURE_H
+#define GPUTUTORIALCORE_EVENTCAPTURE_H
+
+// System include(s).
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace GPUTutorial
+{
+   /// The offload input columns that can be captured
+   enum class CaptureColumn : std::uint32_t
+   {
+      ElectronEta = 1,      ///< Electron eta (float)
+      ElectronPhi = 2,      ///< Electron phi (float)
+      ElectronPt = 3,       ///< Electron pT (float)
+      ElectronAuthor = 4,   ///< Electron author (uint16)
+      JetPt = 16,           ///< Jet pT (float)
+      JetEta = 17,          ///< Jet eta (float)
+      JetPhi = 18,          ///< Jet phi (float)
+      JetNConstituents = 19, ///< Number of constituents per jet (uint64)
+      ConstituentPt = 20,   ///< Constituent pT, grouped by jet (float)
+      ConstituentEta = 21,  ///< Constituent eta, grouped by jet (float)
+      ConstituentPhi = 22   ///< Constituent phi, grouped by jet (float)
+   };
+
+   /// The value types of the captured columns
+   enum class CaptureType : std::uint32_t
+   {
+      Float32 = 1, ///< @c float
+      UInt16 = 2,  ///< @c std::uint16_t
+      UInt64 = 3   ///< @c std::uint64_t (and @c std::size_t)
+   };
+
+   /// The capture type of a C++ type
+   template <typename T>
+   constexpr CaptureType captureType()
+   {
+      if constexpr (std::is_same_v<T, float>)
+      {
+         return CaptureType::Float32;
+      }
+      else if constexpr (std::is_same_v<T, std::uint16_t>)
+      {
+         return CaptureType::UInt16;
+      }
+      else
+      {
+         static_assert(std::is_unsigned_v<T> && (sizeof(T) == 8),
+                       "Unsupported capture column type");
+         return CaptureType::UInt64;
+      }
+   }
+
+   /// One column of an event to capture
+   struct CaptureBlock
+   {
+      /// Constructor from the values of the column
+      template <typename T>
+      CaptureBlock(CaptureColumn c, std::span<const T> values)
+          : column(c), type(captureType<T>()), data(values.data()),
+            count(values.size()), bytes(values.size_bytes()) {}
+
+      /// The column
+      CaptureColumn column;
+      /// The type of the values
+      CaptureType type;
+      /// The values
+      const void *data;
+      /// The number of values
+      std::size_t count;
+      /// The size of the values in bytes
+      std::size_t bytes;
+   };
+
+   /// Writer of the offload inputs of events into a capture file
+   ///
+   /// The file holds the flat columns that the algorithms hand to their
+   /// backends, so that the calculations can be replayed without the event
+   /// reading and the reconstruction that produced them. It is written
+   /// append-only:
+   ///
+   ///  - a file header;
+   ///  - one record per event, with the run and event numbers, a table of
+   ///    the event's columns, and the values of the columns. Every record
+   ///    and every column starts at an @c ALIGNMENT byte boundary, so that
+   ///    a reader mapping the file into memory can use the columns in
+   ///    place;
+   ///  - the event index, with the position of every record, written by
+   ///    @c close().
+   ///
+   /// Files without an index (from jobs that did not finish) can still be
+   /// read, by scanning the records. All numbers are written in the byte
+   /// order of the host.
+   ///
+   /// Existing files are not overwritten, or appended to. Users writing into
+   /// the same file within a job share one writer, see @c shared.
+   ///
+   /// Events can be written concurrently, they are stored in the order that
+   /// they were written in.
+   ///
+   class EventCaptureWriter
+   {
+   public:
+      /// Alignment of the records and the columns in the file
+      static constexpr std::size_t ALIGNMENT = 64;
+
+      /// Constructor, creating the file
+      ///
+      /// @throws std::runtime_error if the file exists already, or could not
+      ///         be created
+      ///
+      explicit EventCaptureWriter(const std::string &fileName);
+      /// Destructor, closing the file if that was not done yet
+      ~EventCaptureWriter();
+
+      /// The writer can not be copied
+      EventCaptureWriter(const EventCaptureWriter &) = delete;
+      /// The writer can not be assigned
+      EventCaptureWriter &operator=(const EventCaptureWriter &) = delete;
+
+      /// The writer of a file, shared by all of its users in the job
+      ///
+      /// The writer is created on the first call for the file, and lives
+      /// for as long as any of its users keeps a pointer to it.
+      ///
+      /// @throws std::runtime_error if the file had to be created, and that
+      ///         failed
+      ///
+      static std::shared_ptr<EventCaptureWriter>
+      shared(const std::string &fileName);
+
+      /// Write the columns of one event
+      ///
+      /// @throws std::runtime_error if writing failed, or the writer was
+      ///         closed already
+      ///
+      void write(std::uint64_t run, std::uint64_t event,
+                 std::initializer_list<CaptureBlock> columns);
+      /// Write the event index, and close the file
+      ///
+      /// Closing a writer that was closed already (by another one of its
+      /// users) does nothing.
+      ///
+      /// @throws std::runtime_error if writing failed
+      ///
+      void close();
+
+      /// The number of events written so far
+      std::size_t size() const;
+
+   private:
+      /// Write some bytes, followed by padding up to @c ALIGNMENT
+      void writeAligned(const void *data, std::size_t bytes);
+
+      /// Mutex serialising the writes
+      mutable std::mutex m_mutex;
+      /// The name of the file
+      std::string m_fileName;
+      /// The output file
+      std::ofstream m_file;
+      /// The current size of the file
+      std::uint64_t m_size = 0;
+      /// The offsets of the event records in the file
+      std::vector<std::uint64_t> m_index;
+
+   }; // class EventCaptureWriter
+
+   /// One event of a capture file, as mapped into memory
+   class CapturedEvent
+   {
+   public:
+      /// Constructor with the record of the event in memory
+      explicit CapturedEvent(const std::byte *record);
+
+      /// The run number of the event
+      std::uint64_t run() const;
+      /// The event number of the event
+      std::uint64_t event() const;
+
+      /// Whether the event has a given column
+      bool has(CaptureColumn column) const;
+      /// The values of a column, in place in the mapped file
+      ///
+      /// @return An empty span if the event does not have the column
+      /// @throws std::runtime_error if the column holds another type, or
+      ///         does not fit into the record of the event
+      ///
+      template <typename T>
+      std::span<const T> column(CaptureColumn column) const
+      {
+         const void *data = nullptr;
+         const std::size_t count = find(column, captureType<T>(), data);
+         return {static_cast<const T *>(data), count};
+      }
+
+   private:
+      /// Find a column, returning its size
+      std::size_t find(CaptureColumn column, CaptureType type,
+                       const void *&data) const;
+
+      /// The record of the event
+      const std::byte *m_record;
+
+   }; // class CapturedEvent
+
+   /// Reader of capture files, mapping them into memory
+   ///
+   /// The events are not copied out of the file, their columns are used in
+   /// place. The reader can be used concurrently.
+   ///
+   class EventCaptureReader
+   {
+   public:
+      /// Constructor, mapping the file into memory
+      ///
+      /// @throws std::runtime_error if the file could not be opened, or is
+      ///         not a (valid) capture file
+      ///
+      explicit EventCaptureReader(const std::string &fileName);
+      /// Destructor, unmapping the file
+      ~EventCaptureReader();
+
+      /// The reader can not be copied
+      EventCaptureReader(const EventCaptureReader &) = delete;
+      /// The reader can not be assigned
+      EventCaptureReader &operator=(const EventCaptureReader &) = delete;
+
+      /// The name of the file
+      const std::string &fileName() const { return m_fileName; }
+      /// Whether the file had an index, or its records had to be scanned
+      bool indexed() const { return m_indexed; }
+      /// The number of events in the file
+      std::size_t size() const { return m_index.size(); }
+      /// One of the events of the file
+      CapturedEvent operator[](std::size_t i) const
+      {
+         return CapturedEvent(m_data + m_index[i]);
+      }
+
+   private:
+      /// Find the records by scanning the file
+      void scan();
+
+      /// The name of the file
+      std::string m_fileName;
+      /// The mapped file
+      const std::byte *m_data = nullptr;
+      /// The size of the file
+      std::size_t m_size = 0;
+      /// Whether the file had an index
+      bool m_indexed = false;
+      /// The offsets of the event records in the file
+      std::vector<std::uint64_t> m_index;
+
+   }; // class EventCaptureReader
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_EVENTCAPTURE_H
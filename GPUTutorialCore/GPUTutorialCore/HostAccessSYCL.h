@@ -0,0 +1,90 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_HOSTACCESSSYCL_H
+#define GPUTUTORIALCORE_HOSTACCESSSYCL_H
+
+// SYCL include(s).
+#include <sycl/sycl.hpp>
+
+namespace GPUTutorial
+{
+   namespace SYCL
+   {
+      /// The way the kernels of a device can access host memory
+      enum class HostAccess
+      {
+         /// Through copies only. Like discrete GPUs, for which reading host
+         /// memory from a kernel would mean going over PCIe.
+         Copy,
+         /// Directly, for host (and shared) USM allocations. Like CPU
+         /// devices, which use the same memory as the host.
+         HostUSM,
+         /// Directly, for any host memory. Including @c std::vector and
+         /// aux store arrays, which were not allocated through SYCL.
+         System
+      };
+
+      /// The way the kernels of a device can access host memory
+      ///
+      /// Decided based on the aspects of the device. Only devices that share
+      /// the memory of the host, i.e. CPU devices and devices that can use
+      /// system allocations as USM, get direct access. All other devices
+      /// (including integrated GPUs that do not advertise system
+      /// allocations) use explicit copies.
+      ///
+      inline HostAccess hostAccess(const sycl::device &device)
+      {
+         if (device.has(sycl::aspect::usm_system_allocations))
+         {
+            return HostAccess::System;
+         }
+         if (device.has(sycl::aspect::cpu) &&
+             device.has(sycl::aspect::usm_host_allocations))
+         {
+            return HostAccess::HostUSM;
+         }
+         return HostAccess::Copy;
+      }
+
+      /// Whether a kernel may use some host memory in place
+      ///
+      /// @param access The way the device can access host memory
+      /// @param context The context of the queue running the kernel
+      /// @param ptr The host memory
+      ///
+      inline bool usableInPlace(HostAccess access,
+                                const sycl::context &context, const void *ptr)
+      {
+         switch (access)
+         {
+         case HostAccess::System:
+            return true;
+         case HostAccess::HostUSM:
+         {
+            const sycl::usm::alloc type = sycl::get_pointer_type(ptr, context);
+            return ((type == sycl::usm::alloc::host) ||
+                    (type == sycl::usm::alloc::shared));
+         }
+         default:
+            return false;
+         }
+      }
+
+      /// Describe a way of accessing host memory
+      inline const char *toString(HostAccess access)
+      {
+         switch (access)
+         {
+         case HostAccess::System:
+            return "zero-copy (any host memory)";
+         case HostAccess::HostUSM:
+            return "zero-copy (host USM memory)";
+         default:
+            return "explicit copies";
+         }
+      }
+
+   } // namespace SYCL
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_HOSTACCESSSYCL_H
@@ -0,0 +1,88 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_INSTRUMENTEDMEMORYRESOURCE_H
+#define GPUTUTORIALCORE_INSTRUMENTEDMEMORYRESOURCE_H
+
+// System include(s).
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace GPUTutorial
+{
+   /// Memory resource recording statistics about the use of its upstream
+   ///
+   /// It counts the allocations and deallocations made through it, the
+   /// number of bytes allocated, the largest number of bytes in use at any
+   /// one time, and the time spent in the upstream resource's allocations.
+   /// Placed on top of a caching resource it tells how much memory was
+   /// requested, placed below one it tells how often the cache missed.
+   ///
+   /// The counters are atomic, so the resource is thread-safe if its
+   /// upstream resource is.
+   ///
+   class InstrumentedMemoryResource : public std::pmr::memory_resource
+   {
+   public:
+      /// Statistics collected by the resource
+      struct Statistics
+      {
+         /// Number of allocations
+         std::size_t allocations = 0;
+         /// Number of deallocations
+         std::size_t deallocations = 0;
+         /// Total number of bytes allocated
+         std::size_t bytes = 0;
+         /// Largest number of bytes in use at any one time
+         std::size_t peak = 0;
+         /// Time spent allocating memory
+         std::chrono::nanoseconds time{0};
+
+         /// Add the statistics of another period (taking the larger peak)
+         Statistics &operator+=(const Statistics &other);
+      };
+
+      /// Constructor with the upstream resource
+      explicit InstrumentedMemoryResource(std::pmr::memory_resource &upstream);
+
+      /// The statistics collected since construction, or the last reset
+      Statistics statistics() const;
+      /// Return the statistics collected so far, and start counting anew
+      ///
+      /// The peak of the new period starts from the number of bytes still
+      /// in use. Allocations made concurrently with the reset may be
+      /// accounted to either period.
+      ///
+      Statistics reset();
+
+      /// The number of bytes currently in use
+      std::size_t inUse() const { return m_inUse; }
+
+   private:
+      /// @name Functions implementing @c std::pmr::memory_resource
+      /// @{
+      void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+      void do_deallocate(void *p, std::size_t bytes,
+                         std::size_t alignment) override;
+      bool do_is_equal(
+          const std::pmr::memory_resource &other) const noexcept override;
+      /// @}
+
+      /// The upstream memory resource
+      std::pmr::memory_resource &m_upstream;
+      /// @name Counters
+      /// @{
+      std::atomic<std::size_t> m_allocations{0};
+      std::atomic<std::size_t> m_deallocations{0};
+      std::atomic<std::size_t> m_bytes{0};
+      std::atomic<std::size_t> m_inUse{0};
+      std::atomic<std::size_t> m_peak{0};
+      std::atomic<std::int64_t> m_time{0};
+      /// @}
+
+   }; // class InstrumentedMemoryResource
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_INSTRUMENTEDMEMORYRESOURCE_H
@@ -0,0 +1,32 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_JETARRAYS_H
+#define GPUTUTORIALCORE_JETARRAYS_H
+
+// System include(s).
+#include <cstddef>
+#include <span>
+
+namespace GPUTutorial
+{
+   /// Flat (non-owning) jet and constituent arrays of a jet pull calculation
+   struct JetArrays
+   {
+      /// Jet pT array
+      std::span<const float> jetPt;
+      /// Jet eta array
+      std::span<const float> jetEta;
+      /// Jet phi array
+      std::span<const float> jetPhi;
+      /// Number of constituents for each jet
+      std::span<const std::size_t> nConstituents;
+      /// Flat array of constituent pTs (grouped by jet)
+      std::span<const float> constPt;
+      /// Flat array of constituent etas (grouped by jet)
+      std::span<const float> constEta;
+      /// Flat array of constituent phis (grouped by jet)
+      std::span<const float> constPhi;
+   };
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_JETARRAYS_H
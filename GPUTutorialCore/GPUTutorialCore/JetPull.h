@@ -0,0 +1,100 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_JETPULL_H
+#define GPUTUTORIALCORE_JETPULL_H
+
+// Local include(s).
+#include "GPUTutorialCore/Kinematics.h"
+#include "GPUTutorialCore/SegmentedReduction.h"
+
+// VecMem include(s).
+#include <vecmem/utils/types.hpp>
+
+// System include(s).
+#include <cmath>
+#include <cstddef>
+
+namespace GPUTutorial
+{
+   /// Wrap an angle into the [-π, π) range, without branches
+   using Kinematics::wrapPhi;
+
+   /// Add the contribution of one constituent to the pull of its jet
+   ///
+   /// With c denoting the constituent and j the jet, the jet pull is the
+   /// sum over the constituents of
+   /// (p_T,c/p_T,j) * |[η_c - η_j, φ_c - φ_j]| * [η_c - η_j, φ_c - φ_j]
+   ///
+   /// The same function is used by the host, CUDA and SYCL calculations,
+   /// so that they only differ in the order of the summation.
+   ///
+   VECMEM_HOST_AND_DEVICE
+   inline void addPullContribution(float invJetPt, ///< [in] 1 / jet pT
+                                   float jetEta,   ///< [in] Jet eta
+                                   float jetPhi,   ///< [in] Jet phi
+                                   float pt,       ///< [in] Constituent pT
+                                   float eta,      ///< [in] Constituent eta
+                                   float phi,      ///< [in] Constituent phi
+                                   float &sumEta,  ///< [in,out] Eta sum
+                                   float &sumPhi   ///< [in,out] Phi sum
+   )
+   {
+      const float deltaEta = eta - jetEta;
+      const float deltaPhi = Kinematics::deltaPhi(phi, jetPhi);
+      const float coeff =
+          pt * invJetPt * std::sqrt(deltaEta * deltaEta + deltaPhi * deltaPhi);
+      sumEta += coeff * deltaEta;
+      sumPhi += coeff * deltaPhi;
+   }
+
+   /// The (eta, phi) sums of a jet pull, in a segmented reduction
+   using PullSum = SegmentValue<float, 2>;
+
+   /// Element transformation of a segmented jet pull reduction
+   ///
+   /// Returns the contribution of one constituent to the pull of its jet.
+   ///
+   struct PullContribution
+   {
+      /// @name Jet and constituent arrays, on the host or the device
+      /// @{
+      const float *jetPt;
+      const float *jetEta;
+      const float *jetPhi;
+      const float *constPt;
+      const float *constEta;
+      const float *constPhi;
+      /// @}
+
+      /// The contribution of constituent @c c to the pull of jet @c jet
+      VECMEM_HOST_AND_DEVICE
+      PullSum operator()(std::size_t jet, std::size_t c) const
+      {
+         PullSum result;
+         addPullContribution(1.f / jetPt[jet], jetEta[jet], jetPhi[jet],
+                             constPt[c], constEta[c], constPhi[c], result[0],
+                             result[1]);
+         return result;
+      }
+   };
+
+   /// Output of a segmented jet pull reduction
+   struct PullStore
+   {
+      /// @name Output arrays, on the host or the device
+      /// @{
+      float *pullEta;
+      float *pullPhi;
+      /// @}
+
+      /// Store the pull of jet @c jet
+      VECMEM_HOST_AND_DEVICE
+      void operator()(std::size_t jet, const PullSum &sum) const
+      {
+         pullEta[jet] = sum[0];
+         pullPhi[jet] = wrapPhi(sum[1]);
+      }
+   };
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_JETPULL_H
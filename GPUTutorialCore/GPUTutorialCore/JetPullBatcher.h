@@ -0,0 +1,223 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_JETPULLBATCHER_H
+#define GPUTUTORIALCORE_JETPULLBATCHER_H
+
+// Local include(s).
+#include "GPUTutorialCore/JetArrays.h"
+
+// System include(s).
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace GPUTutorial
+{
+   /// Flat (owning) arrays of a combined, multi-event jet pull calculation
+   struct JetPullBatch
+   {
+      /// Constructor with a memory resource for the (large) arrays
+      explicit JetPullBatch(std::pmr::memory_resource *mr)
+          : jetPt(mr), jetEta(mr), jetPhi(mr), nConstituents(mr),
+            constPt(mr), constEta(mr), constPhi(mr), pullEta(mr),
+            pullPhi(mr) {}
+
+      /// @name Inputs of the calculation
+      /// @{
+
+      std::pmr::vector<float> jetPt;
+      std::pmr::vector<float> jetEta;
+      std::pmr::vector<float> jetPhi;
+      std::pmr::vector<std::size_t> nConstituents;
+      std::pmr::vector<float> constPt;
+      std::pmr::vector<float> constEta;
+      std::pmr::vector<float> constPhi;
+
+      /// @}
+
+      /// @name Outputs of the calculation
+      /// @{
+
+      std::pmr::vector<float> pullEta;
+      std::pmr::vector<float> pullPhi;
+
+      /// @}
+
+      /// Index of the first jet of each event, with an extra "end" slot
+      std::vector<std::size_t> eventOffsets{0};
+
+      /// Number of events in the batch
+      std::size_t size() const { return eventOffsets.size() - 1; }
+
+      /// Append the jets of one event to the batch
+      void append(const JetArrays &event)
+      {
+         jetPt.insert(jetPt.end(), event.jetPt.begin(), event.jetPt.end());
+         jetEta.insert(jetEta.end(), event.jetEta.begin(), event.jetEta.end());
+         jetPhi.insert(jetPhi.end(), event.jetPhi.begin(), event.jetPhi.end());
+         nConstituents.insert(nConstituents.end(),
+                              event.nConstituents.begin(),
+                              event.nConstituents.end());
+         constPt.insert(constPt.end(), event.constPt.begin(),
+                        event.constPt.end());
+         constEta.insert(constEta.end(), event.constEta.begin(),
+                         event.constEta.end());
+         constPhi.insert(constPhi.end(), event.constPhi.begin(),
+                         event.constPhi.end());
+         eventOffsets.push_back(jetPt.size());
+      }
+
+      /// Copy the results belonging to one event out of the batch
+      void extract(std::size_t event, std::span<float> eventPullEta,
+                   std::span<float> eventPullPhi) const
+      {
+         const std::size_t begin = eventOffsets[event];
+         const std::size_t end = eventOffsets[event + 1];
+         std::copy(pullEta.begin() + begin, pullEta.begin() + end,
+                   eventPullEta.begin());
+         std::copy(pullPhi.begin() + begin, pullPhi.begin() + end,
+                   eventPullPhi.begin());
+      }
+
+   }; // struct JetPullBatch
+
+   /// Helper class combining the jet pull calculations of multiple events
+   ///
+   /// Every event calling @c process is added to the currently open batch.
+   /// The event that fills up the batch, or the first one whose waiting time
+   /// runs out, launches the combined calculation for all events in the
+   /// batch, and distributes the results to all of them.
+   ///
+   /// The mutex and condition variable types are template parameters, so that
+   /// fiber aware primitives could be used in asynchronous algorithms.
+   ///
+   template <typename MUTEX = std::mutex,
+             typename CONDVAR = std::condition_variable>
+   class JetPullBatcher
+   {
+   public:
+      /// Function performing the calculation on a whole batch
+      ///
+      /// It needs to fill the @c pullEta and @c pullPhi arrays of the batch,
+      /// and return @c false in case of an error.
+      ///
+      using Function = std::function<bool(JetPullBatch &)>;
+
+      /// Constructor
+      JetPullBatcher(Function function, std::size_t batchSize,
+                     std::chrono::microseconds maxWait,
+                     std::pmr::memory_resource *mr)
+          : m_function(std::move(function)),
+            m_batchSize(std::max(batchSize, std::size_t{1})),
+            m_maxWait(maxWait), m_mr(mr),
+            m_current(std::make_shared<State>(mr)) {}
+
+      /// Process the jets of a single event, as part of a batch
+      ///
+      /// @return @c false if the calculation of the batch failed
+      ///
+      bool process(const JetArrays &event, std::span<float> pullEta,
+                   std::span<float> pullPhi)
+      {
+         std::unique_lock lock(m_mutex);
+
+         // Add the event to the currently open batch.
+         std::shared_ptr<State> state = m_current;
+         const std::size_t index = state->batch.size();
+         state->batch.append(event);
+
+         // If the batch is full, launch it right away.
+         if (state->batch.size() >= m_batchSize)
+         {
+            launch(state, lock);
+         }
+         else
+         {
+            // Otherwise wait for someone else to launch it, or for the
+            // waiting time to run out.
+            const auto deadline = std::chrono::steady_clock::now() + m_maxWait;
+            const bool launched = state->cond.wait_until(
+                lock, deadline,
+                [&]()
+                { return state->launched; });
+            if (!launched)
+            {
+               launch(state, lock);
+            }
+            else
+            {
+               state->cond.wait(lock, [&]()
+                                { return state->done; });
+            }
+         }
+
+         // Copy out the results of this event.
+         if (state->success)
+         {
+            state->batch.extract(index, pullEta, pullPhi);
+         }
+         return state->success;
+      }
+
+   private:
+      /// The shared state of one batch
+      struct State
+      {
+         /// Constructor
+         explicit State(std::pmr::memory_resource *mr) : batch(mr) {}
+         /// The combined arrays
+         JetPullBatch batch;
+         /// Flag set when the batch was launched
+         bool launched = false;
+         /// Flag set when the batch has finished
+         bool done = false;
+         /// Flag showing whether the calculation succeeded
+         bool success = false;
+         /// Condition variable signaling changes in the state
+         CONDVAR cond;
+      };
+
+      /// Launch the calculation of a batch, with the mutex held
+      void launch(const std::shared_ptr<State> &state,
+                  std::unique_lock<MUTEX> &lock)
+      {
+         // Open a new batch for the events coming after this one.
+         state->launched = true;
+         m_current = std::make_shared<State>(m_mr);
+         state->cond.notify_all();
+
+         // Perform the calculation without holding the lock.
+         lock.unlock();
+         const bool success = m_function(state->batch);
+         lock.lock();
+
+         // Let everybody know that the results are ready.
+         state->success = success;
+         state->done = true;
+         state->cond.notify_all();
+      }
+
+      /// The function performing the calculation
+      Function m_function;
+      /// The (maximal) number of events in one batch
+      std::size_t m_batchSize;
+      /// The maximal time that an event would wait for the batch to fill up
+      std::chrono::microseconds m_maxWait;
+      /// The memory resource used by the batches
+      std::pmr::memory_resource *m_mr;
+      /// Mutex protecting the internal state
+      MUTEX m_mutex;
+      /// The batch currently collecting events
+      std::shared_ptr<State> m_current;
+
+   }; // class JetPullBatcher
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_JETPULLBATCHER_H
@@ -0,0 +1,76 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_JETPULLHOST_H
+#define GPUTUTORIALCORE_JETPULLHOST_H
+
+// Local include(s).
+#include "GPUTutorialCore/SegmentedReduction.h"
+
+// System include(s).
+#include <cstddef>
+#include <span>
+
+namespace GPUTutorial
+{
+   namespace Host
+   {
+      /// Calculate jet pull vectors on the host
+      ///
+      /// This is the host equivalent of @c GPUTutorial::Kernels::calculatePulls.
+      /// Jets are processed in parallel using TBB, while the loop over the
+      /// constituents of each jet is written such that the compiler could
+      /// vectorize it.
+      ///
+      void calculatePulls(
+          std::span<const float> jetPt,                ///< [in] Jet pT array
+          std::span<const float> jetEta,               ///< [in] Jet eta array
+          std::span<const float> jetPhi,               ///< [in] Jet phi array
+          std::span<const std::size_t> nConstituents,  ///< [in] number of constituents for each jet
+          std::span<const float> constPt,              ///< [in] flat array of constituent pTs (grouped by jet)
+          std::span<const float> constEta,             ///< [in] flat array of constituent etas (grouped by jet)
+          std::span<const float> constPhi,             ///< [in] flat array of constituent phis (grouped by jet)
+          std::span<float> jetPullEta,                 ///< [out] eta component of each jet pull vector
+          std::span<float> jetPullPhi,                 ///< [out] phi component of each jet pull vector
+          std::size_t grainSize = 16                   ///< [in] number of jets per TBB task
+      );
+
+      /// Calculate jet pull vectors on the host, with a segmented reduction
+      ///
+      /// Same as @c GPUTutorial::Host::calculatePulls, but the work is split
+      /// into TBB tasks of equal merge-path length (see
+      /// @c GPUTutorial::Host::segmentedReduce), instead of equal numbers of
+      /// jets. Which balances the load much better if a few jets have many
+      /// more constituents than the rest.
+      ///
+      void calculatePullsSegmented(
+          std::span<const float> jetPt,                ///< [in] Jet pT array
+          std::span<const float> jetEta,               ///< [in] Jet eta array
+          std::span<const float> jetPhi,               ///< [in] Jet phi array
+          std::span<const std::size_t> nConstituents,  ///< [in] number of constituents for each jet
+          std::span<const float> constPt,              ///< [in] flat array of constituent pTs (grouped by jet)
+          std::span<const float> constEta,             ///< [in] flat array of constituent etas (grouped by jet)
+          std::span<const float> constPhi,             ///< [in] flat array of constituent phis (grouped by jet)
+          std::span<float> jetPullEta,                 ///< [out] eta component of each jet pull vector
+          std::span<float> jetPullPhi,                 ///< [out] phi component of each jet pull vector
+          const SegmentedReductionConfig &config = {}  ///< [in] configuration of the reduction
+      );
+
+      /// Compare two sets of jet pull vectors
+      ///
+      /// The eta components are compared directly, while the phi components
+      /// are compared through their difference wrapped into [-π, π). A pair of
+      /// values is considered to agree if
+      /// |reference - other| <= absTolerance + relTolerance * |reference|.
+      ///
+      /// @return The number of jets for which the two results disagree
+      ///
+      std::size_t comparePulls(std::span<const float> referenceEta,
+                               std::span<const float> referencePhi,
+                               std::span<const float> otherEta,
+                               std::span<const float> otherPhi,
+                               float relTolerance, float absTolerance);
+
+   } // namespace Host
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_JETPULLHOST_H
@@ -0,0 +1,255 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_JETSUBSTRUCTURE_H
+#define GPUTUTORIALCORE_JETSUBSTRUCTURE_H
+
+// Local include(s).
+#include "GPUTutorialCore/JetArrays.h"
+#include "GPUTutorialCore/Kinematics.h"
+#include "GPUTutorialCore/SegmentedReduction.h"
+
+// VecMem include(s).
+#include <vecmem/utils/types.hpp>
+
+// System include(s).
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace GPUTutorial
+{
+   /// Jet substructure observables, calculated in a single fused pass
+   ///
+   /// All of them are sums over the constituents of a jet, so a single
+   /// (segmented) reduction over the gathered constituent arrays yields all
+   /// of the requested ones together.
+   ///
+   enum class JetObservable : unsigned int
+   {
+      /// The pull vector, (pullEta, pullPhi)
+      Pull = 1u << 0,
+      /// Σ p_T,i ΔR_i / p_T,jet
+      Girth = 1u << 1,
+      /// Σ p_T,i ΔR_i / Σ p_T,i
+      Width = 1u << 2,
+      /// √(Σ p_T,i²) / Σ p_T,i
+      PtD = 1u << 3,
+      /// Energy correlation ratio e3 e1 / e2², with β = 1
+      C2 = 1u << 4,
+      /// Energy correlation ratio e3 e1³ / e2³, with β = 1
+      D2 = 1u << 5
+   };
+
+   /// A set of @c GPUTutorial::JetObservable values, OR-ed together
+   using JetObservableSet = unsigned int;
+
+   /// Check whether a set contains an observable
+   VECMEM_HOST_AND_DEVICE
+   constexpr bool contains(JetObservableSet set, JetObservable observable)
+   {
+      return (set & static_cast<unsigned int>(observable)) != 0;
+   }
+
+   /// Parse a list of observable names ("Pull", "Girth", "Width", "PtD",
+   /// "C2" and "D2") into a set
+   ///
+   /// @throws std::invalid_argument for unknown names
+   ///
+   JetObservableSet parseJetObservables(const std::vector<std::string> &names);
+   /// Describe a set of observables, as a comma separated list of names
+   std::string toString(JetObservableSet set);
+
+   /// Output arrays of the fused substructure pass, on the host or a device
+   ///
+   /// Every array has one element per jet. The arrays of the observables
+   /// that are not calculated may be null.
+   ///
+   struct SubstructureArrays
+   {
+      /// @name Output arrays, named after the observables
+      /// @{
+      float *pullEta = nullptr;
+      float *pullPhi = nullptr;
+      float *girth = nullptr;
+      float *width = nullptr;
+      float *ptD = nullptr;
+      float *c2 = nullptr;
+      float *d2 = nullptr;
+      /// @}
+   };
+
+   /// The output arrays of @c GPUTutorial::SubstructureArrays, with the
+   /// names of the decorations that they are written into
+   inline constexpr std::array<std::pair<const char *, float *SubstructureArrays::*>, 7>
+       SUBSTRUCTURE_OUTPUTS = {{{"pullEta", &SubstructureArrays::pullEta},
+                                {"pullPhi", &SubstructureArrays::pullPhi},
+                                {"girth", &SubstructureArrays::girth},
+                                {"width", &SubstructureArrays::width},
+                                {"ptD", &SubstructureArrays::ptD},
+                                {"C2", &SubstructureArrays::c2},
+                                {"D2", &SubstructureArrays::d2}}};
+
+   /// Lay out the output arrays of some observables in a single buffer
+   ///
+   /// The buffer (on the host or a device) has to hold
+   /// @c SUBSTRUCTURE_OUTPUTS.size() * @c nJets elements. The arrays of the
+   /// observables that are not requested are left null.
+   ///
+   SubstructureArrays makeSubstructureArrays(JetObservableSet observables,
+                                             float *buffer, std::size_t nJets);
+
+   /// The sums of the fused substructure pass, in a segmented reduction
+   ///
+   /// The components are: the two pull sums, Σ z_i ΔR_i, Σ z_i, Σ z_i²,
+   /// e2 and e3. With z_i = p_T,i / p_T,jet, so that the energy
+   /// correlations stay well within the range of single precision.
+   ///
+   using SubstructureSum = SegmentValue<float, 7>;
+
+   /// Element transformation of the fused substructure reduction
+   ///
+   /// Returns the contribution of one constituent to all of the requested
+   /// sums. The pair and triplet sums of the energy correlations are
+   /// attributed to the first constituent of every pair / triplet, which
+   /// makes them quadratic / cubic in the number of constituents. So C2 and
+   /// D2 should only be requested when they are needed.
+   ///
+   struct SubstructureContribution
+   {
+      /// @name Jet and constituent arrays, on the host or the device
+      /// @{
+      const float *jetPt;
+      const float *jetEta;
+      const float *jetPhi;
+      const std::size_t *offsets;
+      const float *constPt;
+      const float *constEta;
+      const float *constPhi;
+      /// @}
+      /// The observables to calculate
+      JetObservableSet observables;
+
+      /// The contribution of constituent @c c to the sums of jet @c jet
+      VECMEM_HOST_AND_DEVICE
+      SubstructureSum operator()(std::size_t jet, std::size_t c) const
+      {
+         SubstructureSum result;
+         const float invJetPt = 1.f / jetPt[jet];
+         const float z = constPt[c] * invJetPt;
+
+         // The terms depending on the distance from the jet axis.
+         const float deltaEta = constEta[c] - jetEta[jet];
+         const float deltaPhi = Kinematics::deltaPhi(constPhi[c], jetPhi[jet]);
+         const float deltaR =
+             std::sqrt(deltaEta * deltaEta + deltaPhi * deltaPhi);
+         if (contains(observables, JetObservable::Pull))
+         {
+            const float coeff = z * deltaR;
+            result[0] = coeff * deltaEta;
+            result[1] = coeff * deltaPhi;
+         }
+         if (contains(observables, JetObservable::Girth) ||
+             contains(observables, JetObservable::Width))
+         {
+            result[2] = z * deltaR;
+         }
+         result[3] = z;
+         result[4] = z * z;
+
+         // The energy correlations, with the constituents after this one.
+         if (contains(observables, JetObservable::C2) ||
+             contains(observables, JetObservable::D2))
+         {
+            const std::size_t end = offsets[jet + 1];
+            float e2 = 0.f;
+            float e3 = 0.f;
+            for (std::size_t j = c + 1; j < end; ++j)
+            {
+               const float zj = constPt[j] * invJetPt;
+               const float rij = Kinematics::deltaR(constEta[c], constPhi[c],
+                                                    constEta[j], constPhi[j]);
+               e2 += zj * rij;
+               for (std::size_t k = j + 1; k < end; ++k)
+               {
+                  const float zk = constPt[k] * invJetPt;
+                  e3 += zj * zk * rij *
+                        Kinematics::deltaR(constEta[c], constPhi[c],
+                                           constEta[k], constPhi[k]) *
+                        Kinematics::deltaR(constEta[j], constPhi[j],
+                                           constEta[k], constPhi[k]);
+               }
+            }
+            result[5] = z * e2;
+            result[6] = z * e3;
+         }
+         return result;
+      }
+   };
+
+   /// Output of the fused substructure reduction
+   struct SubstructureStore
+   {
+      /// The output arrays
+      SubstructureArrays outputs;
+      /// The observables to store
+      JetObservableSet observables;
+
+      /// Store the observables of jet @c jet
+      VECMEM_HOST_AND_DEVICE
+      void operator()(std::size_t jet, const SubstructureSum &sum) const
+      {
+         const float sumZ = sum[3];
+         const float invSumZ = ((sumZ > 0.f) ? 1.f / sumZ : 0.f);
+         if (contains(observables, JetObservable::Pull))
+         {
+            outputs.pullEta[jet] = sum[0];
+            outputs.pullPhi[jet] = Kinematics::wrapPhi(sum[1]);
+         }
+         if (contains(observables, JetObservable::Girth))
+         {
+            outputs.girth[jet] = sum[2];
+         }
+         if (contains(observables, JetObservable::Width))
+         {
+            outputs.width[jet] = sum[2] * invSumZ;
+         }
+         if (contains(observables, JetObservable::PtD))
+         {
+            outputs.ptD[jet] = std::sqrt(sum[4]) * invSumZ;
+         }
+         const float e2 = sum[5];
+         const float e3 = sum[6];
+         const float e1OverE2 = ((e2 > 0.f) ? sumZ / e2 : 0.f);
+         if (contains(observables, JetObservable::C2))
+         {
+            outputs.c2[jet] = e3 * e1OverE2 * ((e2 > 0.f) ? 1.f / e2 : 0.f);
+         }
+         if (contains(observables, JetObservable::D2))
+         {
+            outputs.d2[jet] = e3 * e1OverE2 * e1OverE2 * e1OverE2;
+         }
+      }
+   };
+
+   namespace Host
+   {
+      /// Calculate jet substructure observables on the host
+      ///
+      /// All of the requested observables are calculated by a single
+      /// segmented reduction over the constituents (see
+      /// @c GPUTutorial::Host::segmentedReduce).
+      ///
+      void calculateSubstructure(
+          const JetArrays &input,                     ///< [in] Jets and constituents
+          JetObservableSet observables,               ///< [in] Observables to calculate
+          const SubstructureArrays &outputs,          ///< [out] Host arrays of the observables
+          const SegmentedReductionConfig &config = {} ///< [in] configuration of the reduction
+      );
+
+   } // namespace Host
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_JETSUBSTRUCTURE_H
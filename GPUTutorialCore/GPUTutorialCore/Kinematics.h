@@ -0,0 +1,197 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_KINEMATICS_H
+#define GPUTUTORIALCORE_KINEMATICS_H
+
+// VecMem include(s).
+#include <vecmem/utils/types.hpp>
+
+// System include(s).
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <span>
+
+namespace GPUTutorial
+{
+   /// Kinematic helper functions, shared by the host and device code
+   ///
+   /// The scalar functions can be called from host, CUDA and SYCL code
+   /// alike. They avoid @c fmodf and @c hypotf, which are slow on every
+   /// backend, and are written with selects instead of branches, so that
+   /// they also vectorise on the host. The span overloads apply them to
+   /// whole arrays on the host.
+   ///
+   namespace Kinematics
+   {
+      /// @name Constants
+      /// @{
+
+      /// π
+      constexpr float PI = std::numbers::pi_v<float>;
+      /// 2π
+      constexpr float TWO_PI = 2.f * PI;
+      /// 1 / π
+      constexpr float INV_PI = std::numbers::inv_pi_v<float>;
+      /// 1 / 2π
+      constexpr float INV_TWO_PI = 0.5f * INV_PI;
+
+      /// @}
+
+      /// @name Scalar functions
+      /// @{
+
+      /// Wrap any angle into the [-π, π) range
+      VECMEM_HOST_AND_DEVICE
+      inline float wrapPhi(float phi)
+      {
+         return phi - TWO_PI * std::floor((phi + PI) * INV_TWO_PI);
+      }
+
+      /// The difference of two azimuthal angles, in the [-π, π) range
+      ///
+      /// The angles are expected in the [-π, π] range, as the phi of
+      /// particles is. Instead of a division and a rounding, like
+      /// @c wrapPhi, it needs just two selects. The result is correct for
+      /// any pair of angles that differ by less than 3π.
+      ///
+      VECMEM_HOST_AND_DEVICE
+      constexpr float deltaPhi(float phi1, float phi2)
+      {
+         const float d = phi1 - phi2;
+         const float up = d + ((d < -PI) ? TWO_PI : 0.f);
+         return up - ((up >= PI) ? TWO_PI : 0.f);
+      }
+
+      /// The squared (eta, phi) distance of two directions
+      VECMEM_HOST_AND_DEVICE
+      constexpr float deltaR2(float eta1, float phi1, float eta2, float phi2)
+      {
+         const float dEta = eta1 - eta2;
+         const float dPhi = deltaPhi(phi1, phi2);
+         return dEta * dEta + dPhi * dPhi;
+      }
+
+      /// The (eta, phi) distance of two directions
+      VECMEM_HOST_AND_DEVICE
+      inline float deltaR(float eta1, float phi1, float eta2, float phi2)
+      {
+         return std::sqrt(deltaR2(eta1, phi1, eta2, phi2));
+      }
+
+      /// Add a pT weighted value to a sum
+      VECMEM_HOST_AND_DEVICE
+      constexpr void addPtWeighted(float pt, float value, float &sum)
+      {
+         sum += pt * value;
+      }
+
+      /// @}
+
+      /// @name Host functions, for whole arrays
+      /// @{
+
+      /// Number of independent partial sums, used by the pT weighted sums
+      ///
+      /// Floating point additions are not associative, so without such
+      /// explicit "lanes" the compiler would not be allowed to vectorise the
+      /// sums. Also used by the host jet pull calculation.
+      ///
+      constexpr std::size_t SUM_LANES = 8;
+
+      /// The differences of azimuthal angles from an axis
+      inline void deltaPhi(std::span<const float> phi, ///< [in] Angles
+                           float axisPhi,              ///< [in] Axis angle
+                           std::span<float> result     ///< [out] Differences
+      )
+      {
+         assert(result.size() == phi.size());
+         for (std::size_t i = 0; i < phi.size(); ++i)
+         {
+            result[i] = deltaPhi(phi[i], axisPhi);
+         }
+      }
+
+      /// The (eta, phi) distances of directions from an axis
+      inline void deltaR(std::span<const float> eta, ///< [in] Direction etas
+                         std::span<const float> phi, ///< [in] Direction phis
+                         float axisEta,              ///< [in] Axis eta
+                         float axisPhi,              ///< [in] Axis phi
+                         std::span<float> result     ///< [out] Distances
+      )
+      {
+         assert((phi.size() == eta.size()) && (result.size() == eta.size()));
+         for (std::size_t i = 0; i < eta.size(); ++i)
+         {
+            result[i] = std::sqrt(deltaR2(eta[i], phi[i], axisEta, axisPhi));
+         }
+      }
+
+      /// The pT weighted sum of some values
+      inline float ptWeightedSum(std::span<const float> pt,    ///< [in] pTs
+                                 std::span<const float> values ///< [in] Values
+      )
+      {
+         assert(values.size() == pt.size());
+         float sum[SUM_LANES] = {};
+         std::size_t i = 0;
+         for (; i + SUM_LANES <= pt.size(); i += SUM_LANES)
+         {
+            for (std::size_t l = 0; l < SUM_LANES; ++l)
+            {
+               addPtWeighted(pt[i + l], values[i + l], sum[l]);
+            }
+         }
+         for (std::size_t l = 0; i < pt.size(); ++i, ++l)
+         {
+            addPtWeighted(pt[i], values[i], sum[l]);
+         }
+         float result = 0.f;
+         for (std::size_t l = 0; l < SUM_LANES; ++l)
+         {
+            result += sum[l];
+         }
+         return result;
+      }
+
+      /// The pT weighted sum of the (eta, phi) distances from an axis
+      inline float
+      ptWeightedDeltaR(std::span<const float> pt,  ///< [in] Particle pTs
+                       std::span<const float> eta, ///< [in] Particle etas
+                       std::span<const float> phi, ///< [in] Particle phis
+                       float axisEta,              ///< [in] Axis eta
+                       float axisPhi               ///< [in] Axis phi
+      )
+      {
+         assert((eta.size() == pt.size()) && (phi.size() == pt.size()));
+         float sum[SUM_LANES] = {};
+         std::size_t i = 0;
+         for (; i + SUM_LANES <= pt.size(); i += SUM_LANES)
+         {
+            for (std::size_t l = 0; l < SUM_LANES; ++l)
+            {
+               addPtWeighted(pt[i + l],
+                             deltaR(eta[i + l], phi[i + l], axisEta, axisPhi),
+                             sum[l]);
+            }
+         }
+         for (std::size_t l = 0; i < pt.size(); ++i, ++l)
+         {
+            addPtWeighted(pt[i], deltaR(eta[i], phi[i], axisEta, axisPhi),
+                          sum[l]);
+         }
+         float result = 0.f;
+         for (std::size_t l = 0; l < SUM_LANES; ++l)
+         {
+            result += sum[l];
+         }
+         return result;
+      }
+
+      /// @}
+
+   } // namespace Kinematics
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_KINEMATICS_H
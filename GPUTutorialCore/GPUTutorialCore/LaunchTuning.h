@@ -0,0 +1,203 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_LAUNCHTUNING_H
+#define GPUTUTORIALCORE_LAUNCHTUNING_H
+
+// System include(s).
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace GPUTutorial
+{
+   /// Launch parameters of a (one dimensional) kernel
+   struct LaunchConfig
+   {
+      /// Number of work-items (threads) in a work-group (block)
+      std::size_t workGroupSize = 256;
+      /// Number of elements (or vectors) processed by every work-item
+      std::size_t itemsPerThread = 1;
+
+      /// Parse a "WORKGROUPSIZE[xITEMSPERTHREAD]" string, like "256x4"
+      ///
+      /// @throws std::invalid_argument for a malformed string, or zero
+      ///         values
+      ///
+      static LaunchConfig parse(const std::string &text);
+      /// Describe the parameters, in the format understood by @c parse
+      std::string toString() const;
+
+      /// Number of work-groups needed to cover @c n elements
+      std::size_t nWorkGroups(std::size_t n) const
+      {
+         const std::size_t perGroup = workGroupSize * itemsPerThread;
+         return (n + perGroup - 1) / perGroup;
+      }
+      /// Total number of work-items needed to cover @c n elements
+      std::size_t globalSize(std::size_t n) const
+      {
+         return nWorkGroups(n) * workGroupSize;
+      }
+
+      /// Comparison operator
+      bool operator==(const LaunchConfig &) const = default;
+
+   }; // struct LaunchConfig
+
+   /// File caching the tuned launch parameters of kernels, per device
+   ///
+   /// The file is a plain text file, with one "device<TAB>kernel<TAB>
+   /// parameters" line per entry. It is read once, when the cache is
+   /// created, and rewritten with every @c store. The rewrite merges the
+   /// entries currently in the file, so that the algorithms (and jobs)
+   /// sharing a file do not lose each others' entries. The new file is
+   /// written next to the old one and renamed over it, so a job never reads
+   /// a partially written file.
+   ///
+   class LaunchTuningCache
+   {
+   public:
+      /// Constructor with the name of the file
+      ///
+      /// A missing file is treated as an empty cache.
+      ///
+      /// @throws std::runtime_error if an existing file can not be parsed
+      ///
+      explicit LaunchTuningCache(std::string fileName);
+
+      /// The cached parameters of a kernel on a device, if there are any
+      std::optional<LaunchConfig> find(const std::string &device,
+                                       const std::string &kernel) const;
+      /// Store the parameters of a kernel on a device, and update the file
+      ///
+      /// @throws std::runtime_error if the file can not be written
+      ///
+      void store(const std::string &device, const std::string &kernel,
+                 const LaunchConfig &config);
+
+      /// The name of the cache file
+      const std::string &fileName() const { return m_fileName; }
+      /// Number of entries in the cache
+      std::size_t size() const;
+
+   private:
+      /// Key of the entries, (device, kernel)
+      using Key = std::pair<std::string, std::string>;
+      /// Type of the entries
+      using Entries = std::map<Key, LaunchConfig>;
+
+      /// Read the entries of the file, if it exists
+      Entries read() const;
+
+      /// The name of the cache file
+      std::string m_fileName;
+      /// Mutex protecting the entries
+      mutable std::mutex m_mutex;
+      /// The cached entries
+      Entries m_entries;
+
+   }; // class LaunchTuningCache
+
+   /// Picks the launch parameters of a kernel with timing runs
+   ///
+   /// Every candidate (a combination of the configured work-group sizes and
+   /// items per work-item) is timed a few times on a representative input,
+   /// and the fastest one is chosen. Results are looked up in, and written
+   /// to, a @c LaunchTuningCache, so that later jobs on the same device
+   /// skip the timing runs.
+   ///
+   class LaunchTuner
+   {
+   public:
+      /// Type used for the timings
+      using Duration = std::chrono::duration<double>;
+      /// Function launching a kernel with some parameters, and waiting for
+      /// it to finish
+      using Function = std::function<void(const LaunchConfig &)>;
+
+      /// Configuration of the tuning
+      struct Config
+      {
+         /// Work-group sizes to try
+         std::vector<std::size_t> workGroupSizes{32, 64, 128, 256, 512, 1024};
+         /// Numbers of items per work-item to try
+         std::vector<std::size_t> itemsPerThread{1, 2, 4, 8};
+         /// Largest work-group size supported by the device (0: no limit)
+         std::size_t maxWorkGroupSize = 0;
+         /// Number of timed runs per candidate, the fastest one being used
+         unsigned int repetitions = 5;
+      };
+
+      /// Result of tuning a kernel
+      struct Result
+      {
+         /// The chosen launch parameters
+         LaunchConfig config;
+         /// Whether the parameters were taken from the cache
+         bool cached = false;
+         /// Number of candidates timed
+         std::size_t nCandidates = 0;
+         /// Time of the chosen parameters (zero if taken from the cache)
+         Duration time{0.};
+         /// Time of the slowest candidate (zero if taken from the cache)
+         Duration slowest{0.};
+
+         /// Describe how the parameters were chosen
+         std::string toString() const;
+      };
+
+      /// Constructor with a cache (which may be null) and a configuration
+      LaunchTuner(LaunchTuningCache *cache, const Config &config);
+
+      /// The candidates to time, given the configuration
+      std::vector<LaunchConfig> candidates() const;
+
+      /// Pick the launch parameters of a kernel on a device
+      ///
+      /// Cached parameters are used if they are still among the
+      /// candidates. Otherwise all candidates are timed with @c run, after a
+      /// warm-up call, and the fastest one is stored in the cache.
+      ///
+      /// @throws std::invalid_argument if there are no candidates
+      /// @throws Any exception thrown by @c run
+      ///
+      Result tune(const std::string &device, const std::string &kernel,
+                  const Function &run) const;
+
+   private:
+      /// The cache of the results, if any
+      LaunchTuningCache *m_cache;
+      /// The configuration of the tuning
+      Config m_config;
+
+   }; // class LaunchTuner
+
+   /// Choose the launch parameters of a kernel, as configured by a user
+   ///
+   /// @param setting "auto" to tune the parameters, or fixed parameters in
+   ///                the format of @c GPUTutorial::LaunchConfig::parse
+   /// @param cacheFile The cache of the tuned parameters (none if empty)
+   /// @param device The name of the device
+   /// @param kernel The name of the kernel
+   /// @param config The configuration of the tuning
+   /// @param run Function launching the kernel, see @c LaunchTuner::tune
+   ///
+   /// @throws std::invalid_argument for an invalid setting, or fixed
+   ///         parameters not supported by the device
+   /// @throws std::runtime_error if the cache file can not be used
+   ///
+   LaunchTuner::Result selectLaunchConfig(const std::string &setting,
+                                          const std::string &cacheFile,
+                                          const std::string &device,
+                                          const std::string &kernel,
+                                          const LaunchTuner::Config &config,
+                                          const LaunchTuner::Function &run);
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_LAUNCHTUNING_H
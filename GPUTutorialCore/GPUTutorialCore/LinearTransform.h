@@ -0,0 +1,61 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_LINEARTRANSFORM_H
+#define GPUTUTORIALCORE_LINEARTRANSFORM_H
+
+// Local include(s).
+#include "GPUTutorialCore/ElementWise.h"
+
+// VecMem include(s).
+#include <vecmem/utils/types.hpp>
+
+// System include(s).
+#include <span>
+
+namespace GPUTutorial
+{
+   /// The very simple linear transformation performed by the examples
+   VECMEM_HOST_AND_DEVICE
+   inline float linearTransform(float x)
+   {
+      return 2.0f * x + 1.0f;
+   }
+
+   /// The same linear transformation, as an element-wise expression
+   inline constexpr auto linearTransformExpression =
+       2.0f * ElementWise::arg<0> + 1.0f;
+
+   /// The transformations of the element-wise chain benchmark
+   ///
+   /// The linear transformation of the values, followed by a few more
+   /// cheap steps, which a naive implementation would run one after the
+   /// other, each reading and writing all of the values.
+   ///
+   namespace ElementWiseChain
+   {
+      /// Standardise the linearly transformed values, to roughly unit width
+      inline constexpr auto standardise =
+          (ElementWise::arg<0> - 1.0f) * (1.0f / 1155.0f);
+      /// Square the values
+      inline constexpr auto square = ElementWise::arg<0> * ElementWise::arg<0>;
+      /// Squash the values into [0, 1)
+      inline constexpr auto squash =
+          ElementWise::arg<0> / (ElementWise::arg<0> + 1.0f);
+
+      /// All steps, fused into a single transformation
+      inline constexpr auto fused = ElementWise::fuse(
+          linearTransformExpression, standardise, square, squash);
+
+   } // namespace ElementWiseChain
+
+   namespace Host
+   {
+      /// Perform the linear transformation on the host
+      void linearTransform(std::span<const float> input, ///< [in] Input array
+                           std::span<float> output       ///< [out] Output array
+      );
+
+   } // namespace Host
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_LINEARTRANSFORM_H
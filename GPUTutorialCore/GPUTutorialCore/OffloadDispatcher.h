@@ -0,0 +1,211 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_OFFLOADDISPATCHER_H
+#define GPUTUTORIALCORE_OFFLOADDISPATCHER_H
+
+// System include(s).
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace GPUTutorial
+{
+   /// Where a calculation is run
+   enum class OffloadTarget
+   {
+      Host,  ///< On the host
+      Device ///< On the accelerator, including all transfers
+   };
+
+   /// Linear cost model of a calculation on the host and on a device
+   ///
+   /// Both sides are described by a fixed cost per call (allocations,
+   /// launches, transfer latencies, ...) and a cost per element. For most
+   /// offloaded calculations the device has the larger fixed cost, and the
+   /// smaller cost per element, which gives a threshold on the number of
+   /// elements above which offloading pays off.
+   ///
+   struct OffloadCostModel
+   {
+      /// Type used for the costs
+      using Duration = std::chrono::duration<double>;
+
+      /// One timing measurement, used to fit the model
+      struct Sample
+      {
+         /// Number of elements processed
+         std::size_t n = 0;
+         /// Time that the processing took
+         Duration time{0.};
+      };
+
+      /// Fixed cost of a calculation on the host
+      Duration hostOverhead{0.};
+      /// Cost of processing one element on the host
+      Duration hostPerElement{0.};
+      /// Fixed cost of a calculation on the device
+      Duration deviceOverhead{0.};
+      /// Cost of processing one element on the device
+      Duration devicePerElement{0.};
+
+      /// Expected time of processing @c n elements on the host
+      Duration hostTime(std::size_t n) const;
+      /// Expected time of processing @c n elements on the device
+      Duration deviceTime(std::size_t n) const;
+      /// The smallest number of elements to offload
+      ///
+      /// The device is only used above the threshold. If it is faster only
+      /// for small numbers of elements (with a smaller fixed cost, but a
+      /// larger cost per element), nothing is offloaded.
+      ///
+      /// @return @c std::numeric_limits<std::size_t>::max() if the device
+      ///         would never be faster for large enough numbers of elements
+      ///
+      std::size_t threshold() const;
+
+      /// Fit the model to timing measurements on the host and the device
+      ///
+      /// Both sides are fitted with a straight line, with negative fit
+      /// results (from noisy measurements) set to zero.
+      ///
+      /// @throws std::invalid_argument if either side has less than two
+      ///         different sizes measured
+      ///
+      static OffloadCostModel fit(std::span<const Sample> host,
+                                  std::span<const Sample> device);
+
+   }; // struct OffloadCostModel
+
+   /// Decides per call whether to run a calculation on the host or a device
+   ///
+   /// The decision is made by comparing the number of elements to process
+   /// with a threshold. The threshold either comes from an
+   /// @c OffloadCostModel, typically calibrated with short timing runs at
+   /// the start of the job, or is set explicitly.
+   ///
+   /// The configuration is meant to be set up before the processing
+   /// starts. @c decide can be called concurrently, and counts the decisions
+   /// that it makes.
+   ///
+   class OffloadDispatcher
+   {
+   public:
+      /// Function processing a given number of (synthetic) elements
+      using Function = std::function<void(std::size_t)>;
+
+      /// Configuration of the calibration
+      struct CalibrationConfig
+      {
+         /// The sizes to time the host and the device with
+         std::vector<std::size_t> sizes{1, 16, 256, 4096, 65536};
+         /// Number of runs per size, the fastest one being used
+         unsigned int repetitions = 5;
+      };
+
+      /// Count of the decisions made
+      struct Counters
+      {
+         /// Number of calls run on the host
+         std::size_t hostCalls = 0;
+         /// Number of elements processed on the host
+         std::size_t hostElements = 0;
+         /// Number of calls run on the device
+         std::size_t deviceCalls = 0;
+         /// Number of elements processed on the device
+         std::size_t deviceElements = 0;
+      };
+
+      /// Calibrate the cost model with timing runs
+      ///
+      /// @c host and @c device are both called with each of the configured
+      /// sizes, @c repetitions times, after a warm-up call each. The
+      /// threshold is set from the fitted model, unless it was overridden.
+      ///
+      /// @return The fitted cost model
+      ///
+      const OffloadCostModel &calibrate(const Function &host,
+                                        const Function &device,
+                                        const CalibrationConfig &config);
+      /// Set the cost model explicitly
+      void setModel(const OffloadCostModel &model);
+      /// The current cost model, if one was calibrated or set
+      const std::optional<OffloadCostModel> &model() const { return m_model; }
+
+      /// Override the threshold of the cost model
+      void setThreshold(std::size_t threshold);
+      /// The smallest number of elements offloaded to the device
+      std::size_t threshold() const { return m_threshold; }
+
+      /// Decide where to process @c n elements, and count the decision
+      OffloadTarget decide(std::size_t n);
+
+      /// The counts of the decisions made so far
+      Counters counters() const;
+      /// Print a summary of the configuration and the decisions
+      void printSummary(std::ostream &out) const;
+
+   private:
+      /// The cost model
+      std::optional<OffloadCostModel> m_model;
+      /// Flag set when the threshold was set explicitly
+      bool m_thresholdOverridden = false;
+      /// The smallest number of elements to offload (never by default)
+      std::size_t m_threshold = std::numeric_limits<std::size_t>::max();
+
+      /// @name Decision counters
+      /// @{
+      std::atomic<std::size_t> m_hostCalls{0};
+      std::atomic<std::size_t> m_hostElements{0};
+      std::atomic<std::size_t> m_deviceCalls{0};
+      std::atomic<std::size_t> m_deviceElements{0};
+      /// @}
+
+   }; // class OffloadDispatcher
+
+   /// Stand-in for a slow accelerator, running the calculations on the host
+   ///
+   /// Every call is delayed by a fixed launch latency, and by the time that
+   /// moving the given amount of data would take with the configured
+   /// bandwidth. The calculation itself is run on the calling thread. This
+   /// allows exercising the offload logic of the algorithms without an
+   /// accelerator.
+   ///
+   class MockDevice
+   {
+   public:
+      /// Type used for the latency
+      using Duration = std::chrono::duration<double>;
+
+      /// Constructor with the latency and bandwidth of the "device"
+      MockDevice(Duration latency, double bytesPerSecond);
+
+      /// Run a calculation on the "device"
+      template <typename FUNCTION>
+      void run(std::size_t bytes, FUNCTION &&function) const
+      {
+         delay(bytes);
+         function();
+      }
+
+      /// The time that moving @c bytes takes, including the latency
+      Duration cost(std::size_t bytes) const;
+
+   private:
+      /// Wait for the (simulated) latency and transfers
+      void delay(std::size_t bytes) const;
+
+      /// The latency of every call
+      Duration m_latency;
+      /// The bandwidth of the (simulated) transfers
+      double m_bytesPerSecond;
+
+   }; // class MockDevice
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_OFFLOADDISPATCHER_H
@@ -0,0 +1,190 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_SEGMENTEDREDUCTION_H
+#define GPUTUTORIALCORE_SEGMENTEDREDUCTION_H
+
+// VecMem include(s).
+#include <vecmem/utils/types.hpp>
+
+// System include(s).
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace GPUTutorial
+{
+   /// Fixed size set of values summed up by a segmented reduction
+   ///
+   /// A segmented reduction reduces every segment of a flat array (like the
+   /// constituents of every jet) into one such value.
+   ///
+   template <typename T, std::size_t N>
+   struct SegmentValue
+   {
+      /// The components of the value
+      T values[N] = {};
+
+      /// Access one component (non-const)
+      VECMEM_HOST_AND_DEVICE
+      T &operator[](std::size_t i) { return values[i]; }
+      /// Access one component (const)
+      VECMEM_HOST_AND_DEVICE
+      const T &operator[](std::size_t i) const { return values[i]; }
+
+      /// Add another value to this one, component by component
+      VECMEM_HOST_AND_DEVICE
+      SegmentValue &operator+=(const SegmentValue &rhs)
+      {
+         for (std::size_t i = 0; i < N; ++i)
+         {
+            values[i] += rhs.values[i];
+         }
+         return *this;
+      }
+   };
+
+   /// Find where a diagonal crosses the merge path of a segmented reduction
+   ///
+   /// The merge path walks through the segment ends and the elements of
+   /// a segmented array, consuming the elements of segment x while there
+   /// are any left, and then closing the segment. Diagonal d crosses the
+   /// path after x segments were closed and d - x elements were consumed.
+   /// Splitting the path into pieces of equal length balances the work of
+   /// visiting elements and finishing segments, no matter how long the
+   /// segments are.
+   ///
+   /// @param offsets The offsets of the segments (nSegments + 1 values,
+   ///                starting with 0)
+   /// @param nSegments The number of segments
+   /// @param diagonal The diagonal, in [0, nSegments + offsets[nSegments]]
+   /// @return The number of segments closed before the diagonal
+   ///
+   VECMEM_HOST_AND_DEVICE
+   inline std::size_t mergePathSearch(const std::size_t *offsets,
+                                      std::size_t nSegments,
+                                      std::size_t diagonal)
+   {
+      // Find the largest x with offsets[x] + x <= diagonal.
+      std::size_t low = 0;
+      std::size_t high = (diagonal < nSegments ? diagonal : nSegments);
+      while (low < high)
+      {
+         const std::size_t mid = (low + high + 1) / 2;
+         if (offsets[mid] + mid <= diagonal)
+         {
+            low = mid;
+         }
+         else
+         {
+            high = mid - 1;
+         }
+      }
+      return low;
+   }
+
+   /// Configuration of the segmented reduction
+   ///
+   /// On a device, segments are reduced by a single work-item, by a sub-group
+   /// or by a merge-path split over multiple work-groups, depending on their
+   /// length. On the host all segments are reduced with a merge-path split
+   /// over TBB tasks.
+   ///
+   struct SegmentedReductionConfig
+   {
+      /// Longest segment reduced by a single work-item
+      std::size_t threadMaxLength = 16;
+      /// Longest segment reduced by a single sub-group
+      std::size_t subGroupMaxLength = 256;
+      /// Number of elements reduced by one work-group in the merge-path
+      /// split of the longest segments
+      ///
+      /// Must not be larger than @c subGroupMaxLength + 1, so that a tile
+      /// would never touch more than two segments.
+      ///
+      std::size_t tileSize = 256;
+      /// Number of work-items in the work-groups of the reduction
+      std::size_t workGroupSize = 128;
+      /// Number of merge-path diagonals (segments + elements) handled by
+      /// one TBB task on the host
+      std::size_t hostGrainSize = 4096;
+
+      /// Check that the configuration is valid
+      ///
+      /// @throws std::invalid_argument if it is not
+      ///
+      void validate() const;
+   };
+
+   /// The segments of an array, grouped by how they are to be reduced
+   ///
+   /// The plan is made on the host, from the segment offsets that the host
+   /// already knows about when it prepares the inputs of a calculation.
+   ///
+   class SegmentedReductionPlan
+   {
+   public:
+      /// Constructor with the segment offsets and the configuration
+      ///
+      /// @param offsets The offsets of the segments (nSegments + 1 values,
+      ///                starting with 0)
+      /// @param config The configuration of the reduction
+      /// @param mr Memory resource for the arrays of the plan
+      ///
+      /// @throws std::invalid_argument for an invalid configuration
+      ///
+      SegmentedReductionPlan(
+          std::span<const std::size_t> offsets,
+          const SegmentedReductionConfig &config,
+          std::pmr::memory_resource *mr = std::pmr::get_default_resource());
+
+      /// The configuration of the reduction
+      const SegmentedReductionConfig &config() const { return m_config; }
+      /// The number of segments
+      std::size_t nSegments() const { return m_nSegments; }
+
+      /// Segments reduced by a single work-item
+      std::span<const std::uint32_t> threadSegments() const
+      {
+         return m_threadSegments;
+      }
+      /// Segments reduced by a single sub-group
+      std::span<const std::uint32_t> subGroupSegments() const
+      {
+         return m_subGroupSegments;
+      }
+      /// Segments reduced with a merge-path split over multiple work-groups
+      std::span<const std::uint32_t> mergePathSegments() const
+      {
+         return m_mergePathSegments;
+      }
+      /// Offsets of the merge-path segments, when laid out after each other
+      ///
+      /// Has one more element than @c mergePathSegments().
+      ///
+      std::span<const std::size_t> mergePathOffsets() const
+      {
+         return m_mergePathOffsets;
+      }
+      /// The number of merge-path tiles
+      std::size_t nTiles() const;
+
+   private:
+      /// The configuration of the reduction
+      SegmentedReductionConfig m_config;
+      /// The number of segments
+      std::size_t m_nSegments = 0;
+      /// Segments reduced by a single work-item
+      std::pmr::vector<std::uint32_t> m_threadSegments;
+      /// Segments reduced by a single sub-group
+      std::pmr::vector<std::uint32_t> m_subGroupSegments;
+      /// Segments reduced with a merge-path split
+      std::pmr::vector<std::uint32_t> m_mergePathSegments;
+      /// Offsets of the merge-path segments, when laid out after each other
+      std::pmr::vector<std::size_t> m_mergePathOffsets;
+
+   }; // class SegmentedReductionPlan
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_SEGMENTEDREDUCTION_H
@@ -0,0 +1,171 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_SEGMENTEDREDUCTIONHOST_H
+#define GPUTUTORIALCORE_SEGMENTEDREDUCTIONHOST_H
+
+// Local include(s).
+#include "GPUTutorialCore/SegmentedReduction.h"
+
+// TBB include(s).
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+// System include(s).
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace GPUTutorial
+{
+   namespace Host
+   {
+      /// Reduce every segment of a flat array on the host
+      ///
+      /// The merge path of the segments (see
+      /// @c GPUTutorial::mergePathSearch) is split into pieces of
+      /// @c grainSize diagonals, each reduced by one TBB task. So a single
+      /// very long segment is shared by many tasks, while many short ones
+      /// are reduced by the same task. The partial sums of the segments
+      /// crossing the task boundaries are combined sequentially at the end.
+      ///
+      /// @param offsets The offsets of the segments (nSegments + 1 values,
+      ///                starting with 0)
+      /// @param transform Functor returning the @c VALUE of one element, when
+      ///                  called with (segment index, element index)
+      /// @param store Functor receiving the sum of every segment, when called
+      ///              with (segment index, @c VALUE). Called exactly once for
+      ///              every segment, possibly concurrently for different ones.
+      /// @param grainSize Number of merge-path diagonals per TBB task
+      /// @param mr Memory resource for the partial sums of the tasks
+      ///
+      template <typename VALUE, typename TRANSFORM, typename STORE>
+      void segmentedReduce(
+          std::span<const std::size_t> offsets, TRANSFORM &&transform,
+          STORE &&store, std::size_t grainSize = 4096,
+          std::pmr::memory_resource *mr = std::pmr::get_default_resource())
+      {
+         // Handle the trivial case.
+         if (offsets.size() < 2)
+         {
+            return;
+         }
+         assert(offsets.front() == 0);
+         const std::size_t nSegments = offsets.size() - 1;
+         const std::size_t total = nSegments + offsets.back();
+         grainSize = std::max(grainSize, std::size_t{1});
+         const std::size_t nTasks = (total + grainSize - 1) / grainSize;
+
+         /// Partial sums of the segments crossing the task boundaries
+         struct Partial
+         {
+            /// Sum of the last segment, that a previous task started
+            VALUE head{};
+            /// Index of the segment of @c head
+            std::size_t headSegment = 0;
+            /// Whether this task finished a segment started by another one
+            bool hasHead = false;
+            /// Sum of the first segment, that a following task finishes
+            VALUE carry{};
+            /// Index of the segment of @c carry
+            std::size_t carrySegment = 0;
+            /// Whether this task left a segment for a following one
+            bool hasCarry = false;
+         };
+         std::pmr::vector<Partial> partials(nTasks, mr);
+
+         // Walk the pieces of the merge path in parallel.
+         tbb::parallel_for(
+             tbb::blocked_range<std::size_t>(0, nTasks, 1),
+             [&](const tbb::blocked_range<std::size_t> &range)
+             {
+                for (std::size_t task = range.begin(); task != range.end();
+                     ++task)
+                {
+                   // Find the start and end of this piece of the path.
+                   const std::size_t d0 = task * grainSize;
+                   const std::size_t d1 = std::min(d0 + grainSize, total);
+                   const std::size_t x0 =
+                       mergePathSearch(offsets.data(), nSegments, d0);
+                   const std::size_t y0 = d0 - x0;
+
+                   // Walk the path.
+                   Partial &partial = partials[task];
+                   VALUE sum{};
+                   std::size_t x = x0;
+                   std::size_t y = y0;
+                   while (x + y < d1)
+                   {
+                      // Consume the elements of the current segment.
+                      const std::size_t end = std::min(offsets[x + 1], d1 - x);
+                      for (; y < end; ++y)
+                      {
+                         sum += transform(x, y);
+                      }
+                      if (x + y == d1)
+                      {
+                         break;
+                      }
+                      // Close the segment. Unless it was started by a
+                      // previous task, in which case the sum is partial.
+                      if ((x == x0) && (y0 > offsets[x0]))
+                      {
+                         partial.head = sum;
+                         partial.headSegment = x;
+                         partial.hasHead = true;
+                      }
+                      else
+                      {
+                         store(x, sum);
+                      }
+                      sum = VALUE{};
+                      ++x;
+                   }
+
+                   // Leave the open segment for the following task(s).
+                   if ((x < nSegments) && (y > ((x == x0) ? y0 : offsets[x])))
+                   {
+                      partial.carry = sum;
+                      partial.carrySegment = x;
+                      partial.hasCarry = true;
+                   }
+                }
+             });
+
+         // Combine the partial sums of the segments shared by the tasks.
+         VALUE running{};
+         std::size_t runningSegment = nSegments;
+         for (const Partial &partial : partials)
+         {
+            if (partial.hasHead)
+            {
+               VALUE sum{};
+               if (runningSegment == partial.headSegment)
+               {
+                  sum = running;
+               }
+               sum += partial.head;
+               store(partial.headSegment, sum);
+               runningSegment = nSegments;
+            }
+            if (partial.hasCarry)
+            {
+               if (runningSegment == partial.carrySegment)
+               {
+                  running += partial.carry;
+               }
+               else
+               {
+                  running = partial.carry;
+                  runningSegment = partial.carrySegment;
+               }
+            }
+         }
+      }
+
+   } // namespace Host
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_SEGMENTEDREDUCTIONHOST_H
@@ -0,0 +1,391 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_SEGMENTEDREDUCTIONSYCL_H
+#define GPUTUTORIALCORE_SEGMENTEDREDUCTIONSYCL_H
+
+// Local include(s).
+#include "GPUTutorialCore/SegmentedReduction.h"
+
+// SYCL include(s).
+#include <sycl/sycl.hpp>
+
+// System include(s).
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace GPUTutorial
+{
+   namespace Kernels
+   {
+      /// @name Kernel names of @c GPUTutorial::SYCL::SegmentedReducer
+      /// @{
+
+      /// Kernel reducing the shortest segments, one work-item per segment
+      template <typename NAME>
+      class SegmentedReduceThreads;
+      /// Kernel reducing the medium segments, one sub-group per segment
+      template <typename NAME>
+      class SegmentedReduceSubGroups;
+      /// Kernel reducing the merge-path tiles of the longest segments
+      template <typename NAME>
+      class SegmentedReduceTiles;
+      /// Kernel combining the tile results of the longest segments
+      template <typename NAME>
+      class SegmentedReduceCombine;
+
+      /// @}
+
+   } // namespace Kernels
+
+   namespace SYCL
+   {
+      /// Load balanced segmented reduction on a SYCL device
+      ///
+      /// Reduces the segments of a flat array with the strategy chosen for
+      /// them by a @c GPUTutorial::SegmentedReductionPlan. Short segments
+      /// are reduced by a single work-item, medium ones by a sub-group, and
+      /// the longest ones are split into tiles of equal size along their
+      /// merge path, with the tiles' partial sums combined by a second
+      /// kernel. So no work-group idles on a short segment, while no single
+      /// one is stuck with a very long one.
+      ///
+      /// The device arrays of the plan are kept between the calls, and are
+      /// only re-allocated when they need to grow.
+      ///
+      template <typename T, std::size_t N>
+      class SegmentedReducer
+      {
+      public:
+         /// The type of the per-segment sums
+         using value_type = SegmentValue<T, N>;
+
+         /// Constructor with the queue and a device memory resource
+         SegmentedReducer(sycl::queue &queue,
+                          std::pmr::memory_resource &deviceMR)
+             : m_queue(queue), m_mr(deviceMR)
+         {
+            const std::vector<std::size_t> sizes =
+                queue.get_device().get_info<sycl::info::device::sub_group_sizes>();
+            m_maxSubGroupSize = (sizes.empty()
+                                     ? 1
+                                     : *std::max_element(sizes.begin(),
+                                                         sizes.end()));
+         }
+         /// Disallow copies
+         SegmentedReducer(const SegmentedReducer &) = delete;
+         /// Disallow assignment
+         SegmentedReducer &operator=(const SegmentedReducer &) = delete;
+         /// Destructor
+         ~SegmentedReducer()
+         {
+            for (Block *block : {&m_threadSegments, &m_subGroupSegments,
+                                 &m_mergePathSegments, &m_mergePathOffsets,
+                                 &m_partials})
+            {
+               if (block->m_ptr != nullptr)
+               {
+                  m_mr.deallocate(block->m_ptr, block->m_size);
+               }
+            }
+         }
+
+         /// Copy the arrays of a plan to the device
+         ///
+         /// @return The events of the copies
+         ///
+         std::vector<sycl::event> upload(const SegmentedReductionPlan &plan)
+         {
+            std::vector<sycl::event> result;
+            upload(m_threadSegments, plan.threadSegments(), result);
+            upload(m_subGroupSegments, plan.subGroupSegments(), result);
+            upload(m_mergePathSegments, plan.mergePathSegments(), result);
+            upload(m_mergePathOffsets, plan.mergePathOffsets(), result);
+            get<value_type>(m_partials, 2 * plan.nTiles());
+            return result;
+         }
+
+         /// Reduce the segments of an array on the device
+         ///
+         /// @param plan The plan of the reduction, already uploaded with
+         ///             @c upload
+         /// @param offsets The offsets of the segments, on the device
+         /// @param transform Functor returning the @c value_type of one
+         ///                  element, when called with (segment index,
+         ///                  element index)
+         /// @param store Functor receiving the sum of every segment, when
+         ///              called with (segment index, @c value_type)
+         /// @param deps Events that the reduction has to wait for
+         /// @return The events of the kernels
+         ///
+         template <typename NAME, typename TRANSFORM, typename STORE>
+         std::vector<sycl::event>
+         reduce(const SegmentedReductionPlan &plan, const std::size_t *offsets,
+                TRANSFORM transform, STORE store,
+                const std::vector<sycl::event> &deps = {})
+         {
+            const SegmentedReductionConfig &config = plan.config();
+            const std::size_t wgSize = config.workGroupSize;
+            std::vector<sycl::event> result;
+
+            // Short segments, one work-item each.
+            const std::size_t nThread = plan.threadSegments().size();
+            if (nThread > 0)
+            {
+               const std::uint32_t *segments =
+                   static_cast<const std::uint32_t *>(m_threadSegments.m_ptr);
+               result.push_back(m_queue.submit(
+                   [&](sycl::handler &h)
+                   {
+                      h.depends_on(deps);
+                      h.parallel_for<Kernels::SegmentedReduceThreads<NAME>>(
+                          sycl::nd_range<1>{roundUp(nThread, wgSize), wgSize},
+                          [=](sycl::nd_item<1> item)
+                          {
+                             const std::size_t i = item.get_global_id(0);
+                             if (i >= nThread)
+                             {
+                                return;
+                             }
+                             const std::size_t segment = segments[i];
+                             value_type sum;
+                             for (std::size_t e = offsets[segment];
+                                  e < offsets[segment + 1]; ++e)
+                             {
+                                sum += transform(segment, e);
+                             }
+                             store(segment, sum);
+                          });
+                   }));
+            }
+
+            // Medium segments, one sub-group each. Every work-group holds
+            // at least wgSize / m_maxSubGroupSize sub-groups, with the
+            // sub-groups looping over the segments in case there are more.
+            const std::size_t nSubGroup = plan.subGroupSegments().size();
+            if (nSubGroup > 0)
+            {
+               const std::uint32_t *segments =
+                   static_cast<const std::uint32_t *>(m_subGroupSegments.m_ptr);
+               const std::size_t nGroups =
+                   roundUp(nSubGroup * m_maxSubGroupSize, wgSize) / wgSize;
+               result.push_back(m_queue.submit(
+                   [&](sycl::handler &h)
+                   {
+                      h.depends_on(deps);
+                      h.parallel_for<Kernels::SegmentedReduceSubGroups<NAME>>(
+                          sycl::nd_range<1>{nGroups * wgSize, wgSize},
+                          [=](sycl::nd_item<1> item)
+                          {
+                             const sycl::sub_group sg = item.get_sub_group();
+                             const std::size_t sgPerGroup =
+                                 sg.get_group_linear_range();
+                             const std::size_t lane = sg.get_local_linear_id();
+                             const std::size_t sgSize =
+                                 sg.get_local_linear_range();
+                             for (std::size_t s = item.get_group_linear_id() *
+                                                      sgPerGroup +
+                                                  sg.get_group_linear_id();
+                                  s < nSubGroup; s += nGroups * sgPerGroup)
+                             {
+                                const std::size_t segment = segments[s];
+                                value_type sum;
+                                for (std::size_t e = offsets[segment] + lane;
+                                     e < offsets[segment + 1]; e += sgSize)
+                                {
+                                   sum += transform(segment, e);
+                                }
+                                for (std::size_t i = 0; i < N; ++i)
+                                {
+                                   sum[i] = sycl::reduce_over_group(
+                                       sg, sum[i], sycl::plus<T>());
+                                }
+                                if (lane == 0)
+                                {
+                                   store(segment, sum);
+                                }
+                             }
+                          });
+                   }));
+            }
+
+            // Long segments, split into tiles of equal length. Since every
+            // long segment is at least as long as a tile, a tile may only
+            // touch two of them.
+            const std::size_t nLong = plan.mergePathSegments().size();
+            const std::size_t nTiles = plan.nTiles();
+            if (nTiles > 0)
+            {
+               const std::uint32_t *segments =
+                   static_cast<const std::uint32_t *>(m_mergePathSegments.m_ptr);
+               const std::size_t *longOffsets =
+                   static_cast<const std::size_t *>(m_mergePathOffsets.m_ptr);
+               value_type *partials =
+                   static_cast<value_type *>(m_partials.m_ptr);
+               const std::size_t tileSize = config.tileSize;
+               const std::size_t total = plan.mergePathOffsets().back();
+               sycl::event tiles = m_queue.submit(
+                   [&](sycl::handler &h)
+                   {
+                      h.depends_on(deps);
+                      h.parallel_for<Kernels::SegmentedReduceTiles<NAME>>(
+                          sycl::nd_range<1>{nTiles * wgSize, wgSize},
+                          [=](sycl::nd_item<1> item)
+                          {
+                             // Find the segment that the tile starts in.
+                             const std::size_t tile = item.get_group_linear_id();
+                             const std::size_t begin = tile * tileSize;
+                             const std::size_t end =
+                                 std::min(begin + tileSize, total);
+                             std::size_t low = 0;
+                             std::size_t high = nLong - 1;
+                             while (low < high)
+                             {
+                                const std::size_t mid = (low + high + 1) / 2;
+                                if (longOffsets[mid] <= begin)
+                                {
+                                   low = mid;
+                                }
+                                else
+                                {
+                                   high = mid - 1;
+                                }
+                             }
+                             const std::size_t boundary = longOffsets[low + 1];
+
+                             // Sum up the elements of (up to) two segments.
+                             value_type sum[2];
+                             for (std::size_t v = begin + item.get_local_id(0);
+                                  v < end; v += item.get_local_range(0))
+                             {
+                                const std::size_t slot = (v < boundary) ? 0 : 1;
+                                const std::size_t j = low + slot;
+                                const std::size_t segment = segments[j];
+                                sum[slot] += transform(
+                                    segment,
+                                    offsets[segment] + (v - longOffsets[j]));
+                             }
+                             const sycl::group<1> group = item.get_group();
+                             for (std::size_t slot = 0; slot < 2; ++slot)
+                             {
+                                for (std::size_t i = 0; i < N; ++i)
+                                {
+                                   sum[slot][i] = sycl::reduce_over_group(
+                                       group, sum[slot][i], sycl::plus<T>());
+                                }
+                             }
+                             if (item.get_local_id(0) == 0)
+                             {
+                                partials[2 * tile] = sum[0];
+                                partials[2 * tile + 1] = sum[1];
+                             }
+                          });
+                   });
+               result.push_back(tiles);
+
+               // Combine the partial sums of the tiles.
+               result.push_back(m_queue.submit(
+                   [&](sycl::handler &h)
+                   {
+                      h.depends_on(tiles);
+                      h.parallel_for<Kernels::SegmentedReduceCombine<NAME>>(
+                          sycl::nd_range<1>{roundUp(nLong, wgSize), wgSize},
+                          [=](sycl::nd_item<1> item)
+                          {
+                             const std::size_t j = item.get_global_id(0);
+                             if (j >= nLong)
+                             {
+                                return;
+                             }
+                             const std::size_t firstTile =
+                                 longOffsets[j] / tileSize;
+                             const std::size_t lastTile =
+                                 (longOffsets[j + 1] - 1) / tileSize;
+                             value_type sum;
+                             for (std::size_t t = firstTile; t <= lastTile; ++t)
+                             {
+                                // The segment is the second one in its first
+                                // tile, unless it starts that tile.
+                                const std::size_t slot =
+                                    ((t == firstTile) &&
+                                     (longOffsets[j] != t * tileSize))
+                                        ? 1
+                                        : 0;
+                                sum += partials[2 * t + slot];
+                             }
+                             store(segments[j], sum);
+                          });
+                   }));
+            }
+            return result;
+         }
+
+      private:
+         /// Device memory block that is only ever grown
+         struct Block
+         {
+            /// Pointer to the memory block
+            void *m_ptr = nullptr;
+            /// Size of the memory block
+            std::size_t m_size = 0;
+         };
+
+         /// Get a block of (at least) the requested size
+         template <typename U>
+         U *get(Block &block, std::size_t n)
+         {
+            const std::size_t bytes = std::max(n, std::size_t{1}) * sizeof(U);
+            if (bytes > block.m_size)
+            {
+               if (block.m_ptr != nullptr)
+               {
+                  m_mr.deallocate(block.m_ptr, block.m_size);
+               }
+               block.m_ptr = m_mr.allocate(bytes);
+               block.m_size = bytes;
+            }
+            return static_cast<U *>(block.m_ptr);
+         }
+         /// Copy an array of the plan into a device block
+         template <typename U>
+         void upload(Block &block, std::span<const U> data,
+                     std::vector<sycl::event> &events)
+         {
+            U *ptr = get<U>(block, data.size());
+            if (!data.empty())
+            {
+               events.push_back(
+                   m_queue.memcpy(ptr, data.data(), data.size_bytes()));
+            }
+         }
+         /// Round up a size to a multiple of another
+         static std::size_t roundUp(std::size_t n, std::size_t multiple)
+         {
+            return (n + multiple - 1) / multiple * multiple;
+         }
+
+         /// The queue to run the reduction on
+         sycl::queue &m_queue;
+         /// The memory resource to allocate the device arrays with
+         std::pmr::memory_resource &m_mr;
+         /// The largest sub-group size of the device
+         std::size_t m_maxSubGroupSize = 1;
+
+         /// @name Device arrays of the plan
+         /// @{
+         Block m_threadSegments;
+         Block m_subGroupSegments;
+         Block m_mergePathSegments;
+         Block m_mergePathOffsets;
+         Block m_partials;
+         /// @}
+
+      }; // class SegmentedReducer
+
+   } // namespace SYCL
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_SEGMENTEDREDUCTIONSYCL_H
@@ -0,0 +1,183 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_STAGETIMELINE_H
+#define GPUTUTORIALCORE_STAGETIMELINE_H
+
+// TBB include(s).
+#include <tbb/concurrent_vector.h>
+
+// System include(s).
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace GPUTutorial
+{
+   /// Job-wide record of how long the stages of the algorithms took
+   ///
+   /// Every algorithm ("source") registers itself with the timeline, and
+   /// then records the start time and duration of the stages of its events.
+   /// Stages measured on the host, and stages measured on a device (with
+   /// CUDA events or SYCL event profiling) are kept on separate tracks.
+   ///
+   /// Recording is thread-safe and does not lock. The timeline can print
+   /// per-stage summaries, and can write all records as a Chrome trace
+   /// (https://ui.perfetto.dev, or chrome://tracing), with one row per
+   /// source and event slot.
+   ///
+   class StageTimeline
+   {
+   public:
+      /// Clock used for all host side time measurements
+      using Clock = std::chrono::steady_clock;
+
+      /// Slot number used for work not belonging to a single event
+      static constexpr std::size_t NO_SLOT =
+          std::numeric_limits<std::size_t>::max();
+
+      /// Where a stage was measured
+      enum class Track
+      {
+         Host,  ///< With the host clock
+         Device ///< With device events
+      };
+
+      /// One timed stage
+      struct Record
+      {
+         /// The source (algorithm) of the stage
+         std::size_t source = 0;
+         /// The name of the stage (a string literal)
+         const char *stage = nullptr;
+         /// The event slot that the stage was executed for
+         std::size_t slot = NO_SLOT;
+         /// The event that the stage was executed for
+         std::size_t event = 0;
+         /// The thread that recorded the stage
+         std::thread::id thread;
+         /// The (host) time that the stage started at
+         Clock::time_point start;
+         /// The duration of the stage
+         Clock::duration duration{0};
+         /// Where the stage was measured
+         Track track = Track::Host;
+      };
+
+      /// Summary of all records of one stage
+      struct StageSummary
+      {
+         /// The name of the stage
+         std::string stage;
+         /// Where the stage was measured
+         Track track = Track::Host;
+         /// The number of times the stage was executed
+         std::size_t count = 0;
+         /// Total time spent in the stage
+         Clock::duration total{0};
+         /// Shortest execution of the stage
+         Clock::duration min = Clock::duration::max();
+         /// Longest execution of the stage
+         Clock::duration max{0};
+      };
+
+      /// Default constructor
+      StageTimeline();
+
+      /// The timeline shared by all users in the job
+      ///
+      /// The timeline is created on the first call, and lives for as long
+      /// as any of its users keeps a pointer to it.
+      ///
+      static std::shared_ptr<StageTimeline> shared();
+
+      /// Register a source, returning its identifier
+      std::size_t registerSource(const std::string &name);
+      /// Record one stage
+      void record(const Record &record);
+
+      /// Summarise the stages of one source, in order of first appearance
+      std::vector<StageSummary> summary(std::size_t source) const;
+      /// Print the summary of one source as a table
+      void printSummary(std::ostream &out, std::size_t source) const;
+      /// Write all records as a Chrome trace
+      void writeChromeTrace(std::ostream &out) const;
+      /// Write all records as a Chrome trace into a file
+      ///
+      /// @throws std::runtime_error if the file could not be written
+      ///
+      void writeChromeTrace(const std::string &fileName) const;
+
+   private:
+      /// The time that all others are measured relative to
+      Clock::time_point m_start;
+      /// Mutex protecting the source names
+      mutable std::mutex m_sourceMutex;
+      /// The names of the sources
+      std::vector<std::string> m_sources;
+      /// All records
+      tbb::concurrent_vector<Record> m_records;
+
+   }; // class StageTimeline
+
+   /// Identifies the source, slot and event that stages are recorded for
+   ///
+   /// A default constructed context records nothing, which is how timing
+   /// is switched off.
+   ///
+   struct StageContext
+   {
+      /// The timeline to record into (none if null)
+      StageTimeline *timeline = nullptr;
+      /// The source (algorithm) of the stages
+      std::size_t source = 0;
+      /// The event slot
+      std::size_t slot = StageTimeline::NO_SLOT;
+      /// The event number
+      std::size_t event = 0;
+
+      /// Check whether anything should be recorded
+      bool enabled() const { return timeline != nullptr; }
+      /// Record one stage (if enabled)
+      void record(const char *stage, StageTimeline::Clock::time_point start,
+                  StageTimeline::Clock::duration duration,
+                  StageTimeline::Track track =
+                      StageTimeline::Track::Host) const;
+   };
+
+   /// Helper timing a scope (or part of it) with the host clock
+   class ScopedStageTimer
+   {
+   public:
+      /// Constructor, starting the timer
+      ScopedStageTimer(const StageContext &context, const char *stage);
+      /// Destructor, stopping the timer if it is still running
+      ~ScopedStageTimer() { stop(); }
+
+      /// The timer can not be copied
+      ScopedStageTimer(const ScopedStageTimer &) = delete;
+      /// The timer can not be assigned
+      ScopedStageTimer &operator=(const ScopedStageTimer &) = delete;
+
+      /// Stop the timer, recording the stage
+      void stop();
+
+   private:
+      /// The context to record the stage for
+      const StageContext &m_context;
+      /// The name of the stage
+      const char *m_stage;
+      /// The start time of the stage
+      StageTimeline::Clock::time_point m_start;
+      /// Whether the timer is running
+      bool m_running;
+
+   }; // class ScopedStageTimer
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_STAGETIMELINE_H
@@ -0,0 +1,131 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_SYNTHETICEVENTS_H
+#define GPUTUTORIALCORE_SYNTHETICEVENTS_H
+
+// System include(s).
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace GPUTutorial
+{
+   /// Description of the distribution of a (per-event/per-object) multiplicity
+   struct SizeDistribution
+   {
+      /// Available distribution types
+      enum class Type
+      {
+         Fixed,       ///< Always @c mean
+         Uniform,     ///< Uniform in [0, 2 * @c mean]
+         Poisson,     ///< Poisson distribution with @c mean
+         Exponential  ///< Exponential distribution with @c mean (skewed)
+      };
+
+      /// The type of the distribution
+      Type type = Type::Poisson;
+      /// The mean of the distribution
+      double mean = 10.;
+      /// The largest value ever returned (0 for "no limit")
+      std::size_t max = 0;
+
+      /// Draw a value from the distribution
+      std::size_t operator()(std::mt19937_64 &rng) const;
+
+      /// Construct a distribution from a "type:mean[:max]" string
+      ///
+      /// For instance "poisson:25", "fixed:100" or "exponential:20:500".
+      ///
+      static SizeDistribution parse(const std::string &spec);
+      /// Convert the distribution back into a "type:mean[:max]" string
+      std::string toString() const;
+
+   }; // struct SizeDistribution
+
+   /// Synthetic, "xAOD-like" electron
+   struct SyntheticElectron
+   {
+      float pt = 0.f;
+      float eta = 0.f;
+      float phi = 0.f;
+      float m = 0.f;
+      std::uint16_t author = 0;
+      /// Output of the calibration
+      float calibratedPt = 0.f;
+   };
+
+   /// Synthetic, "xAOD-like" jet constituent
+   struct SyntheticConstituent
+   {
+      float pt = 0.f;
+      float eta = 0.f;
+      float phi = 0.f;
+      float m = 0.f;
+   };
+
+   /// Synthetic, "xAOD-like" jet
+   struct SyntheticJet
+   {
+      float pt = 0.f;
+      float eta = 0.f;
+      float phi = 0.f;
+      float m = 0.f;
+      /// The constituents of the jet
+      std::vector<SyntheticConstituent> constituents;
+      /// Output of the jet pull calculation
+      float pullEta = 0.f;
+      /// Output of the jet pull calculation
+      float pullPhi = 0.f;
+   };
+
+   /// A synthetic event
+   struct SyntheticEvent
+   {
+      /// Input of the linear transformation
+      std::vector<float> values;
+      /// Output of the linear transformation
+      std::vector<float> transformedValues;
+      /// Electrons in the event
+      std::vector<SyntheticElectron> electrons;
+      /// Jets in the event
+      std::vector<SyntheticJet> jets;
+   };
+
+   /// Configuration of the synthetic event generation
+   struct SyntheticEventConfig
+   {
+      /// Number of values to transform linearly per event
+      SizeDistribution nValues{SizeDistribution::Type::Fixed, 1000000, 0};
+      /// Number of electrons per event
+      SizeDistribution nElectrons{SizeDistribution::Type::Poisson, 3, 0};
+      /// Number of jets per event
+      SizeDistribution nJets{SizeDistribution::Type::Poisson, 30, 0};
+      /// Number of constituents per jet
+      SizeDistribution nConstituents{SizeDistribution::Type::Poisson, 25,
+                                     0};
+      /// Seed for the random number generator
+      std::uint64_t seed = 1234;
+   };
+
+   /// Generator of synthetic events
+   class SyntheticEventGenerator
+   {
+   public:
+      /// Constructor with a configuration
+      explicit SyntheticEventGenerator(const SyntheticEventConfig &config);
+
+      /// Generate one event
+      SyntheticEvent generate();
+
+   private:
+      /// The configuration of the generator
+      SyntheticEventConfig m_config;
+      /// The random number generator
+      std::mt19937_64 m_rng;
+
+   }; // class SyntheticEventGenerator
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_SYNTHETICEVENTS_H
@@ -0,0 +1,368 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_TRANSFERENCODING_H
+#define GPUTUTORIALCORE_TRANSFERENCODING_H
+
+// Local include(s).
+#include "GPUTutorialCore/JetArrays.h"
+
+// VecMem include(s).
+#include <vecmem/utils/types.hpp>
+
+// System include(s).
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace GPUTutorial
+{
+   /// The ways of encoding a floating point column for a transfer
+   enum class FloatEncoding : unsigned int
+   {
+      /// The values are transferred as they are
+      Float32 = 0,
+      /// The values are quantized into a fixed range, with up to 16 bits
+      FixedPoint = 1,
+      /// The (scaled) values are transferred as IEEE half precision floats
+      Half = 2
+   };
+
+   /// The ways of encoding the constituent counts of the jets
+   enum class CountEncoding : unsigned int
+   {
+      /// The counts are transferred as @c std::size_t values
+      Size = 0,
+      /// The counts are transferred as 16-bit values
+      Count16 = 1,
+      /// The (nJets + 1) offsets of the jets are transferred as 32-bit values
+      Offset32 = 2
+   };
+
+   namespace details
+   {
+      /// Re-interpret the bits of a value as another type
+      template <typename TO, typename FROM>
+      VECMEM_HOST_AND_DEVICE inline TO bitCast(FROM value)
+      {
+         static_assert(sizeof(TO) == sizeof(FROM));
+         TO result;
+         std::memcpy(&result, &value, sizeof(TO));
+         return result;
+      }
+   } // namespace details
+
+   /// Convert a float to IEEE half precision, rounding to nearest even
+   ///
+   /// Values too large for a half precision float become infinities, NaNs
+   /// stay NaNs. All cases are calculated, and the right one is selected
+   /// with bit masks, so that loops over the conversion can be vectorized.
+   ///
+   VECMEM_HOST_AND_DEVICE
+   inline std::uint16_t floatToHalf(float value)
+   {
+      const std::uint32_t bits = details::bitCast<std::uint32_t>(value);
+      const std::uint32_t sign = (bits >> 16) & 0x8000u;
+      const std::uint32_t abs = bits & 0x7fffffffu;
+      // Normal numbers: re-bias the exponent, and round the mantissa.
+      const std::uint32_t normal =
+          (abs + 0xc8000fffu + ((abs >> 13) & 0x1u)) >> 13;
+      // Sub-normal numbers: let the FPU align the mantissa.
+      const std::uint32_t subnormal =
+          details::bitCast<std::uint32_t>(details::bitCast<float>(abs) + 0.5f) -
+          0x3f000000u;
+      // Values too large to represent, infinities and NaNs.
+      const std::uint32_t special =
+          0x7c00u | ((abs > 0x7f800000u) ? 0x0200u : 0u);
+      // Select the right result.
+      const std::uint32_t isSubnormal =
+          0u - static_cast<std::uint32_t>(abs < 0x38800000u);
+      const std::uint32_t isSpecial =
+          0u - static_cast<std::uint32_t>(abs >= 0x47800000u);
+      const std::uint32_t finite =
+          (subnormal & isSubnormal) | (normal & ~isSubnormal);
+      return static_cast<std::uint16_t>(
+          (special & isSpecial) | (finite & ~isSpecial) | sign);
+   }
+
+   /// Convert an IEEE half precision value to a float
+   VECMEM_HOST_AND_DEVICE
+   inline float halfToFloat(std::uint16_t value)
+   {
+      // Re-bias the exponent with a multiplication, which also takes care
+      // of sub-normal numbers.
+      const float scaled =
+          details::bitCast<float>(static_cast<std::uint32_t>(value & 0x7fffu)
+                                  << 13) *
+          details::bitCast<float>(0x77800000u);
+      std::uint32_t result = details::bitCast<std::uint32_t>(scaled);
+      // Infinities and NaNs.
+      result |= (scaled >= details::bitCast<float>(0x47800000u)) ? 0x7f800000u
+                                                                 : 0u;
+      result |= static_cast<std::uint32_t>(value & 0x8000u) << 16;
+      return details::bitCast<float>(result);
+   }
+
+   /// Decoder of an encoded floating point column, usable on the devices
+   struct FloatDecoder
+   {
+      /// The encoding of the column
+      FloatEncoding type = FloatEncoding::Float32;
+      /// Value of the code 0 (fixed point)
+      float offset = 0.f;
+      /// Difference between consecutive codes (fixed point), or the factor
+      /// to multiply the half precision values with
+      float step = 1.f;
+
+      /// Decode one value
+      VECMEM_HOST_AND_DEVICE
+      float operator()(std::uint16_t code) const
+      {
+         return (type == FloatEncoding::Half)
+                    ? step * halfToFloat(code)
+                    : offset + step * static_cast<float>(code);
+      }
+   };
+
+   /// Description of how one floating point column is encoded
+   struct FloatColumnEncoding
+   {
+      /// The encoding of the column
+      FloatEncoding type = FloatEncoding::Float32;
+      /// The number of bits used by the fixed point encoding (1-16)
+      unsigned int bits = 16;
+      /// Lower end of the range of the fixed point encoding
+      float min = 0.f;
+      /// Upper end of the range of the fixed point encoding
+      float max = 0.f;
+      /// Factor to multiply the values with before the half precision
+      /// conversion
+      float scale = 1.f;
+
+      /// Create an encoding from its string representation
+      ///
+      /// The accepted formats are "float32", "fixed:BITS[:MIN:MAX]" and
+      /// "half[:SCALE]". Parameters not given in the string are taken from
+      /// the function arguments.
+      ///
+      /// @throws std::invalid_argument for malformed / invalid descriptions
+      ///
+      static FloatColumnEncoding parse(const std::string &spec,
+                                       float defaultMin, float defaultMax,
+                                       float defaultScale);
+      /// The string representation of the encoding
+      std::string toString() const;
+      /// Check that the encoding makes sense
+      ///
+      /// @throws std::invalid_argument if it does not
+      ///
+      void validate() const;
+
+      /// Whether the column is encoded at all
+      bool encoded() const { return type != FloatEncoding::Float32; }
+      /// The number of bytes transferred per value
+      std::size_t bytesPerElement() const;
+      /// The largest absolute error of a fixed point value inside the range
+      ///
+      /// Returns 0 for the other encodings.
+      ///
+      float quantizationError() const;
+      /// The decoder of the encoded values
+      FloatDecoder decoder() const;
+
+      /// Encode a column
+      ///
+      /// Values outside of the range of a fixed point encoding (and NaNs)
+      /// are clamped into it.
+      ///
+      /// @throws std::logic_error for the @c FloatEncoding::Float32 encoding
+      ///
+      void encode(std::span<const float> values,
+                  std::span<std::uint16_t> codes) const;
+   };
+
+   /// Decode a floating point column on the host
+   void decode(std::span<const std::uint16_t> codes,
+               const FloatDecoder &decoder, std::span<float> values);
+
+   /// Encode the constituent counts of the jets as 16-bit values
+   ///
+   /// @throws std::runtime_error if a count does not fit into 16 bits
+   ///
+   void encodeCounts16(std::span<const std::size_t> counts,
+                       std::span<std::uint16_t> codes);
+   /// Encode the constituent counts of the jets as (nJets + 1) 32-bit
+   /// offsets
+   ///
+   /// @throws std::runtime_error if the total does not fit into 32 bits
+   ///
+   void encodeOffsets32(std::span<const std::size_t> counts,
+                        std::span<std::uint32_t> offsets);
+
+   /// Description of how the kinematic columns are encoded for a transfer
+   struct TransferEncoding
+   {
+      /// Default range of the fixed point pseudorapidities
+      static constexpr float DEFAULT_ETA_MAX = 5.f;
+      /// Default factor applied to the transverse momenta (MeV -> GeV)
+      /// before a half precision conversion
+      static constexpr float DEFAULT_PT_SCALE = 1e-3f;
+
+      /// Encoding of the pseudorapidity columns
+      FloatColumnEncoding eta;
+      /// Encoding of the azimuthal angle columns
+      FloatColumnEncoding phi;
+      /// Encoding of the transverse momentum columns
+      FloatColumnEncoding pt;
+      /// Encoding of the constituent counts
+      CountEncoding counts = CountEncoding::Size;
+
+      /// Create an encoding from its string representation
+      ///
+      /// The description is a comma separated list of "COLUMN=ENCODING"
+      /// pairs, COLUMN being one of "eta", "phi", "pt" or "counts". The
+      /// floating point encodings are described by
+      /// @c GPUTutorial::FloatColumnEncoding::parse, with the fixed point
+      /// range being [-5, 5] for eta and [-π, π] for phi by default, and
+      /// the half precision scale being 1e-3 for pt. The counts can be
+      /// encoded as "size", "count16" or "offset32". Columns that are not
+      /// mentioned are not encoded. "none" is accepted for no encoding.
+      ///
+      /// @throws std::invalid_argument for malformed / invalid descriptions
+      ///
+      static TransferEncoding parse(const std::string &spec);
+      /// The string representation of the encoding
+      std::string toString() const;
+      /// Check that the encoding makes sense
+      ///
+      /// @throws std::invalid_argument if it does not
+      ///
+      void validate() const;
+      /// Whether any of the columns is encoded
+      bool encoded() const;
+   };
+
+   /// A floating point column, as it is to be transferred
+   struct EncodedFloatColumn
+   {
+      /// The values of the column, if it is not encoded
+      std::span<const float> values;
+      /// The encoded values of the column, if it is encoded
+      std::span<const std::uint16_t> codes;
+      /// The decoder of the encoded values
+      FloatDecoder decoder;
+
+      /// Whether the column is encoded
+      bool encoded() const { return decoder.type != FloatEncoding::Float32; }
+      /// The number of values in the column
+      std::size_t size() const
+      {
+         return (encoded() ? codes.size() : values.size());
+      }
+      /// The number of bytes to transfer
+      std::size_t size_bytes() const
+      {
+         return (encoded() ? codes.size_bytes() : values.size_bytes());
+      }
+   };
+
+   /// The constituent counts of the jets, as they are to be transferred
+   struct EncodedCountColumn
+   {
+      /// The encoding of the counts
+      CountEncoding type = CountEncoding::Size;
+      /// The counts, with @c CountEncoding::Size
+      std::span<const std::size_t> sizes;
+      /// The counts, with @c CountEncoding::Count16
+      std::span<const std::uint16_t> counts;
+      /// The (nJets + 1) offsets, with @c CountEncoding::Offset32
+      std::span<const std::uint32_t> offsets;
+
+      /// The number of jets
+      std::size_t size() const;
+      /// The number of bytes to transfer
+      std::size_t size_bytes() const;
+   };
+
+   /// Encode a floating point column into a host buffer
+   ///
+   /// @return The column referring to @c values if @c encoding does not
+   ///         encode it, or to @c buffer otherwise
+   ///
+   EncodedFloatColumn encodeColumn(const FloatColumnEncoding &encoding,
+                                   std::span<const float> values,
+                                   std::pmr::vector<std::uint16_t> &buffer);
+   /// Get the (decoded) values of a floating point column on the host
+   ///
+   /// @return @c column.values if the column is not encoded, or
+   ///         @c buffer holding the decoded values otherwise
+   ///
+   std::span<const float> decodeColumn(const EncodedFloatColumn &column,
+                                       std::pmr::vector<float> &buffer);
+   /// Get the (decoded) constituent counts on the host
+   std::span<const std::size_t>
+   decodeCounts(const EncodedCountColumn &column,
+                std::pmr::vector<std::size_t> &buffer);
+
+   /// Jet and constituent arrays, encoded for a transfer
+   struct EncodedJetArrays
+   {
+      /// @name Jet properties
+      /// @{
+      EncodedFloatColumn jetPt;
+      EncodedFloatColumn jetEta;
+      EncodedFloatColumn jetPhi;
+      EncodedCountColumn nConstituents;
+      /// @}
+      /// @name Constituent properties (grouped by jet)
+      /// @{
+      EncodedFloatColumn constPt;
+      EncodedFloatColumn constEta;
+      EncodedFloatColumn constPhi;
+      /// @}
+
+      /// The number of bytes to transfer
+      std::size_t size_bytes() const;
+   };
+
+   /// Helper encoding the jet pull inputs into host buffers that it owns
+   class JetArraysEncoder
+   {
+   public:
+      /// Constructor with the encoding, and the memory for the buffers
+      JetArraysEncoder(
+          const TransferEncoding &encoding,
+          std::pmr::memory_resource *mr = std::pmr::get_default_resource());
+
+      /// The encoding used
+      const TransferEncoding &encoding() const { return m_encoding; }
+
+      /// Encode some jets
+      ///
+      /// The result refers to the input arrays and/or the buffers of the
+      /// encoder, it is invalidated by the next call.
+      ///
+      EncodedJetArrays encode(const JetArrays &input);
+
+   private:
+      /// The encoding used
+      TransferEncoding m_encoding;
+      /// @name Buffers for the encoded columns
+      /// @{
+      std::pmr::vector<std::uint16_t> m_jetPt;
+      std::pmr::vector<std::uint16_t> m_jetEta;
+      std::pmr::vector<std::uint16_t> m_jetPhi;
+      std::pmr::vector<std::uint16_t> m_counts;
+      std::pmr::vector<std::uint32_t> m_offsets;
+      std::pmr::vector<std::uint16_t> m_constPt;
+      std::pmr::vector<std::uint16_t> m_constEta;
+      std::pmr::vector<std::uint16_t> m_constPhi;
+      /// @}
+
+   }; // class JetArraysEncoder
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_TRANSFERENCODING_H
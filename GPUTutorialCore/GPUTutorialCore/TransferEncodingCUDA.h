@@ -0,0 +1,94 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef GPUTUTORIALCORE_TRANSFERENCODINGCUDA_H
+#define GPUTUTORIALCORE_TRANSFERENCODINGCUDA_H
+
+// Local include(s).
+#include "GPUTutorialCore/TransferEncoding.h"
+
+// CUDA include(s).
+#include <cuda_runtime_api.h>
+
+// System include(s).
+#include <cstddef>
+#include <cstdint>
+
+namespace GPUTutorial
+{
+   namespace CUDA
+   {
+      namespace Kernels
+      {
+         /// Kernel decoding an encoded floating point column
+         template <typename CODE>
+         __global__ void decodeColumn(std::size_t n, const CODE *codes,
+                                      FloatDecoder decoder, float *values)
+         {
+            const std::size_t i = blockIdx.x * blockDim.x + threadIdx.x;
+            if (i >= n)
+            {
+               return;
+            }
+            values[i] = decoder(codes[i]);
+         }
+
+         /// Kernel widening narrow counts / offsets to @c std::size_t
+         template <typename T>
+         __global__ void widen(std::size_t n, const T *input,
+                               std::size_t *output)
+         {
+            const std::size_t i = blockIdx.x * blockDim.x + threadIdx.x;
+            if (i >= n)
+            {
+               return;
+            }
+            output[i] = input[i];
+         }
+
+      } // namespace Kernels
+
+      /// Decode a floating point column on the device
+      ///
+      /// The kernel is only launched, it is not waited for.
+      ///
+      inline cudaError_t decodeColumn(std::size_t n,
+                                      const std::uint16_t *codes,
+                                      const FloatDecoder &decoder,
+                                      float *values, cudaStream_t stream)
+      {
+         if (n == 0)
+         {
+            return cudaSuccess;
+         }
+         const std::size_t blockSize = 256;
+         const std::size_t numBlocks = (n + blockSize - 1) / blockSize;
+         Kernels::decodeColumn<<<numBlocks, blockSize, 0, stream>>>(
+             n, codes, decoder, values);
+         return cudaGetLastError();
+      }
+
+      /// Widen the encoded constituent counts / offsets on the device
+      ///
+      /// @c n is the number of jets for 16-bit counts, and the number of
+      /// jets + 1 for 32-bit offsets. The kernel is only launched, it is not
+      /// waited for.
+      ///
+      template <typename T>
+      cudaError_t widen(std::size_t n, const T *input, std::size_t *output,
+                        cudaStream_t stream)
+      {
+         if (n == 0)
+         {
+            return cudaSuccess;
+         }
+         const std::size_t blockSize = 256;
+         const std::size_t numBlocks = (n + blockSize - 1) / blockSize;
+         Kernels::widen<<<numBlocks, blockSize, 0, stream>>>(n, input,
+                                                             output);
+         return cudaGetLastError();
+      }
+
+   } // namespace CUDA
+
+} // namespace GPUTutorial
+
+#endif // GPUTUTORIALCORE_TRANSFERENCODINGCUDA_H
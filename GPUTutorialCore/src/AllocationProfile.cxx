@@ -0,0 +1,226 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "GPUTutorialCore/AllocationProfile.h"
+
+// POSIX include(s).
+#include <unistd.h>
+
+// System include(s).
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace
+{
+   /// Header line of the profile files
+   constexpr const char *PROFILE_HEADER =
+       "# GPUTutorial allocation profile: resource<TAB>block size<TAB>blocks";
+
+   /// The smallest size class
+   constexpr std::size_t MIN_SIZE_CLASS = 256;
+
+   /// Alignment of the blocks allocated by @c GPUTutorial::prewarm
+   constexpr std::size_t PREWARM_ALIGNMENT = alignof(std::max_align_t);
+
+} // namespace
+
+namespace GPUTutorial
+{
+   std::size_t AllocationProfile::sizeClass(std::size_t bytes)
+   {
+      return std::bit_ceil(std::max(bytes, MIN_SIZE_CLASS));
+   }
+
+   std::size_t AllocationProfile::bytes(const Histogram &blocks)
+   {
+      std::size_t result = 0;
+      for (const auto &[size, count] : blocks)
+      {
+         result += size * count;
+      }
+      return result;
+   }
+
+   void AllocationProfile::set(const std::string &resource, Histogram blocks)
+   {
+      std::erase_if(blocks, [](const auto &entry)
+                    { return (entry.first == 0) || (entry.second == 0); });
+      if (blocks.empty())
+      {
+         m_resources.erase(resource);
+      }
+      else
+      {
+         m_resources[resource] = std::move(blocks);
+      }
+   }
+
+   const AllocationProfile::Histogram &
+   AllocationProfile::blocks(const std::string &resource) const
+   {
+      static const Histogram EMPTY;
+      auto itr = m_resources.find(resource);
+      return ((itr != m_resources.end()) ? itr->second : EMPTY);
+   }
+
+   AllocationProfile AllocationProfile::read(const std::string &fileName)
+   {
+      AllocationProfile result;
+      std::ifstream in(fileName);
+      if (!in)
+      {
+         return result;
+      }
+      std::string line;
+      std::size_t lineNumber = 0;
+      while (std::getline(in, line))
+      {
+         ++lineNumber;
+         if (line.empty() || (line.front() == '#'))
+         {
+            continue;
+         }
+         // The resource names may contain spaces, so only split the line at
+         // its tabs.
+         const std::size_t tab = line.find('\t');
+         std::istringstream numbers(
+             (tab == std::string::npos) ? std::string() : line.substr(tab + 1));
+         std::size_t size = 0, count = 0;
+         if ((tab == 0) || !(numbers >> size >> count) || (size == 0) ||
+             !(numbers >> std::ws).eof())
+         {
+            throw std::runtime_error("Malformed line " +
+                                     std::to_string(lineNumber) +
+                                     " in allocation profile file " + fileName);
+         }
+         Histogram &blocks = result.m_resources[line.substr(0, tab)];
+         blocks[size] = std::max(blocks[size], count);
+      }
+      return result;
+   }
+
+   void AllocationProfile::write(const std::string &fileName) const
+   {
+      // Tabs and new lines would break the format of the file.
+      for (const auto &[resource, blocks] : m_resources)
+      {
+         if (resource.empty() ||
+             (resource.find_first_of("\t\n") != std::string::npos))
+         {
+            throw std::invalid_argument("Invalid resource name: \"" +
+                                        resource + "\"");
+         }
+      }
+
+      // Write a new file, and move it in place of the old one. So that a
+      // job starting at the same time never reads a partially written file.
+      const std::string tmpName =
+          fileName + ".tmp." + std::to_string(::getpid());
+      {
+         std::ofstream out(tmpName, std::ios::trunc);
+         out << PROFILE_HEADER << "\n";
+         for (const auto &[resource, blocks] : m_resources)
+         {
+            for (const auto &[size, count] : blocks)
+            {
+               out << resource << "\t" << size << "\t" << count << "\n";
+            }
+         }
+         if (!out)
+         {
+            throw std::runtime_error("Could not write allocation profile file: " +
+                                     tmpName);
+         }
+      }
+      std::error_code ec;
+      std::filesystem::rename(tmpName, fileName, ec);
+      if (ec)
+      {
+         throw std::runtime_error("Could not replace allocation profile file " +
+                                  fileName + ": " + ec.message());
+      }
+   }
+
+   AllocationRecorder::AllocationRecorder(std::pmr::memory_resource &upstream)
+       : m_upstream(upstream) {}
+
+   AllocationProfile::Histogram AllocationRecorder::histogram() const
+   {
+      std::lock_guard lock(m_mutex);
+      AllocationProfile::Histogram result;
+      for (const auto &[size, blocks] : m_blocks)
+      {
+         result[size] = blocks.peak;
+      }
+      return result;
+   }
+
+   void *AllocationRecorder::do_allocate(std::size_t bytes,
+                                         std::size_t alignment)
+   {
+      void *result = m_upstream.allocate(bytes, alignment);
+      std::lock_guard lock(m_mutex);
+      Blocks &blocks = m_blocks[AllocationProfile::sizeClass(bytes)];
+      blocks.peak = std::max(blocks.peak, ++blocks.inUse);
+      return result;
+   }
+
+   void AllocationRecorder::do_deallocate(void *p, std::size_t bytes,
+                                          std::size_t alignment)
+   {
+      m_upstream.deallocate(p, bytes, alignment);
+      std::lock_guard lock(m_mutex);
+      --(m_blocks[AllocationProfile::sizeClass(bytes)].inUse);
+   }
+
+   bool AllocationRecorder::do_is_equal(
+       const std::pmr::memory_resource &other) const noexcept
+   {
+      return (this == &other);
+   }
+
+   std::size_t prewarm(std::pmr::memory_resource &mr,
+                       const AllocationProfile::Histogram &blocks)
+   {
+      // Allocate all blocks at once, so that the resource could not serve
+      // any of them with the memory of another one.
+      std::vector<std::pair<void *, std::size_t>> allocations;
+      try
+      {
+         for (const auto &[size, count] : blocks)
+         {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+               allocations.emplace_back(mr.allocate(size, PREWARM_ALIGNMENT),
+                                        size);
+            }
+         }
+      }
+      catch (...)
+      {
+         for (const auto &[p, size] : allocations)
+         {
+            mr.deallocate(p, size, PREWARM_ALIGNMENT);
+         }
+         throw;
+      }
+
+      // Give them back to the resource.
+      std::size_t result = 0;
+      for (const auto &[p, size] : allocations)
+      {
+         mr.deallocate(p, size, PREWARM_ALIGNMENT);
+         result += size;
+      }
+      return result;
+   }
+
+} // namespace GPUTutorial
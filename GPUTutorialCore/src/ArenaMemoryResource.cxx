@@ -0,0 +1,152 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "GPUTutorialCore/ArenaMemoryResource.h"
+
+// System include(s).
+#include <algorithm>
+#include <cstdint>
+
+namespace
+{
+   /// Alignment of the chunks allocated from the upstream resource
+   ///
+   /// Large enough for any host type, and for the coalesced accesses of
+   /// GPU kernels.
+   ///
+   constexpr std::size_t CHUNK_ALIGNMENT = 256;
+
+} // namespace
+
+namespace GPUTutorial
+{
+   ArenaMemoryResource::ArenaMemoryResource(std::pmr::memory_resource &upstream,
+                                            std::size_t chunkSize)
+       : m_upstream(upstream),
+         m_chunkSize(std::max(chunkSize, CHUNK_ALIGNMENT)) {}
+
+   ArenaMemoryResource::~ArenaMemoryResource()
+   {
+      releaseChunks();
+   }
+
+   void ArenaMemoryResource::reset()
+   {
+      // Collect how much memory was used.
+      std::size_t used = 0, total = 0;
+      for (const std::unique_ptr<Chunk> &chunk : m_chunks)
+      {
+         used += chunk->used.load();
+         total += chunk->size;
+      }
+      m_peak = std::max(m_peak, used);
+
+      // Replace multiple chunks with a single one.
+      if (m_chunks.size() > 1)
+      {
+         releaseChunks();
+         addChunk(total);
+      }
+      else if (!m_chunks.empty())
+      {
+         m_chunks.front()->used = 0;
+      }
+   }
+
+   void ArenaMemoryResource::reserve(std::size_t bytes)
+   {
+      // Never shrink the arena.
+      const std::size_t size = std::max(bytes, capacity());
+      if ((size == 0) ||
+          ((m_chunks.size() == 1) && (m_chunks.front()->size >= size)))
+      {
+         return;
+      }
+      releaseChunks();
+      addChunk(size);
+   }
+
+   std::size_t ArenaMemoryResource::capacity() const
+   {
+      std::size_t result = 0;
+      for (const std::unique_ptr<Chunk> &chunk : m_chunks)
+      {
+         result += chunk->size;
+      }
+      return result;
+   }
+
+   void *ArenaMemoryResource::do_allocate(std::size_t bytes,
+                                          std::size_t alignment)
+   {
+      while (true)
+      {
+         // Try to allocate from the current chunk.
+         Chunk *chunk = m_current.load(std::memory_order_acquire);
+         if (chunk != nullptr)
+         {
+            if (void *result = tryAllocate(*chunk, bytes, alignment))
+            {
+               return result;
+            }
+         }
+         // Add a new chunk, unless another thread did that already.
+         std::lock_guard lock(m_chunkMutex);
+         if (m_current.load(std::memory_order_acquire) == chunk)
+         {
+            addChunk(std::max((chunk != nullptr) ? 2 * chunk->size
+                                                 : m_chunkSize,
+                              bytes + alignment));
+         }
+      }
+   }
+
+   bool ArenaMemoryResource::do_is_equal(
+       const std::pmr::memory_resource &other) const noexcept
+   {
+      return (this == &other);
+   }
+
+   void *ArenaMemoryResource::tryAllocate(Chunk &chunk, std::size_t bytes,
+                                          std::size_t alignment)
+   {
+      const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(chunk.data);
+      std::size_t used = chunk.used.load(std::memory_order_relaxed);
+      while (true)
+      {
+         const std::uintptr_t begin =
+             (base + used + alignment - 1) & ~(alignment - 1);
+         const std::size_t newUsed = (begin - base) + bytes;
+         if (newUsed > chunk.size)
+         {
+            return nullptr;
+         }
+         if (chunk.used.compare_exchange_weak(used, newUsed,
+                                              std::memory_order_relaxed))
+         {
+            return reinterpret_cast<void *>(begin);
+         }
+      }
+   }
+
+   void ArenaMemoryResource::addChunk(std::size_t bytes)
+   {
+      auto chunk = std::make_unique<Chunk>();
+      chunk->data = static_cast<std::byte *>(
+          m_upstream.allocate(bytes, CHUNK_ALIGNMENT));
+      chunk->size = bytes;
+      m_current.store(chunk.get(), std::memory_order_release);
+      m_chunks.push_back(std::move(chunk));
+   }
+
+   void ArenaMemoryResource::releaseChunks()
+   {
+      m_current = nullptr;
+      for (const std::unique_ptr<Chunk> &chunk : m_chunks)
+      {
+         m_upstream.deallocate(chunk->data, chunk->size, CHUNK_ALIGNMENT);
+      }
+      m_chunks.clear();
+   }
+
+} // namespace GPUTutorial
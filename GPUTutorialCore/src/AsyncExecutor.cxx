@@ -0,0 +1,219 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "GPUTutorialCore/AsyncExecutor.h"
+
+// System include(s).
+#include <future>
+#include <stdexcept>
+#include <utility>
+
+namespace GPUTutorial
+{
+   void AsyncExecutor::Stream::wait()
+   {
+      // The promise is shared with the callback, as that may still be
+      // running when the waiting thread already returned.
+      auto promise = std::make_shared<std::promise<std::exception_ptr>>();
+      std::future<std::exception_ptr> future = promise->get_future();
+      notify([promise](std::exception_ptr error)
+             { promise->set_value(error); });
+      if (std::exception_ptr error = future.get())
+      {
+         std::rethrow_exception(error);
+      }
+   }
+
+   class HostThreadPool::PoolStream final : public AsyncExecutor::Stream
+   {
+   public:
+      /// Constructor with the pool to run the work on
+      explicit PoolStream(HostThreadPool &pool)
+          : m_state(std::make_shared<State>(pool)) {}
+      /// Destructor, waiting for the work to finish
+      ~PoolStream() override
+      {
+         try
+         {
+            wait();
+         }
+         catch (...)
+         {
+            // Nobody is left to report the failure to.
+         }
+      }
+
+      /// @name Functions implementing @c GPUTutorial::AsyncExecutor::Stream
+      /// @{
+
+      void enqueue(Work work) override { push(m_state, {std::move(work), {}}); }
+      void notify(Callback callback) override
+      {
+         push(m_state, {{}, std::move(callback)});
+      }
+
+      /// @}
+
+   private:
+      /// One entry of the stream, either some work or a callback
+      struct Item
+      {
+         /// The work to run
+         Work work;
+         /// The callback to call
+         Callback callback;
+      };
+
+      /// The state of the stream, shared with the tasks running its items
+      struct State
+      {
+         /// Constructor with the pool
+         explicit State(HostThreadPool &p) : pool(p) {}
+
+         /// The pool running the items
+         HostThreadPool &pool;
+         /// Mutex protecting the state
+         std::mutex mutex;
+         /// The items not run yet
+         std::deque<Item> items;
+         /// Whether a task running the next item is scheduled / running
+         bool scheduled = false;
+         /// The first failure since the last callback
+         std::exception_ptr error;
+      };
+
+      /// Add an item to the stream, scheduling it if nothing is running
+      static void push(const std::shared_ptr<State> &state, Item item)
+      {
+         {
+            std::lock_guard lock(state->mutex);
+            state->items.push_back(std::move(item));
+            if (state->scheduled)
+            {
+               return;
+            }
+            state->scheduled = true;
+         }
+         state->pool.post([state]() { runNext(state); });
+      }
+
+      /// Run the next item of the stream, and schedule the one after it
+      static void runNext(const std::shared_ptr<State> &state)
+      {
+         // Take the next item.
+         Item item;
+         std::exception_ptr error;
+         {
+            std::lock_guard lock(state->mutex);
+            item = std::move(state->items.front());
+            state->items.pop_front();
+            error = state->error;
+            if (item.callback)
+            {
+               state->error = nullptr;
+            }
+         }
+
+         // Run it, skipping the work after a failure.
+         if (item.callback)
+         {
+            item.callback(error);
+         }
+         else if (!error)
+         {
+            try
+            {
+               item.work();
+            }
+            catch (...)
+            {
+               std::lock_guard lock(state->mutex);
+               state->error = std::current_exception();
+            }
+         }
+
+         // Give up the thread, re-scheduling the stream if it has more
+         // items.
+         {
+            std::lock_guard lock(state->mutex);
+            if (state->items.empty())
+            {
+               state->scheduled = false;
+               return;
+            }
+         }
+         state->pool.post([state]() { runNext(state); });
+      }
+
+      /// The state of the stream
+      std::shared_ptr<State> m_state;
+   };
+
+   HostThreadPool::HostThreadPool(std::size_t nThreads)
+   {
+      if (nThreads == 0)
+      {
+         throw std::invalid_argument(
+             "A host thread pool needs at least one thread");
+      }
+      m_threads.reserve(nThreads);
+      for (std::size_t i = 0; i < nThreads; ++i)
+      {
+         m_threads.emplace_back([this]() { run(); });
+      }
+   }
+
+   HostThreadPool::~HostThreadPool()
+   {
+      {
+         std::lock_guard lock(m_mutex);
+         m_stop = true;
+      }
+      m_condition.notify_all();
+      for (std::thread &thread : m_threads)
+      {
+         thread.join();
+      }
+   }
+
+   std::string HostThreadPool::name() const
+   {
+      return "host-pool:" + std::to_string(m_threads.size());
+   }
+
+   std::unique_ptr<AsyncExecutor::Stream> HostThreadPool::makeStream()
+   {
+      return std::make_unique<PoolStream>(*this);
+   }
+
+   void HostThreadPool::post(std::function<void()> task)
+   {
+      {
+         std::lock_guard lock(m_mutex);
+         m_tasks.push_back(std::move(task));
+      }
+      m_condition.notify_one();
+   }
+
+   void HostThreadPool::run()
+   {
+      while (true)
+      {
+         std::function<void()> task;
+         {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock,
+                             [this]() { return m_stop || !m_tasks.empty(); });
+            // Only finish once all tasks were run.
+            if (m_tasks.empty())
+            {
+               return;
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+         }
+         task();
+      }
+   }
+
+} // namespace GPUTutorial
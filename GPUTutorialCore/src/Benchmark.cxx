@@ -0,0 +1,1417 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "GPUTutorialCore/Benchmark.h"
+#include "GPUTutorialCore/ArenaMemoryResource.h"
+#include "GPUTutorialCore/AsyncExecutor.h"
+#include "GPUTutorialCore/ConstituentGather.h"
+#include "GPUTutorialCore/ElectronCalibration.h"
+#include "GPUTutorialCore/JetPullBatcher.h"
+#include "GPUTutorialCore/JetPullHost.h"
+#include "GPUTutorialCore/Kinematics.h"
+#include "GPUTutorialCore/LinearTransform.h"
+#include "GPUTutorialCore/OffloadDispatcher.h"
+
+// VecMem include(s).
+#include <vecmem/memory/pool_memory_resource.hpp>
+
+// System include(s).
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numbers>
+#include <numeric>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+   using namespace GPUTutorial;
+   using namespace GPUTutorial::Benchmark;
+
+   /// @name Largest relative errors accepted from the calculations
+   /// @{
+
+   /// Electron calibration of a backend, with respect to the host. Both use
+   /// the same formula, so they only differ by rounding.
+   constexpr double CALIBRATION_TOLERANCE = 1e-5;
+   /// Jet pulls of a backend, with respect to the host. They also differ in
+   /// the order that the constituents are summed up in.
+   constexpr double PULL_TOLERANCE = 1e-4;
+   /// Kinematic helpers, with respect to a double precision calculation
+   constexpr double KINEMATICS_TOLERANCE = 1e-5;
+
+   /// @}
+
+   /// Backend running all calculations on the host
+   class HostBackend : public Benchmark::Backend
+   {
+   public:
+      /// Constructor
+      explicit HostBackend(std::size_t grainSize) : m_grainSize(grainSize) {}
+
+      /// @name Functions implementing @c GPUTutorial::Benchmark::Backend
+      /// @{
+
+      std::string name() const override { return "host"; }
+      std::pmr::memory_resource &hostMR() override { return m_hostMR; }
+      bool hostAccessible() const override { return true; }
+
+      void linearTransform(std::span<const float> input,
+                           std::span<float> output,
+                           StageResults &results) override
+      {
+         timeStage(results.compute, 2 * input.size_bytes(), [&]()
+                   { Host::linearTransform(input, output); });
+      }
+
+      void setCalibrationTable(const ElectronCalibrationTable &table,
+                               StageResults &) override
+      {
+         m_table = table.view();
+      }
+
+      void calibrateElectrons(const ElectronArrays &input,
+                              std::span<float> calibratedPt,
+                              StageResults &results) override
+      {
+         timeStage(results.compute,
+                   input.eta.size_bytes() + input.phi.size_bytes() +
+                       input.pt.size_bytes() + input.author.size_bytes() +
+                       calibratedPt.size_bytes(),
+                   [&]()
+                   { Host::calibrateElectrons(input.eta, input.phi, input.pt,
+                                              input.author, m_table,
+                                              calibratedPt); });
+      }
+
+      void calculatePulls(const JetArrays &input, std::span<float> pullEta,
+                          std::span<float> pullPhi,
+                          StageResults &results) override
+      {
+         timeStage(results.compute,
+                   3 * input.jetPt.size_bytes() +
+                       input.nConstituents.size_bytes() +
+                       3 * input.constPt.size_bytes() +
+                       pullEta.size_bytes() + pullPhi.size_bytes(),
+                   [&]()
+                   { Host::calculatePulls(input.jetPt, input.jetEta,
+                                          input.jetPhi, input.nConstituents,
+                                          input.constPt, input.constEta,
+                                          input.constPhi, pullEta, pullPhi,
+                                          m_grainSize); });
+      }
+
+      bool hasSegmentedReduction() const override { return true; }
+
+      void calculatePullsSegmented(const JetArrays &input,
+                                   std::span<float> pullEta,
+                                   std::span<float> pullPhi,
+                                   const SegmentedReductionConfig &config,
+                                   StageResults &results) override
+      {
+         timeStage(results.compute,
+                   3 * input.jetPt.size_bytes() +
+                       input.nConstituents.size_bytes() +
+                       3 * input.constPt.size_bytes() +
+                       pullEta.size_bytes() + pullPhi.size_bytes(),
+                   [&]()
+                   { Host::calculatePullsSegmented(
+                         input.jetPt, input.jetEta, input.jetPhi,
+                         input.nConstituents, input.constPt, input.constEta,
+                         input.constPhi, pullEta, pullPhi, config); });
+      }
+
+      bool hasTransferEncoding() const override { return true; }
+
+      void calibrateElectronsEncoded(const EncodedElectronArrays &input,
+                                     std::span<float> calibratedPt,
+                                     StageResults &results) override
+      {
+         // Decode the inputs as part of the calculation, like a device
+         // would.
+         timeStage(results.compute,
+                   input.size_bytes() + calibratedPt.size_bytes(), [&]()
+                   { Host::calibrateElectrons(
+                         decodeColumn(input.eta, m_decoded[0]),
+                         decodeColumn(input.phi, m_decoded[1]),
+                         decodeColumn(input.pt, m_decoded[2]), input.author,
+                         m_table, calibratedPt); });
+      }
+
+      void calculatePullsEncoded(const EncodedJetArrays &input,
+                                 std::span<float> pullEta,
+                                 std::span<float> pullPhi,
+                                 StageResults &results) override
+      {
+         timeStage(results.compute,
+                   input.size_bytes() + pullEta.size_bytes() +
+                       pullPhi.size_bytes(),
+                   [&]()
+                   { Host::calculatePulls(
+                         decodeColumn(input.jetPt, m_decoded[0]),
+                         decodeColumn(input.jetEta, m_decoded[1]),
+                         decodeColumn(input.jetPhi, m_decoded[2]),
+                         decodeCounts(input.nConstituents, m_decodedCounts),
+                         decodeColumn(input.constPt, m_decoded[3]),
+                         decodeColumn(input.constEta, m_decoded[4]),
+                         decodeColumn(input.constPhi, m_decoded[5]), pullEta,
+                         pullPhi, m_grainSize); });
+      }
+
+      bool hasElementWise() const override { return true; }
+
+      void elementWiseChain(std::span<const float> input,
+                            std::span<float> output, bool fused,
+                            StageResults &results) override
+      {
+         if (fused)
+         {
+            timeStage(results.compute, 2 * input.size_bytes(), [&]()
+                      { ElementWise::evaluate(ElementWiseChain::fused, output,
+                                              input); });
+            return;
+         }
+         timeStage(results.compute, 8 * input.size_bytes(), [&]()
+                   {
+            ElementWise::evaluate(linearTransformExpression, output, input);
+            ElementWise::evaluate(ElementWiseChain::standardise, output,
+                                  output);
+            ElementWise::evaluate(ElementWiseChain::square, output, output);
+            ElementWise::evaluate(ElementWiseChain::squash, output,
+                                  output); });
+      }
+
+      /// @}
+
+   private:
+      /// Number of jets per TBB task
+      std::size_t m_grainSize;
+      /// Buffers for the decoded floating point columns
+      std::array<std::pmr::vector<float>, 6> m_decoded;
+      /// Buffer for the decoded constituent counts
+      std::pmr::vector<std::size_t> m_decodedCounts;
+      /// The electron calibration table
+      ElectronCalibrationTableView m_table;
+      /// Memory resource used for the host arrays
+      std::pmr::unsynchronized_pool_resource m_hostMR;
+
+   }; // class HostBackend
+
+   /// Minimal stand-in for @c xAOD::IParticle
+   class Particle
+   {
+   public:
+      /// Virtual destructor
+      virtual ~Particle() = default;
+      /// @name Kinematic accessors
+      /// @{
+      virtual float pt() const = 0;
+      virtual float eta() const = 0;
+      virtual float phi() const = 0;
+      virtual float m() const = 0;
+      /// @}
+   };
+
+   /// Container of particles, storing their variables in aux store columns
+   struct ParticleContainer
+   {
+      /// Identifiers of the aux store columns
+      enum Column
+      {
+         PT = 0,
+         ETA = 1,
+         PHI = 2,
+         M = 3
+      };
+      /// The aux store columns
+      std::vector<std::vector<float>> columns{4};
+      /// The interface objects
+      std::vector<std::unique_ptr<Particle>> objects;
+   };
+
+   /// Particle reading its variables from the columns of its container
+   ///
+   /// Just like xAOD objects, every accessor call looks up the column of
+   /// the variable in the particle's container.
+   ///
+   class AuxParticle : public Particle
+   {
+   public:
+      /// Constructor
+      AuxParticle(const ParticleContainer &container, std::size_t index)
+          : m_container(container), m_index(index) {}
+
+      /// @name Functions implementing @c Particle
+      /// @{
+      float pt() const override { return get(ParticleContainer::PT); }
+      float eta() const override { return get(ParticleContainer::ETA); }
+      float phi() const override { return get(ParticleContainer::PHI); }
+      float m() const override { return get(ParticleContainer::M); }
+      /// @}
+
+   private:
+      /// Get one variable of the particle
+      float get(std::size_t column) const
+      {
+         return m_container.columns[column][m_index];
+      }
+      /// The container that the particle is in
+      const ParticleContainer &m_container;
+      /// The index of the particle in its container
+      std::size_t m_index;
+   };
+
+   /// Link to a particle in a container
+   struct ParticleLink
+   {
+      const ParticleContainer *container = nullptr;
+      std::size_t index = 0;
+      const Particle *operator->() const
+      {
+         return container->objects[index].get();
+      }
+   };
+
+   /// The jet constituents of one event, in an "xAOD-like" layout
+   struct ConstituentEvent
+   {
+      /// The constituent containers
+      std::vector<ParticleContainer> containers;
+      /// The constituent links of every jet
+      std::vector<std::vector<ParticleLink>> jetLinks;
+   };
+
+   /// Distribute the constituents of an event over some containers
+   ConstituentEvent makeConstituentEvent(const SyntheticEvent &event,
+                                         std::size_t nSources,
+                                         std::mt19937 &rng)
+   {
+      ConstituentEvent result;
+      result.containers.resize(nSources);
+      result.jetLinks.resize(event.jets.size());
+
+      // Decide which container each constituent goes to. Keeping the
+      // constituents of the same type (container) next to each other, like
+      // jet finding would.
+      std::uniform_int_distribution<std::size_t> sourceDist(0, nSources - 1);
+      std::vector<std::vector<std::size_t>> sources(event.jets.size());
+      std::vector<std::size_t> sizes(nSources, 0);
+      for (std::size_t j = 0; j < event.jets.size(); ++j)
+      {
+         const std::size_t n = event.jets[j].constituents.size();
+         for (std::size_t c = 0; c < n; ++c)
+         {
+            sources[j].push_back(sourceDist(rng));
+            ++sizes[sources[j].back()];
+         }
+         std::sort(sources[j].begin(), sources[j].end());
+      }
+
+      // Give the constituents random positions in their containers.
+      std::vector<std::vector<std::size_t>> positions(nSources);
+      for (std::size_t s = 0; s < nSources; ++s)
+      {
+         positions[s].resize(sizes[s]);
+         std::iota(positions[s].begin(), positions[s].end(), 0);
+         std::shuffle(positions[s].begin(), positions[s].end(), rng);
+         ParticleContainer &container = result.containers[s];
+         for (std::vector<float> &column : container.columns)
+         {
+            column.resize(sizes[s]);
+         }
+         for (std::size_t i = 0; i < sizes[s]; ++i)
+         {
+            container.objects.push_back(
+                std::make_unique<AuxParticle>(container, i));
+         }
+      }
+      std::vector<std::size_t> used(nSources, 0);
+      for (std::size_t j = 0; j < event.jets.size(); ++j)
+      {
+         const std::vector<SyntheticConstituent> &constituents =
+             event.jets[j].constituents;
+         for (std::size_t c = 0; c < constituents.size(); ++c)
+         {
+            const std::size_t s = sources[j][c];
+            const std::size_t index = positions[s][used[s]++];
+            ParticleContainer &container = result.containers[s];
+            container.columns[ParticleContainer::PT][index] =
+                constituents[c].pt;
+            container.columns[ParticleContainer::ETA][index] =
+                constituents[c].eta;
+            container.columns[ParticleContainer::PHI][index] =
+                constituents[c].phi;
+            container.columns[ParticleContainer::M][index] = constituents[c].m;
+            result.jetLinks[j].push_back({&container, index});
+         }
+      }
+      return result;
+   }
+
+   /// Stage a column in a backend's host memory, encoding it if requested
+   EncodedFloatColumn stageColumn(const FloatColumnEncoding &encoding,
+                                  std::span<const float> values,
+                                  std::pmr::vector<float> &staged,
+                                  std::pmr::vector<std::uint16_t> &codes)
+   {
+      if (encoding.encoded())
+      {
+         return encodeColumn(encoding, values, codes);
+      }
+      staged.assign(values.begin(), values.end());
+      return {staged, {}, {}};
+   }
+
+   /// Write the results of one stage as JSON
+   void writeStage(std::ostream &out, const char *name,
+                   const StageResult &result)
+   {
+      const double seconds = result.time.count();
+      out << "        \"" << name << "\": {\"seconds\": " << seconds
+          << ", \"bytes\": " << result.bytes << ", \"bytesPerSecond\": "
+          << ((seconds > 0.) ? static_cast<double>(result.bytes) / seconds
+                             : 0.)
+          << "}";
+   }
+
+   /// Write the results of all calculations as JSON
+   void writeResults(std::ostream &out, const std::vector<KernelResult> &results)
+   {
+      out << "  \"results\": [";
+      for (std::size_t i = 0; i < results.size(); ++i)
+      {
+         const KernelResult &result = results[i];
+         const double total =
+             (result.stages.gather.time + result.stages.transfer.time +
+              result.stages.compute.time + result.stages.scatter.time)
+                 .count();
+         out << ((i == 0) ? "\n" : ",\n");
+         out << "    {\n";
+         out << "      \"kernel\": \"" << result.kernel << "\",\n";
+         out << "      \"backend\": \"" << result.backend << "\",\n";
+         out << "      \"variant\": \"" << result.variant << "\",\n";
+         out << "      \"batchSize\": " << result.batchSize << ",\n";
+         out << "      \"events\": " << result.nEvents << ",\n";
+         out << "      \"objects\": " << result.nObjects << ",\n";
+         out << "      \"seconds\": " << total << ",\n";
+         out << "      \"bytesMovedPerEvent\": "
+             << ((result.nEvents > 0)
+                     ? static_cast<double>(result.stages.gather.bytes +
+                                           result.stages.transfer.bytes +
+                                           result.stages.scatter.bytes) /
+                           static_cast<double>(result.nEvents)
+                     : 0.)
+             << ",\n";
+         out << "      \"eventsPerSecond\": "
+             << ((total > 0.) ? static_cast<double>(result.nEvents) / total
+                              : 0.)
+             << ",\n";
+         out << "      \"stages\": {\n";
+         writeStage(out, "gather", result.stages.gather);
+         out << ",\n";
+         writeStage(out, "transfer", result.stages.transfer);
+         out << ",\n";
+         writeStage(out, "compute", result.stages.compute);
+         out << ",\n";
+         writeStage(out, "scatter", result.stages.scatter);
+         out << "\n      }";
+         if (result.accuracy)
+         {
+            const Accuracy &accuracy = *(result.accuracy);
+            const double n = static_cast<double>(
+                std::max(accuracy.n, std::size_t{1}));
+            out << ",\n      \"accuracy\": {\"values\": " << accuracy.n
+                << ", \"maxAbsError\": " << accuracy.maxAbsError
+                << ", \"rmsError\": "
+                << std::sqrt(accuracy.sumSquaredError / n)
+                << ", \"rmsReference\": "
+                << std::sqrt(accuracy.sumSquaredReference / n)
+                << ", \"relativeError\": " << accuracy.relativeError();
+            if (accuracy.tolerance > 0.)
+            {
+               out << ", \"tolerance\": " << accuracy.tolerance
+                   << ", \"passed\": "
+                   << (accuracy.passed() ? "true" : "false");
+            }
+            out << "}";
+         }
+         out << "\n    }";
+      }
+      out << "\n  ]\n";
+   }
+
+} // namespace
+
+namespace GPUTutorial
+{
+   namespace Benchmark
+   {
+      StageResult &StageResult::operator+=(const StageResult &rhs)
+      {
+         time += rhs.time;
+         bytes += rhs.bytes;
+         return *this;
+      }
+
+      StageResults &StageResults::operator+=(const StageResults &rhs)
+      {
+         gather += rhs.gather;
+         transfer += rhs.transfer;
+         compute += rhs.compute;
+         scatter += rhs.scatter;
+         return *this;
+      }
+
+      void Backend::calculatePullsSegmented(const JetArrays &,
+                                            std::span<float>, std::span<float>,
+                                            const SegmentedReductionConfig &,
+                                            StageResults &)
+      {
+         throw std::logic_error("The \"" + name() +
+                                "\" backend has no segmented reduction");
+      }
+
+      void Backend::calibrateElectronsEncoded(const EncodedElectronArrays &,
+                                              std::span<float>,
+                                              StageResults &)
+      {
+         throw std::logic_error("The \"" + name() +
+                                "\" backend has no encoded transfers");
+      }
+
+      void Backend::calculatePullsEncoded(const EncodedJetArrays &,
+                                          std::span<float>, std::span<float>,
+                                          StageResults &)
+      {
+         throw std::logic_error("The \"" + name() +
+                                "\" backend has no encoded transfers");
+      }
+
+      void Backend::elementWiseChain(std::span<const float>,
+                                     std::span<float>, bool, StageResults &)
+      {
+         throw std::logic_error("The \"" + name() +
+                                "\" backend has no element-wise chain");
+      }
+
+      std::size_t EncodedElectronArrays::size_bytes() const
+      {
+         return eta.size_bytes() + phi.size_bytes() + pt.size_bytes() +
+                author.size_bytes();
+      }
+
+      void Accuracy::add(double reference, double value)
+      {
+         const double error = std::abs(value - reference);
+         ++n;
+         maxAbsError = std::max(maxAbsError, error);
+         sumSquaredError += error * error;
+         sumSquaredReference += reference * reference;
+      }
+
+      double Accuracy::relativeError() const
+      {
+         if (sumSquaredError == 0.)
+         {
+            return 0.;
+         }
+         return std::sqrt(sumSquaredError /
+                          std::max(sumSquaredReference,
+                                   std::numeric_limits<double>::min()));
+      }
+
+      bool Accuracy::passed() const
+      {
+         return ((tolerance <= 0.) || (relativeError() <= tolerance));
+      }
+
+      std::unique_ptr<Backend> makeHostBackend(std::size_t grainSize)
+      {
+         return std::make_unique<HostBackend>(grainSize);
+      }
+
+      KernelResult runLinearTransform(Backend &backend,
+                                      std::vector<SyntheticEvent> &events)
+      {
+         KernelResult result{"linearTransform", backend.name(), "", 1, 0, 0,
+                             {}, {}};
+         for (SyntheticEvent &event : events)
+         {
+            const std::size_t n = event.values.size();
+            std::pmr::vector<float> input(&backend.hostMR());
+            std::pmr::vector<float> output(&backend.hostMR());
+
+            // Gather the inputs into the backend's host memory.
+            timeStage(result.stages.gather, n * sizeof(float), [&]()
+                      {
+               input.assign(event.values.begin(), event.values.end());
+               output.resize(n); });
+
+            // Run the calculation.
+            backend.linearTransform(input, output, result.stages);
+
+            // Scatter the results back into the event.
+            timeStage(result.stages.scatter, n * sizeof(float), [&]()
+                      { event.transformedValues.assign(output.begin(),
+                                                       output.end()); });
+
+            ++result.nEvents;
+            result.nObjects += n;
+         }
+         return result;
+      }
+
+      KernelResult runElementWiseChain(Backend &backend,
+                                       std::vector<SyntheticEvent> &events,
+                                       bool fused)
+      {
+         KernelResult result{"elementWiseChain", backend.name(),
+                             (fused ? "launches:fused" : "launches:separate"),
+                             1, 0, 0, {}, {}};
+         for (SyntheticEvent &event : events)
+         {
+            const std::size_t n = event.values.size();
+            std::pmr::vector<float> input(&backend.hostMR());
+            std::pmr::vector<float> output(&backend.hostMR());
+
+            // Gather the inputs into the backend's host memory.
+            timeStage(result.stages.gather, n * sizeof(float), [&]()
+                      {
+               input.assign(event.values.begin(), event.values.end());
+               output.resize(n); });
+
+            // Run the calculation.
+            backend.elementWiseChain(input, output, fused, result.stages);
+
+            // Scatter the results back into the event.
+            timeStage(result.stages.scatter, n * sizeof(float), [&]()
+                      { event.transformedValues.assign(output.begin(),
+                                                       output.end()); });
+
+            ++result.nEvents;
+            result.nObjects += n;
+         }
+         return result;
+      }
+
+      KernelResult runCalibrateElectrons(Backend &backend,
+                                         std::vector<SyntheticEvent> &events,
+                                         const ElectronCalibrationTable &table,
+                                         bool zeroCopyInput,
+                                         const TransferEncoding *encoding)
+      {
+         if (zeroCopyInput && encoding)
+         {
+            throw std::invalid_argument(
+                "Encoded transfers need staged electron inputs");
+         }
+         KernelResult result{"calibrateElectrons", backend.name(), "", 1, 0,
+                             0, {}, {}};
+         result.variant = (zeroCopyInput ? "input:zero-copy" : "input:staged");
+         result.accuracy = Accuracy{};
+         if (encoding)
+         {
+            result.variant += ",encoding:" + encoding->toString();
+         }
+         else
+         {
+            result.accuracy->tolerance = CALIBRATION_TOLERANCE;
+         }
+         if (!table.empty())
+         {
+            const ElectronCalibrationTableView layout = table.view();
+            result.variant += ",table:" + std::to_string(layout.nEta) + "x" +
+                              std::to_string(layout.nPhi) + "x" +
+                              std::to_string(layout.nPt) + "x" +
+                              std::to_string(layout.nAuthor);
+         }
+         backend.setCalibrationTable(table, result.stages);
+         for (SyntheticEvent &event : events)
+         {
+            const std::size_t n = event.electrons.size();
+
+            // Set up the "aux store" of the electrons. Not timed, as in a job
+            // the xAOD objects would already hold their variables like this.
+            std::vector<float> auxEta(n), auxPhi(n), auxPt(n);
+            std::vector<std::uint16_t> auxAuthor(n);
+            std::vector<float> auxCalibratedPt(n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+               const SyntheticElectron &el = event.electrons[i];
+               auxEta[i] = el.eta;
+               auxPhi[i] = el.phi;
+               auxPt[i] = el.pt;
+               auxAuthor[i] = el.author;
+            }
+
+            if (zeroCopyInput)
+            {
+               // Let the backend use the aux store arrays directly.
+               backend.calibrateElectrons({auxEta, auxPhi, auxPt, auxAuthor},
+                                          auxCalibratedPt, result.stages);
+            }
+            else if (encoding)
+            {
+               std::pmr::vector<float> eta(&backend.hostMR());
+               std::pmr::vector<float> phi(&backend.hostMR());
+               std::pmr::vector<float> pt(&backend.hostMR());
+               std::pmr::vector<std::uint16_t> etaCodes(&backend.hostMR());
+               std::pmr::vector<std::uint16_t> phiCodes(&backend.hostMR());
+               std::pmr::vector<std::uint16_t> ptCodes(&backend.hostMR());
+               std::pmr::vector<std::uint16_t> author(&backend.hostMR());
+               std::pmr::vector<float> calibratedPt(&backend.hostMR());
+
+               // Stage the electron variables in the backend's memory,
+               // encoding them on the way.
+               EncodedElectronArrays input;
+               const Clock::time_point gatherStart = Clock::now();
+               input.eta = stageColumn(encoding->eta, auxEta, eta, etaCodes);
+               input.phi = stageColumn(encoding->phi, auxPhi, phi, phiCodes);
+               input.pt = stageColumn(encoding->pt, auxPt, pt, ptCodes);
+               author.assign(auxAuthor.begin(), auxAuthor.end());
+               input.author = author;
+               calibratedPt.resize(n);
+               result.stages.gather.time += Clock::now() - gatherStart;
+               result.stages.gather.bytes += input.size_bytes();
+
+               // Run the calculation.
+               backend.calibrateElectronsEncoded(input, calibratedPt,
+                                                 result.stages);
+
+               // Copy the results into the aux store.
+               timeStage(result.stages.scatter, n * sizeof(float), [&]()
+                         { std::copy(calibratedPt.begin(), calibratedPt.end(),
+                                     auxCalibratedPt.begin()); });
+            }
+            else
+            {
+               std::pmr::vector<float> eta(&backend.hostMR());
+               std::pmr::vector<float> phi(&backend.hostMR());
+               std::pmr::vector<float> pt(&backend.hostMR());
+               std::pmr::vector<std::uint16_t> author(&backend.hostMR());
+               std::pmr::vector<float> calibratedPt(&backend.hostMR());
+
+               // Stage the electron variables in the backend's memory.
+               timeStage(result.stages.gather,
+                         n * (3 * sizeof(float) + sizeof(std::uint16_t)),
+                         [&]()
+                         {
+                  eta.assign(auxEta.begin(), auxEta.end());
+                  phi.assign(auxPhi.begin(), auxPhi.end());
+                  pt.assign(auxPt.begin(), auxPt.end());
+                  author.assign(auxAuthor.begin(), auxAuthor.end());
+                  calibratedPt.resize(n); });
+
+               // Run the calculation.
+               backend.calibrateElectrons({eta, phi, pt, author},
+                                          calibratedPt, result.stages);
+
+               // Copy the results into the aux store.
+               timeStage(result.stages.scatter, n * sizeof(float), [&]()
+                         { std::copy(calibratedPt.begin(), calibratedPt.end(),
+                                     auxCalibratedPt.begin()); });
+            }
+
+            // Compare the results to an unencoded host calculation.
+            std::vector<float> reference(n);
+            Host::calibrateElectrons(auxEta, auxPhi, auxPt, auxAuthor,
+                                     table.view(), reference);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+               result.accuracy->add(reference[i], auxCalibratedPt[i]);
+            }
+
+            // Set the results on the electrons, for validation.
+            for (std::size_t i = 0; i < n; ++i)
+            {
+               event.electrons[i].calibratedPt = auxCalibratedPt[i];
+            }
+
+            ++result.nEvents;
+            result.nObjects += n;
+         }
+         return result;
+      }
+
+      KernelResult runCalculatePulls(Backend &backend,
+                                     std::vector<SyntheticEvent> &events,
+                                     std::size_t batchSize,
+                                     const SegmentedReductionConfig *segmented,
+                                     const TransferEncoding *encoding)
+      {
+         if (segmented && encoding)
+         {
+            throw std::invalid_argument(
+                "Encoded transfers are not available with the segmented "
+                "reduction");
+         }
+         KernelResult result{"calculatePulls", backend.name(),
+                             (segmented ? "reduction:segmented"
+                                        : "reduction:block-per-jet"),
+                             1, 0, 0, {}, {}};
+         result.batchSize = std::max(batchSize, std::size_t{1});
+         std::optional<JetArraysEncoder> encoder;
+         result.accuracy = Accuracy{};
+         if (encoding)
+         {
+            result.variant += ",encoding:" + encoding->toString();
+            encoder.emplace(*encoding, &backend.hostMR());
+         }
+         else
+         {
+            result.accuracy->tolerance = PULL_TOLERANCE;
+         }
+         std::vector<SyntheticEvent *> batchEvents;
+         JetPullBatch batch(&backend.hostMR());
+         for (std::size_t iEvent = 0; iEvent < events.size(); ++iEvent)
+         {
+            SyntheticEvent &event = events[iEvent];
+            const std::size_t nJets = event.jets.size();
+
+            // Gather the jet and constituent properties, the same way
+            // JetPullCUDAAlg does it. Appending them to the current batch.
+            std::size_t totalConstituents = 0;
+            const Clock::time_point gatherStart = Clock::now();
+            for (const SyntheticJet &jet : event.jets)
+            {
+               batch.jetPt.push_back(jet.pt);
+               batch.jetEta.push_back(jet.eta);
+               batch.jetPhi.push_back(jet.phi);
+               batch.nConstituents.push_back(jet.constituents.size());
+               totalConstituents += jet.constituents.size();
+            }
+            batch.constPt.reserve(batch.constPt.size() + totalConstituents);
+            batch.constEta.reserve(batch.constEta.size() + totalConstituents);
+            batch.constPhi.reserve(batch.constPhi.size() + totalConstituents);
+            for (const SyntheticJet &jet : event.jets)
+            {
+               for (const SyntheticConstituent &c : jet.constituents)
+               {
+                  batch.constPt.push_back(c.pt);
+                  batch.constEta.push_back(c.eta);
+                  batch.constPhi.push_back(c.phi);
+               }
+            }
+            batch.eventOffsets.push_back(batch.jetPt.size());
+            batchEvents.push_back(&event);
+            result.stages.gather.time += Clock::now() - gatherStart;
+            // With an encoding, the gathered arrays only stage the values
+            // for the encoder. What is moved is the encoded batch.
+            if (!encoder)
+            {
+               result.stages.gather.bytes +=
+                   nJets * (3 * sizeof(float) + sizeof(std::size_t)) +
+                   totalConstituents * 3 * sizeof(float);
+            }
+            ++result.nEvents;
+            result.nObjects += nJets;
+
+            // Continue, if the batch is not full yet.
+            if ((batch.size() < result.batchSize) &&
+                (iEvent + 1 < events.size()))
+            {
+               continue;
+            }
+
+            // Run the calculation.
+            batch.pullEta.resize(batch.jetPt.size());
+            batch.pullPhi.resize(batch.jetPt.size());
+            const JetArrays input{batch.jetPt, batch.jetEta, batch.jetPhi,
+                                  batch.nConstituents, batch.constPt,
+                                  batch.constEta, batch.constPhi};
+            if (segmented)
+            {
+               backend.calculatePullsSegmented(input, batch.pullEta,
+                                               batch.pullPhi, *segmented,
+                                               result.stages);
+            }
+            else if (encoder)
+            {
+               // Encode the gathered arrays, as part of the gather.
+               EncodedJetArrays encoded;
+               timeStage(result.stages.gather, 0, [&]()
+                         { encoded = encoder->encode(input); });
+               result.stages.gather.bytes += encoded.size_bytes();
+               backend.calculatePullsEncoded(encoded, batch.pullEta,
+                                             batch.pullPhi, result.stages);
+            }
+            else
+            {
+               backend.calculatePulls(input, batch.pullEta, batch.pullPhi,
+                                      result.stages);
+            }
+
+            // Compare the results to an unencoded host calculation.
+            std::vector<float> referenceEta(batch.jetPt.size());
+            std::vector<float> referencePhi(batch.jetPt.size());
+            Host::calculatePulls(input.jetPt, input.jetEta, input.jetPhi,
+                                 input.nConstituents, input.constPt,
+                                 input.constEta, input.constPhi, referenceEta,
+                                 referencePhi);
+            for (std::size_t i = 0; i < referenceEta.size(); ++i)
+            {
+               result.accuracy->add(referenceEta[i], batch.pullEta[i]);
+               result.accuracy->add(referencePhi[i], batch.pullPhi[i]);
+            }
+
+            // Scatter the results back into the jets of every event.
+            timeStage(result.stages.scatter,
+                      2 * batch.jetPt.size() * sizeof(float), [&]()
+                      {
+               for (std::size_t i = 0; i < batchEvents.size(); ++i)
+               {
+                  std::vector<SyntheticJet> &jets = batchEvents[i]->jets;
+                  const std::size_t offset = batch.eventOffsets[i];
+                  for (std::size_t j = 0; j < jets.size(); ++j)
+                  {
+                     jets[j].pullEta = batch.pullEta[offset + j];
+                     jets[j].pullPhi = batch.pullPhi[offset + j];
+                  }
+               } });
+
+            // Start a new batch.
+            batch = JetPullBatch(&backend.hostMR());
+            batchEvents.clear();
+         }
+         return result;
+      }
+
+      KernelResult runGatherConstituents(std::vector<SyntheticEvent> &events,
+                                         std::size_t nSources, bool indexed)
+      {
+         KernelResult result{"gatherConstituents", "host", "", 1, 0, 0, {},
+                             {}};
+         nSources = std::max(nSources, std::size_t{1});
+         result.variant = std::string(indexed ? "gather:indexed" : "gather:loop") +
+                          ",sources:" + std::to_string(nSources);
+         std::mt19937 rng(1234);
+         std::pmr::unsynchronized_pool_resource mr;
+         for (const SyntheticEvent &event : events)
+         {
+            // Set up the constituent containers. Not timed, as in a job they
+            // would already exist.
+            const ConstituentEvent input =
+                makeConstituentEvent(event, nSources, rng);
+
+            std::pmr::vector<std::size_t> nConstituents(&mr);
+            std::pmr::vector<float> constPt(&mr);
+            std::pmr::vector<float> constEta(&mr);
+            std::pmr::vector<float> constPhi(&mr);
+
+            // Gather the constituents through their interface objects, in
+            // two passes, the same way as JetPullCUDAAlg used to. Like
+            // xAOD::JetConstituentVector, creating a four-momentum for each
+            // constituent first.
+            auto gatherLoop = [&]()
+            {
+               std::size_t totalConstituents = 0;
+               nConstituents.reserve(input.jetLinks.size());
+               for (const std::vector<ParticleLink> &links : input.jetLinks)
+               {
+                  totalConstituents += links.size();
+                  nConstituents.push_back(links.size());
+               }
+               constPt.reserve(totalConstituents);
+               constEta.reserve(totalConstituents);
+               constPhi.reserve(totalConstituents);
+               for (const std::vector<ParticleLink> &links : input.jetLinks)
+               {
+                  for (const ParticleLink &link : links)
+                  {
+                     const SyntheticConstituent c{link->pt(), link->eta(),
+                                                  link->phi(), link->m()};
+                     constPt.push_back(c.pt);
+                     constEta.push_back(c.eta);
+                     constPhi.push_back(c.phi);
+                  }
+               }
+            };
+
+            // Gather the constituents with indexed loads from the columns.
+            auto gatherIndexed = [&]()
+            {
+               std::size_t totalConstituents = 0;
+               nConstituents.reserve(input.jetLinks.size());
+               for (const std::vector<ParticleLink> &links : input.jetLinks)
+               {
+                  totalConstituents += links.size();
+                  nConstituents.push_back(links.size());
+               }
+               constPt.resize(totalConstituents);
+               constEta.resize(totalConstituents);
+               constPhi.resize(totalConstituents);
+               ConstituentGatherer<const ParticleContainer *> gatherer(
+                   [](const ParticleContainer *container)
+                   {
+                      return ConstituentColumns{
+                          container->columns[ParticleContainer::PT],
+                          container->columns[ParticleContainer::ETA],
+                          container->columns[ParticleContainer::PHI]};
+                   },
+                   constPt, constEta, constPhi, &mr);
+               for (const std::vector<ParticleLink> &links : input.jetLinks)
+               {
+                  for (const ParticleLink &link : links)
+                  {
+                     gatherer.gather(link.container, link.index);
+                  }
+               }
+            };
+
+            // Time the requested gather.
+            std::size_t totalConstituents = 0;
+            for (const std::vector<ParticleLink> &links : input.jetLinks)
+            {
+               totalConstituents += links.size();
+            }
+            timeStage(result.stages.gather,
+                      input.jetLinks.size() * sizeof(std::size_t) +
+                          totalConstituents * 3 * sizeof(float),
+                      [&]()
+                      {
+               if (indexed)
+               {
+                  gatherIndexed();
+               }
+               else
+               {
+                  gatherLoop();
+               } });
+
+            // Check the indexed gather against the simple loop.
+            if (indexed)
+            {
+               const std::pmr::vector<std::size_t> indexedN = nConstituents;
+               const std::pmr::vector<float> indexedPt = constPt;
+               const std::pmr::vector<float> indexedEta = constEta;
+               const std::pmr::vector<float> indexedPhi = constPhi;
+               nConstituents.clear();
+               constPt.clear();
+               constEta.clear();
+               constPhi.clear();
+               gatherLoop();
+               if ((indexedN != nConstituents) || (indexedPt != constPt) ||
+                   (indexedEta != constEta) || (indexedPhi != constPhi))
+               {
+                  throw std::runtime_error(
+                      "The indexed constituent gather gave different results "
+                      "than the simple loop");
+               }
+            }
+
+            ++result.nEvents;
+            result.nObjects += totalConstituents;
+         }
+         return result;
+      }
+
+      KernelResult runKinematics(std::vector<SyntheticEvent> &events,
+                                 KinematicsFunction function)
+      {
+         KernelResult result{"kinematics", "host", "", 1, 0, 0, {}, {}};
+         std::size_t bytesPerConstituent = 0;
+         switch (function)
+         {
+         case KinematicsFunction::DeltaPhi:
+            result.variant = "function:deltaPhi";
+            bytesPerConstituent = 2 * sizeof(float);
+            break;
+         case KinematicsFunction::DeltaR:
+            result.variant = "function:deltaR";
+            bytesPerConstituent = 3 * sizeof(float);
+            break;
+         case KinematicsFunction::PtWeightedSum:
+            result.variant = "function:ptWeightedSum";
+            bytesPerConstituent = 2 * sizeof(float);
+            break;
+         case KinematicsFunction::PtWeightedDeltaR:
+            result.variant = "function:ptWeightedDeltaR";
+            bytesPerConstituent = 3 * sizeof(float);
+            break;
+         }
+         result.accuracy = Accuracy{};
+         result.accuracy->tolerance = KINEMATICS_TOLERANCE;
+
+         // Double precision versions of the functions.
+         auto deltaPhi = [](float phi1, float phi2)
+         {
+            return std::remainder(static_cast<double>(phi1) -
+                                      static_cast<double>(phi2),
+                                  2. * std::numbers::pi);
+         };
+         auto deltaR = [&](float eta1, float phi1, float eta2, float phi2)
+         {
+            const double dEta =
+                static_cast<double>(eta1) - static_cast<double>(eta2);
+            const double dPhi = deltaPhi(phi1, phi2);
+            return std::sqrt(dEta * dEta + dPhi * dPhi);
+         };
+
+         std::vector<std::size_t> offsets;
+         std::vector<float> pt, eta, phi, output, sums;
+         for (const SyntheticEvent &event : events)
+         {
+            // Lay out the constituents in flat arrays. Not timed, as this is
+            // what the calculations would receive.
+            offsets.assign(1, 0);
+            pt.clear();
+            eta.clear();
+            phi.clear();
+            for (const SyntheticJet &jet : event.jets)
+            {
+               for (const SyntheticConstituent &c : jet.constituents)
+               {
+                  pt.push_back(c.pt);
+                  eta.push_back(c.eta);
+                  phi.push_back(c.phi);
+               }
+               offsets.push_back(pt.size());
+            }
+            output.resize(pt.size());
+            sums.resize(event.jets.size());
+
+            // Apply the function to the constituents of every jet.
+            timeStage(result.stages.compute, pt.size() * bytesPerConstituent,
+                      [&]()
+                      {
+               for (std::size_t j = 0; j < event.jets.size(); ++j)
+               {
+                  const SyntheticJet &jet = event.jets[j];
+                  const std::size_t begin = offsets[j];
+                  const std::size_t n = offsets[j + 1] - begin;
+                  const std::span<const float> cPt(pt.data() + begin, n);
+                  const std::span<const float> cEta(eta.data() + begin, n);
+                  const std::span<const float> cPhi(phi.data() + begin, n);
+                  const std::span<float> out(output.data() + begin, n);
+                  switch (function)
+                  {
+                  case KinematicsFunction::DeltaPhi:
+                     Kinematics::deltaPhi(cPhi, jet.phi, out);
+                     break;
+                  case KinematicsFunction::DeltaR:
+                     Kinematics::deltaR(cEta, cPhi, jet.eta, jet.phi, out);
+                     break;
+                  case KinematicsFunction::PtWeightedSum:
+                     sums[j] = Kinematics::ptWeightedSum(cPt, cEta);
+                     break;
+                  case KinematicsFunction::PtWeightedDeltaR:
+                     sums[j] = Kinematics::ptWeightedDeltaR(cPt, cEta, cPhi,
+                                                            jet.eta, jet.phi);
+                     break;
+                  }
+               } });
+
+            // Compare the results to the double precision calculation.
+            for (std::size_t j = 0; j < event.jets.size(); ++j)
+            {
+               const SyntheticJet &jet = event.jets[j];
+               double sum = 0.;
+               for (std::size_t i = offsets[j]; i < offsets[j + 1]; ++i)
+               {
+                  switch (function)
+                  {
+                  case KinematicsFunction::DeltaPhi:
+                     result.accuracy->add(deltaPhi(phi[i], jet.phi),
+                                          output[i]);
+                     break;
+                  case KinematicsFunction::DeltaR:
+                     result.accuracy->add(
+                         deltaR(eta[i], phi[i], jet.eta, jet.phi), output[i]);
+                     break;
+                  case KinematicsFunction::PtWeightedSum:
+                     sum += static_cast<double>(pt[i]) *
+                            static_cast<double>(eta[i]);
+                     break;
+                  case KinematicsFunction::PtWeightedDeltaR:
+                     sum += static_cast<double>(pt[i]) *
+                            deltaR(eta[i], phi[i], jet.eta, jet.phi);
+                     break;
+                  }
+               }
+               if ((function == KinematicsFunction::PtWeightedSum) ||
+                   (function == KinematicsFunction::PtWeightedDeltaR))
+               {
+                  result.accuracy->add(sum, sums[j]);
+               }
+            }
+
+            ++result.nEvents;
+            result.nObjects += pt.size();
+         }
+         return result;
+      }
+
+      KernelResult runConcurrentOffload(std::vector<SyntheticEvent> &events,
+                                        const ConcurrentOffloadConfig &config)
+      {
+         const std::size_t nSlots =
+             std::max(config.concurrentEvents, std::size_t{1});
+         KernelResult result{"concurrentOffload", "host", "", 1, 0, 0, {},
+                             {}};
+         result.variant =
+             std::string(config.deviceWideSync ? "sync:device" : "sync:stream") +
+             ",concurrency:" + std::to_string(nSlots);
+
+         // The eta, phi, pt and author of every electron go to the "device",
+         // its calibrated pt comes back.
+         static constexpr std::size_t BYTES_PER_ELECTRON =
+             4 * sizeof(float) + sizeof(std::uint16_t);
+
+         // Set up the "device", with one stream per event slot.
+         const MockDevice device(config.latency, config.bytesPerSecond);
+         HostThreadPool pool(nSlots);
+         std::vector<std::unique_ptr<AsyncExecutor::Stream>> streams;
+         for (std::size_t i = 0; i < nSlots; ++i)
+         {
+            streams.push_back(pool.makeStream());
+         }
+
+         // Process the events, every slot taking the next unprocessed one.
+         std::size_t totalElectrons = 0;
+         for (const SyntheticEvent &event : events)
+         {
+            totalElectrons += event.electrons.size();
+         }
+         std::atomic<std::size_t> nextEvent{0};
+         auto processEvents = [&](AsyncExecutor::Stream &stream)
+         {
+            for (std::size_t i = nextEvent++; i < events.size();
+                 i = nextEvent++)
+            {
+               std::vector<SyntheticElectron> &electrons = events[i].electrons;
+               stream.enqueue(
+                   [&device, &electrons]()
+                   {
+                      device.run(electrons.size() * BYTES_PER_ELECTRON,
+                                 [&electrons]()
+                                 {
+                                    for (SyntheticElectron &el : electrons)
+                                    {
+                                       el.calibratedPt =
+                                           calibratedElectronPt(el.pt, el.phi);
+                                    }
+                                 });
+                   });
+               if (config.deviceWideSync)
+               {
+                  for (const std::unique_ptr<AsyncExecutor::Stream> &s :
+                       streams)
+                  {
+                     s->wait();
+                  }
+               }
+               else
+               {
+                  stream.wait();
+               }
+            }
+         };
+         timeStage(result.stages.compute, totalElectrons * BYTES_PER_ELECTRON,
+                   [&]()
+                   {
+            std::vector<std::thread> slots;
+            for (std::size_t i = 0; i < nSlots; ++i)
+            {
+               slots.emplace_back(processEvents, std::ref(*streams[i]));
+            }
+            for (std::thread &slot : slots)
+            {
+               slot.join();
+            } });
+
+         result.nEvents = events.size();
+         result.nObjects = totalElectrons;
+         return result;
+      }
+
+      KernelResult runFirstEvents(std::vector<SyntheticEvent> &events,
+                                  std::pmr::memory_resource &upstream,
+                                  AllocationProfile &profile,
+                                  const FirstEventsConfig &config)
+      {
+         KernelResult result{"firstEvents", "host", "", 1, 0, 0, {}, {}};
+         result.variant = "upstream:" + config.upstream +
+                          ",prewarm:" + (config.prewarm ? "yes" : "no");
+
+         // Set up the memory resources of the "job".
+         static const std::string ARENA = "arena";
+         static const std::string POOL = "pool";
+         ArenaMemoryResource arena(upstream);
+         vecmem::pool_memory_resource pool(upstream);
+         AllocationRecorder recorder(pool);
+         if (config.prewarm)
+         {
+            arena.reserve(AllocationProfile::bytes(profile.blocks(ARENA)));
+            prewarm(pool, profile.blocks(POOL));
+         }
+
+         // Allocate and fill the arrays of the first events.
+         const std::size_t nEvents = std::min(config.nEvents, events.size());
+         for (std::size_t i = 0; i < nEvents; ++i)
+         {
+            const SyntheticEvent &event = events[i];
+            const std::size_t nValues = event.values.size();
+            const std::size_t nElectrons = event.electrons.size();
+            const std::size_t nJets = event.jets.size();
+            std::size_t nConstituents = 0;
+            for (const SyntheticJet &jet : event.jets)
+            {
+               nConstituents += jet.constituents.size();
+            }
+            const std::size_t bytes =
+                2 * nValues * sizeof(float) +
+                nElectrons * (4 * sizeof(float) + sizeof(std::uint16_t)) +
+                nJets * (5 * sizeof(float) + sizeof(std::uint32_t)) +
+                3 * nConstituents * sizeof(float);
+
+            timeStage(result.stages.gather, bytes, [&]()
+                      {
+               {
+                  // Linear transformation.
+                  std::pmr::vector<float> values(event.values.begin(),
+                                                 event.values.end(), &arena);
+                  std::pmr::vector<float> transformed(nValues, 0.f, &arena);
+                  // Electron calibration (eta, phi, pt, calibrated pt).
+                  std::pmr::vector<float> electrons(4 * nElectrons, 0.f,
+                                                    &arena);
+                  std::pmr::vector<std::uint16_t> authors(nElectrons, 0,
+                                                          &arena);
+                  // Jet pull (eta, phi, pt, pull eta, pull phi).
+                  std::pmr::vector<float> jets(5 * nJets, 0.f, &arena);
+                  std::pmr::vector<std::uint32_t> counts(nJets, 0, &arena);
+                  std::pmr::vector<float> constituents(3 * nConstituents, 0.f,
+                                                       &recorder);
+               }
+               arena.reset(); });
+
+            ++result.nEvents;
+            result.nObjects += nValues + nElectrons + nConstituents;
+         }
+
+         // Record the memory use of this run, for the next one.
+         profile.set(ARENA, {{arena.peak(), 1}});
+         profile.set(POOL, recorder.histogram());
+         return result;
+      }
+
+      KernelResult replayCalibrateElectrons(
+          Backend &backend, const EventCaptureReader &input,
+          const ElectronCalibrationTable &table)
+      {
+         KernelResult result{"calibrateElectrons", backend.name(),
+                             "input:capture", 1, 0, 0, {}, {}};
+         if (!table.empty())
+         {
+            const ElectronCalibrationTableView layout = table.view();
+            result.variant += ",table:" + std::to_string(layout.nEta) + "x" +
+                              std::to_string(layout.nPhi) + "x" +
+                              std::to_string(layout.nPt) + "x" +
+                              std::to_string(layout.nAuthor);
+         }
+         backend.setCalibrationTable(table, result.stages);
+         std::pmr::vector<float> calibratedPt(&backend.hostMR());
+         for (std::size_t iEvent = 0; iEvent < input.size(); ++iEvent)
+         {
+            const CapturedEvent event = input[iEvent];
+            if (!event.has(CaptureColumn::ElectronPt))
+            {
+               continue;
+            }
+
+            // The electron variables are used in place in the mapped file.
+            // Nothing needs to be gathered for them.
+            const ElectronArrays electrons{
+                event.column<float>(CaptureColumn::ElectronEta),
+                event.column<float>(CaptureColumn::ElectronPhi),
+                event.column<float>(CaptureColumn::ElectronPt),
+                event.column<std::uint16_t>(CaptureColumn::ElectronAuthor)};
+            const std::size_t n = electrons.pt.size();
+            calibratedPt.resize(n);
+
+            // Run the calculation.
+            backend.calibrateElectrons(electrons, calibratedPt, result.stages);
+
+            ++result.nEvents;
+            result.nObjects += n;
+         }
+         return result;
+      }
+
+      KernelResult replayCalculatePulls(Backend &backend,
+                                        const EventCaptureReader &input)
+      {
+         KernelResult result{"calculatePulls", backend.name(),
+                             "input:capture", 1, 0, 0, {}, {}};
+         std::pmr::vector<float> pullEta(&backend.hostMR());
+         std::pmr::vector<float> pullPhi(&backend.hostMR());
+         for (std::size_t iEvent = 0; iEvent < input.size(); ++iEvent)
+         {
+            const CapturedEvent event = input[iEvent];
+            if (!event.has(CaptureColumn::JetPt))
+            {
+               continue;
+            }
+
+            // The jet and constituent variables are used in place in the
+            // mapped file. Nothing needs to be gathered for them.
+            const JetArrays jets{
+                event.column<float>(CaptureColumn::JetPt),
+                event.column<float>(CaptureColumn::JetEta),
+                event.column<float>(CaptureColumn::JetPhi),
+                event.column<std::size_t>(CaptureColumn::JetNConstituents),
+                event.column<float>(CaptureColumn::ConstituentPt),
+                event.column<float>(CaptureColumn::ConstituentEta),
+                event.column<float>(CaptureColumn::ConstituentPhi)};
+            const std::size_t nJets = jets.jetPt.size();
+            pullEta.resize(nJets);
+            pullPhi.resize(nJets);
+
+            // Run the calculation.
+            backend.calculatePulls(jets, pullEta, pullPhi, result.stages);
+
+            ++result.nEvents;
+            result.nObjects += nJets;
+         }
+         return result;
+      }
+
+      void writeJson(std::ostream &out, const SyntheticEventConfig &config,
+                     const std::vector<KernelResult> &results)
+      {
+         out << "{\n";
+         out << "  \"config\": {\n";
+         out << "    \"seed\": " << config.seed << ",\n";
+         out << "    \"nValues\": \"" << config.nValues.toString() << "\",\n";
+         out << "    \"nElectrons\": \"" << config.nElectrons.toString()
+             << "\",\n";
+         out << "    \"nJets\": \"" << config.nJets.toString() << "\",\n";
+         out << "    \"nConstituents\": \"" << config.nConstituents.toString()
+             << "\"\n";
+         out << "  },\n";
+         writeResults(out, results);
+         out << "}\n";
+      }
+
+      void writeJson(std::ostream &out, const EventCaptureReader &input,
+                     const std::vector<KernelResult> &results)
+      {
+         out << "{\n";
+         out << "  \"config\": {\n";
+         out << "    \"input\": \"" << input.fileName() << "\",\n";
+         out << "    \"indexed\": " << (input.indexed() ? "true" : "false")
+             << ",\n";
+         out << "    \"events\": " << input.size() << "\n";
+         out << "  },\n";
+         writeResults(out, results);
+         out << "}\n";
+      }
+
+   } // namespace Benchmark
+
+} // namespace GPUTutorial
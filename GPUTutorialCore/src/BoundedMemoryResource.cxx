@@ -0,0 +1,56 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "GPUTutorialCore/BoundedMemoryResource.h"
+
+// System include(s).
+#include <new>
+
+namespace GPUTutorial
+{
+   BoundedMemoryResource::BoundedMemoryResource(
+       std::pmr::memory_resource &upstream, std::size_t limit)
+       : m_upstream(upstream), m_limit(limit) {}
+
+   void *BoundedMemoryResource::do_allocate(std::size_t bytes,
+                                            std::size_t alignment)
+   {
+      // Reserve the memory in the bookkeeping first.
+      const std::size_t allocated = m_allocated.fetch_add(bytes) + bytes;
+      if ((m_limit != 0) && (allocated > m_limit))
+      {
+         m_allocated.fetch_sub(bytes);
+         throw std::bad_alloc();
+      }
+      std::size_t peak = m_peak.load();
+      while ((allocated > peak) &&
+             !m_peak.compare_exchange_weak(peak, allocated))
+      {
+      }
+
+      // Then perform the allocation.
+      try
+      {
+         return m_upstream.allocate(bytes, alignment);
+      }
+      catch (...)
+      {
+         m_allocated.fetch_sub(bytes);
+         throw;
+      }
+   }
+
+   void BoundedMemoryResource::do_deallocate(void *p, std::size_t bytes,
+                                             std::size_t alignment)
+   {
+      m_upstream.deallocate(p, bytes, alignment);
+      m_allocated.fetch_sub(bytes);
+   }
+
+   bool BoundedMemoryResource::do_is_equal(
+       const std::pmr::memory_resource &other) const noexcept
+   {
+      return (this == &other);
+   }
+
+} // namespace GPUTutorial
@@ -0,0 +1,48 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "GPUTutorialCore/ElectronCalibration.h"
+
+// System include(s).
+#include <cassert>
+
+namespace GPUTutorial
+{
+   namespace Host
+   {
+      void calibrateElectrons(std::span<const float> eta,
+                              std::span<const float> phi,
+                              std::span<const float> pt,
+                              std::span<const std::uint16_t> author,
+                              std::span<float> calibratedPt)
+      {
+         calibrateElectrons(eta, phi, pt, author, {}, calibratedPt);
+      }
+
+      void calibrateElectrons(std::span<const float> eta,
+                              std::span<const float> phi,
+                              std::span<const float> pt,
+                              std::span<const std::uint16_t> author,
+                              const ElectronCalibrationTableView &table,
+                              std::span<float> calibratedPt)
+      {
+         assert(eta.size() == pt.size());
+         assert(phi.size() == pt.size());
+         assert(author.size() == pt.size());
+         assert(calibratedPt.size() == pt.size());
+         const std::size_t n = pt.size();
+         const float *inEta = eta.data();
+         const float *inPhi = phi.data();
+         const float *inPt = pt.data();
+         const std::uint16_t *inAuthor = author.data();
+         float *out = calibratedPt.data();
+         for (std::size_t i = 0; i < n; ++i)
+         {
+            out[i] = calibratedElectronPt(inPt[i], inEta[i], inPhi[i],
+                                          inAuthor[i], table);
+         }
+      }
+
+   } // namespace Host
+
+} // namespace GPUTutorial
@@ -0,0 +1,270 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "GPUTutorialCore/ElectronCalibrationTable.h"
+#include "GPUTutorialCore/Kinematics.h"
+
+// System include(s).
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <istream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+   /// Check that an axis is valid, and whether its bins are equidistant
+   bool checkAxis(const char *name, std::span<const float> edges)
+   {
+      if (edges.size() < 2)
+      {
+         throw std::invalid_argument(std::string("Axis \"") + name +
+                                     "\" needs at least 2 bin edges");
+      }
+      if (!std::is_sorted(edges.begin(), edges.end()) ||
+          (std::adjacent_find(edges.begin(), edges.end()) != edges.end()))
+      {
+         throw std::invalid_argument(std::string("Axis \"") + name +
+                                     "\" has non-increasing bin edges");
+      }
+      const float width = (edges.back() - edges.front()) /
+                          static_cast<float>(edges.size() - 1);
+      for (std::size_t i = 1; i < edges.size(); ++i)
+      {
+         if (std::abs((edges[i] - edges[i - 1]) - width) > 1e-4f * width)
+         {
+            return false;
+         }
+      }
+      return true;
+   }
+
+   /// Read all values from the remainder of a line
+   template <typename T>
+   std::vector<T> readValues(std::istringstream &line)
+   {
+      std::vector<T> result;
+      T value{};
+      while (line >> value)
+      {
+         result.push_back(value);
+      }
+      if (!line.eof())
+      {
+         throw std::runtime_error("Failed to interpret value(s)");
+      }
+      return result;
+   }
+
+} // namespace
+
+namespace GPUTutorial
+{
+   ElectronCalibrationTable::ElectronCalibrationTable(
+       std::span<const float> etaEdges, std::span<const float> phiEdges,
+       std::span<const float> ptEdges, std::span<const std::uint16_t> authors,
+       std::span<const float> factors)
+   {
+      // Check the consistency of the arguments.
+      m_layout.uniformEta = checkAxis("eta", etaEdges);
+      m_layout.uniformPhi = checkAxis("phi", phiEdges);
+      m_layout.uniformPt = checkAxis("pt", ptEdges);
+      if (authors.empty())
+      {
+         throw std::invalid_argument("No authors given for the table");
+      }
+      m_layout.nEta = static_cast<unsigned int>(etaEdges.size() - 1);
+      m_layout.nPhi = static_cast<unsigned int>(phiEdges.size() - 1);
+      m_layout.nPt = static_cast<unsigned int>(ptEdges.size() - 1);
+      m_layout.nAuthor = static_cast<unsigned int>(authors.size());
+      if (factors.size() != nBins())
+      {
+         throw std::invalid_argument(
+             "Expected " + std::to_string(nBins()) +
+             " correction factors, received " +
+             std::to_string(factors.size()));
+      }
+
+      // Flatten everything into a single array.
+      m_data.reserve(etaEdges.size() + phiEdges.size() + ptEdges.size() +
+                     authors.size() + factors.size());
+      m_data.insert(m_data.end(), etaEdges.begin(), etaEdges.end());
+      m_data.insert(m_data.end(), phiEdges.begin(), phiEdges.end());
+      m_data.insert(m_data.end(), ptEdges.begin(), ptEdges.end());
+      m_data.insert(m_data.end(), authors.begin(), authors.end());
+      m_data.insert(m_data.end(), factors.begin(), factors.end());
+   }
+
+   std::size_t ElectronCalibrationTable::nBins() const
+   {
+      return static_cast<std::size_t>(m_layout.nAuthor) * m_layout.nEta *
+             m_layout.nPhi * m_layout.nPt;
+   }
+
+   ElectronCalibrationTableView ElectronCalibrationTable::view() const
+   {
+      return view(m_data.data());
+   }
+
+   ElectronCalibrationTableView
+   ElectronCalibrationTable::view(const float *data) const
+   {
+      ElectronCalibrationTableView result = m_layout;
+      result.data = (empty() ? nullptr : data);
+      return result;
+   }
+
+   std::vector<ElectronCalibrationIOV>
+   readElectronCalibration(std::istream &in)
+   {
+      std::vector<ElectronCalibrationIOV> result;
+
+      // Helper function finishing the table currently being read.
+      bool inTable = false;
+      std::uint32_t firstRun = 0, lastRun = 0;
+      std::vector<float> etaEdges, phiEdges, ptEdges, factors;
+      std::vector<std::uint16_t> authors;
+      auto finishTable = [&]()
+      {
+         if (!inTable)
+         {
+            return;
+         }
+         result.push_back({firstRun, lastRun,
+                           ElectronCalibrationTable(etaEdges, phiEdges,
+                                                    ptEdges, authors,
+                                                    factors)});
+         etaEdges.clear();
+         phiEdges.clear();
+         ptEdges.clear();
+         authors.clear();
+         factors.clear();
+      };
+
+      // Read the input line-by-line.
+      std::string line;
+      std::size_t lineNumber = 0;
+      while (std::getline(in, line))
+      {
+         ++lineNumber;
+         std::istringstream tokens(line);
+         std::string keyword;
+         if (!(tokens >> keyword) || (keyword[0] == '#'))
+         {
+            continue;
+         }
+         try
+         {
+            if (keyword == "iov")
+            {
+               finishTable();
+               if (!(tokens >> firstRun >> lastRun) || (firstRun > lastRun))
+               {
+                  throw std::runtime_error("Invalid IOV");
+               }
+               inTable = true;
+               continue;
+            }
+            if (!inTable)
+            {
+               throw std::runtime_error("Table data before an \"iov\" line");
+            }
+            if (keyword == "eta")
+            {
+               etaEdges = readValues<float>(tokens);
+            }
+            else if (keyword == "phi")
+            {
+               phiEdges = readValues<float>(tokens);
+            }
+            else if (keyword == "pt")
+            {
+               ptEdges = readValues<float>(tokens);
+            }
+            else if (keyword == "author")
+            {
+               authors = readValues<std::uint16_t>(tokens);
+            }
+            else if (keyword == "factors")
+            {
+               factors = readValues<float>(tokens);
+            }
+            else
+            {
+               throw std::runtime_error("Unknown keyword \"" + keyword + "\"");
+            }
+         }
+         catch (const std::exception &ex)
+         {
+            throw std::runtime_error("Line " + std::to_string(lineNumber) +
+                                     ": " + ex.what());
+         }
+      }
+      finishTable();
+      return result;
+   }
+
+   std::vector<ElectronCalibrationIOV>
+   readElectronCalibration(const std::string &fileName)
+   {
+      std::ifstream in(fileName);
+      if (!in)
+      {
+         throw std::runtime_error("Could not open file \"" + fileName + "\"");
+      }
+      try
+      {
+         return readElectronCalibration(in);
+      }
+      catch (const std::exception &ex)
+      {
+         throw std::runtime_error("Failed to read \"" + fileName +
+                                  "\": " + ex.what());
+      }
+   }
+
+   ElectronCalibrationTable
+   makeSyntheticElectronCalibration(unsigned int nEta, unsigned int nPhi,
+                                    unsigned int nPt, unsigned int nAuthor,
+                                    unsigned int seed)
+   {
+      // Helper function creating equidistant bin edges.
+      auto uniformEdges = [](unsigned int n, float low, float high)
+      {
+         std::vector<float> edges(n + 1);
+         for (unsigned int i = 0; i <= n; ++i)
+         {
+            edges[i] = low + (high - low) * static_cast<float>(i) /
+                                 static_cast<float>(n);
+         }
+         return edges;
+      };
+
+      const std::vector<float> etaEdges = uniformEdges(nEta, -2.5f, 2.5f);
+      const std::vector<float> phiEdges =
+          uniformEdges(nPhi, -Kinematics::PI, Kinematics::PI);
+      std::vector<float> ptEdges = uniformEdges(nPt, std::log(5000.f),
+                                                std::log(500000.f));
+      std::transform(ptEdges.begin(), ptEdges.end(), ptEdges.begin(),
+                     [](float x)
+                     { return std::exp(x); });
+      std::vector<std::uint16_t> authors(nAuthor);
+      for (unsigned int i = 0; i < nAuthor; ++i)
+      {
+         authors[i] = static_cast<std::uint16_t>(i + 1);
+      }
+
+      std::mt19937 rng(seed);
+      std::uniform_real_distribution<float> factorDist(0.9f, 1.1f);
+      std::vector<float> factors(static_cast<std::size_t>(nAuthor) * nEta *
+                                 nPhi * nPt);
+      std::generate(factors.begin(), factors.end(), [&]()
+                    { return factorDist(rng); });
+
+      return ElectronCalibrationTable(etaEdges, phiEdges, ptEdges, authors,
+                                      factors);
+   }
+
+} // namespace GPUTutorial
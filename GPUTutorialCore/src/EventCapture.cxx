@@ -0,0 +1,439 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "GPUTutorialCore/EventCapture.h"
+
+// POSIX include(s).
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// System include(s).
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+   using GPUTutorial::EventCaptureWriter;
+
+   /// Magic bytes at the start of capture files
+   constexpr std::array<char, 8> FILE_MAGIC = {'G', 'P', 'U', 'T',
+                                               'C', 'A', 'P', '1'};
+   /// Magic bytes at the end of indexed capture files
+   constexpr std::array<char, 8> INDEX_MAGIC = {'G', 'P', 'U', 'T',
+                                                'I', 'D', 'X', '1'};
+   /// Magic number at the start of every event record
+   constexpr std::uint64_t RECORD_MAGIC = 0x544e455645545047; // "GPTEVENT"
+
+   /// Header of a capture file
+   struct FileHeader
+   {
+      /// The magic bytes
+      std::array<char, 8> magic = FILE_MAGIC;
+      /// The alignment used in the file
+      std::uint64_t alignment = EventCaptureWriter::ALIGNMENT;
+   };
+
+   /// Header of an event record
+   struct RecordHeader
+   {
+      /// The magic number
+      std::uint64_t magic = RECORD_MAGIC;
+      /// The size of the record, including its padding
+      std::uint64_t size = 0;
+      /// The run number
+      std::uint64_t run = 0;
+      /// The event number
+      std::uint64_t event = 0;
+      /// The number of columns
+      std::uint64_t nColumns = 0;
+   };
+
+   /// Description of one column of a record
+   struct ColumnEntry
+   {
+      /// The column
+      std::uint32_t column = 0;
+      /// The type of the values
+      std::uint32_t type = 0;
+      /// The number of values
+      std::uint64_t count = 0;
+      /// The offset of the values from the start of the record
+      std::uint64_t offset = 0;
+   };
+
+   /// Footer of indexed capture files
+   struct IndexFooter
+   {
+      /// The number of events in the index
+      std::uint64_t nEvents = 0;
+      /// The offset of the index in the file
+      std::uint64_t offset = 0;
+      /// The magic bytes
+      std::array<char, 8> magic = INDEX_MAGIC;
+   };
+
+   /// Round a size up to the alignment of the file
+   constexpr std::uint64_t aligned(std::uint64_t size)
+   {
+      return ((size + EventCaptureWriter::ALIGNMENT - 1) /
+              EventCaptureWriter::ALIGNMENT) *
+             EventCaptureWriter::ALIGNMENT;
+   }
+
+   /// Read a (trivial) structure from memory
+   template <typename T>
+   T load(const std::byte *data)
+   {
+      T result;
+      std::memcpy(&result, data, sizeof(T));
+      return result;
+   }
+
+   /// The size of one value of a capture type (zero for unknown types)
+   std::uint64_t valueSize(std::uint32_t type)
+   {
+      switch (static_cast<GPUTutorial::CaptureType>(type))
+      {
+      case GPUTutorial::CaptureType::Float32:
+         return sizeof(float);
+      case GPUTutorial::CaptureType::UInt16:
+         return sizeof(std::uint16_t);
+      case GPUTutorial::CaptureType::UInt64:
+         return sizeof(std::uint64_t);
+      }
+      return 0;
+   }
+
+   /// The number of columns of a record, checked against its size
+   std::uint64_t nColumns(const RecordHeader &header)
+   {
+      if (header.nColumns >
+          (header.size - std::min<std::uint64_t>(header.size,
+                                                 sizeof(RecordHeader))) /
+              sizeof(ColumnEntry))
+      {
+         throw std::runtime_error(
+             "The column table of a captured event does not fit into its "
+             "record");
+      }
+      return header.nColumns;
+   }
+
+} // namespace
+
+namespace GPUTutorial
+{
+   EventCaptureWriter::EventCaptureWriter(const std::string &fileName)
+       : m_fileName(fileName)
+   {
+      // Create the file, without overwriting an existing one. Appending to
+      // it would leave the index of the old events in the middle of the
+      // file.
+      const int fd = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_EXCL,
+                            0644);
+      if (fd < 0)
+      {
+         throw std::runtime_error("Could not create capture file \"" +
+                                  fileName + "\": " + std::strerror(errno));
+      }
+      ::close(fd);
+      m_file.open(fileName, std::ios::binary);
+      if (!m_file)
+      {
+         throw std::runtime_error("Could not create capture file \"" +
+                                  fileName + "\"");
+      }
+      const FileHeader header;
+      writeAligned(&header, sizeof(header));
+   }
+
+   EventCaptureWriter::~EventCaptureWriter()
+   {
+      try
+      {
+         close();
+      }
+      catch (...)
+      {
+         // Without an index the file can still be read by scanning it.
+      }
+   }
+
+   std::shared_ptr<EventCaptureWriter>
+   EventCaptureWriter::shared(const std::string &fileName)
+   {
+      static std::mutex mutex;
+      static std::map<std::string, std::weak_ptr<EventCaptureWriter>> writers;
+      const std::string key =
+          std::filesystem::absolute(fileName).lexically_normal().string();
+      std::lock_guard lock(mutex);
+      std::shared_ptr<EventCaptureWriter> result = writers[key].lock();
+      if (!result)
+      {
+         result = std::make_shared<EventCaptureWriter>(fileName);
+         writers[key] = result;
+      }
+      return result;
+   }
+
+   void EventCaptureWriter::write(std::uint64_t run, std::uint64_t event,
+                                  std::initializer_list<CaptureBlock> columns)
+   {
+      // Lay out the record.
+      RecordHeader header;
+      header.run = run;
+      header.event = event;
+      header.nColumns = columns.size();
+      std::vector<ColumnEntry> entries;
+      entries.reserve(columns.size());
+      std::uint64_t offset = aligned(sizeof(RecordHeader) +
+                                     columns.size() * sizeof(ColumnEntry));
+      for (const CaptureBlock &block : columns)
+      {
+         entries.push_back({static_cast<std::uint32_t>(block.column),
+                            static_cast<std::uint32_t>(block.type),
+                            block.count, offset});
+         offset += aligned(block.bytes);
+      }
+      header.size = offset;
+
+      // Write it.
+      std::lock_guard lock(m_mutex);
+      if (!m_file.is_open())
+      {
+         throw std::runtime_error("The capture file \"" + m_fileName +
+                                  "\" was closed already");
+      }
+      const std::uint64_t start = m_size;
+      m_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+      m_file.write(reinterpret_cast<const char *>(entries.data()),
+                   entries.size() * sizeof(ColumnEntry));
+      m_size += sizeof(header) + entries.size() * sizeof(ColumnEntry);
+      writeAligned(nullptr, 0);
+      for (const CaptureBlock &block : columns)
+      {
+         writeAligned(block.data, block.bytes);
+      }
+      if (!m_file)
+      {
+         throw std::runtime_error("Failed to write into capture file \"" +
+                                  m_fileName + "\"");
+      }
+      m_index.push_back(start);
+   }
+
+   void EventCaptureWriter::close()
+   {
+      std::lock_guard lock(m_mutex);
+      if (!m_file.is_open())
+      {
+         return;
+      }
+      IndexFooter footer;
+      footer.nEvents = m_index.size();
+      footer.offset = m_size;
+      m_file.write(reinterpret_cast<const char *>(m_index.data()),
+                   m_index.size() * sizeof(std::uint64_t));
+      m_file.write(reinterpret_cast<const char *>(&footer), sizeof(footer));
+      m_file.close();
+      if (!m_file)
+      {
+         throw std::runtime_error("Failed to write the index of capture file "
+                                  "\"" +
+                                  m_fileName + "\"");
+      }
+   }
+
+   std::size_t EventCaptureWriter::size() const
+   {
+      std::lock_guard lock(m_mutex);
+      return m_index.size();
+   }
+
+   void EventCaptureWriter::writeAligned(const void *data, std::size_t bytes)
+   {
+      static constexpr std::array<char, ALIGNMENT> padding{};
+      if (bytes > 0)
+      {
+         m_file.write(static_cast<const char *>(data), bytes);
+      }
+      m_size += bytes;
+      const std::uint64_t end = aligned(m_size);
+      m_file.write(padding.data(), end - m_size);
+      m_size = end;
+   }
+
+   CapturedEvent::CapturedEvent(const std::byte *record) : m_record(record) {}
+
+   std::uint64_t CapturedEvent::run() const
+   {
+      return load<RecordHeader>(m_record).run;
+   }
+
+   std::uint64_t CapturedEvent::event() const
+   {
+      return load<RecordHeader>(m_record).event;
+   }
+
+   bool CapturedEvent::has(CaptureColumn column) const
+   {
+      const RecordHeader header = load<RecordHeader>(m_record);
+      for (std::uint64_t i = 0; i < nColumns(header); ++i)
+      {
+         const ColumnEntry entry = load<ColumnEntry>(
+             m_record + sizeof(RecordHeader) + i * sizeof(ColumnEntry));
+         if (entry.column == static_cast<std::uint32_t>(column))
+         {
+            return true;
+         }
+      }
+      return false;
+   }
+
+   std::size_t CapturedEvent::find(CaptureColumn column, CaptureType type,
+                                   const void *&data) const
+   {
+      const RecordHeader header = load<RecordHeader>(m_record);
+      for (std::uint64_t i = 0; i < nColumns(header); ++i)
+      {
+         const ColumnEntry entry = load<ColumnEntry>(
+             m_record + sizeof(RecordHeader) + i * sizeof(ColumnEntry));
+         if (entry.column != static_cast<std::uint32_t>(column))
+         {
+            continue;
+         }
+         if (entry.type != static_cast<std::uint32_t>(type))
+         {
+            throw std::runtime_error(
+                "Captured column " + std::to_string(entry.column) +
+                " was requested with the wrong type");
+         }
+         // Make sure that the values are inside of the record, so that a
+         // damaged file can not make the caller read beyond it.
+         if ((entry.offset > header.size) ||
+             (entry.count > (header.size - entry.offset) /
+                                valueSize(entry.type)))
+         {
+            throw std::runtime_error(
+                "Captured column " + std::to_string(entry.column) +
+                " does not fit into the record of its event");
+         }
+         data = m_record + entry.offset;
+         return entry.count;
+      }
+      data = nullptr;
+      return 0;
+   }
+
+   EventCaptureReader::EventCaptureReader(const std::string &fileName)
+       : m_fileName(fileName)
+   {
+      // Map the file into memory.
+      const int fd = ::open(fileName.c_str(), O_RDONLY);
+      if (fd < 0)
+      {
+         throw std::runtime_error("Could not open capture file \"" +
+                                  fileName + "\": " + std::strerror(errno));
+      }
+      struct stat info;
+      if (::fstat(fd, &info) != 0)
+      {
+         ::close(fd);
+         throw std::runtime_error("Could not read capture file \"" +
+                                  fileName + "\": " + std::strerror(errno));
+      }
+      m_size = static_cast<std::size_t>(info.st_size);
+      if (m_size < aligned(sizeof(FileHeader)))
+      {
+         ::close(fd);
+         throw std::runtime_error("\"" + fileName +
+                                  "\" is not a capture file");
+      }
+      void *data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      ::close(fd);
+      if (data == MAP_FAILED)
+      {
+         throw std::runtime_error("Could not map capture file \"" +
+                                  fileName + "\": " + std::strerror(errno));
+      }
+      m_data = static_cast<const std::byte *>(data);
+
+      // Check the header.
+      const FileHeader header = load<FileHeader>(m_data);
+      if ((header.magic != FILE_MAGIC) ||
+          (header.alignment != EventCaptureWriter::ALIGNMENT))
+      {
+         ::munmap(const_cast<std::byte *>(m_data), m_size);
+         throw std::runtime_error("\"" + fileName +
+                                  "\" is not a capture file");
+      }
+
+      // Use the index, if the file has a (consistent) one.
+      if (m_size >= aligned(sizeof(FileHeader)) + sizeof(IndexFooter))
+      {
+         const IndexFooter footer =
+             load<IndexFooter>(m_data + m_size - sizeof(IndexFooter));
+         if ((footer.magic == INDEX_MAGIC) &&
+             (footer.offset + footer.nEvents * sizeof(std::uint64_t) +
+                  sizeof(IndexFooter) ==
+              m_size))
+         {
+            m_index.resize(footer.nEvents);
+            std::memcpy(m_index.data(), m_data + footer.offset,
+                        footer.nEvents * sizeof(std::uint64_t));
+            // Only use the index if all of its records are complete.
+            m_indexed = std::all_of(
+                m_index.begin(), m_index.end(),
+                [&](std::uint64_t offset)
+                {
+                   if (offset + sizeof(RecordHeader) > footer.offset)
+                   {
+                      return false;
+                   }
+                   const RecordHeader header =
+                       load<RecordHeader>(m_data + offset);
+                   return ((header.magic == RECORD_MAGIC) &&
+                           (header.size <= footer.offset - offset));
+                });
+            if (m_indexed)
+            {
+               return;
+            }
+            m_index.clear();
+         }
+      }
+      scan();
+   }
+
+   EventCaptureReader::~EventCaptureReader()
+   {
+      ::munmap(const_cast<std::byte *>(m_data), m_size);
+   }
+
+   void EventCaptureReader::scan()
+   {
+      // Collect all complete records. A truncated last record, from a job
+      // that did not finish, is ignored.
+      std::uint64_t offset = aligned(sizeof(FileHeader));
+      while (offset + sizeof(RecordHeader) <= m_size)
+      {
+         const RecordHeader header = load<RecordHeader>(m_data + offset);
+         if ((header.magic != RECORD_MAGIC) || (header.size == 0) ||
+             (offset + header.size > m_size))
+         {
+            break;
+         }
+         m_index.push_back(offset);
+         offset += header.size;
+      }
+   }
+
+} // namespace GPUTutorial
@@ -0,0 +1,90 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "GPUTutorialCore/InstrumentedMemoryResource.h"
+
+// System include(s).
+#include <algorithm>
+
+namespace GPUTutorial
+{
+   InstrumentedMemoryResource::Statistics &
+   InstrumentedMemoryResource::Statistics::operator+=(const Statistics &other)
+   {
+      allocations += other.allocations;
+      deallocations += other.deallocations;
+      bytes += other.bytes;
+      peak = std::max(peak, other.peak);
+      time += other.time;
+      return *this;
+   }
+
+   InstrumentedMemoryResource::InstrumentedMemoryResource(
+       std::pmr::memory_resource &upstream)
+       : m_upstream(upstream) {}
+
+   InstrumentedMemoryResource::Statistics
+   InstrumentedMemoryResource::statistics() const
+   {
+      Statistics result;
+      result.allocations = m_allocations.load(std::memory_order_relaxed);
+      result.deallocations = m_deallocations.load(std::memory_order_relaxed);
+      result.bytes = m_bytes.load(std::memory_order_relaxed);
+      result.peak = m_peak.load(std::memory_order_relaxed);
+      result.time =
+          std::chrono::nanoseconds(m_time.load(std::memory_order_relaxed));
+      return result;
+   }
+
+   InstrumentedMemoryResource::Statistics InstrumentedMemoryResource::reset()
+   {
+      Statistics result;
+      result.allocations = m_allocations.exchange(0);
+      result.deallocations = m_deallocations.exchange(0);
+      result.bytes = m_bytes.exchange(0);
+      result.peak = m_peak.exchange(m_inUse.load());
+      result.time = std::chrono::nanoseconds(m_time.exchange(0));
+      return result;
+   }
+
+   void *InstrumentedMemoryResource::do_allocate(std::size_t bytes,
+                                                 std::size_t alignment)
+   {
+      // Perform (and time) the allocation.
+      const auto start = std::chrono::steady_clock::now();
+      void *result = m_upstream.allocate(bytes, alignment);
+      const auto end = std::chrono::steady_clock::now();
+
+      // Update the counters.
+      m_allocations.fetch_add(1, std::memory_order_relaxed);
+      m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+      m_time.fetch_add(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+              .count(),
+          std::memory_order_relaxed);
+      const std::size_t inUse =
+          m_inUse.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+      std::size_t peak = m_peak.load(std::memory_order_relaxed);
+      while ((inUse > peak) &&
+             !m_peak.compare_exchange_weak(peak, inUse,
+                                           std::memory_order_relaxed))
+      {
+      }
+      return result;
+   }
+
+   void InstrumentedMemoryResource::do_deallocate(void *p, std::size_t bytes,
+                                                  std::size_t alignment)
+   {
+      m_upstream.deallocate(p, bytes, alignment);
+      m_deallocations.fetch_add(1, std::memory_order_relaxed);
+      m_inUse.fetch_sub(bytes, std::memory_order_relaxed);
+   }
+
+   bool InstrumentedMemoryResource::do_is_equal(
+       const std::pmr::memory_resource &other) const noexcept
+   {
+      return (this == &other);
+   }
+
+} // namespace GPUTutorial
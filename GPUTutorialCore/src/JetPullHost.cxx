@@ -0,0 +1,186 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "GPUTutorialCore/JetPull.h"
+#include "GPUTutorialCore/JetPullHost.h"
+#include "GPUTutorialCore/Kinematics.h"
+#include "GPUTutorialCore/SegmentedReductionHost.h"
+
+// TBB include(s).
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+// System include(s).
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+   /// Number of independent partial sums used in the constituent loop (see
+   /// @c GPUTutorial::Kinematics::SUM_LANES)
+   constexpr std::size_t LANES = GPUTutorial::Kinematics::SUM_LANES;
+
+} // namespace
+
+namespace GPUTutorial
+{
+   namespace Host
+   {
+      void calculatePulls(std::span<const float> jetPt,
+                          std::span<const float> jetEta,
+                          std::span<const float> jetPhi,
+                          std::span<const std::size_t> nConstituents,
+                          std::span<const float> constPt,
+                          std::span<const float> constEta,
+                          std::span<const float> constPhi,
+                          std::span<float> jetPullEta,
+                          std::span<float> jetPullPhi,
+                          std::size_t grainSize)
+      {
+         // Some sanity checks.
+         const std::size_t nJets = jetPt.size();
+         assert(jetEta.size() == nJets);
+         assert(jetPhi.size() == nJets);
+         assert(nConstituents.size() == nJets);
+         assert(constEta.size() == constPt.size());
+         assert(constPhi.size() == constPt.size());
+         assert(jetPullEta.size() == nJets);
+         assert(jetPullPhi.size() == nJets);
+
+         // Turn the constituent counts into offsets. Just like on the device,
+         // with an extra slot for the "end" offset.
+         std::vector<std::size_t> offsets(nJets + 1, 0);
+         std::inclusive_scan(nConstituents.begin(), nConstituents.end(),
+                             offsets.begin() + 1);
+         assert(offsets.back() == constPt.size());
+
+         // Process the jets in parallel.
+         const tbb::blocked_range<std::size_t> jets(
+             0, nJets, std::max(grainSize, std::size_t{1}));
+         tbb::parallel_for(
+             jets, [&](const tbb::blocked_range<std::size_t> &range)
+             {
+                for (std::size_t jetIdx = range.begin(); jetIdx != range.end();
+                     ++jetIdx)
+                {
+                   // Parameters of the jet.
+                   const float invPt = 1.f / jetPt[jetIdx];
+                   const float eta = jetEta[jetIdx];
+                   const float phi = jetPhi[jetIdx];
+
+                   // Flat pointers to the constituents of this jet.
+                   const std::size_t begin = offsets[jetIdx];
+                   const std::size_t n = offsets[jetIdx + 1] - begin;
+                   const float *cPt = constPt.data() + begin;
+                   const float *cEta = constEta.data() + begin;
+                   const float *cPhi = constPhi.data() + begin;
+
+                   // Sum up the contributions of the constituents.
+                   float sumEta[LANES] = {};
+                   float sumPhi[LANES] = {};
+                   std::size_t c = 0;
+                   for (; c + LANES <= n; c += LANES)
+                   {
+                      for (std::size_t l = 0; l < LANES; ++l)
+                      {
+                         addPullContribution(invPt, eta, phi, cPt[c + l],
+                                             cEta[c + l], cPhi[c + l],
+                                             sumEta[l], sumPhi[l]);
+                      }
+                   }
+                   for (std::size_t l = 0; c < n; ++c, ++l)
+                   {
+                      addPullContribution(invPt, eta, phi, cPt[c], cEta[c],
+                                          cPhi[c], sumEta[l], sumPhi[l]);
+                   }
+
+                   // Sum up the lanes, and set the outputs.
+                   float pullEta = 0.f;
+                   float pullPhi = 0.f;
+                   for (std::size_t l = 0; l < LANES; ++l)
+                   {
+                      pullEta += sumEta[l];
+                      pullPhi += sumPhi[l];
+                   }
+                   jetPullEta[jetIdx] = pullEta;
+                   jetPullPhi[jetIdx] = wrapPhi(pullPhi);
+                }
+             });
+      }
+
+      void calculatePullsSegmented(std::span<const float> jetPt,
+                                   std::span<const float> jetEta,
+                                   std::span<const float> jetPhi,
+                                   std::span<const std::size_t> nConstituents,
+                                   std::span<const float> constPt,
+                                   std::span<const float> constEta,
+                                   std::span<const float> constPhi,
+                                   std::span<float> jetPullEta,
+                                   std::span<float> jetPullPhi,
+                                   const SegmentedReductionConfig &config)
+      {
+         // Some sanity checks.
+         const std::size_t nJets = jetPt.size();
+         assert(jetEta.size() == nJets);
+         assert(jetPhi.size() == nJets);
+         assert(nConstituents.size() == nJets);
+         assert(constEta.size() == constPt.size());
+         assert(constPhi.size() == constPt.size());
+         assert(jetPullEta.size() == nJets);
+         assert(jetPullPhi.size() == nJets);
+         config.validate();
+
+         // Turn the constituent counts into offsets.
+         std::vector<std::size_t> offsets(nJets + 1, 0);
+         std::inclusive_scan(nConstituents.begin(), nConstituents.end(),
+                             offsets.begin() + 1);
+         assert(offsets.back() == constPt.size());
+
+         // Sum up the constituents of all jets.
+         segmentedReduce<PullSum>(
+             offsets,
+             PullContribution{jetPt.data(), jetEta.data(), jetPhi.data(),
+                              constPt.data(), constEta.data(),
+                              constPhi.data()},
+             PullStore{jetPullEta.data(), jetPullPhi.data()},
+             config.hostGrainSize);
+      }
+
+      std::size_t comparePulls(std::span<const float> referenceEta,
+                               std::span<const float> referencePhi,
+                               std::span<const float> otherEta,
+                               std::span<const float> otherPhi,
+                               float relTolerance, float absTolerance)
+      {
+         // Mismatching sizes mean that nothing agrees.
+         const std::size_t nJets = referenceEta.size();
+         if ((referencePhi.size() != nJets) || (otherEta.size() != nJets) ||
+             (otherPhi.size() != nJets))
+         {
+            return nJets;
+         }
+
+         // Compare the results one-by-one.
+         std::size_t result = 0;
+         for (std::size_t i = 0; i < nJets; ++i)
+         {
+            const float diffEta = std::abs(otherEta[i] - referenceEta[i]);
+            const float diffPhi =
+                std::abs(wrapPhi(otherPhi[i] - referencePhi[i]));
+            if ((!(diffEta <= absTolerance +
+                                  relTolerance * std::abs(referenceEta[i]))) ||
+                (!(diffPhi <= absTolerance +
+                                  relTolerance * std::abs(referencePhi[i]))))
+            {
+               ++result;
+            }
+         }
+         return result;
+      }
+
+   } // namespace Host
+
+} // namespace GPUTutorial
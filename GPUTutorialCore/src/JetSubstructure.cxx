@@ -0,0 +1,122 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "GPUTutorialCore/JetSubstructure.h"
+#include "GPUTutorialCore/SegmentedReductionHost.h"
+
+// System include(s).
+#include <array>
+#include <cassert>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+   using GPUTutorial::JetObservable;
+
+   /// The names of the observables
+   constexpr std::array<std::pair<const char *, JetObservable>, 6>
+       OBSERVABLE_NAMES = {{{"Pull", JetObservable::Pull},
+                            {"Girth", JetObservable::Girth},
+                            {"Width", JetObservable::Width},
+                            {"PtD", JetObservable::PtD},
+                            {"C2", JetObservable::C2},
+                            {"D2", JetObservable::D2}}};
+
+} // namespace
+
+namespace GPUTutorial
+{
+   JetObservableSet parseJetObservables(const std::vector<std::string> &names)
+   {
+      JetObservableSet result = 0;
+      for (const std::string &name : names)
+      {
+         bool found = false;
+         for (const auto &[observableName, observable] : OBSERVABLE_NAMES)
+         {
+            if (name == observableName)
+            {
+               result |= static_cast<unsigned int>(observable);
+               found = true;
+               break;
+            }
+         }
+         if (!found)
+         {
+            throw std::invalid_argument("Unknown jet observable: \"" + name +
+                                        "\"");
+         }
+      }
+      return result;
+   }
+
+   std::string toString(JetObservableSet set)
+   {
+      std::string result;
+      for (const auto &[name, observable] : OBSERVABLE_NAMES)
+      {
+         if (contains(set, observable))
+         {
+            result += (result.empty() ? "" : ",");
+            result += name;
+         }
+      }
+      return result;
+   }
+
+   SubstructureArrays makeSubstructureArrays(JetObservableSet observables,
+                                             float *buffer, std::size_t nJets)
+   {
+      SubstructureArrays result;
+      auto slice = [&](JetObservable observable, std::size_t index) -> float *
+      {
+         return (contains(observables, observable) ? buffer + index * nJets
+                                                   : nullptr);
+      };
+      result.pullEta = slice(JetObservable::Pull, 0);
+      result.pullPhi = slice(JetObservable::Pull, 1);
+      result.girth = slice(JetObservable::Girth, 2);
+      result.width = slice(JetObservable::Width, 3);
+      result.ptD = slice(JetObservable::PtD, 4);
+      result.c2 = slice(JetObservable::C2, 5);
+      result.d2 = slice(JetObservable::D2, 6);
+      return result;
+   }
+
+   namespace Host
+   {
+      void calculateSubstructure(const JetArrays &input,
+                                 JetObservableSet observables,
+                                 const SubstructureArrays &outputs,
+                                 const SegmentedReductionConfig &config)
+      {
+         // Some sanity checks.
+         const std::size_t nJets = input.jetPt.size();
+         assert(input.jetEta.size() == nJets);
+         assert(input.jetPhi.size() == nJets);
+         assert(input.nConstituents.size() == nJets);
+         assert(input.constEta.size() == input.constPt.size());
+         assert(input.constPhi.size() == input.constPt.size());
+         config.validate();
+
+         // Turn the constituent counts into offsets.
+         std::vector<std::size_t> offsets(nJets + 1, 0);
+         std::inclusive_scan(input.nConstituents.begin(),
+                             input.nConstituents.end(), offsets.begin() + 1);
+         assert(offsets.back() == input.constPt.size());
+
+         // Sum up the constituents of all jets, for all observables at once.
+         segmentedReduce<SubstructureSum>(
+             offsets,
+             SubstructureContribution{
+                 input.jetPt.data(), input.jetEta.data(),
+                 input.jetPhi.data(), offsets.data(), input.constPt.data(),
+                 input.constEta.data(), input.constPhi.data(), observables},
+             SubstructureStore{outputs, observables}, config.hostGrainSize);
+      }
+
+   } // namespace Host
+
+} // namespace GPUTutorial
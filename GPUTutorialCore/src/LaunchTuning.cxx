@@ -0,0 +1,319 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "GPUTutorialCore/LaunchTuning.h"
+
+// POSIX include(s).
+#include <unistd.h>
+
+// System include(s).
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+
+namespace
+{
+   /// Header line of the cache files
+   constexpr const char *CACHE_HEADER =
+       "# GPUTutorial launch parameters: device<TAB>kernel<TAB>parameters";
+
+   /// Parse a positive number
+   std::size_t parsePositive(const std::string &text, const std::string &what)
+   {
+      std::size_t pos = 0;
+      unsigned long value = 0;
+      try
+      {
+         value = std::stoul(text, &pos);
+      }
+      catch (const std::exception &)
+      {
+         pos = 0;
+      }
+      if ((pos == 0) || (pos != text.size()) || (value == 0))
+      {
+         throw std::invalid_argument("Invalid launch parameters: \"" + what +
+                                     "\"");
+      }
+      return value;
+   }
+
+} // namespace
+
+namespace GPUTutorial
+{
+   LaunchConfig LaunchConfig::parse(const std::string &text)
+   {
+      LaunchConfig result;
+      const std::size_t x = text.find('x');
+      result.workGroupSize = parsePositive(text.substr(0, x), text);
+      result.itemsPerThread =
+          ((x == std::string::npos) ? 1 : parsePositive(text.substr(x + 1), text));
+      return result;
+   }
+
+   std::string LaunchConfig::toString() const
+   {
+      return std::to_string(workGroupSize) + "x" +
+             std::to_string(itemsPerThread);
+   }
+
+   LaunchTuningCache::LaunchTuningCache(std::string fileName)
+       : m_fileName(std::move(fileName)), m_entries(read())
+   {
+   }
+
+   std::optional<LaunchConfig>
+   LaunchTuningCache::find(const std::string &device,
+                           const std::string &kernel) const
+   {
+      std::lock_guard lock(m_mutex);
+      auto itr = m_entries.find({device, kernel});
+      if (itr == m_entries.end())
+      {
+         return std::nullopt;
+      }
+      return itr->second;
+   }
+
+   void LaunchTuningCache::store(const std::string &device,
+                                 const std::string &kernel,
+                                 const LaunchConfig &config)
+   {
+      // Tabs and new lines would break the format of the file.
+      auto valid = [](const std::string &s)
+      { return (!s.empty()) && (s.find_first_of("\t\n") == std::string::npos); };
+      if (!valid(device) || !valid(kernel))
+      {
+         throw std::invalid_argument("Invalid launch cache key: \"" + device +
+                                     "\", \"" + kernel + "\"");
+      }
+
+      // Merge the entry with the current content of the file. All caches of
+      // the process are serialised, as they may well use the same file.
+      static std::mutex fileMutex;
+      std::scoped_lock lock(fileMutex, m_mutex);
+      m_entries[{device, kernel}] = config;
+      Entries entries = read();
+      entries[{device, kernel}] = config;
+      for (const auto &[key, value] : entries)
+      {
+         m_entries.try_emplace(key, value);
+      }
+
+      // Write a new file, and move it in place of the old one.
+      const std::string tmpName =
+          m_fileName + ".tmp." + std::to_string(::getpid());
+      {
+         std::ofstream out(tmpName, std::ios::trunc);
+         out << CACHE_HEADER << "\n";
+         for (const auto &[key, value] : entries)
+         {
+            out << key.first << "\t" << key.second << "\t" << value.toString()
+                << "\n";
+         }
+         if (!out)
+         {
+            throw std::runtime_error("Could not write launch cache file: " +
+                                     tmpName);
+         }
+      }
+      std::error_code ec;
+      std::filesystem::rename(tmpName, m_fileName, ec);
+      if (ec)
+      {
+         throw std::runtime_error("Could not replace launch cache file " +
+                                  m_fileName + ": " + ec.message());
+      }
+   }
+
+   std::size_t LaunchTuningCache::size() const
+   {
+      std::lock_guard lock(m_mutex);
+      return m_entries.size();
+   }
+
+   LaunchTuningCache::Entries LaunchTuningCache::read() const
+   {
+      Entries result;
+      std::ifstream in(m_fileName);
+      if (!in)
+      {
+         return result;
+      }
+      std::string line;
+      std::size_t lineNumber = 0;
+      while (std::getline(in, line))
+      {
+         ++lineNumber;
+         if (line.empty() || (line.front() == '#'))
+         {
+            continue;
+         }
+         const std::size_t tab1 = line.find('\t');
+         const std::size_t tab2 =
+             ((tab1 == std::string::npos) ? std::string::npos
+                                          : line.find('\t', tab1 + 1));
+         if (tab2 == std::string::npos)
+         {
+            throw std::runtime_error("Malformed line " +
+                                     std::to_string(lineNumber) +
+                                     " in launch cache file " + m_fileName);
+         }
+         try
+         {
+            result[{line.substr(0, tab1), line.substr(tab1 + 1, tab2 - tab1 - 1)}] =
+                LaunchConfig::parse(line.substr(tab2 + 1));
+         }
+         catch (const std::invalid_argument &ex)
+         {
+            throw std::runtime_error(std::string(ex.what()) + " on line " +
+                                     std::to_string(lineNumber) +
+                                     " of launch cache file " + m_fileName);
+         }
+      }
+      return result;
+   }
+
+   std::string LaunchTuner::Result::toString() const
+   {
+      std::ostringstream result;
+      result << config.toString();
+      if (cached)
+      {
+         result << " (from the cache)";
+      }
+      else if (nCandidates == 0)
+      {
+         result << " (fixed)";
+      }
+      else
+      {
+         result << " (fastest of " << nCandidates
+                << " candidates: " << time.count() * 1e6
+                << " us, slowest: " << slowest.count() * 1e6 << " us)";
+      }
+      return result.str();
+   }
+
+   LaunchTuner::LaunchTuner(LaunchTuningCache *cache, const Config &config)
+       : m_cache(cache), m_config(config)
+   {
+   }
+
+   std::vector<LaunchConfig> LaunchTuner::candidates() const
+   {
+      std::vector<LaunchConfig> result;
+      for (std::size_t workGroupSize : m_config.workGroupSizes)
+      {
+         if ((workGroupSize == 0) || ((m_config.maxWorkGroupSize > 0) &&
+                                      (workGroupSize > m_config.maxWorkGroupSize)))
+         {
+            continue;
+         }
+         for (std::size_t itemsPerThread : m_config.itemsPerThread)
+         {
+            if (itemsPerThread > 0)
+            {
+               result.push_back({workGroupSize, itemsPerThread});
+            }
+         }
+      }
+      return result;
+   }
+
+   LaunchTuner::Result LaunchTuner::tune(const std::string &device,
+                                         const std::string &kernel,
+                                         const Function &run) const
+   {
+      const std::vector<LaunchConfig> configs = candidates();
+      if (configs.empty())
+      {
+         throw std::invalid_argument("No launch parameters to choose from for " +
+                                     kernel + " on " + device);
+      }
+
+      // Use the cached parameters, if they are still valid.
+      Result result;
+      result.nCandidates = configs.size();
+      if (m_cache != nullptr)
+      {
+         const std::optional<LaunchConfig> cached = m_cache->find(device, kernel);
+         if (cached &&
+             (std::find(configs.begin(), configs.end(), *cached) != configs.end()))
+         {
+            result.config = *cached;
+            result.cached = true;
+            return result;
+         }
+      }
+
+      // Warm up, to not time one-off initializations (like the JIT
+      // compilation of the kernel) with the first candidate.
+      run(configs.front());
+
+      // Time all candidates.
+      using Clock = std::chrono::steady_clock;
+      result.time = Duration::max();
+      for (const LaunchConfig &config : configs)
+      {
+         Duration fastest = Duration::max();
+         for (unsigned int i = 0; i < std::max(m_config.repetitions, 1u); ++i)
+         {
+            const Clock::time_point start = Clock::now();
+            run(config);
+            fastest = std::min<Duration>(fastest, Clock::now() - start);
+         }
+         if (fastest < result.time)
+         {
+            result.time = fastest;
+            result.config = config;
+         }
+         result.slowest = std::max(result.slowest, fastest);
+      }
+
+      // Remember the winner.
+      if (m_cache != nullptr)
+      {
+         m_cache->store(device, kernel, result.config);
+      }
+      return result;
+   }
+
+   LaunchTuner::Result selectLaunchConfig(const std::string &setting,
+                                          const std::string &cacheFile,
+                                          const std::string &device,
+                                          const std::string &kernel,
+                                          const LaunchTuner::Config &config,
+                                          const LaunchTuner::Function &run)
+   {
+      // Use fixed parameters, if they were given.
+      if (setting != "auto")
+      {
+         LaunchTuner::Result result;
+         result.config = LaunchConfig::parse(setting);
+         if ((config.maxWorkGroupSize > 0) &&
+             (result.config.workGroupSize > config.maxWorkGroupSize))
+         {
+            throw std::invalid_argument(
+                "Work-group size " + std::to_string(result.config.workGroupSize) +
+                " is not supported by " + device + " (maximum: " +
+                std::to_string(config.maxWorkGroupSize) + ")");
+         }
+         return result;
+      }
+
+      // Tune them otherwise.
+      std::unique_ptr<LaunchTuningCache> cache;
+      if (!cacheFile.empty())
+      {
+         cache = std::make_unique<LaunchTuningCache>(cacheFile);
+      }
+      return LaunchTuner(cache.get(), config).tune(device, kernel, run);
+   }
+
+} // namespace GPUTutorial
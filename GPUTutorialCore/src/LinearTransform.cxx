@@ -0,0 +1,18 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "GPUTutorialCore/LinearTransform.h"
+
+namespace GPUTutorial
+{
+   namespace Host
+   {
+      void linearTransform(std::span<const float> input,
+                           std::span<float> output)
+      {
+         ElementWise::evaluate(linearTransformExpression, output, input);
+      }
+
+   } // namespace Host
+
+} // namespace GPUTutorial
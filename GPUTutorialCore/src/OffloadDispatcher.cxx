@@ -0,0 +1,246 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "GPUTutorialCore/OffloadDispatcher.h"
+
+// System include(s).
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+namespace
+{
+   using GPUTutorial::OffloadCostModel;
+
+   /// Fit a straight line to some timing measurements
+   ///
+   /// The measurements are weighted by their inverse squared time, so that
+   /// the (relative) precision of the small sizes, which determine the
+   /// fixed cost, is not swamped by the large ones.
+   ///
+   /// @return The (non-negative) intercept and slope of the line
+   ///
+   std::pair<OffloadCostModel::Duration, OffloadCostModel::Duration>
+   fitLine(std::span<const OffloadCostModel::Sample> samples,
+           const char *side)
+   {
+      double sumW = 0., sumX = 0., sumY = 0., sumXX = 0., sumXY = 0.;
+      for (const OffloadCostModel::Sample &sample : samples)
+      {
+         const double x = static_cast<double>(sample.n);
+         const double y = sample.time.count();
+         const double w = 1. / std::max(y * y, 1e-18);
+         sumW += w;
+         sumX += w * x;
+         sumY += w * y;
+         sumXX += w * x * x;
+         sumXY += w * x * y;
+      }
+      const double denominator = sumW * sumXX - sumX * sumX;
+      if ((samples.size() < 2) ||
+          (std::abs(denominator) <= 1e-12 * std::max(1., sumW * sumXX)))
+      {
+         throw std::invalid_argument(
+             std::string("At least two different sizes need to be timed on "
+                         "the ") +
+             side);
+      }
+      const double slope = (sumW * sumXY - sumX * sumY) / denominator;
+      const double intercept = (sumY - slope * sumX) / sumW;
+      return {OffloadCostModel::Duration(std::max(intercept, 0.)),
+              OffloadCostModel::Duration(std::max(slope, 0.))};
+   }
+
+   /// Time the fastest of a few calls of a function
+   OffloadCostModel::Duration
+   fastest(const GPUTutorial::OffloadDispatcher::Function &function,
+           std::size_t n, unsigned int repetitions)
+   {
+      using Clock = std::chrono::steady_clock;
+      OffloadCostModel::Duration result = OffloadCostModel::Duration::max();
+      for (unsigned int i = 0; i < std::max(repetitions, 1u); ++i)
+      {
+         const Clock::time_point start = Clock::now();
+         function(n);
+         result = std::min<OffloadCostModel::Duration>(result,
+                                                       Clock::now() - start);
+      }
+      return result;
+   }
+
+   /// Print a number of elements, or "never" for the maximal value
+   std::string elements(std::size_t n)
+   {
+      return ((n == std::numeric_limits<std::size_t>::max())
+                  ? std::string("never")
+                  : std::to_string(n) + " element(s)");
+   }
+
+} // namespace
+
+namespace GPUTutorial
+{
+   OffloadCostModel::Duration OffloadCostModel::hostTime(std::size_t n) const
+   {
+      return hostOverhead + static_cast<double>(n) * hostPerElement;
+   }
+
+   OffloadCostModel::Duration OffloadCostModel::deviceTime(std::size_t n) const
+   {
+      return deviceOverhead + static_cast<double>(n) * devicePerElement;
+   }
+
+   std::size_t OffloadCostModel::threshold() const
+   {
+      const double perElementGain =
+          (hostPerElement - devicePerElement).count();
+      const double overheadLoss = (deviceOverhead - hostOverhead).count();
+
+      // With a per-element disadvantage the device can at most be faster
+      // for a few elements, below a crossover. A lower threshold can not
+      // express that, so everything is left on the host then. Without
+      // a per-element difference, the overheads decide alone.
+      if (perElementGain < 0.)
+      {
+         return std::numeric_limits<std::size_t>::max();
+      }
+      if (perElementGain == 0.)
+      {
+         return ((overheadLoss < 0.) ? 0
+                                     : std::numeric_limits<std::size_t>::max());
+      }
+
+      // With a per-element advantage, the device is faster above the
+      // crossover. Or always, if it has no larger overhead either.
+      if (overheadLoss <= 0.)
+      {
+         return 0;
+      }
+      const double crossover = std::ceil(overheadLoss / perElementGain);
+      if (crossover >=
+          static_cast<double>(std::numeric_limits<std::size_t>::max()))
+      {
+         return std::numeric_limits<std::size_t>::max();
+      }
+      return static_cast<std::size_t>(crossover);
+   }
+
+   OffloadCostModel OffloadCostModel::fit(std::span<const Sample> host,
+                                          std::span<const Sample> device)
+   {
+      OffloadCostModel result;
+      std::tie(result.hostOverhead, result.hostPerElement) =
+          fitLine(host, "host");
+      std::tie(result.deviceOverhead, result.devicePerElement) =
+          fitLine(device, "device");
+      return result;
+   }
+
+   const OffloadCostModel &
+   OffloadDispatcher::calibrate(const Function &host, const Function &device,
+                                const CalibrationConfig &config)
+   {
+      // Warm up both sides, to not time one-off initializations.
+      const std::size_t warmup =
+          (config.sizes.empty() ? 1 : config.sizes.front());
+      host(warmup);
+      device(warmup);
+
+      // Time them with all sizes.
+      std::vector<OffloadCostModel::Sample> hostSamples, deviceSamples;
+      for (std::size_t n : config.sizes)
+      {
+         hostSamples.push_back({n, fastest(host, n, config.repetitions)});
+         deviceSamples.push_back({n, fastest(device, n, config.repetitions)});
+      }
+      setModel(OffloadCostModel::fit(hostSamples, deviceSamples));
+      return *m_model;
+   }
+
+   void OffloadDispatcher::setModel(const OffloadCostModel &model)
+   {
+      m_model = model;
+      if (!m_thresholdOverridden)
+      {
+         m_threshold = model.threshold();
+      }
+   }
+
+   void OffloadDispatcher::setThreshold(std::size_t threshold)
+   {
+      m_threshold = threshold;
+      m_thresholdOverridden = true;
+   }
+
+   OffloadTarget OffloadDispatcher::decide(std::size_t n)
+   {
+      if (n >= m_threshold)
+      {
+         m_deviceCalls.fetch_add(1, std::memory_order_relaxed);
+         m_deviceElements.fetch_add(n, std::memory_order_relaxed);
+         return OffloadTarget::Device;
+      }
+      m_hostCalls.fetch_add(1, std::memory_order_relaxed);
+      m_hostElements.fetch_add(n, std::memory_order_relaxed);
+      return OffloadTarget::Host;
+   }
+
+   OffloadDispatcher::Counters OffloadDispatcher::counters() const
+   {
+      return {m_hostCalls.load(), m_hostElements.load(), m_deviceCalls.load(),
+              m_deviceElements.load()};
+   }
+
+   void OffloadDispatcher::printSummary(std::ostream &out) const
+   {
+      if (m_model)
+      {
+         out << "  cost model: host " << m_model->hostOverhead.count() * 1e6
+             << " us + " << m_model->hostPerElement.count() * 1e9
+             << " ns/element, device " << m_model->deviceOverhead.count() * 1e6
+             << " us + " << m_model->devicePerElement.count() * 1e9
+             << " ns/element\n";
+      }
+      out << "  threshold: " << elements(m_threshold)
+          << (m_thresholdOverridden ? " (overridden)" : "") << "\n";
+      const Counters c = counters();
+      out << "  host:   " << c.hostCalls << " call(s), " << c.hostElements
+          << " element(s)\n";
+      out << "  device: " << c.deviceCalls << " call(s), " << c.deviceElements
+          << " element(s)\n";
+   }
+
+   MockDevice::MockDevice(Duration latency, double bytesPerSecond)
+       : m_latency(latency), m_bytesPerSecond(bytesPerSecond)
+   {
+      if (!(bytesPerSecond > 0.))
+      {
+         throw std::invalid_argument(
+             "The bandwidth of the mock device must be positive");
+      }
+   }
+
+   MockDevice::Duration MockDevice::cost(std::size_t bytes) const
+   {
+      return m_latency + Duration(static_cast<double>(bytes) / m_bytesPerSecond);
+   }
+
+   void MockDevice::delay(std::size_t bytes) const
+   {
+      // Spin instead of sleeping, as the sleep granularity of most systems
+      // is much coarser than the latencies to simulate.
+      using Clock = std::chrono::steady_clock;
+      const Clock::time_point end =
+          Clock::now() + std::chrono::duration_cast<Clock::duration>(cost(bytes));
+      while (Clock::now() < end)
+      {
+         std::this_thread::yield();
+      }
+   }
+
+} // namespace GPUTutorial
@@ -0,0 +1,74 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "GPUTutorialCore/SegmentedReduction.h"
+
+// System include(s).
+#include <cassert>
+#include <stdexcept>
+
+namespace GPUTutorial
+{
+   void SegmentedReductionConfig::validate() const
+   {
+      if ((threadMaxLength == 0) || (subGroupMaxLength == 0) ||
+          (tileSize == 0) || (workGroupSize == 0) || (hostGrainSize == 0))
+      {
+         throw std::invalid_argument(
+             "The sizes of a segmented reduction must be positive");
+      }
+      if (threadMaxLength > subGroupMaxLength)
+      {
+         throw std::invalid_argument(
+             "Segments reduced by single work-items can not be longer than "
+             "the ones reduced by sub-groups");
+      }
+      if (tileSize > subGroupMaxLength + 1)
+      {
+         throw std::invalid_argument(
+             "The merge-path tiles of a segmented reduction can not be "
+             "longer than the segments reduced by sub-groups (+1)");
+      }
+   }
+
+   SegmentedReductionPlan::SegmentedReductionPlan(
+       std::span<const std::size_t> offsets,
+       const SegmentedReductionConfig &config, std::pmr::memory_resource *mr)
+       : m_config(config),
+         m_nSegments(offsets.empty() ? 0 : offsets.size() - 1),
+         m_threadSegments(mr),
+         m_subGroupSegments(mr),
+         m_mergePathSegments(mr),
+         m_mergePathOffsets(1, 0, mr)
+   {
+      // Make sure that the configuration makes sense.
+      m_config.validate();
+
+      // Sort the segments into the three categories.
+      for (std::size_t i = 0; i < m_nSegments; ++i)
+      {
+         assert(offsets[i + 1] >= offsets[i]);
+         const std::size_t length = offsets[i + 1] - offsets[i];
+         if (length <= m_config.threadMaxLength)
+         {
+            m_threadSegments.push_back(static_cast<std::uint32_t>(i));
+         }
+         else if (length <= m_config.subGroupMaxLength)
+         {
+            m_subGroupSegments.push_back(static_cast<std::uint32_t>(i));
+         }
+         else
+         {
+            m_mergePathSegments.push_back(static_cast<std::uint32_t>(i));
+            m_mergePathOffsets.push_back(m_mergePathOffsets.back() + length);
+         }
+      }
+   }
+
+   std::size_t SegmentedReductionPlan::nTiles() const
+   {
+      return (m_mergePathOffsets.back() + m_config.tileSize - 1) /
+             m_config.tileSize;
+   }
+
+} // namespace GPUTutorial
@@ -0,0 +1,238 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "GPUTutorialCore/StageTimeline.h"
+
+// System include(s).
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <ostream>
+#include <set>
+#include <stdexcept>
+#include <tuple>
+
+namespace
+{
+   using GPUTutorial::StageTimeline;
+
+   /// Helper type for printing durations in microseconds
+   using fmicroseconds = std::chrono::duration<double, std::micro>;
+
+   /// Name of a track
+   const char *trackName(StageTimeline::Track track)
+   {
+      return (track == StageTimeline::Track::Host) ? "host" : "device";
+   }
+
+   /// Escape a string for JSON
+   std::string escape(const std::string &str)
+   {
+      std::string result;
+      for (char c : str)
+      {
+         if ((c == '"') || (c == '\\'))
+         {
+            result += '\\';
+         }
+         result += c;
+      }
+      return result;
+   }
+
+   /// The Chrome trace "thread" of a slot, on one of the tracks
+   std::size_t traceThread(std::size_t slot, StageTimeline::Track track)
+   {
+      const std::size_t lane =
+          (slot == StageTimeline::NO_SLOT) ? 1000000 : slot;
+      return 2 * lane + ((track == StageTimeline::Track::Device) ? 1 : 0);
+   }
+
+} // namespace
+
+namespace GPUTutorial
+{
+   StageTimeline::StageTimeline() : m_start(Clock::now()) {}
+
+   std::shared_ptr<StageTimeline> StageTimeline::shared()
+   {
+      static std::mutex mutex;
+      static std::weak_ptr<StageTimeline> instance;
+      std::lock_guard lock(mutex);
+      std::shared_ptr<StageTimeline> result = instance.lock();
+      if (!result)
+      {
+         result = std::make_shared<StageTimeline>();
+         instance = result;
+      }
+      return result;
+   }
+
+   std::size_t StageTimeline::registerSource(const std::string &name)
+   {
+      std::lock_guard lock(m_sourceMutex);
+      m_sources.push_back(name);
+      return m_sources.size() - 1;
+   }
+
+   void StageTimeline::record(const Record &record)
+   {
+      m_records.push_back(record);
+   }
+
+   std::vector<StageTimeline::StageSummary>
+   StageTimeline::summary(std::size_t source) const
+   {
+      std::vector<StageSummary> result;
+      for (const Record &record : m_records)
+      {
+         if (record.source != source)
+         {
+            continue;
+         }
+         auto it = std::find_if(result.begin(), result.end(),
+                                [&record](const StageSummary &s)
+                                { return ((s.track == record.track) &&
+                                          (s.stage == record.stage)); });
+         if (it == result.end())
+         {
+            result.push_back({record.stage, record.track});
+            it = result.end() - 1;
+         }
+         ++(it->count);
+         it->total += record.duration;
+         it->min = std::min(it->min, record.duration);
+         it->max = std::max(it->max, record.duration);
+      }
+      return result;
+   }
+
+   void StageTimeline::printSummary(std::ostream &out,
+                                    std::size_t source) const
+   {
+      out << std::left << std::setw(16) << "Stage" << " " << std::setw(7)
+          << "Track" << std::right << std::setw(9) << "Calls"
+          << std::setw(13) << "Total [ms]" << std::setw(13) << "Mean [us]"
+          << std::setw(13) << "Min [us]" << std::setw(13) << "Max [us]";
+      for (const StageSummary &s : summary(source))
+      {
+         const fmicroseconds total = s.total;
+         out << "\n"
+             << std::left << std::setw(16) << s.stage << " " << std::setw(7)
+             << trackName(s.track) << std::right << std::setw(9) << s.count
+             << std::fixed << std::setprecision(3) << std::setw(13)
+             << total.count() / 1000. << std::setprecision(2)
+             << std::setw(13) << total.count() / static_cast<double>(s.count)
+             << std::setw(13) << fmicroseconds(s.min).count()
+             << std::setw(13) << fmicroseconds(s.max).count()
+             << std::defaultfloat;
+      }
+   }
+
+   void StageTimeline::writeChromeTrace(std::ostream &out) const
+   {
+      out << std::fixed << std::setprecision(3)
+          << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+      const char *separator = "\n";
+
+      // Name the "processes" (sources) and "threads" (slots) of the trace.
+      {
+         std::lock_guard lock(m_sourceMutex);
+         for (std::size_t i = 0; i < m_sources.size(); ++i)
+         {
+            out << separator
+                << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": "
+                << i << ", \"args\": {\"name\": \"" << escape(m_sources[i])
+                << "\"}}";
+            separator = ",\n";
+         }
+      }
+      std::set<std::tuple<std::size_t, std::size_t, Track>> threads;
+      for (const Record &record : m_records)
+      {
+         threads.emplace(record.source, record.slot, record.track);
+      }
+      for (const auto &[source, slot, track] : threads)
+      {
+         out << separator
+             << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": "
+             << source << ", \"tid\": " << traceThread(slot, track)
+             << ", \"args\": {\"name\": \"";
+         if (slot == NO_SLOT)
+         {
+            out << "shared";
+         }
+         else
+         {
+            out << "slot " << slot;
+         }
+         out << " (" << trackName(track) << ")\"}}";
+      }
+
+      // Write the stages.
+      for (const Record &record : m_records)
+      {
+         out << separator << "{\"name\": \"" << escape(record.stage)
+             << "\", \"ph\": \"X\", \"pid\": " << record.source
+             << ", \"tid\": " << traceThread(record.slot, record.track)
+             << ", \"ts\": " << fmicroseconds(record.start - m_start).count()
+             << ", \"dur\": " << fmicroseconds(record.duration).count()
+             << ", \"args\": {\"event\": " << record.event
+             << ", \"thread\": "
+             << std::hash<std::thread::id>{}(record.thread) << "}}";
+         separator = ",\n";
+      }
+      out << "\n]}\n" << std::defaultfloat;
+   }
+
+   void StageTimeline::writeChromeTrace(const std::string &fileName) const
+   {
+      std::ofstream out(fileName);
+      if (!out)
+      {
+         throw std::runtime_error("Could not open \"" + fileName +
+                                  "\" for writing");
+      }
+      writeChromeTrace(out);
+      if (!out)
+      {
+         throw std::runtime_error("Failed to write \"" + fileName + "\"");
+      }
+   }
+
+   void StageContext::record(const char *stage,
+                             StageTimeline::Clock::time_point start,
+                             StageTimeline::Clock::duration duration,
+                             StageTimeline::Track track) const
+   {
+      if (timeline != nullptr)
+      {
+         timeline->record({source, stage, slot, event,
+                           std::this_thread::get_id(), start, duration,
+                           track});
+      }
+   }
+
+   ScopedStageTimer::ScopedStageTimer(const StageContext &context,
+                                      const char *stage)
+       : m_context(context), m_stage(stage), m_running(context.enabled())
+   {
+      if (m_running)
+      {
+         m_start = StageTimeline::Clock::now();
+      }
+   }
+
+   void ScopedStageTimer::stop()
+   {
+      if (m_running)
+      {
+         m_context.record(m_stage, m_start,
+                          StageTimeline::Clock::now() - m_start);
+         m_running = false;
+      }
+   }
+
+} // namespace GPUTutorial
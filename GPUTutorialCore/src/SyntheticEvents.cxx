@@ -0,0 +1,176 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "GPUTutorialCore/SyntheticEvents.h"
+#include "GPUTutorialCore/Kinematics.h"
+
+// System include(s).
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace GPUTutorial
+{
+   std::size_t SizeDistribution::operator()(std::mt19937_64 &rng) const
+   {
+      // Draw a value.
+      std::size_t result = 0;
+      switch (type)
+      {
+      case Type::Fixed:
+         result = static_cast<std::size_t>(mean);
+         break;
+      case Type::Uniform:
+         result = std::uniform_int_distribution<std::size_t>(
+             0, static_cast<std::size_t>(2. * mean))(rng);
+         break;
+      case Type::Poisson:
+         result = (mean > 0.)
+                      ? std::poisson_distribution<std::size_t>(mean)(rng)
+                      : 0;
+         break;
+      case Type::Exponential:
+         result = (mean > 0.) ? static_cast<std::size_t>(
+                                    std::exponential_distribution<double>(
+                                        1. / mean)(rng))
+                              : 0;
+         break;
+      }
+
+      // Apply the upper limit, if there is one.
+      return ((max > 0) ? std::min(result, max) : result);
+   }
+
+   SizeDistribution SizeDistribution::parse(const std::string &spec)
+   {
+      // Split the string at the colons.
+      std::vector<std::string> tokens;
+      std::size_t begin = 0;
+      while (true)
+      {
+         const std::size_t end = spec.find(':', begin);
+         tokens.push_back(spec.substr(begin, end - begin));
+         if (end == std::string::npos)
+         {
+            break;
+         }
+         begin = end + 1;
+      }
+      if ((tokens.size() < 2) || (tokens.size() > 3))
+      {
+         throw std::invalid_argument("Invalid size distribution: \"" + spec +
+                                     "\"");
+      }
+
+      // Interpret the tokens.
+      SizeDistribution result;
+      if (tokens[0] == "fixed")
+      {
+         result.type = Type::Fixed;
+      }
+      else if (tokens[0] == "uniform")
+      {
+         result.type = Type::Uniform;
+      }
+      else if (tokens[0] == "poisson")
+      {
+         result.type = Type::Poisson;
+      }
+      else if (tokens[0] == "exponential")
+      {
+         result.type = Type::Exponential;
+      }
+      else
+      {
+         throw std::invalid_argument("Unknown size distribution type: \"" +
+                                     tokens[0] + "\"");
+      }
+      result.mean = std::stod(tokens[1]);
+      if (tokens.size() == 3)
+      {
+         result.max = std::stoul(tokens[2]);
+      }
+      return result;
+   }
+
+   std::string SizeDistribution::toString() const
+   {
+      std::string result;
+      switch (type)
+      {
+      case Type::Fixed:
+         result = "fixed";
+         break;
+      case Type::Uniform:
+         result = "uniform";
+         break;
+      case Type::Poisson:
+         result = "poisson";
+         break;
+      case Type::Exponential:
+         result = "exponential";
+         break;
+      }
+      result += ":" + std::to_string(mean);
+      if (max > 0)
+      {
+         result += ":" + std::to_string(max);
+      }
+      return result;
+   }
+
+   SyntheticEventGenerator::SyntheticEventGenerator(
+       const SyntheticEventConfig &config)
+       : m_config(config), m_rng(config.seed) {}
+
+   SyntheticEvent SyntheticEventGenerator::generate()
+   {
+      // Distributions used for the kinematic properties.
+      std::uniform_real_distribution<float> etaDist(-2.5f, 2.5f);
+      std::uniform_real_distribution<float> phiDist(
+          -Kinematics::PI, Kinematics::PI);
+      std::exponential_distribution<float> electronPtDist(1.f / 30000.f);
+      std::exponential_distribution<float> jetPtDist(1.f / 50000.f);
+      std::exponential_distribution<float> constPtDist(1.f / 2000.f);
+      std::normal_distribution<float> spreadDist(0.f, 0.15f);
+      std::uniform_int_distribution<std::uint16_t> authorDist(1, 16);
+
+      SyntheticEvent event;
+
+      // Values for the linear transformation.
+      event.values.resize(m_config.nValues(m_rng));
+      std::uniform_real_distribution<float> valueDist(-1000.f, 1000.f);
+      std::generate(event.values.begin(), event.values.end(),
+                    [&]()
+                    { return valueDist(m_rng); });
+
+      // Electrons.
+      event.electrons.resize(m_config.nElectrons(m_rng));
+      for (SyntheticElectron &el : event.electrons)
+      {
+         el.pt = 5000.f + electronPtDist(m_rng);
+         el.eta = etaDist(m_rng);
+         el.phi = phiDist(m_rng);
+         el.m = 0.511f;
+         el.author = authorDist(m_rng);
+      }
+
+      // Jets, with constituents distributed around the jet axis.
+      event.jets.resize(m_config.nJets(m_rng));
+      for (SyntheticJet &jet : event.jets)
+      {
+         jet.pt = 20000.f + jetPtDist(m_rng);
+         jet.eta = etaDist(m_rng);
+         jet.phi = phiDist(m_rng);
+         jet.constituents.resize(m_config.nConstituents(m_rng));
+         for (SyntheticConstituent &c : jet.constituents)
+         {
+            c.pt = 500.f + constPtDist(m_rng);
+            c.eta = jet.eta + spreadDist(m_rng);
+            c.phi = Kinematics::wrapPhi(jet.phi + spreadDist(m_rng));
+         }
+      }
+      return event;
+   }
+
+} // namespace GPUTutorial
@@ -0,0 +1,532 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "GPUTutorialCore/TransferEncoding.h"
+#include "GPUTutorialCore/Kinematics.h"
+
+// System include(s).
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+   /// Split a separated list
+   std::vector<std::string> split(const std::string &list, char separator)
+   {
+      std::vector<std::string> result;
+      std::size_t begin = 0;
+      while (begin <= list.size())
+      {
+         const std::size_t end =
+             std::min(list.find(separator, begin), list.size());
+         result.push_back(list.substr(begin, end - begin));
+         begin = end + 1;
+      }
+      return result;
+   }
+
+   /// Interpret a number, insisting on using up the whole string
+   template <typename T, typename FUNC>
+   T toNumber(const std::string &value, const std::string &spec,
+              FUNC &&convert)
+   {
+      std::size_t used = 0;
+      T result{};
+      try
+      {
+         result = convert(value, &used);
+      }
+      catch (const std::exception &)
+      {
+         used = 0;
+      }
+      if (value.empty() || (used != value.size()))
+      {
+         throw std::invalid_argument("Invalid number \"" + value +
+                                     "\" in encoding \"" + spec + "\"");
+      }
+      return result;
+   }
+
+   /// Interpret a floating point number
+   float toFloat(const std::string &value, const std::string &spec)
+   {
+      return toNumber<float>(value, spec,
+                             [](const std::string &s, std::size_t *used)
+                             { return std::stof(s, used); });
+   }
+
+   /// Interpret an unsigned integer
+   unsigned long toUnsigned(const std::string &value, const std::string &spec)
+   {
+      return toNumber<unsigned long>(
+          value, spec, [](const std::string &s, std::size_t *used)
+          { return std::stoul(s, used); });
+   }
+
+   /// The number of codes of a fixed point encoding
+   float nSteps(unsigned int bits)
+   {
+      return static_cast<float>((1u << bits) - 1u);
+   }
+
+   /// @name Encoding / decoding loops
+   ///
+   /// The loops are kept trivial, working on raw pointers, so that the
+   /// compiler would vectorize them.
+   ///
+   /// @{
+
+   void encodeFixedPoint(const float *input, std::uint16_t *output,
+                         std::size_t n, float lower, float invStep,
+                         float range)
+   {
+      for (std::size_t i = 0; i < n; ++i)
+      {
+         // The order of the comparisons maps NaNs to the lower edge.
+         const float value = input[i];
+         const float position =
+             (((lower < value) ? value : lower) - lower) * invStep;
+         output[i] = static_cast<std::uint16_t>(static_cast<std::int32_t>(
+             ((position < range) ? position : range) + 0.5f));
+      }
+   }
+
+   void encodeHalf(const float *input, std::uint16_t *output, std::size_t n,
+                   float scale)
+   {
+      for (std::size_t i = 0; i < n; ++i)
+      {
+         output[i] = GPUTutorial::floatToHalf(scale * input[i]);
+      }
+   }
+
+   void decodeFixedPoint(const std::uint16_t *input, float *output,
+                         std::size_t n, float offset, float step)
+   {
+      for (std::size_t i = 0; i < n; ++i)
+      {
+         output[i] = offset + step * static_cast<float>(input[i]);
+      }
+   }
+
+   void decodeHalf(const std::uint16_t *input, float *output, std::size_t n,
+                   float step)
+   {
+      for (std::size_t i = 0; i < n; ++i)
+      {
+         output[i] = step * GPUTutorial::halfToFloat(input[i]);
+      }
+   }
+
+   /// Returns the bitwise OR of all the counts, to check for overflows
+   std::size_t narrowCounts(const std::size_t *input, std::uint16_t *output,
+                            std::size_t n)
+   {
+      std::size_t bits = 0;
+      for (std::size_t i = 0; i < n; ++i)
+      {
+         bits |= input[i];
+         output[i] = static_cast<std::uint16_t>(input[i]);
+      }
+      return bits;
+   }
+
+   /// @}
+
+} // namespace
+
+namespace GPUTutorial
+{
+   FloatColumnEncoding FloatColumnEncoding::parse(const std::string &spec,
+                                                  float defaultMin,
+                                                  float defaultMax,
+                                                  float defaultScale)
+   {
+      const std::vector<std::string> fields = split(spec, ':');
+      FloatColumnEncoding result;
+      result.min = defaultMin;
+      result.max = defaultMax;
+      result.scale = defaultScale;
+      if ((fields[0] == "float32") && (fields.size() == 1))
+      {
+         result.type = FloatEncoding::Float32;
+      }
+      else if ((fields[0] == "fixed") &&
+               ((fields.size() == 2) || (fields.size() == 4)))
+      {
+         result.type = FloatEncoding::FixedPoint;
+         result.bits = static_cast<unsigned int>(
+             std::min(toUnsigned(fields[1], spec), 1000ul));
+         if (fields.size() == 4)
+         {
+            result.min = toFloat(fields[2], spec);
+            result.max = toFloat(fields[3], spec);
+         }
+      }
+      else if ((fields[0] == "half") && (fields.size() <= 2))
+      {
+         result.type = FloatEncoding::Half;
+         if (fields.size() == 2)
+         {
+            result.scale = toFloat(fields[1], spec);
+         }
+      }
+      else
+      {
+         throw std::invalid_argument("Invalid column encoding: \"" + spec +
+                                     "\"");
+      }
+      result.validate();
+      return result;
+   }
+
+   std::string FloatColumnEncoding::toString() const
+   {
+      std::ostringstream result;
+      switch (type)
+      {
+      case FloatEncoding::Float32:
+         result << "float32";
+         break;
+      case FloatEncoding::FixedPoint:
+         result << "fixed:" << bits << ":" << min << ":" << max;
+         break;
+      case FloatEncoding::Half:
+         result << "half:" << scale;
+         break;
+      }
+      return result.str();
+   }
+
+   void FloatColumnEncoding::validate() const
+   {
+      if (type == FloatEncoding::FixedPoint)
+      {
+         if ((bits == 0) || (bits > 16))
+         {
+            throw std::invalid_argument(
+                "Fixed point encodings must use 1-16 bits");
+         }
+         if (!std::isfinite(min) || !std::isfinite(max) || !(max > min))
+         {
+            throw std::invalid_argument(
+                "Fixed point encodings need a finite, non-empty range");
+         }
+      }
+      else if (type == FloatEncoding::Half)
+      {
+         if (!std::isfinite(scale) || !(scale > 0.f))
+         {
+            throw std::invalid_argument(
+                "Half precision encodings need a finite, positive scale");
+         }
+      }
+   }
+
+   std::size_t FloatColumnEncoding::bytesPerElement() const
+   {
+      return (encoded() ? sizeof(std::uint16_t) : sizeof(float));
+   }
+
+   float FloatColumnEncoding::quantizationError() const
+   {
+      if (type != FloatEncoding::FixedPoint)
+      {
+         return 0.f;
+      }
+      return 0.5f * (max - min) / nSteps(bits);
+   }
+
+   FloatDecoder FloatColumnEncoding::decoder() const
+   {
+      switch (type)
+      {
+      case FloatEncoding::FixedPoint:
+         return {type, min, (max - min) / nSteps(bits)};
+      case FloatEncoding::Half:
+         return {type, 0.f, 1.f / scale};
+      default:
+         return {};
+      }
+   }
+
+   void FloatColumnEncoding::encode(std::span<const float> values,
+                                    std::span<std::uint16_t> codes) const
+   {
+      assert(values.size() == codes.size());
+
+      switch (type)
+      {
+      case FloatEncoding::FixedPoint:
+         encodeFixedPoint(values.data(), codes.data(), values.size(), min,
+                          nSteps(bits) / (max - min), nSteps(bits));
+         break;
+      case FloatEncoding::Half:
+         encodeHalf(values.data(), codes.data(), values.size(), scale);
+         break;
+      default:
+         throw std::logic_error("Float32 columns are not encoded");
+      }
+   }
+
+   void decode(std::span<const std::uint16_t> codes,
+               const FloatDecoder &decoder, std::span<float> values)
+   {
+      assert(codes.size() == values.size());
+
+      switch (decoder.type)
+      {
+      case FloatEncoding::FixedPoint:
+         decodeFixedPoint(codes.data(), values.data(), codes.size(),
+                          decoder.offset, decoder.step);
+         break;
+      case FloatEncoding::Half:
+         decodeHalf(codes.data(), values.data(), codes.size(), decoder.step);
+         break;
+      default:
+         throw std::logic_error("Float32 columns are not decoded");
+      }
+   }
+
+   void encodeCounts16(std::span<const std::size_t> counts,
+                       std::span<std::uint16_t> codes)
+   {
+      assert(counts.size() == codes.size());
+      const std::size_t bits =
+          narrowCounts(counts.data(), codes.data(), counts.size());
+      if (bits > std::numeric_limits<std::uint16_t>::max())
+      {
+         throw std::runtime_error(
+             "Jets with more than 65535 constituents can not use 16-bit "
+             "constituent counts");
+      }
+   }
+
+   void encodeOffsets32(std::span<const std::size_t> counts,
+                        std::span<std::uint32_t> offsets)
+   {
+      assert(offsets.size() == counts.size() + 1);
+      std::size_t offset = 0;
+      offsets[0] = 0;
+      for (std::size_t i = 0; i < counts.size(); ++i)
+      {
+         offset += counts[i];
+         offsets[i + 1] = static_cast<std::uint32_t>(offset);
+      }
+      if (offset > std::numeric_limits<std::uint32_t>::max())
+      {
+         throw std::runtime_error(
+             std::to_string(offset) +
+             " constituents can not use 32-bit constituent offsets");
+      }
+   }
+
+   TransferEncoding TransferEncoding::parse(const std::string &spec)
+   {
+      TransferEncoding result;
+      if (spec == "none")
+      {
+         return result;
+      }
+      for (const std::string &field : split(spec, ','))
+      {
+         const std::size_t eq = field.find('=');
+         const std::string column = field.substr(0, eq);
+         const std::string value =
+             ((eq == std::string::npos) ? "" : field.substr(eq + 1));
+         if (column == "eta")
+         {
+            result.eta = FloatColumnEncoding::parse(
+                value, -DEFAULT_ETA_MAX, DEFAULT_ETA_MAX, 1.f);
+         }
+         else if (column == "phi")
+         {
+            result.phi = FloatColumnEncoding::parse(value, -Kinematics::PI,
+                                                    Kinematics::PI, 1.f);
+         }
+         else if (column == "pt")
+         {
+            result.pt =
+                FloatColumnEncoding::parse(value, 0.f, 0.f, DEFAULT_PT_SCALE);
+         }
+         else if ((column == "counts") && (value == "size"))
+         {
+            result.counts = CountEncoding::Size;
+         }
+         else if ((column == "counts") && (value == "count16"))
+         {
+            result.counts = CountEncoding::Count16;
+         }
+         else if ((column == "counts") && (value == "offset32"))
+         {
+            result.counts = CountEncoding::Offset32;
+         }
+         else
+         {
+            throw std::invalid_argument("Invalid transfer encoding: \"" +
+                                        field + "\"");
+         }
+      }
+      result.validate();
+      return result;
+   }
+
+   std::string TransferEncoding::toString() const
+   {
+      if (!encoded())
+      {
+         return "none";
+      }
+      std::string result = "eta=" + eta.toString() + ",phi=" + phi.toString() +
+                           ",pt=" + pt.toString() + ",counts=";
+      switch (counts)
+      {
+      case CountEncoding::Size:
+         result += "size";
+         break;
+      case CountEncoding::Count16:
+         result += "count16";
+         break;
+      case CountEncoding::Offset32:
+         result += "offset32";
+         break;
+      }
+      return result;
+   }
+
+   void TransferEncoding::validate() const
+   {
+      eta.validate();
+      phi.validate();
+      pt.validate();
+   }
+
+   bool TransferEncoding::encoded() const
+   {
+      return (eta.encoded() || phi.encoded() || pt.encoded() ||
+              (counts != CountEncoding::Size));
+   }
+
+   std::size_t EncodedCountColumn::size() const
+   {
+      switch (type)
+      {
+      case CountEncoding::Count16:
+         return counts.size();
+      case CountEncoding::Offset32:
+         return (offsets.empty() ? 0 : offsets.size() - 1);
+      default:
+         return sizes.size();
+      }
+   }
+
+   std::size_t EncodedCountColumn::size_bytes() const
+   {
+      return sizes.size_bytes() + counts.size_bytes() + offsets.size_bytes();
+   }
+
+   EncodedFloatColumn encodeColumn(const FloatColumnEncoding &encoding,
+                                   std::span<const float> values,
+                                   std::pmr::vector<std::uint16_t> &buffer)
+   {
+      if (!encoding.encoded())
+      {
+         return {values, {}, {}};
+      }
+      buffer.resize(values.size());
+      encoding.encode(values, buffer);
+      return {{}, buffer, encoding.decoder()};
+   }
+
+   std::span<const float> decodeColumn(const EncodedFloatColumn &column,
+                                       std::pmr::vector<float> &buffer)
+   {
+      if (!column.encoded())
+      {
+         return column.values;
+      }
+      buffer.resize(column.codes.size());
+      decode(column.codes, column.decoder, buffer);
+      return buffer;
+   }
+
+   std::span<const std::size_t>
+   decodeCounts(const EncodedCountColumn &column,
+                std::pmr::vector<std::size_t> &buffer)
+   {
+      switch (column.type)
+      {
+      case CountEncoding::Count16:
+         buffer.assign(column.counts.begin(), column.counts.end());
+         return buffer;
+      case CountEncoding::Offset32:
+         buffer.resize(column.size());
+         for (std::size_t i = 0; i < buffer.size(); ++i)
+         {
+            buffer[i] = column.offsets[i + 1] - column.offsets[i];
+         }
+         return buffer;
+      default:
+         return column.sizes;
+      }
+   }
+
+   std::size_t EncodedJetArrays::size_bytes() const
+   {
+      return jetPt.size_bytes() + jetEta.size_bytes() + jetPhi.size_bytes() +
+             nConstituents.size_bytes() + constPt.size_bytes() +
+             constEta.size_bytes() + constPhi.size_bytes();
+   }
+
+   JetArraysEncoder::JetArraysEncoder(const TransferEncoding &encoding,
+                                      std::pmr::memory_resource *mr)
+       : m_encoding(encoding),
+         m_jetPt(mr),
+         m_jetEta(mr),
+         m_jetPhi(mr),
+         m_counts(mr),
+         m_offsets(mr),
+         m_constPt(mr),
+         m_constEta(mr),
+         m_constPhi(mr)
+   {
+      m_encoding.validate();
+   }
+
+   EncodedJetArrays JetArraysEncoder::encode(const JetArrays &input)
+   {
+      EncodedJetArrays result;
+      result.jetPt = encodeColumn(m_encoding.pt, input.jetPt, m_jetPt);
+      result.jetEta = encodeColumn(m_encoding.eta, input.jetEta, m_jetEta);
+      result.jetPhi = encodeColumn(m_encoding.phi, input.jetPhi, m_jetPhi);
+      result.constPt = encodeColumn(m_encoding.pt, input.constPt, m_constPt);
+      result.constEta =
+          encodeColumn(m_encoding.eta, input.constEta, m_constEta);
+      result.constPhi =
+          encodeColumn(m_encoding.phi, input.constPhi, m_constPhi);
+      result.nConstituents.type = m_encoding.counts;
+      switch (m_encoding.counts)
+      {
+      case CountEncoding::Count16:
+         m_counts.resize(input.nConstituents.size());
+         encodeCounts16(input.nConstituents, m_counts);
+         result.nConstituents.counts = m_counts;
+         break;
+      case CountEncoding::Offset32:
+         m_offsets.resize(input.nConstituents.size() + 1);
+         encodeOffsets32(input.nConstituents, m_offsets);
+         result.nConstituents.offsets = m_offsets;
+         break;
+      default:
+         result.nConstituents.sizes = input.nConstituents;
+         break;
+      }
+      return result;
+   }
+
+} // namespace GPUTutorial
@@ -0,0 +1,665 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+
+// Local include(s).
+#include "GPUTutorialCore/Benchmark.h"
+#include "GPUTutorialCore/ElectronCalibration.h"
+#include "GPUTutorialCore/JetPull.h"
+#include "GPUTutorialCore/LaunchTuning.h"
+#include "GPUTutorialCore/LinearTransform.h"
+#include "GPUTutorialCore/TransferEncodingCUDA.h"
+
+// VecMem include(s).
+#include <vecmem/memory/cuda/host_memory_resource.hpp>
+#include <vecmem/memory/pool_memory_resource.hpp>
+
+// CUDA include(s).
+#include <cuda_runtime.h>
+#include <cub/cub.cuh>
+
+// System include(s).
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+/// Helper macro for checking CUDA calls
+#define GPUTUTORIAL_CUDA_CHECK(EXP)                                     \
+   do                                                                   \
+   {                                                                    \
+      const cudaError_t ce = EXP;                                       \
+      if (ce != cudaSuccess)                                            \
+      {                                                                 \
+         throw std::runtime_error(std::string("Failed to execute \"") + \
+                                  #EXP + "\" because: " +               \
+                                  cudaGetErrorString(ce));              \
+      }                                                                 \
+   } while (false)
+
+namespace
+{
+   using namespace GPUTutorial;
+   using namespace GPUTutorial::Benchmark;
+
+   constexpr int BLOCKSIZE = 128;
+
+   namespace Kernels
+   {
+      /// Kernel performing the linear transformation
+      __global__ void linearTransform(std::size_t n, const float *input,
+                                      float *output)
+      {
+         const std::size_t i = blockIdx.x * blockDim.x + threadIdx.x;
+         if (i >= n)
+         {
+            return;
+         }
+         output[i] = GPUTutorial::linearTransform(input[i]);
+      }
+
+      /// Kernel "calibrating" electrons
+      __global__ void calibrateElectrons(std::size_t n, const float *eta,
+                                         const float *phi, const float *pt,
+                                         const std::uint16_t *author,
+                                         ElectronCalibrationTableView table,
+                                         float *calibratedPt)
+      {
+         const std::size_t i = blockIdx.x * blockDim.x + threadIdx.x;
+         if (i >= n)
+         {
+            return;
+         }
+         calibratedPt[i] =
+             calibratedElectronPt(pt[i], eta[i], phi[i], author[i], table);
+      }
+
+      /// Kernel calculating jet pulls, with one block per jet
+      __global__ void calculatePulls(const float *jetPt, const float *jetEta,
+                                     const float *jetPhi,
+                                     const float *constPt,
+                                     const float *constEta,
+                                     const float *constPhi,
+                                     const std::size_t *offsets,
+                                     std::size_t nJets, float *pullEta,
+                                     float *pullPhi)
+      {
+         const std::size_t jetIdx = blockIdx.x;
+         if (jetIdx >= nJets)
+         {
+            return;
+         }
+         const std::size_t begin = offsets[jetIdx];
+         const std::size_t end = offsets[jetIdx + 1];
+
+         const float invPt = 1.f / jetPt[jetIdx];
+         float sumEta = 0.f;
+         float sumPhi = 0.f;
+         for (std::size_t c = begin + threadIdx.x; c < end; c += blockDim.x)
+         {
+            addPullContribution(invPt, jetEta[jetIdx], jetPhi[jetIdx],
+                                constPt[c], constEta[c], constPhi[c], sumEta,
+                                sumPhi);
+         }
+         __syncthreads();
+
+         using BlockReduce = cub::BlockReduce<float, BLOCKSIZE>;
+         __shared__ typename BlockReduce::TempStorage tempStorage;
+         const float resultEta = BlockReduce(tempStorage).Sum(sumEta);
+         __syncthreads();
+         float resultPhi = BlockReduce(tempStorage).Sum(sumPhi);
+
+         if (threadIdx.x == 0)
+         {
+            pullEta[jetIdx] = resultEta;
+            pullPhi[jetIdx] = wrapPhi(resultPhi);
+         }
+      }
+
+   } // namespace Kernels
+
+   /// Device memory block that is only ever grown, never shrunk
+   class DeviceBlock
+   {
+   public:
+      /// Default constructor
+      DeviceBlock() = default;
+      /// Disallow copies
+      DeviceBlock(const DeviceBlock &) = delete;
+      /// Destructor
+      ~DeviceBlock() { cudaFree(m_ptr); }
+
+      /// Get a pointer to a block of at least the requested size
+      template <typename T>
+      T *get(std::size_t n)
+      {
+         const std::size_t bytes = n * sizeof(T);
+         if (bytes > m_size)
+         {
+            GPUTUTORIAL_CUDA_CHECK(cudaFree(m_ptr));
+            m_ptr = nullptr;
+            GPUTUTORIAL_CUDA_CHECK(cudaMalloc(&m_ptr, bytes));
+            m_size = bytes;
+         }
+         return static_cast<T *>(m_ptr);
+      }
+
+   private:
+      /// The device memory block
+      void *m_ptr = nullptr;
+      /// Size of the block
+      std::size_t m_size = 0;
+
+   }; // class DeviceBlock
+
+   /// Backend running the calculations on a CUDA device
+   class CUDABackend : public Benchmark::Backend
+   {
+   public:
+      /// Constructor
+      CUDABackend()
+      {
+         GPUTUTORIAL_CUDA_CHECK(cudaStreamCreate(&m_stream));
+         int device = 0, pageableAccess = 0;
+         GPUTUTORIAL_CUDA_CHECK(cudaGetDevice(&device));
+         GPUTUTORIAL_CUDA_CHECK(cudaDeviceGetAttribute(
+             &pageableAccess, cudaDevAttrPageableMemoryAccess, device));
+         m_hostAccessible = (pageableAccess != 0);
+         cudaDeviceProp properties;
+         GPUTUTORIAL_CUDA_CHECK(cudaGetDeviceProperties(&properties, device));
+         m_deviceName = properties.name;
+         m_maxBlockSize =
+             static_cast<std::size_t>(properties.maxThreadsPerBlock);
+         for (cudaEvent_t &event : m_events)
+         {
+            GPUTUTORIAL_CUDA_CHECK(cudaEventCreate(&event));
+         }
+      }
+      /// Destructor
+      ~CUDABackend()
+      {
+         for (cudaEvent_t event : m_events)
+         {
+            cudaEventDestroy(event);
+         }
+         cudaStreamDestroy(m_stream);
+      }
+
+      /// @name Functions implementing @c GPUTutorial::Benchmark::Backend
+      /// @{
+
+      std::string name() const override { return "cuda"; }
+      std::pmr::memory_resource &hostMR() override { return m_cachedHostMR; }
+      bool hostAccessible() const override { return m_hostAccessible; }
+
+      void linearTransform(std::span<const float> input,
+                           std::span<float> output,
+                           StageResults &results) override
+      {
+         const std::size_t n = input.size();
+         float *dInput = m_blocks[0].get<float>(n);
+         float *dOutput = m_blocks[1].get<float>(n);
+
+         start();
+         copyToDevice(dInput, input);
+         launched();
+         launchLinearTransform(n, dInput, dOutput,
+                               m_linearTransformLaunch.value_or(
+                                   LaunchConfig{}));
+         computed();
+         copyToHost(output, dOutput);
+         finish(results, 2 * n * sizeof(float), 2 * n * sizeof(float));
+
+         // Tune the launch parameters on the arrays of the first call.
+         tune("linearTransform", n, m_linearTransformLaunch,
+              [&](const LaunchConfig &launch)
+              { launchLinearTransform(n, dInput, dOutput, launch); });
+      }
+
+      void setCalibrationTable(const ElectronCalibrationTable &table,
+                               StageResults &results) override
+      {
+         const std::span<const float> data = table.data();
+         float *dTable = m_tableBlock.get<float>(data.size());
+         start();
+         copyToDevice(dTable, data);
+         launched();
+         computed();
+         finish(results, data.size_bytes(), 0);
+         m_table = table.view(dTable);
+      }
+
+      void calibrateElectrons(const ElectronArrays &input,
+                              std::span<float> calibratedPt,
+                              StageResults &results) override
+      {
+         const std::size_t n = input.pt.size();
+         const std::size_t bytes =
+             n * (4 * sizeof(float) + sizeof(std::uint16_t));
+
+         // If the device can access the host arrays, use them directly.
+         const float *dEta = input.eta.data();
+         const float *dPhi = input.phi.data();
+         const float *dPt = input.pt.data();
+         const std::uint16_t *dAuthor = input.author.data();
+         float *dOutput = calibratedPt.data();
+
+         start();
+         if (!m_hostAccessible)
+         {
+            float *eta = m_blocks[0].get<float>(n);
+            float *phi = m_blocks[1].get<float>(n);
+            float *pt = m_blocks[2].get<float>(n);
+            std::uint16_t *author = m_blocks[3].get<std::uint16_t>(n);
+            copyToDevice(eta, input.eta);
+            copyToDevice(phi, input.phi);
+            copyToDevice(pt, input.pt);
+            copyToDevice(author, input.author);
+            dEta = eta;
+            dPhi = phi;
+            dPt = pt;
+            dAuthor = author;
+            dOutput = m_blocks[4].get<float>(n);
+         }
+         launched();
+         launchCalibrateElectrons(n, dEta, dPhi, dPt, dAuthor, dOutput,
+                                  m_calibrateElectronsLaunch.value_or(
+                                      LaunchConfig{}));
+         computed();
+         if (!m_hostAccessible)
+         {
+            copyToHost(calibratedPt, dOutput);
+         }
+         finish(results, (m_hostAccessible ? 0 : bytes), bytes);
+
+         // Tune the launch parameters on the arrays of the first call. (The
+         // output was already copied to the host.)
+         tune("calibrateElectrons", n, m_calibrateElectronsLaunch,
+              [&](const LaunchConfig &launch)
+              {
+                 launchCalibrateElectrons(n, dEta, dPhi, dPt, dAuthor,
+                                          dOutput, launch);
+              });
+      }
+
+      void calculatePulls(const JetArrays &input, std::span<float> pullEta,
+                          std::span<float> pullPhi,
+                          StageResults &results) override
+      {
+         const std::size_t nJets = input.jetPt.size();
+         const std::size_t nConst = input.constPt.size();
+         float *dJetPt = m_blocks[0].get<float>(nJets);
+         float *dJetEta = m_blocks[1].get<float>(nJets);
+         float *dJetPhi = m_blocks[2].get<float>(nJets);
+         float *dConstPt = m_blocks[3].get<float>(nConst);
+         float *dConstEta = m_blocks[4].get<float>(nConst);
+         float *dConstPhi = m_blocks[5].get<float>(nConst);
+         std::size_t *dOffsets = m_blocks[6].get<std::size_t>(nJets + 1);
+         float *dPullEta = m_blocks[7].get<float>(nJets);
+         float *dPullPhi = m_blocks[8].get<float>(nJets);
+
+         start();
+         copyToDevice(dJetPt, input.jetPt);
+         copyToDevice(dJetEta, input.jetEta);
+         copyToDevice(dJetPhi, input.jetPhi);
+         copyToDevice(dConstPt, input.constPt);
+         copyToDevice(dConstEta, input.constEta);
+         copyToDevice(dConstPhi, input.constPhi);
+         copyToDevice(dOffsets, input.nConstituents);
+         launched();
+         launchPulls(nJets, true);
+         computed();
+         copyToHost(pullEta, dPullEta);
+         copyToHost(pullPhi, dPullPhi);
+         const std::size_t inputBytes =
+             nJets * (3 * sizeof(float) + sizeof(std::size_t)) +
+             3 * nConst * sizeof(float);
+         const std::size_t outputBytes = 2 * nJets * sizeof(float);
+         finish(results, inputBytes + outputBytes, inputBytes + outputBytes);
+      }
+
+      bool hasTransferEncoding() const override { return true; }
+
+      void calibrateElectronsEncoded(const EncodedElectronArrays &input,
+                                     std::span<float> calibratedPt,
+                                     StageResults &results) override
+      {
+         const std::size_t n = input.pt.size();
+         std::uint16_t *dAuthor = m_blocks[3].get<std::uint16_t>(n);
+         float *dOutput = m_blocks[4].get<float>(n);
+
+         // Encoded inputs are always copied, since they need to be decoded
+         // into device memory anyway.
+         start();
+         uploadColumn(input.eta, m_codeBlocks[0], m_blocks[0]);
+         uploadColumn(input.phi, m_codeBlocks[1], m_blocks[1]);
+         uploadColumn(input.pt, m_codeBlocks[2], m_blocks[2]);
+         copyToDevice(dAuthor, input.author);
+         launched();
+         const float *dEta =
+             decodeColumn(input.eta, m_codeBlocks[0], m_blocks[0]);
+         const float *dPhi =
+             decodeColumn(input.phi, m_codeBlocks[1], m_blocks[1]);
+         const float *dPt = decodeColumn(input.pt, m_codeBlocks[2], m_blocks[2]);
+         launchCalibrateElectrons(n, dEta, dPhi, dPt, dAuthor, dOutput,
+                                  m_calibrateElectronsLaunch.value_or(
+                                      LaunchConfig{}));
+         computed();
+         copyToHost(calibratedPt, dOutput);
+         const std::size_t inputBytes = input.size_bytes();
+         const std::size_t outputBytes = calibratedPt.size_bytes();
+         finish(results, inputBytes + outputBytes,
+                n * (4 * sizeof(float) + sizeof(std::uint16_t)));
+
+         // Tune the launch parameters on the arrays of the first call.
+         tune("calibrateElectrons", n, m_calibrateElectronsLaunch,
+              [&](const LaunchConfig &launch)
+              {
+                 launchCalibrateElectrons(n, dEta, dPhi, dPt, dAuthor,
+                                          dOutput, launch);
+              });
+      }
+
+      void calculatePullsEncoded(const EncodedJetArrays &input,
+                                 std::span<float> pullEta,
+                                 std::span<float> pullPhi,
+                                 StageResults &results) override
+      {
+         const EncodedCountColumn &counts = input.nConstituents;
+         const std::size_t nJets = counts.size();
+         const std::size_t nConst = input.constPt.size();
+         std::size_t *dOffsets = m_blocks[6].get<std::size_t>(nJets + 1);
+         float *dPullEta = m_blocks[7].get<float>(nJets);
+         float *dPullPhi = m_blocks[8].get<float>(nJets);
+
+         start();
+         uploadColumn(input.jetPt, m_codeBlocks[0], m_blocks[0]);
+         uploadColumn(input.jetEta, m_codeBlocks[1], m_blocks[1]);
+         uploadColumn(input.jetPhi, m_codeBlocks[2], m_blocks[2]);
+         uploadColumn(input.constPt, m_codeBlocks[3], m_blocks[3]);
+         uploadColumn(input.constEta, m_codeBlocks[4], m_blocks[4]);
+         uploadColumn(input.constPhi, m_codeBlocks[5], m_blocks[5]);
+         switch (counts.type)
+         {
+         case CountEncoding::Size:
+            copyToDevice(dOffsets, counts.sizes);
+            break;
+         case CountEncoding::Count16:
+            copyToDevice(m_codeBlocks[6].get<std::uint16_t>(nJets),
+                         counts.counts);
+            break;
+         case CountEncoding::Offset32:
+            copyToDevice(m_codeBlocks[6].get<std::uint32_t>(nJets + 1),
+                         counts.offsets);
+            break;
+         }
+         launched();
+         decodeColumn(input.jetPt, m_codeBlocks[0], m_blocks[0]);
+         decodeColumn(input.jetEta, m_codeBlocks[1], m_blocks[1]);
+         decodeColumn(input.jetPhi, m_codeBlocks[2], m_blocks[2]);
+         decodeColumn(input.constPt, m_codeBlocks[3], m_blocks[3]);
+         decodeColumn(input.constEta, m_codeBlocks[4], m_blocks[4]);
+         decodeColumn(input.constPhi, m_codeBlocks[5], m_blocks[5]);
+         // The 32-bit offsets only need to be widened, the counts also need
+         // to be summed up.
+         if (counts.type == CountEncoding::Count16)
+         {
+            GPUTUTORIAL_CUDA_CHECK(
+                CUDA::widen(nJets, m_codeBlocks[6].get<std::uint16_t>(nJets),
+                            dOffsets, m_stream));
+         }
+         else if (counts.type == CountEncoding::Offset32)
+         {
+            GPUTUTORIAL_CUDA_CHECK(CUDA::widen(
+                nJets + 1, m_codeBlocks[6].get<std::uint32_t>(nJets + 1),
+                dOffsets, m_stream));
+         }
+         launchPulls(nJets, counts.type != CountEncoding::Offset32);
+         computed();
+         copyToHost(pullEta, dPullEta);
+         copyToHost(pullPhi, dPullPhi);
+         const std::size_t inputBytes = input.size_bytes();
+         const std::size_t outputBytes = 2 * nJets * sizeof(float);
+         finish(results, inputBytes + outputBytes,
+                nJets * (3 * sizeof(float) + sizeof(std::size_t)) +
+                    3 * nConst * sizeof(float) + outputBytes);
+      }
+
+      /// @}
+
+   private:
+      /// Launch the linear transformation of @c n elements
+      void launchLinearTransform(std::size_t n, const float *input,
+                                 float *output, const LaunchConfig &launch)
+      {
+         if (n == 0)
+         {
+            return;
+         }
+         Kernels::linearTransform<<<launch.nWorkGroups(n),
+                                    launch.workGroupSize, 0, m_stream>>>(
+             n, input, output);
+         GPUTUTORIAL_CUDA_CHECK(cudaGetLastError());
+      }
+
+      /// Launch the calibration of @c n electrons
+      void launchCalibrateElectrons(std::size_t n, const float *eta,
+                                    const float *phi, const float *pt,
+                                    const std::uint16_t *author, float *output,
+                                    const LaunchConfig &launch)
+      {
+         if (n == 0)
+         {
+            return;
+         }
+         Kernels::calibrateElectrons<<<launch.nWorkGroups(n),
+                                       launch.workGroupSize, 0, m_stream>>>(
+             n, eta, phi, pt, author, m_table, output);
+         GPUTUTORIAL_CUDA_CHECK(cudaGetLastError());
+      }
+
+      /// Tune the block size of a kernel, if it was not tuned yet
+      ///
+      /// The (untimed) tuning runs after the first call with a non-empty
+      /// input, on the device arrays of that call. Every thread of the
+      /// kernels processes a single element. Nothing is cached between
+      /// jobs, so that every benchmark measures the device it runs on.
+      ///
+      void tune(const std::string &kernel, std::size_t n,
+                std::optional<LaunchConfig> &launch,
+                const LaunchTuner::Function &run)
+      {
+         if (launch || (n == 0))
+         {
+            return;
+         }
+         LaunchTuner::Config config;
+         config.itemsPerThread = {1};
+         config.maxWorkGroupSize = m_maxBlockSize;
+         launch = LaunchTuner(nullptr, config)
+                      .tune(m_deviceName, kernel,
+                            [&](const LaunchConfig &candidate)
+                            {
+                               run(candidate);
+                               GPUTUTORIAL_CUDA_CHECK(
+                                   cudaStreamSynchronize(m_stream));
+                            })
+                      .config;
+      }
+
+      /// Launch the jet pull calculation on the inputs in the device blocks
+      ///
+      /// @param nJets The number of jets to process
+      /// @param scan Whether the offsets block still holds the constituent
+      ///             counts, which need to be turned into offsets first
+      ///
+      void launchPulls(std::size_t nJets, bool scan)
+      {
+         if (nJets == 0)
+         {
+            return;
+         }
+         std::size_t *dOffsets = m_blocks[6].get<std::size_t>(nJets + 1);
+         if (scan)
+         {
+            GPUTUTORIAL_CUDA_CHECK(cudaMemsetAsync(
+                dOffsets + nJets, 0, sizeof(std::size_t), m_stream));
+            std::size_t tempSize = 0;
+            GPUTUTORIAL_CUDA_CHECK(cub::DeviceScan::ExclusiveSum(
+                nullptr, tempSize, dOffsets, dOffsets, nJets + 1, m_stream));
+            void *dTemp = m_blocks[9].get<char>(tempSize);
+            GPUTUTORIAL_CUDA_CHECK(cub::DeviceScan::ExclusiveSum(
+                dTemp, tempSize, dOffsets, dOffsets, nJets + 1, m_stream));
+         }
+         // The blocks were already sized by the caller, these calls only
+         // retrieve the pointers.
+         Kernels::calculatePulls<<<nJets, BLOCKSIZE, 0, m_stream>>>(
+             m_blocks[0].get<float>(0), m_blocks[1].get<float>(0),
+             m_blocks[2].get<float>(0), m_blocks[3].get<float>(0),
+             m_blocks[4].get<float>(0), m_blocks[5].get<float>(0), dOffsets,
+             nJets, m_blocks[7].get<float>(0), m_blocks[8].get<float>(0));
+         GPUTUTORIAL_CUDA_CHECK(cudaGetLastError());
+      }
+
+      /// Copy a (possibly encoded) column to the device, as it is
+      void uploadColumn(const EncodedFloatColumn &column, DeviceBlock &codes,
+                        DeviceBlock &values)
+      {
+         if (column.encoded())
+         {
+            copyToDevice(codes.get<std::uint16_t>(column.size()),
+                         column.codes);
+         }
+         else
+         {
+            copyToDevice(values.get<float>(column.size()), column.values);
+         }
+      }
+      /// Decode a column uploaded by @c uploadColumn, if it is encoded
+      const float *decodeColumn(const EncodedFloatColumn &column,
+                                DeviceBlock &codes, DeviceBlock &values)
+      {
+         float *result = values.get<float>(column.size());
+         if (column.encoded())
+         {
+            GPUTUTORIAL_CUDA_CHECK(CUDA::decodeColumn(
+                column.size(), codes.get<std::uint16_t>(column.size()),
+                column.decoder, result, m_stream));
+         }
+         return result;
+      }
+
+      /// Asynchronously copy an array to the device
+      template <typename T>
+      void copyToDevice(T *dest, std::span<const T> source)
+      {
+         GPUTUTORIAL_CUDA_CHECK(cudaMemcpyAsync(dest, source.data(),
+                                                source.size_bytes(),
+                                                cudaMemcpyHostToDevice,
+                                                m_stream));
+      }
+      /// Asynchronously copy an array to the host
+      template <typename T>
+      void copyToHost(std::span<T> dest, const T *source)
+      {
+         GPUTUTORIAL_CUDA_CHECK(cudaMemcpyAsync(dest.data(), source,
+                                                dest.size_bytes(),
+                                                cudaMemcpyDeviceToHost,
+                                                m_stream));
+      }
+
+      /// Mark the start of a calculation
+      void start()
+      {
+         GPUTUTORIAL_CUDA_CHECK(cudaEventRecord(m_events[0], m_stream));
+      }
+      /// Mark the end of the host-to-device copies
+      void launched()
+      {
+         GPUTUTORIAL_CUDA_CHECK(cudaEventRecord(m_events[1], m_stream));
+      }
+      /// Mark the end of the kernel(s)
+      void computed()
+      {
+         GPUTUTORIAL_CUDA_CHECK(cudaEventRecord(m_events[2], m_stream));
+      }
+      /// Wait for the calculation to finish, and record its timing
+      void finish(StageResults &results, std::size_t transferBytes,
+                  std::size_t computeBytes)
+      {
+         GPUTUTORIAL_CUDA_CHECK(cudaEventRecord(m_events[3], m_stream));
+         GPUTUTORIAL_CUDA_CHECK(cudaStreamSynchronize(m_stream));
+         float h2d = 0.f, kernel = 0.f, d2h = 0.f;
+         GPUTUTORIAL_CUDA_CHECK(
+             cudaEventElapsedTime(&h2d, m_events[0], m_events[1]));
+         GPUTUTORIAL_CUDA_CHECK(
+             cudaEventElapsedTime(&kernel, m_events[1], m_events[2]));
+         GPUTUTORIAL_CUDA_CHECK(
+             cudaEventElapsedTime(&d2h, m_events[2], m_events[3]));
+         results.transfer.time += Duration((h2d + d2h) * 1e-3);
+         results.transfer.bytes += transferBytes;
+         results.compute.time += Duration(kernel * 1e-3);
+         results.compute.bytes += computeBytes;
+      }
+
+      /// Flag showing whether the device can access pageable host memory
+      bool m_hostAccessible = false;
+      /// Name of the device
+      std::string m_deviceName;
+      /// Largest block size supported by the device
+      std::size_t m_maxBlockSize = 0;
+      /// Tuned launch parameters of the linear transformation
+      std::optional<LaunchConfig> m_linearTransformLaunch;
+      /// Tuned launch parameters of the electron calibration
+      std::optional<LaunchConfig> m_calibrateElectronsLaunch;
+      /// Pinned host memory resource
+      vecmem::cuda::host_memory_resource m_pinnedHostMR;
+      /// Cached pinned host memory resource
+      vecmem::pool_memory_resource m_cachedHostMR{m_pinnedHostMR};
+      /// The stream used for all operations
+      cudaStream_t m_stream = nullptr;
+      /// Events used for timing the operations
+      cudaEvent_t m_events[4] = {};
+      /// Device memory blocks, re-used between the events
+      DeviceBlock m_blocks[10];
+      /// Device memory blocks receiving the encoded inputs
+      DeviceBlock m_codeBlocks[7];
+      /// Device memory block holding the electron calibration table
+      DeviceBlock m_tableBlock;
+      /// View of the electron calibration table on the device
+      ElectronCalibrationTableView m_table;
+
+   }; // class CUDABackend
+
+} // namespace
+
+namespace GPUTutorial
+{
+   namespace Benchmark
+   {
+      std::unique_ptr<Backend> makeCUDABackend()
+      {
+         // Only create the backend if there's a device to use.
+         int nDevices = 0;
+         if ((cudaGetDeviceCount(&nDevices) != cudaSuccess) ||
+             (nDevices == 0))
+         {
+            cudaGetLastError();
+            return nullptr;
+         }
+         return std::make_unique<CUDABackend>();
+      }
+
+      std::unique_ptr<std::pmr::memory_resource> makeCUDAPinnedMR()
+      {
+         // Only create the resource if there's a device to use.
+         int nDevices = 0;
+         if ((cudaGetDeviceCount(&nDevices) != cudaSuccess) ||
+             (nDevices == 0))
+         {
+            cudaGetLastError();
+            return nullptr;
+         }
+         return std::make_unique<vecmem::cuda::host_memory_resource>();
+      }
+
+   } // namespace Benchmark
+
+} // namespace GPUTutorial
@@ -0,0 +1,614 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+//
+// Standalone benchmark of the tutorial kernels, using synthetic events.
+//
+// Usage: gpuTutorialBenchmark [--events=N] [--warmup=N] [--seed=N]
+//                             [--values=DIST] [--electrons=DIST]
+//                             [--jets=DIST] [--constituents=DIST]
+//                             [--backends=host,cuda,sycl-cpu,sycl-gpu]
+//                             [--kernels=linearTransform,elementWiseChain,calibrateElectrons,calculatePulls,gatherConstituents,kinematics,concurrentOffload,firstEvents]
+//                             [--grain-size=N] [--batch-size=N]
+//                             [--calib-tables=none,NETAxNPHIxNPTxNAUTHOR,...]
+//                             [--electron-input=staged,zero-copy]
+//                             [--constituent-sources=N,...]
+//                             [--pull-reductions=block-per-jet,segmented]
+//                             [--transfer-encodings=none;ENCODING;...]
+//                             [--concurrent-events=N,...]
+//                             [--offload-sync=stream,device]
+//                             [--mock-latency=US] [--mock-bandwidth=GBPS]
+//                             [--first-events=N] [--memory-upstreams=host,pinned]
+//                             [--output=FILE]
+//
+// Where DIST is a size distribution in the "type:mean[:max]" format, with
+// type being one of "fixed", "uniform", "poisson" or "exponential". The
+// electron calibration is benchmarked with every one of the requested
+// calibration tables, "none" standing for the phi dependent formula, and
+// with every one of the requested ways of providing its input. The jet
+// constituent gather is only run on the host, with the constituents spread
+// over each of the requested numbers of source containers. The jet pulls
+// are calculated with each of the requested reductions over the jet
+// constituents, on the backends implementing them. Comparing the two is
+// most interesting with skewed constituent multiplicities, like
+// "--constituents=exponential:30:500".
+//
+// The electron calibration (with staged input) and the jet pulls (with the
+// default reduction) are also run with each of the requested transfer
+// encodings, on the backends implementing them. An ENCODING is a comma
+// separated list like "eta=fixed:16,phi=fixed:16,pt=half,counts=offset32",
+// see GPUTutorial::TransferEncoding::parse. The results of the encoded runs
+// are compared to an unencoded host calculation, and the deviations are
+// written into the report next to the usual timings.
+//
+// The element-wise chain, which is not run by default, applies a few more
+// cheap transformations after the linear one. It is run both with every
+// step launched separately, and with all of them fused into one kernel.
+//
+// The kinematics benchmark, which is not run by default either, applies the
+// host versions of the GPUTutorial::Kinematics functions to the
+// constituents of every jet, comparing their results to a double precision
+// calculation.
+//
+// The concurrent offload, which is not run by default either, calibrates
+// the electrons of each of the requested numbers of concurrent events on a
+// mock device, asynchronously on a host thread pool. Every event either
+// waits only for its own work ("stream"), or for the work of all events
+// ("device"), like a cudaDeviceSynchronize() call would. It needs no
+// accelerator, and shows how well the offload scales with the number of
+// concurrent events.
+//
+// The first events benchmark, which is not run by default either, allocates
+// the arrays of the first N events from a new arena and pool on each of the
+// requested upstream memory resources ("pinned" needing CUDA). Once with
+// empty resources, and once with resources pre-warmed from the allocation
+// profile recorded in the warm-up run. It shows how much of the latency of
+// a job's first events pre-warming can remove.
+//
+// SYCL backends on devices sharing the memory of the host (like "sycl-cpu")
+// let the kernels use the host arrays in place. Adding ":copy" to their name
+// (like "sycl-cpu:copy") makes them copy the arrays to device memory anyway,
+// so the two can be compared.
+//
+// Before running any benchmark, the offload thresholds of a few simple cost
+// models are checked. The executable exits with a non-zero code if any of
+// them is not what GPUTutorial::OffloadDispatcher should use. It does the
+// same (after writing the report) if the results of any unencoded
+// calculation differ from their reference by more than rounding explains.
+//
+
+// Local include(s).
+#include "GPUTutorialCore/Benchmark.h"
+#include "GPUTutorialCore/ElectronCalibrationTable.h"
+#include "GPUTutorialCore/OffloadDispatcher.h"
+#include "GPUTutorialCore/SyntheticEvents.h"
+#include "GPUTutorialCore/TransferEncoding.h"
+
+// System include(s).
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+   /// Split a separated list
+   std::vector<std::string> split(const std::string &list,
+                                  char separator = ',')
+   {
+      std::vector<std::string> result;
+      std::size_t begin = 0;
+      while (begin <= list.size())
+      {
+         const std::size_t end = std::min(list.find(separator, begin), list.size());
+         if (end > begin)
+         {
+            result.push_back(list.substr(begin, end - begin));
+         }
+         begin = end + 1;
+      }
+      return result;
+   }
+
+   /// Create a synthetic calibration table from a "NETAxNPHIxNPTxNAUTHOR"
+   /// description, or an empty table for "none"
+   GPUTutorial::ElectronCalibrationTable
+   makeCalibrationTable(const std::string &spec)
+   {
+      if (spec == "none")
+      {
+         return {};
+      }
+      const std::vector<std::string> sizes = split(spec, 'x');
+      if (sizes.size() != 4)
+      {
+         throw std::invalid_argument("Invalid calibration table: \"" + spec +
+                                     "\"");
+      }
+      return GPUTutorial::makeSyntheticElectronCalibration(
+          std::stoul(sizes[0]), std::stoul(sizes[1]), std::stoul(sizes[2]),
+          std::stoul(sizes[3]));
+   }
+
+   /// Check the offload thresholds of a few simple cost models
+   ///
+   /// Every model is given with its costs in microseconds, as host overhead,
+   /// host cost per element, device overhead and device cost per element.
+   ///
+   /// @return Whether all thresholds were as expected
+   ///
+   bool checkOffloadThresholds()
+   {
+      using GPUTutorial::OffloadCostModel;
+      static constexpr std::size_t NEVER =
+          std::numeric_limits<std::size_t>::max();
+      struct Case
+      {
+         double hostOverhead, hostPerElement, deviceOverhead,
+             devicePerElement;
+         std::size_t expected;
+      };
+      static const Case cases[] = {
+          // Larger device overhead, smaller device cost per element.
+          {1., 1., 11., 0.5, 20},
+          // Smaller device overhead, larger device cost per element.
+          {10., 0.5, 1., 1., NEVER},
+          // The device is cheaper in both.
+          {10., 1., 1., 0.5, 0},
+          // The device is more expensive in both.
+          {1., 0.5, 10., 1., NEVER},
+          // Same cost per element.
+          {10., 1., 1., 1., 0},
+          {1., 1., 10., 1., NEVER}};
+      bool result = true;
+      for (const Case &c : cases)
+      {
+         const OffloadCostModel model{
+             OffloadCostModel::Duration(c.hostOverhead * 1e-6),
+             OffloadCostModel::Duration(c.hostPerElement * 1e-6),
+             OffloadCostModel::Duration(c.deviceOverhead * 1e-6),
+             OffloadCostModel::Duration(c.devicePerElement * 1e-6)};
+         const std::size_t threshold = model.threshold();
+         if (threshold != c.expected)
+         {
+            std::cerr << "Unexpected offload threshold for cost model (host "
+                      << c.hostOverhead << " us + " << c.hostPerElement
+                      << " us/element, device " << c.deviceOverhead
+                      << " us + " << c.devicePerElement
+                      << " us/element): " << threshold << " instead of "
+                      << c.expected << std::endl;
+            result = false;
+         }
+      }
+      return result;
+   }
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+   using namespace GPUTutorial;
+
+   try
+   {
+      // Default settings.
+      std::map<std::string, std::string> options{
+          {"events", "1000"},
+          {"warmup", "10"},
+          {"seed", "1234"},
+          {"values", "fixed:100000"},
+          {"electrons", "poisson:3"},
+          {"jets", "poisson:30"},
+          {"constituents", "poisson:25"},
+          {"backends", "host,cuda,sycl-cpu,sycl-gpu"},
+          {"kernels", "linearTransform,calibrateElectrons,calculatePulls"},
+          {"grain-size", "16"},
+          {"batch-size", "1"},
+          {"calib-tables", "none"},
+          {"electron-input", "staged"},
+          {"constituent-sources", "1,4"},
+          {"pull-reductions", "block-per-jet"},
+          {"transfer-encodings", "none"},
+          {"concurrent-events", "1,2,4,8"},
+          {"offload-sync", "stream,device"},
+          {"mock-latency", "20"},
+          {"mock-bandwidth", "10"},
+          {"first-events", "10"},
+          {"memory-upstreams", "host,pinned"},
+          {"output", ""}};
+
+      // Interpret the command line.
+      for (int i = 1; i < argc; ++i)
+      {
+         const std::string arg = argv[i];
+         const std::size_t eq = arg.find('=');
+         if ((arg.rfind("--", 0) != 0) || (eq == std::string::npos) ||
+             (options.find(arg.substr(2, eq - 2)) == options.end()))
+         {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+         }
+         options[arg.substr(2, eq - 2)] = arg.substr(eq + 1);
+      }
+
+      // Check the offload decisions, before spending time on the
+      // benchmarks.
+      if (!checkOffloadThresholds())
+      {
+         return 1;
+      }
+
+      // Generate the events.
+      SyntheticEventConfig config;
+      config.seed = std::stoull(options["seed"]);
+      config.nValues = SizeDistribution::parse(options["values"]);
+      config.nElectrons = SizeDistribution::parse(options["electrons"]);
+      config.nJets = SizeDistribution::parse(options["jets"]);
+      config.nConstituents = SizeDistribution::parse(options["constituents"]);
+      SyntheticEventGenerator generator(config);
+      std::vector<SyntheticEvent> warmupEvents, events;
+      for (std::size_t i = 0; i < std::stoul(options["warmup"]); ++i)
+      {
+         warmupEvents.push_back(generator.generate());
+      }
+      for (std::size_t i = 0; i < std::stoul(options["events"]); ++i)
+      {
+         events.push_back(generator.generate());
+      }
+
+      // Set up the requested backends, that are available.
+      std::vector<std::unique_ptr<Benchmark::Backend>> backends;
+      for (const std::string &name : split(options["backends"]))
+      {
+         std::unique_ptr<Benchmark::Backend> backend;
+         if (name == "host")
+         {
+            backend = Benchmark::makeHostBackend(
+                std::stoul(options["grain-size"]));
+         }
+#ifdef GPUTUTORIAL_HAVE_CUDA
+         else if (name == "cuda")
+         {
+            backend = Benchmark::makeCUDABackend();
+         }
+#endif // GPUTUTORIAL_HAVE_CUDA
+#ifdef GPUTUTORIAL_HAVE_SYCL
+         else if (name.rfind("sycl-", 0) == 0)
+         {
+            backend = Benchmark::makeSYCLBackend(name.substr(5));
+         }
+#endif // GPUTUTORIAL_HAVE_SYCL
+         if (backend)
+         {
+            std::cerr << "Using backend: " << backend->name() << std::endl;
+            backends.push_back(std::move(backend));
+         }
+         else
+         {
+            std::cerr << "Backend not available: " << name << std::endl;
+         }
+      }
+
+      // Set up the benchmark jobs.
+      const std::size_t batchSize = std::stoul(options["batch-size"]);
+      std::vector<ElectronCalibrationTable> tables;
+      for (const std::string &spec : split(options["calib-tables"]))
+      {
+         tables.push_back(makeCalibrationTable(spec));
+      }
+      std::vector<bool> zeroCopyInputs;
+      for (const std::string &mode : split(options["electron-input"]))
+      {
+         if ((mode != "staged") && (mode != "zero-copy"))
+         {
+            std::cerr << "Unknown electron input mode: " << mode << std::endl;
+            return 1;
+         }
+         zeroCopyInputs.push_back(mode == "zero-copy");
+      }
+      std::vector<bool> segmentedReductions;
+      for (const std::string &reduction : split(options["pull-reductions"]))
+      {
+         if ((reduction != "block-per-jet") && (reduction != "segmented"))
+         {
+            std::cerr << "Unknown jet pull reduction: " << reduction
+                      << std::endl;
+            return 1;
+         }
+         segmentedReductions.push_back(reduction == "segmented");
+      }
+      std::vector<std::optional<TransferEncoding>> encodings;
+      for (const std::string &spec : split(options["transfer-encodings"], ';'))
+      {
+         const TransferEncoding encoding = TransferEncoding::parse(spec);
+         encodings.push_back(encoding.encoded()
+                                 ? std::optional<TransferEncoding>(encoding)
+                                 : std::nullopt);
+      }
+      static const SegmentedReductionConfig segmentedConfig;
+      // Jobs return no result for backends not supporting them.
+      using RunFunction = std::function<std::optional<Benchmark::KernelResult>(
+          Benchmark::Backend &, std::vector<SyntheticEvent> &)>;
+      std::vector<RunFunction> jobs;
+      const std::vector<std::string> kernels = split(options["kernels"]);
+      for (const std::string &kernel : kernels)
+      {
+         if (kernel == "linearTransform")
+         {
+            jobs.push_back(&Benchmark::runLinearTransform);
+         }
+         else if (kernel == "elementWiseChain")
+         {
+            for (bool fused : {false, true})
+            {
+               jobs.push_back(
+                   [fused](Benchmark::Backend &backend,
+                           std::vector<SyntheticEvent> &events)
+                       -> std::optional<Benchmark::KernelResult>
+                   {
+                      if (!backend.hasElementWise())
+                      {
+                         return std::nullopt;
+                      }
+                      return Benchmark::runElementWiseChain(backend, events,
+                                                            fused);
+                   });
+            }
+         }
+         else if (kernel == "calibrateElectrons")
+         {
+            for (const std::optional<TransferEncoding> &encoding : encodings)
+            {
+               for (bool zeroCopyInput : zeroCopyInputs)
+               {
+                  // Encoded inputs are always staged.
+                  if (zeroCopyInput && encoding)
+                  {
+                     continue;
+                  }
+                  for (const ElectronCalibrationTable &table : tables)
+                  {
+                     jobs.push_back(
+                         [&table, zeroCopyInput, encoding](
+                             Benchmark::Backend &backend,
+                             std::vector<SyntheticEvent> &events)
+                             -> std::optional<Benchmark::KernelResult>
+                         {
+                            if (encoding && !backend.hasTransferEncoding())
+                            {
+                               return std::nullopt;
+                            }
+                            return Benchmark::runCalibrateElectrons(
+                                backend, events, table, zeroCopyInput,
+                                (encoding ? &*encoding : nullptr));
+                         });
+                  }
+               }
+            }
+         }
+         else if (kernel == "calculatePulls")
+         {
+            for (bool segmented : segmentedReductions)
+            {
+               jobs.push_back(
+                   [batchSize, segmented](Benchmark::Backend &backend,
+                                          std::vector<SyntheticEvent> &events)
+                       -> std::optional<Benchmark::KernelResult>
+                   {
+                      if (!segmented)
+                      {
+                         return Benchmark::runCalculatePulls(backend, events,
+                                                             batchSize);
+                      }
+                      if (!backend.hasSegmentedReduction())
+                      {
+                         return std::nullopt;
+                      }
+                      return Benchmark::runCalculatePulls(
+                          backend, events, batchSize, &segmentedConfig);
+                   });
+            }
+            for (const std::optional<TransferEncoding> &encoding : encodings)
+            {
+               if (!encoding)
+               {
+                  continue;
+               }
+               jobs.push_back(
+                   [batchSize, encoding](Benchmark::Backend &backend,
+                                         std::vector<SyntheticEvent> &events)
+                       -> std::optional<Benchmark::KernelResult>
+                   {
+                      if (!backend.hasTransferEncoding())
+                      {
+                         return std::nullopt;
+                      }
+                      return Benchmark::runCalculatePulls(
+                          backend, events, batchSize, nullptr, &*encoding);
+                   });
+            }
+         }
+         else if ((kernel != "gatherConstituents") &&
+                  (kernel != "concurrentOffload") && (kernel != "kinematics") &&
+                  (kernel != "firstEvents"))
+         {
+            std::cerr << "Unknown kernel: " << kernel << std::endl;
+            return 1;
+         }
+      }
+
+      // Set up the host-only benchmark jobs.
+      using HostRunFunction = std::function<Benchmark::KernelResult(
+          std::vector<SyntheticEvent> &)>;
+      std::vector<HostRunFunction> hostJobs;
+      if (std::find(kernels.begin(), kernels.end(), "gatherConstituents") !=
+          kernels.end())
+      {
+         for (const std::string &n : split(options["constituent-sources"]))
+         {
+            const std::size_t nSources = std::stoul(n);
+            for (bool indexed : {false, true})
+            {
+               hostJobs.push_back(
+                   [nSources, indexed](std::vector<SyntheticEvent> &events)
+                   { return Benchmark::runGatherConstituents(
+                         events, nSources, indexed); });
+            }
+         }
+      }
+
+      if (std::find(kernels.begin(), kernels.end(), "kinematics") !=
+          kernels.end())
+      {
+         for (Benchmark::KinematicsFunction function :
+              {Benchmark::KinematicsFunction::DeltaPhi,
+               Benchmark::KinematicsFunction::DeltaR,
+               Benchmark::KinematicsFunction::PtWeightedSum,
+               Benchmark::KinematicsFunction::PtWeightedDeltaR})
+         {
+            hostJobs.push_back(
+                [function](std::vector<SyntheticEvent> &events)
+                { return Benchmark::runKinematics(events, function); });
+         }
+      }
+
+      if (std::find(kernels.begin(), kernels.end(), "concurrentOffload") !=
+          kernels.end())
+      {
+         for (const std::string &sync : split(options["offload-sync"]))
+         {
+            if ((sync != "stream") && (sync != "device"))
+            {
+               std::cerr << "Unknown offload synchronisation: " << sync
+                         << std::endl;
+               return 1;
+            }
+            for (const std::string &n : split(options["concurrent-events"]))
+            {
+               Benchmark::ConcurrentOffloadConfig offloadConfig;
+               offloadConfig.concurrentEvents = std::stoul(n);
+               offloadConfig.deviceWideSync = (sync == "device");
+               offloadConfig.latency =
+                   Benchmark::Duration(std::stod(options["mock-latency"]) * 1e-6);
+               offloadConfig.bytesPerSecond =
+                   std::stod(options["mock-bandwidth"]) * 1e9;
+               hostJobs.push_back(
+                   [offloadConfig](std::vector<SyntheticEvent> &events)
+                   { return Benchmark::runConcurrentOffload(events,
+                                                            offloadConfig); });
+            }
+         }
+      }
+
+      // The upstream memory resources and allocation profiles of the first
+      // events benchmark need to outlive its jobs.
+      std::vector<std::unique_ptr<std::pmr::memory_resource>> upstreams;
+      std::vector<std::unique_ptr<AllocationProfile>> profiles;
+      if (std::find(kernels.begin(), kernels.end(), "firstEvents") !=
+          kernels.end())
+      {
+         for (const std::string &name : split(options["memory-upstreams"]))
+         {
+            std::pmr::memory_resource *upstream = nullptr;
+            if (name == "host")
+            {
+               upstream = std::pmr::new_delete_resource();
+            }
+#ifdef GPUTUTORIAL_HAVE_CUDA
+            else if (name == "pinned")
+            {
+               upstreams.push_back(Benchmark::makeCUDAPinnedMR());
+               upstream = upstreams.back().get();
+            }
+#endif // GPUTUTORIAL_HAVE_CUDA
+            if (upstream == nullptr)
+            {
+               std::cerr << "Memory resource not available: " << name
+                         << std::endl;
+               continue;
+            }
+            // The warm-up run of the job without pre-warming records the
+            // profile that the other job is pre-warmed with.
+            profiles.push_back(std::make_unique<AllocationProfile>());
+            AllocationProfile *profile = profiles.back().get();
+            for (bool prewarm : {false, true})
+            {
+               Benchmark::FirstEventsConfig firstConfig;
+               firstConfig.nEvents = std::stoul(options["first-events"]);
+               firstConfig.prewarm = prewarm;
+               firstConfig.upstream = name;
+               hostJobs.push_back(
+                   [upstream, profile, firstConfig](
+                       std::vector<SyntheticEvent> &events)
+                   { return Benchmark::runFirstEvents(events, *upstream,
+                                                      *profile, firstConfig); });
+            }
+         }
+      }
+
+      // Run the benchmarks.
+      std::vector<Benchmark::KernelResult> results;
+      for (const RunFunction &job : jobs)
+      {
+         for (auto &backend : backends)
+         {
+            if (!job(*backend, warmupEvents))
+            {
+               continue;
+            }
+            results.push_back(*job(*backend, events));
+         }
+      }
+      for (const HostRunFunction &job : hostJobs)
+      {
+         job(warmupEvents);
+         results.push_back(job(events));
+      }
+
+      // Write the report.
+      if (options["output"].empty())
+      {
+         Benchmark::writeJson(std::cout, config, results);
+      }
+      else
+      {
+         std::ofstream out(options["output"]);
+         Benchmark::writeJson(out, config, results);
+      }
+
+      // Fail if any of the calculations disagreed with its reference.
+      bool accurate = true;
+      for (const Benchmark::KernelResult &result : results)
+      {
+         if (result.accuracy && !result.accuracy->passed())
+         {
+            std::cerr << "Inaccurate results from " << result.kernel
+                      << " on " << result.backend << " (" << result.variant
+                      << "): relative error "
+                      << result.accuracy->relativeError()
+                      << ", with a tolerance of "
+                      << result.accuracy->tolerance << std::endl;
+            accurate = false;
+         }
+      }
+      if (!accurate)
+      {
+         return 1;
+      }
+   }
+   catch (const std::exception &ex)
+   {
+      std::cerr << "Failed to run the benchmark: " << ex.what() << std::endl;
+      return 1;
+   }
+
+   // Return gracefully.
+   return 0;
+}
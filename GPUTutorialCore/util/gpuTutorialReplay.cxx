@@ -0,0 +1,227 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+//
+// Replay of captured offload inputs through the tutorial kernels.
+//
+// Usage: gpuTutorialReplay --input=FILE
+//                          [--backends=host,cuda,sycl-cpu,sycl-gpu]
+//                          [--kernels=calibrateElectrons,calculatePulls]
+//                          [--grain-size=N]
+//                          [--calib-tables=none,NETAxNPHIxNPTxNAUTHOR,...]
+//                          [--warmup=N] [--output=FILE]
+//
+// The input file is written by ElectronCalibCUDAAlg and/or JetPullCUDAAlg,
+// when their "CaptureFile" property is set. It holds the flat arrays that
+// the algorithms handed to their offload code in a real job, event by
+// event. The file is mapped into memory, and the arrays are given to the
+// backends in place, without copying them first. So the benchmark
+// exercises the kernels with the object multiplicities and the value
+// distributions of real data, without needing Athena or the input files of
+// the original job.
+//
+// Every kernel is run over all events of the file on every backend, after
+// having been run over all of them N times (1 by default) without being
+// timed.
+//
+
+// Local include(s).
+#include "GPUTutorialCore/Benchmark.h"
+#include "GPUTutorialCore/ElectronCalibrationTable.h"
+#include "GPUTutorialCore/EventCapture.h"
+
+// System include(s).
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+   /// Split a separated list
+   std::vector<std::string> split(const std::string &list,
+                                  char separator = ',')
+   {
+      std::vector<std::string> result;
+      std::size_t begin = 0;
+      while (begin <= list.size())
+      {
+         const std::size_t end = std::min(list.find(separator, begin), list.size());
+         if (end > begin)
+         {
+            result.push_back(list.substr(begin, end - begin));
+         }
+         begin = end + 1;
+      }
+      return result;
+   }
+
+   /// Create a synthetic calibration table from a "NETAxNPHIxNPTxNAUTHOR"
+   /// description, or an empty table for "none"
+   GPUTutorial::ElectronCalibrationTable
+   makeCalibrationTable(const std::string &spec)
+   {
+      if (spec == "none")
+      {
+         return {};
+      }
+      const std::vector<std::string> sizes = split(spec, 'x');
+      if (sizes.size() != 4)
+      {
+         throw std::invalid_argument("Invalid calibration table: \"" + spec +
+                                     "\"");
+      }
+      return GPUTutorial::makeSyntheticElectronCalibration(
+          std::stoul(sizes[0]), std::stoul(sizes[1]), std::stoul(sizes[2]),
+          std::stoul(sizes[3]));
+   }
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+   using namespace GPUTutorial;
+
+   try
+   {
+      // Default settings.
+      std::map<std::string, std::string> options{
+          {"input", ""},
+          {"backends", "host,cuda,sycl-cpu,sycl-gpu"},
+          {"kernels", "calibrateElectrons,calculatePulls"},
+          {"grain-size", "16"},
+          {"calib-tables", "none"},
+          {"warmup", "1"},
+          {"output", ""}};
+
+      // Interpret the command line.
+      for (int i = 1; i < argc; ++i)
+      {
+         const std::string arg = argv[i];
+         const std::size_t eq = arg.find('=');
+         if ((arg.rfind("--", 0) != 0) || (eq == std::string::npos) ||
+             (options.find(arg.substr(2, eq - 2)) == options.end()))
+         {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+         }
+         options[arg.substr(2, eq - 2)] = arg.substr(eq + 1);
+      }
+      if (options["input"].empty())
+      {
+         std::cerr << "No input file given, use --input=FILE" << std::endl;
+         return 1;
+      }
+
+      // Map the captured events.
+      const EventCaptureReader input(options["input"]);
+      std::cerr << "Replaying " << input.size() << " events from "
+                << input.fileName()
+                << (input.indexed() ? "" : " (not indexed, scanned)")
+                << std::endl;
+
+      // Set up the requested backends, that are available.
+      std::vector<std::unique_ptr<Benchmark::Backend>> backends;
+      for (const std::string &name : split(options["backends"]))
+      {
+         std::unique_ptr<Benchmark::Backend> backend;
+         if (name == "host")
+         {
+            backend = Benchmark::makeHostBackend(
+                std::stoul(options["grain-size"]));
+         }
+#ifdef GPUTUTORIAL_HAVE_CUDA
+         else if (name == "cuda")
+         {
+            backend = Benchmark::makeCUDABackend();
+         }
+#endif // GPUTUTORIAL_HAVE_CUDA
+#ifdef GPUTUTORIAL_HAVE_SYCL
+         else if (name.rfind("sycl-", 0) == 0)
+         {
+            backend = Benchmark::makeSYCLBackend(name.substr(5));
+         }
+#endif // GPUTUTORIAL_HAVE_SYCL
+         if (backend)
+         {
+            std::cerr << "Using backend: " << backend->name() << std::endl;
+            backends.push_back(std::move(backend));
+         }
+         else
+         {
+            std::cerr << "Backend not available: " << name << std::endl;
+         }
+      }
+
+      // Set up the benchmark jobs.
+      std::vector<ElectronCalibrationTable> tables;
+      for (const std::string &spec : split(options["calib-tables"]))
+      {
+         tables.push_back(makeCalibrationTable(spec));
+      }
+      using RunFunction = std::function<Benchmark::KernelResult(
+          Benchmark::Backend &, const EventCaptureReader &)>;
+      std::vector<RunFunction> jobs;
+      for (const std::string &kernel : split(options["kernels"]))
+      {
+         if (kernel == "calibrateElectrons")
+         {
+            for (const ElectronCalibrationTable &table : tables)
+            {
+               jobs.push_back(
+                   [&table](Benchmark::Backend &backend,
+                            const EventCaptureReader &events)
+                   { return Benchmark::replayCalibrateElectrons(
+                         backend, events, table); });
+            }
+         }
+         else if (kernel == "calculatePulls")
+         {
+            jobs.push_back(&Benchmark::replayCalculatePulls);
+         }
+         else
+         {
+            std::cerr << "Unknown kernel: " << kernel << std::endl;
+            return 1;
+         }
+      }
+
+      // Run the benchmarks.
+      const std::size_t nWarmup = std::stoul(options["warmup"]);
+      std::vector<Benchmark::KernelResult> results;
+      for (const RunFunction &job : jobs)
+      {
+         for (auto &backend : backends)
+         {
+            for (std::size_t i = 0; i < nWarmup; ++i)
+            {
+               job(*backend, input);
+            }
+            results.push_back(job(*backend, input));
+         }
+      }
+
+      // Write the report.
+      if (options["output"].empty())
+      {
+         Benchmark::writeJson(std::cout, input, results);
+      }
+      else
+      {
+         std::ofstream out(options["output"]);
+         Benchmark::writeJson(out, input, results);
+      }
+   }
+   catch (const std::exception &ex)
+   {
+      std::cerr << "Failed to run the replay: " << ex.what() << std::endl;
+      return 1;
+   }
+
+   // Return gracefully.
+   return 0;
+}
@@ -0,0 +1,45 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#
+
+# Core import(s).
+from AthenaConfiguration.AllConfigFlags import initConfigFlags
+from AthenaConfiguration.ComponentAccumulator import ComponentAccumulator
+from AthenaConfiguration.ComponentFactory import CompFactory
+from AthenaConfiguration.MainServicesConfig import MainServicesCfg
+
+# System import(s).
+import sys
+
+
+def ElementWiseSYCLAlgCfg(flags, **kwargs):
+    # Create an accumulator to hold the configuration.
+    result = ComponentAccumulator()
+    # Create the example algorithm.
+    alg = CompFactory.GPUTutorial.ElementWiseSYCLAlg(**kwargs)
+    result.addEventAlgo(alg)
+    # Return the result to the caller.
+    return result
+
+
+if __name__ == '__main__':
+
+    # Set up the job's flags.
+    flags = initConfigFlags()
+    flags.Exec.MaxEvents = 100
+    flags.fillFromArgs()
+    flags.lock()
+
+    # Set up the main services.
+    acc = MainServicesCfg(flags)
+
+    # Set up the algorithm. Once with the chain fused into a single kernel,
+    # and once launching a kernel for every step.
+    acc.merge(ElementWiseSYCLAlgCfg(flags, name="FusedElementWiseSYCLAlg",
+                                    Fused=True))
+    acc.merge(ElementWiseSYCLAlgCfg(flags, name="SeparateElementWiseSYCLAlg",
+                                    Fused=False))
+
+    # Run the configuration.
+    sys.exit(acc.run().isFailure())
@@ -0,0 +1,116 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef CUDAEXAMPLES_ELEMENTWISESYCLALG_H
+#define CUDAEXAMPLES_ELEMENTWISESYCLALG_H
+
+// Project include(s).
+#include "GPUTutorialCore/LaunchTuning.h"
+#include "GPUTutorialCore/StageTimeline.h"
+
+// Framework include(s).
+#include "AthenaBaseComps/AthReentrantAlgorithm.h"
+
+// System include(s).
+#include <memory>
+#include <string>
+
+namespace GPUTutorial
+{
+   // Forward declaration(s).
+   class SYCLDeviceResources;
+
+   /// Algorithm running a chain of element-wise transformations with SYCL
+   ///
+   /// The linear transformation of @c GPUTutorial::LinearTransformSYCLAlg is
+   /// followed by the further steps of @c GPUTutorial::ElementWiseChain. The
+   /// steps are written as element-wise expressions (see
+   /// GPUTutorialCore/ElementWise.h), and are either fused into a single
+   /// kernel, or launched one by one.
+   ///
+   class ElementWiseSYCLAlg final : public AthReentrantAlgorithm
+   {
+   public:
+      /// Constructor
+      ElementWiseSYCLAlg(const std::string &name, ISvcLocator *svcloc);
+      /// Destructor
+      ~ElementWiseSYCLAlg() override;
+
+      /// @name Functions inherited from @c AthReentrantAlgorithm
+      /// @{
+
+      /// Function initializing the algorithm
+      StatusCode initialize() override;
+      /// Function executing the algorithm
+      StatusCode execute(const EventContext &ctx) const override;
+      /// Function finalizing the algorithm
+      StatusCode finalize() override;
+
+      /// @}
+
+   private:
+      /// @name Algorithm properties
+      /// @{
+
+      /// The type of device to run the transformations on
+      Gaudi::Property<std::string> m_device{
+          this, "Device", "default",
+          "Type of SYCL device to use (cpu, gpu, accelerator or default)"};
+      /// Size of the array transformed in every event
+      Gaudi::Property<std::size_t> m_arraySize{
+          this, "ArraySize", 1000000,
+          "Number of values transformed in every event"};
+      /// Fuse the steps of the chain into a single kernel
+      Gaudi::Property<bool> m_fused{
+          this, "Fused", true,
+          "Run all steps of the chain as a single kernel (False: launch a "
+          "kernel for every step)"};
+      /// Let the kernels use the host buffers in place, where possible
+      Gaudi::Property<bool> m_zeroCopy{
+          this, "ZeroCopy", true,
+          "Let the kernels use the host USM buffers in place on devices that "
+          "share the memory of the host (False: always copy them to device "
+          "memory)"};
+      /// Launch parameters of the kernel(s)
+      Gaudi::Property<std::string> m_launchParameters{
+          this, "LaunchParameters", "auto",
+          "Launch parameters of the kernel(s): \"auto\" to tune them in "
+          "initialize(), or fixed values as \"WORKGROUPSIZExVECTORSPERITEM\", "
+          "like \"256x1\""};
+      /// File caching the tuned launch parameters
+      Gaudi::Property<std::string> m_launchCacheFile{
+          this, "LaunchCacheFile", "gpuTutorialLaunch.cache",
+          "File caching the tuned launch parameters of the kernels, per "
+          "device (none if empty)"};
+      /// Measure the time spent in the stages of the transformations
+      Gaudi::Property<bool> m_stageTiming{
+          this, "StageTiming", false,
+          "Measure the time spent in the stages of every event"};
+      /// File to write the stage timings into, as a Chrome trace
+      Gaudi::Property<std::string> m_chromeTraceFile{
+          this, "ChromeTraceFile", "",
+          "File to write the stage timings of all algorithms into, as a "
+          "Chrome trace (none if empty)"};
+
+      /// @}
+
+      /// @name Algorithm data members
+      /// @{
+
+      /// The queue and memory resources of the device
+      std::unique_ptr<SYCLDeviceResources> m_resources;
+      /// Whether the kernels use the host buffers in place
+      bool m_inPlace = false;
+      /// Launch parameters of the kernel(s)
+      LaunchConfig m_launch;
+
+      /// Timeline to record the stage timings into
+      std::shared_ptr<StageTimeline> m_timeline;
+      /// Identifier of the algorithm on the timeline
+      std::size_t m_timingSource = 0;
+
+      /// @}
+
+   }; // class ElementWiseSYCLAlg
+
+} // namespace GPUTutorial
+
+#endif // CUDAEXAMPLES_ELEMENTWISESYCLALG_H
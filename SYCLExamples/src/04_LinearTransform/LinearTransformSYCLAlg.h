@@ -2,17 +2,26 @@
 #ifndef CUDAEXAMPLES_LINEARTRANSFORMSYCLALG_H
 #define CUDAEXAMPLES_LINEARTRANSFORMSYCLALG_H
 
+// Project include(s).
+#include "GPUTutorialCore/StageTimeline.h"
+
 // Framework include(s).
 #include "AthenaBaseComps/AthReentrantAlgorithm.h"
 
+// System include(s).
+#include <memory>
+#include <string>
+
 namespace GPUTutorial
 {
    /// Example algorithm showing the simplest use of SYCL in Athena
    class LinearTransformSYCLAlg final : public AthReentrantAlgorithm
    {
    public:
-      /// Use the base class's constructor(s).
-      using AthReentrantAlgorithm::AthReentrantAlgorithm;
+      /// Constructor
+      LinearTransformSYCLAlg(const std::string &name, ISvcLocator *svcloc);
+      /// Destructor
+      ~LinearTransformSYCLAlg() override;
 
       /// @name Functions inherited from @c AthReentrantAlgorithm
       /// @{
@@ -21,6 +30,55 @@ namespace GPUTutorial
       StatusCode initialize() override;
       /// Function executing the algorithm
       StatusCode execute(const EventContext &ctx) const override;
+      /// Function finalizing the algorithm
+      StatusCode finalize() override;
+
+      /// @}
+
+   private:
+      /// @name Algorithm properties
+      /// @{
+
+      /// The type of device to run the transformation on
+      Gaudi::Property<std::string> m_device{
+          this, "Device", "default",
+          "Type of SYCL device to use (cpu, gpu, accelerator or default)"};
+      /// Reuse the queue and the USM buffers between events
+      Gaudi::Property<bool> m_reuseResources{
+          this, "ReuseResources", true,
+          "Set up the SYCL queue and the USM buffers once per event slot, and "
+          "reuse them in every event (False: set them up in every event, to "
+          "measure the overhead of that)"};
+      /// Let the kernel use the host buffers in place, where possible
+      Gaudi::Property<bool> m_zeroCopy{
+          this, "ZeroCopy", true,
+          "Let the kernel use the host USM buffers in place on devices that "
+          "share the memory of the host (False: always copy them to device "
+          "memory)"};
+      /// Measure the time spent in the stages of the transformation
+      Gaudi::Property<bool> m_stageTiming{
+          this, "StageTiming", false,
+          "Measure the time spent in the stages of every event"};
+      /// File to write the stage timings into, as a Chrome trace
+      Gaudi::Property<std::string> m_chromeTraceFile{
+          this, "ChromeTraceFile", "",
+          "File to write the stage timings of all algorithms into, as a "
+          "Chrome trace (none if empty)"};
+
+      /// @}
+
+      /// @name Algorithm data members
+      /// @{
+
+      /// PIMPL structure holding the SYCL objects of the algorithm
+      struct Resources;
+      /// The device, the context and the per-slot queues / buffers
+      std::unique_ptr<Resources> m_resources;
+
+      /// Timeline to record the stage timings into
+      std::shared_ptr<StageTimeline> m_timeline;
+      /// Identifier of the algorithm on the timeline
+      std::size_t m_timingSource = 0;
 
       /// @}
 
@@ -0,0 +1,120 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef CUDAEXAMPLES_ELECTRONCALIBSYCLALG_H
+#define CUDAEXAMPLES_ELECTRONCALIBSYCLALG_H
+
+// Project include(s).
+#include "GPUTutorialCore/ElectronCalibrationTable.h"
+#include "GPUTutorialCore/StageTimeline.h"
+
+// Framework include(s).
+#include "AthenaBaseComps/AthReentrantAlgorithm.h"
+#include "StoreGate/ReadHandleKey.h"
+#include "StoreGate/WriteHandleKey.h"
+#include "xAODEgamma/ElectronContainer.h"
+
+// System include(s).
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace GPUTutorial
+{
+   // Forward declaration(s).
+   class SYCLDeviceResources;
+
+   /// SYCL version of @c GPUTutorial::ElectronCalibCUDAAlg
+   ///
+   /// The electron variables are copied from the input aux store into an
+   /// @c GPUTutorial::ElectronDeviceContainer on the device, and the
+   /// calibrated pt values are written into a shallow copy of the input.
+   /// On devices that can access any host memory, the kernel uses the aux
+   /// store arrays in place instead.
+   ///
+   class ElectronCalibSYCLAlg final : public AthReentrantAlgorithm
+   {
+   public:
+      /// Constructor
+      ElectronCalibSYCLAlg(const std::string &name, ISvcLocator *svcloc);
+      /// Destructor
+      ~ElectronCalibSYCLAlg() override;
+
+      /// @name Functions inherited from @c AthReentrantAlgorithm
+      /// @{
+
+      /// Function initializing the algorithm
+      StatusCode initialize() override;
+      /// Function executing the algorithm
+      StatusCode execute(const EventContext &ctx) const override;
+      /// Function finalizing the algorithm
+      StatusCode finalize() override;
+
+      /// @}
+
+   private:
+      /// The context to record the stage timings of an event for
+      StageContext stageContext(const EventContext &ctx) const;
+
+      /// @name Algorithm properties
+      /// @{
+
+      /// The input container key
+      SG::ReadHandleKey<xAOD::ElectronContainer> m_inputKey{
+          this, "InputContainer", "Electrons",
+          "The input electron container"};
+      /// The output container key
+      SG::WriteHandleKey<xAOD::ElectronContainer> m_outputKey{
+          this, "OutputContainer", "CalibratedElectronsSYCL",
+          "The output electron container"};
+      /// The (optional) binned calibration file
+      Gaudi::Property<std::string> m_calibrationFile{
+          this, "CalibrationFile", "",
+          "Text file with the binned calibration tables (none: use a formula)"};
+      /// The type of device to run the calibration on
+      Gaudi::Property<std::string> m_device{
+          this, "Device", "default",
+          "Type of SYCL device to use (cpu, gpu, accelerator or default)"};
+      /// Let the kernel use the aux store arrays in place, where possible
+      Gaudi::Property<bool> m_zeroCopy{
+          this, "ZeroCopy", true,
+          "Let the kernel use the aux store arrays in place on devices that "
+          "can access any host memory (False: always copy them to device "
+          "memory)"};
+      /// Measure the time spent in the stages of the calibration
+      Gaudi::Property<bool> m_stageTiming{
+          this, "StageTiming", false,
+          "Measure the time spent in the stages of every event"};
+      /// File to write the stage timings into, as a Chrome trace
+      Gaudi::Property<std::string> m_chromeTraceFile{
+          this, "ChromeTraceFile", "",
+          "File to write the stage timings of all algorithms into, as a "
+          "Chrome trace (none if empty)"};
+
+      /// @}
+
+      /// @name Algorithm data members
+      /// @{
+
+      /// The queue and memory resources of the device
+      std::unique_ptr<SYCLDeviceResources> m_resources;
+      /// Whether the kernel uses the aux store arrays in place
+      bool m_inPlace = false;
+
+      /// The calibration tables read from the calibration file
+      std::vector<ElectronCalibrationIOV> m_calibrations;
+      /// PIMPL structure holding the calibration table on the device
+      struct DeviceCalibration;
+      /// The calibration table currently on the device
+      std::unique_ptr<DeviceCalibration> m_deviceCalibration;
+
+      /// Timeline to record the stage timings into
+      std::shared_ptr<StageTimeline> m_timeline;
+      /// Identifier of the algorithm on the timeline
+      std::size_t m_timingSource = 0;
+
+      /// @}
+
+   }; // class ElectronCalibSYCLAlg
+
+} // namespace GPUTutorial
+
+#endif // CUDAEXAMPLES_ELECTRONCALIBSYCLALG_H
@@ -0,0 +1,206 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef CUDAEXAMPLES_JETPULLSYCLALG_H
+#define CUDAEXAMPLES_JETPULLSYCLALG_H
+
+// Project include(s).
+#include "GPUTutorialCore/JetSubstructure.h"
+#include "GPUTutorialCore/LaunchTuning.h"
+#include "GPUTutorialCore/SegmentedReduction.h"
+#include "GPUTutorialCore/StageTimeline.h"
+
+// Framework include(s).
+#include "AthenaBaseComps/AthReentrantAlgorithm.h"
+#include "StoreGate/ReadHandleKey.h"
+#include "StoreGate/WriteHandleKey.h"
+#include "xAODJet/JetContainer.h"
+
+// System include(s).
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace GPUTutorial
+{
+   // Forward declaration(s).
+   class SYCLDeviceResources;
+
+   /// SYCL version of @c GPUTutorial::JetPullCUDAAlg
+   ///
+   /// By default the constituents of the jets are summed up with a load
+   /// balanced segmented reduction (@c GPUTutorial::SYCL::SegmentedReducer),
+   /// which picks a work-item, a sub-group or multiple work-groups for every
+   /// jet, depending on its number of constituents. Alternatively every jet
+   /// can be summed up by one work-group. On a CPU device the SYCL runtime
+   /// spreads the work-groups over the cores, and vectorizes the work-items
+   /// of a work-group, so the same code serves CPU-only and accelerator
+   /// nodes.
+   ///
+   /// Other jet substructure observables can be calculated together with
+   /// the pull, by the same segmented reduction over the constituents (see
+   /// @c GPUTutorial::SubstructureContribution).
+   ///
+   /// On devices sharing the memory of the host, the kernels use the host
+   /// arrays that they can access in place, instead of copies of them.
+   ///
+   class JetPullSYCLAlg final : public AthReentrantAlgorithm
+   {
+   public:
+      /// Constructor
+      JetPullSYCLAlg(const std::string &name, ISvcLocator *svcloc);
+      /// Destructor
+      ~JetPullSYCLAlg() override;
+
+      /// @name Functions inherited from @c AthReentrantAlgorithm
+      /// @{
+
+      /// Function initializing the algorithm
+      StatusCode initialize() override;
+      /// Function executing the algorithm
+      StatusCode execute(const EventContext &ctx) const override;
+      /// Function finalizing the algorithm
+      StatusCode finalize() override;
+
+      /// @}
+
+   private:
+      /// PIMPL structure of the segmented reducers of an event slot
+      struct SlotReducers;
+
+      /// Calculate the requested jet observables on the device
+      StatusCode deviceExecute(
+          std::span<const float> jetPt,              ///< [in] Jet pT array
+          std::span<const float> jetEta,             ///< [in] Jet eta array
+          std::span<const float> jetPhi,             ///< [in] Jet phi array
+          std::span<const std::size_t> offsets,      ///< [in] constituent offsets of the jets (nJets + 1)
+          std::span<const float> constPt,            ///< [in] flat array of constituent pTs (grouped by jet)
+          std::span<const float> constEta,           ///< [in] flat array of constituent etas (grouped by jet)
+          std::span<const float> constPhi,           ///< [in] flat array of constituent phis (grouped by jet)
+          const SubstructureArrays &outputs,         ///< [out] host arrays of the requested observables
+          const SegmentedReductionConfig &reduction, ///< [in] configuration of the reduction
+          SlotReducers &reducers,                    ///< [in] reducers of the event slot
+          const StageContext &timing                 ///< [in] context to record the stage timings for
+      ) const;
+
+      /// The context to record the stage timings of an event for
+      StageContext stageContext(const EventContext &ctx) const;
+
+      /// @name Algorithm properties
+      /// @{
+
+      /// The input container key
+      SG::ReadHandleKey<xAOD::JetContainer> m_inputKey{
+          this, "InputContainer", "AntiKt4EMPFlowJets",
+          "The input jet container"};
+      /// The output container key
+      SG::WriteHandleKey<xAOD::JetContainer> m_outputKey{
+          this, "OutputContainer", "JetsWithPullSYCL",
+          "The output jet container with pull vectors"};
+      /// The type of device to calculate the pulls on
+      Gaudi::Property<std::string> m_device{
+          this, "Device", "default",
+          "Type of SYCL device to use (cpu, gpu, accelerator or default)"};
+      /// Let the kernels use the host arrays in place, where possible
+      Gaudi::Property<bool> m_zeroCopy{
+          this, "ZeroCopy", true,
+          "Let the kernels use the host arrays in place on devices that share "
+          "the memory of the host (False: always copy them to device "
+          "memory)"};
+      /// How to sum up the constituents of the jets
+      Gaudi::Property<std::string> m_reduction{
+          this, "Reduction", "Segmented",
+          "How to sum up the constituents of the jets (Segmented or "
+          "WorkGroup)"};
+      /// The jet observables to calculate
+      Gaudi::Property<std::vector<std::string>> m_observables{
+          this, "Observables", {"Pull"},
+          "Jet observables to calculate and decorate the jets with: "
+          "\"Pull\", \"Girth\", \"Width\", \"PtD\", \"C2\" and/or "
+          "\"D2\" (anything other than just \"Pull\" needs "
+          "Reduction=\"Segmented\")"};
+      /// Launch parameters of the calculation
+      Gaudi::Property<std::string> m_launchParameters{
+          this, "LaunchParameters", "auto",
+          "Launch parameters of the calculation: \"auto\" to tune them in "
+          "initialize(), or fixed values as \"WORKGROUPSIZExTHREADMAX\", "
+          "like \"128x16\". With THREADMAX the largest number of "
+          "constituents summed up by a single work-item in the segmented "
+          "reduction (ignored with Reduction=\"WorkGroup\")"};
+      /// File caching the tuned launch parameters
+      Gaudi::Property<std::string> m_launchCacheFile{
+          this, "LaunchCacheFile", "gpuTutorialLaunch.cache",
+          "File caching the tuned launch parameters of the kernels, per "
+          "device (none if empty)"};
+      /// Largest jet summed up by a single sub-group
+      Gaudi::Property<std::size_t> m_subGroupMaxLength{
+          this, "SubGroupMaxConstituents", 256,
+          "Largest number of constituents summed up by a single sub-group "
+          "in the segmented reduction"};
+      /// Number of constituents summed up by one work-group for larger jets
+      Gaudi::Property<std::size_t> m_tileSize{
+          this, "TileSize", 256,
+          "Number of constituents summed up by one work-group, for jets "
+          "larger than SubGroupMaxConstituents"};
+      /// Number of jets handled by one TBB task while preparing the inputs
+      Gaudi::Property<std::size_t> m_prepGrainSize{
+          this, "HostPrepGrainSize", 8,
+          "Number of jets handled by one TBB task while gathering the "
+          "constituents and writing the pull decorations"};
+      /// Cross-check the device results against the host calculation
+      Gaudi::Property<bool> m_crossCheck{
+          this, "CrossCheckHost", false,
+          "Compare the results of the device with the host calculation"};
+      /// Relative tolerance of the host/device cross-check
+      Gaudi::Property<float> m_crossCheckRelTolerance{
+          this, "CrossCheckRelTolerance", 1e-4f,
+          "Relative tolerance of the host/device cross-check"};
+      /// Absolute tolerance of the host/device cross-check
+      Gaudi::Property<float> m_crossCheckAbsTolerance{
+          this, "CrossCheckAbsTolerance", 1e-5f,
+          "Absolute tolerance of the host/device cross-check"};
+      /// Measure the time spent in the stages of the calculation
+      Gaudi::Property<bool> m_stageTiming{
+          this, "StageTiming", false,
+          "Measure the time spent in the stages of every event"};
+      /// File to write the stage timings into, as a Chrome trace
+      Gaudi::Property<std::string> m_chromeTraceFile{
+          this, "ChromeTraceFile", "",
+          "File to write the stage timings of all algorithms into, as a "
+          "Chrome trace (none if empty)"};
+
+      /// @}
+
+      /// @name Algorithm data members
+      /// @{
+
+      /// The queue and memory resources of the device
+      std::unique_ptr<SYCLDeviceResources> m_resources;
+      /// The segmented reducers of every event slot
+      std::vector<std::unique_ptr<SlotReducers>> m_reducers;
+
+      /// Whether to use the segmented reduction
+      bool m_segmented = true;
+      /// Configuration of the segmented reduction
+      SegmentedReductionConfig m_reductionConfig;
+      /// The parsed set of jet observables
+      JetObservableSet m_observableSet = 0;
+
+      /// Timeline to record the stage timings into
+      std::shared_ptr<StageTimeline> m_timeline;
+      /// Identifier of the algorithm on the timeline
+      std::size_t m_timingSource = 0;
+
+      /// Number of jets checked by the host/device cross-check
+      mutable std::atomic<std::size_t> m_nCrossCheckedJets{0};
+      /// Number of jets failing the host/device cross-check
+      mutable std::atomic<std::size_t> m_nCrossCheckFailures{0};
+
+      /// @}
+
+   }; // class JetPullSYCLAlg
+
+} // namespace GPUTutorial
+
+#endif // CUDAEXAMPLES_JETPULLSYCLALG_H
@@ -0,0 +1,98 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef CUDAEXAMPLES_SYCLDEVICERESOURCES_H
+#define CUDAEXAMPLES_SYCLDEVICERESOURCES_H
+
+// VecMem include(s).
+#include <vecmem/memory/binary_page_memory_resource.hpp>
+#include <vecmem/memory/sycl/device_memory_resource.hpp>
+#include <vecmem/memory/sycl/host_memory_resource.hpp>
+#include <vecmem/memory/synchronized_memory_resource.hpp>
+#include <vecmem/utils/sycl/copy.hpp>
+#include <vecmem/utils/sycl/queue_wrapper.hpp>
+
+// SYCL include(s).
+#include <sycl/sycl.hpp>
+
+// System include(s).
+#include <string>
+
+namespace GPUTutorial
+{
+   /// Select a SYCL device by its type
+   ///
+   /// @param type One of "cpu", "gpu", "accelerator" or "default"
+   ///
+   /// @throws std::invalid_argument for an unknown device type
+   /// @throws sycl::exception if no device of the requested type exists
+   ///
+   sycl::device selectDevice(const std::string &type);
+
+   /// The queue and the memory resources used by a SYCL algorithm
+   ///
+   /// All memory is managed through the SYCL memory resources of VecMem,
+   /// with (thread-safe) caches in front of them, so that the algorithms
+   /// do not have to allocate device or host USM memory in every event.
+   ///
+   /// The queue is not in-order, so that the events processed in parallel
+   /// may overlap on the device. Every algorithm waits for its own commands
+   /// instead.
+   ///
+   class SYCLDeviceResources
+   {
+   public:
+      /// Constructor with the type of device to use
+      ///
+      /// @param type The type of the device, see @c selectDevice
+      /// @param profiling Whether profiling should be enabled on the queue
+      ///
+      SYCLDeviceResources(const std::string &type, bool profiling);
+
+      /// The resources can not be copied
+      SYCLDeviceResources(const SYCLDeviceResources &) = delete;
+      /// The resources can not be assigned
+      SYCLDeviceResources &operator=(const SYCLDeviceResources &) = delete;
+
+      /// The queue of the device
+      sycl::queue &queue() { return m_queue; }
+      /// The name of the device
+      std::string deviceName() const;
+
+      /// Cached, thread-safe device memory resource
+      vecmem::memory_resource &deviceMR() { return m_deviceMR; }
+      /// Cached, thread-safe host (USM) memory resource
+      vecmem::memory_resource &hostMR() { return m_hostMR; }
+      /// Helper object copying data between the host and the device
+      const vecmem::copy &copy() const { return m_copy; }
+
+   private:
+      /// The queue of the device
+      sycl::queue m_queue;
+      /// Wrapper around the queue, for VecMem
+      vecmem::sycl::queue_wrapper m_queueWrapper;
+
+      /// @name Memory resources
+      /// @{
+
+      /// Device memory resource
+      vecmem::sycl::device_memory_resource m_deviceUpstream;
+      /// Cache in front of the device memory resource
+      vecmem::binary_page_memory_resource m_deviceCache;
+      /// Thread-safe device memory resource
+      vecmem::synchronized_memory_resource m_deviceMR;
+      /// Host (USM) memory resource
+      vecmem::sycl::host_memory_resource m_hostUpstream;
+      /// Cache in front of the host memory resource
+      vecmem::binary_page_memory_resource m_hostCache;
+      /// Thread-safe host memory resource
+      vecmem::synchronized_memory_resource m_hostMR;
+
+      /// @}
+
+      /// Helper object copying data between the host and the device
+      vecmem::sycl::copy m_copy;
+
+   }; // class SYCLDeviceResources
+
+} // namespace GPUTutorial
+
+#endif // CUDAEXAMPLES_SYCLDEVICERESOURCES_H
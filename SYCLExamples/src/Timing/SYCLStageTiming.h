@@ -0,0 +1,25 @@
+// Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
+#ifndef CUDAEXAMPLES_SYCLSTAGETIMING_H
+#define CUDAEXAMPLES_SYCLSTAGETIMING_H
+
+// Project include(s).
+#include "GPUTutorialCore/StageTimeline.h"
+
+// SYCL include(s).
+#include <sycl/sycl.hpp>
+
+namespace GPUTutorial
+{
+   /// Record the duration of a finished command, measured on the device
+   ///
+   /// The command has to be submitted to a queue with profiling enabled.
+   /// The stage is placed on the timeline at the (host) time that the
+   /// command was submitted at. With a disabled context nothing happens.
+   ///
+   void recordDeviceStage(const StageContext &timing, const char *stage,
+                          StageTimeline::Clock::time_point submitted,
+                          const sycl::event &event);
+
+} // namespace GPUTutorial
+
+#endif // CUDAEXAMPLES_SYCLSTAGETIMING_H
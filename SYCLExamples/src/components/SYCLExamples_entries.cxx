@@ -1,7 +1,13 @@
 // Copyright (C) 2002-2025 CERN for the benefit of the ATLAS collaboration
 
 // Local include(s).
+#include "../04_LinearTransform/ElementWiseSYCLAlg.h"
 #include "../04_LinearTransform/LinearTransformSYCLAlg.h"
+#include "../05_xAODCalib/ElectronCalibSYCLAlg.h"
+#include "../06_JetPull/JetPullSYCLAlg.h"
 
 // Declare the component(s).
 DECLARE_COMPONENT(GPUTutorial::LinearTransformSYCLAlg)
+DECLARE_COMPONENT(GPUTutorial::ElementWiseSYCLAlg)
+DECLARE_COMPONENT(GPUTutorial::ElectronCalibSYCLAlg)
+DECLARE_COMPONENT(GPUTutorial::JetPullSYCLAlg)